@@ -13,7 +13,7 @@
 // [x] use variable size array buffers for each tracker datum instead of [kMaxTrack]
 // [x] turn the truth/GEANT information into vectors
 // [ ] move hit_trkid into the track information, remove kMaxTrackers
-// [ ] turn the hit information into vectors (~1 MB worth), remove kMaxHits
+// [x] turn the hit information into vectors (~1 MB worth), remove kMaxHits
 // [ ] fill the tree branch by branch
 // 
 // Current implementation:
@@ -28,8 +28,10 @@
 // Each of these structures is connected to a set of branches, one branch per
 // data member. Data members are vectors of numbers or vectors of fixed-size
 // C arrays. The vector index represents the tracks reconstructed by the
-// algorithm, and each has a fixed size pool for hits (do ROOT t3rees support
-// branches with more than one dimension with variable size?).
+// algorithm. The calorimetry points of all the tracks are stored one after the
+// other in flat vectors (ROOT leaves support only one variable dimension),
+// and the index of the first point of each track and plane is saved with the
+// track. The event hits are vectors too, sized to the hits in the event.
 // The data structures can assign default values to their data, connect to a
 // ROOT tree (creating the branches they need) and resize.
 // The AnalysisTreeDataStruct is constructed with as many tracking algorithms as
@@ -145,13 +147,12 @@
 #include <functional> // std::mem_fn()
 #include <typeinfo>
 #include <cmath>
+#include <limits>
 
 #include "TTree.h"
 #include "TTimeStamp.h"
 
 constexpr int kNplanes       = 3;     //number of wire planes
-constexpr int kMaxHits       = 25000; //maximum number of hits;
-constexpr int kMaxTrackHits  = 2000;  //maximum number of hits on a track
 constexpr int kMaxTrackers   = 15;    //number of trackers passed into fTrackModuleLabel
 constexpr unsigned short kMaxVertices = 100;    //max number of 3D vertices
 constexpr unsigned short kMaxShowers = 100;    //max number of 3D showers
@@ -227,19 +228,20 @@ namespace sbnd {
        * TrackData_t<Short_t>                    :  2  bytes/track
        * TrackData_t<Float_t>                    :  4  bytes/track
        * PlaneData_t<Float_t>, PlaneData_t<Int_t>: 12  bytes/track
-       * HitData_t<Float_t>                      : 24k bytes/track
-       * HitCoordData_t<Float_t>                 : 72k bytes/track
+       * HitData_t<Float_t>                      :  4  bytes/calorimetry point
+       * HitCoordData_t<Float_t>                 : 12  bytes/calorimetry point
        */
       template <typename T>
       using TrackData_t = std::vector<T>;
       template <typename T>
       using PlaneData_t = std::vector<BoxedArray<T[kNplanes]>>;
       template <typename T>
-      using HitData_t = std::vector<BoxedArray<T[kNplanes][kMaxTrackHits]>>;
+      using HitData_t = std::vector<T>;
       template <typename T>
-      using HitCoordData_t = std::vector<BoxedArray<T[kNplanes][kMaxTrackHits][3]>>;
+      using HitCoordData_t = std::vector<BoxedArray<T[3]>>;
       
       size_t MaxTracks; ///< maximum number of storable tracks
+      size_t MaxCaloHits; ///< number of calorimetry points there is currently room for
       
       Short_t  ntracks;             //number of reconstructed tracks
       PlaneData_t<Float_t>    trkke;
@@ -258,6 +260,8 @@ namespace sbnd {
       PlaneData_t<Float_t>    trkpurtruth; //purity of track
       PlaneData_t<Float_t>    trkpitchc;
       PlaneData_t<Short_t>    ntrkhits;
+      PlaneData_t<Int_t>      trkcalohitidx; //index of the first calorimetry point of the track, -1 if none
+      Int_t                   ncalohits;     //number of calorimetry points of all the tracks
       HitData_t<Float_t>      trkdedx;
       HitData_t<Float_t>      trkdqdx;
       HitData_t<Float_t>      trkresrg;
@@ -312,20 +316,21 @@ namespace sbnd {
       TrackData_t<Int_t>   trkparentpfpid; // The parent of the track's pfparticle ID
 
       /// Creates an empty tracker data structure
-      TrackDataStruct(): MaxTracks(0) { Clear(); }
+      TrackDataStruct(): MaxTracks(0), MaxCaloHits(0) { Clear(); }
       /// Creates a tracker data structure allowing up to maxTracks tracks
-      TrackDataStruct(size_t maxTracks): MaxTracks(maxTracks) { Clear(); }
+      TrackDataStruct(size_t maxTracks): MaxTracks(maxTracks), MaxCaloHits(0) { Clear(); }
       void Clear();
       void SetMaxTracks(size_t maxTracks)
         { MaxTracks = maxTracks; Resize(MaxTracks); }
       void Resize(size_t nTracks);
+      /// Makes room for nHits calorimetry points (addresses need to be set again)
+      void ResizeCaloHits(size_t nHits);
       void SetAddresses(TTree* pTree, std::string tracker, bool isCosmics, bool saveHierarchyInfo);
       
       size_t GetMaxTracks() const { return MaxTracks; }
       size_t GetMaxPlanesPerTrack(int /* iTrack */ = 0) const
         { return (size_t) kNplanes; }
-      size_t GetMaxHitsPerTrack(int /* iTrack */ = 0, int /* ipl */ = 0) const
-        { return (size_t) kMaxTrackHits; }
+      size_t GetMaxCaloHits() const { return MaxCaloHits; }
       
     }; // class TrackDataStruct
     
@@ -451,20 +456,21 @@ namespace sbnd {
     // Double_t   taulife;              //electron lifetime
     Char_t     isdata;               //flag, 0=MC 1=data
 
-    // hit information (non-resizeable, 45x kMaxHits = 900k bytes worth)
+    // hit information (one vector per quantity, sized to the event hits)
+    size_t MaxHits = 0; ///! how many hits there is currently room for
     Int_t    no_hits;                  //number of hits
-    Short_t  hit_tpc[kMaxHits];        //tpc number
-    Short_t  hit_plane[kMaxHits];      //plane number
-    Short_t  hit_wire[kMaxHits];       //wire number
-    Short_t  hit_channel[kMaxHits];    //channel ID
-    Float_t  hit_peakT[kMaxHits];      //peak time
-    Float_t  hit_charge[kMaxHits];     //charge (area)
-    Float_t  hit_ph[kMaxHits];         //amplitude
-    Float_t  hit_startT[kMaxHits];     //hit start time
-    Float_t  hit_endT[kMaxHits];       //hit end time
-    Float_t  hit_nelec[kMaxHits];     //hit number of electrons
-    Float_t  hit_energy[kMaxHits];       //hit energy
-    Short_t  hit_trkid[kMaxHits];      //is this hit associated with a reco track?
+    std::vector<Short_t>  hit_tpc;     //tpc number
+    std::vector<Short_t>  hit_plane;   //plane number
+    std::vector<Short_t>  hit_wire;    //wire number
+    std::vector<Short_t>  hit_channel; //channel ID
+    std::vector<Float_t>  hit_peakT;   //peak time
+    std::vector<Float_t>  hit_charge;  //charge (area)
+    std::vector<Float_t>  hit_ph;      //amplitude
+    std::vector<Float_t>  hit_startT;  //hit start time
+    std::vector<Float_t>  hit_endT;    //hit end time
+    std::vector<Float_t>  hit_nelec;   //hit number of electrons
+    std::vector<Float_t>  hit_energy;  //hit energy
+    std::vector<Short_t>  hit_trkid;   //is this hit associated with a reco track?
 
     // track information
     Char_t kNTracker;
@@ -659,6 +665,9 @@ namespace sbnd {
     /// Allocates data structures for the given number of trackers (no Clear())
     void SetVertices(size_t nTrackers) { VertexData.resize(nTrackers); }
 
+    /// Resize the data structure for the hits
+    void ResizeHits(int nHits);
+    
     /// Resize the data structure for MCNeutrino particles
     void ResizeMCNeutrino(int nNeutrinos);
     
@@ -681,7 +690,7 @@ namespace sbnd {
     size_t GetNTrackers() const { return TrackData.size(); }
     
     /// Returns the number of hits for which memory is allocated
-    size_t GetMaxHits() const { return kMaxHits; }
+    size_t GetMaxHits() const { return MaxHits; }
     
     /// Returns the number of trackers for which memory is allocated
     size_t GetMaxTrackers() const { return TrackData.capacity(); }
@@ -771,6 +780,67 @@ namespace sbnd {
   }; // class AnalysisTreeDataStruct
   
   
+  /// Per-event cache of the true particles contributing to the hits
+  /// 
+  /// Each hit is backtracked once per event, the first time it is asked for:
+  /// the hits of the event hit collection are found by key, the others by
+  /// pointer. The contributions of all the hits are kept in flat arrays; the
+  /// track ones are as returned by the BackTracker, the eve ones are summed by
+  /// eve track ID and sorted by it.
+  class HitBackTrackCache {
+      public:
+    /// Energy deposited in a hit by a true particle
+    struct TrackEnergy_t {
+      int   trackID; ///< GEANT (eve) track ID
+      float energy;  ///< deposited energy [MeV]
+    };
+    
+    /// Range of contributions, valid until the next hit is backtracked
+    struct Range_t {
+      const TrackEnergy_t* first;
+      const TrackEnergy_t* last;
+      const TrackEnergy_t* begin() const { return first; }
+      const TrackEnergy_t* end() const { return last; }
+    };
+    
+    /// Forgets all the hits; the nHits hits of hitProductID are found by key
+    void Reset(art::ProductID hitProductID, size_t nHits);
+    
+    /// True particles contributing to the hit (BackTracker::HitToTrackIDEs())
+    Range_t TrackIDEs(detinfo::DetectorClocksData const& clockData, art::Ptr<recob::Hit> const& hit);
+    
+    /// Eve particles contributing to the hit (BackTracker::HitToEveTrackIDEs())
+    Range_t EveTrackIDEs(detinfo::DetectorClocksData const& clockData, art::Ptr<recob::Hit> const& hit);
+    
+    /// Particle contributing the most energy (RecoUtils::TrueParticleID())
+    int MainTrackID(detinfo::DetectorClocksData const& clockData, art::Ptr<recob::Hit> const& hit);
+    
+      private:
+    struct HitEntry_t {
+      size_t trackBegin, trackEnd; ///< range in fTrackIDEs
+      size_t eveBegin, eveEnd;     ///< range in fEveIDEs
+      int    mainTrackID;          ///< unsaved daughters rolled up
+    };
+    
+    static constexpr size_t kNoEntry = std::numeric_limits<size_t>::max();
+    
+    /// Returns the entry of the hit, backtracking it if needed
+    const HitEntry_t& Entry(detinfo::DetectorClocksData const& clockData, art::Ptr<recob::Hit> const& hit);
+    
+    /// Backtracks the hit and returns the index of its new entry
+    size_t Add(detinfo::DetectorClocksData const& clockData, art::Ptr<recob::Hit> const& hit);
+    
+    art::ProductID fHitProductID;
+    std::vector<size_t> fKeyEntries; ///< entry of each hit of fHitProductID
+    std::map<art::Ptr<recob::Hit>, size_t> fOtherEntries; ///< entry of other hits
+    std::vector<HitEntry_t> fEntries;
+    std::vector<TrackEnergy_t> fTrackIDEs;
+    std::vector<TrackEnergy_t> fEveIDEs;
+    std::vector<std::pair<int, double>> fSums; ///< work buffer
+    
+  }; // class HitBackTrackCache
+  
+  
   /**
    * @brief Creates a simple ROOT tree with tracking and calorimetry information
    * 
@@ -797,6 +867,9 @@ namespace sbnd {
 
     void   HitsPurity(detinfo::DetectorClocksData const& clockData,
                       std::vector< art::Ptr<recob::Hit> > const& hits, Int_t& trackid, Float_t& purity, double& maxe);
+    /// True particle of the hits as from the RecoUtils TrueParticleIDFromTotal*() functions
+    void   HitsTrueParticleIDs(detinfo::DetectorClocksData const& clockData,
+                      std::vector< art::Ptr<recob::Hit> > const& hits, Int_t& fromEnergy, Int_t& fromCharge, Int_t& fromHits);
     double length(const recob::Track& track);
     double length(const simb::MCParticle& part, TVector3& start, TVector3& end);
     double bdist(const recob::Track::Point_t& pos);
@@ -810,6 +883,9 @@ namespace sbnd {
 //    AnalysisTreeDataStruct::RunData_t RunData;
     AnalysisTreeDataStruct::SubRunData_t SubRunData;
 
+    HitBackTrackCache fHitBackTrack; ///< true particles of the hits of the current event
+    std::vector<std::pair<int, double>> fTruthSums; ///< work buffer for the truth matching
+
     std::string fDigitModuleLabel;
     std::string fHitsModuleLabel;
     std::string fLArG4ModuleLabel;
@@ -932,12 +1008,6 @@ namespace sbnd {
 
 
 namespace { // local namespace
-  /// Simple stringstream which empties its buffer on operator() call
-  class AutoResettingStringSteam: public std::ostringstream {
-      public:
-    AutoResettingStringSteam& operator() () { str(""); return *this; }
-  }; // class AutoResettingStringSteam
-
   /// Fills a sequence of TYPE elements
   template <typename ITER, typename TYPE>
   inline void FillWith(ITER from, ITER to, TYPE value)
@@ -1022,23 +1092,36 @@ void sbnd::AnalysisTreeDataStruct::TrackDataStruct::Resize(size_t nTracks)
   trkpurtruth.resize(MaxTracks);
   trkpitchc.resize(MaxTracks);
   ntrkhits.resize(MaxTracks);
+  trkcalohitidx.resize(MaxTracks);
   
   trkisprimary.resize(MaxTracks);  
   trkndaughters.resize(MaxTracks); 
   trkpfpid.resize(MaxTracks);      
   trkparentpfpid.resize(MaxTracks);
-
-  trkdedx.resize(MaxTracks);
-  trkdqdx.resize(MaxTracks);
-  trkresrg.resize(MaxTracks);
-  trkxyz.resize(MaxTracks);
   
 } // sbnd::AnalysisTreeDataStruct::TrackDataStruct::Resize()
 
+void sbnd::AnalysisTreeDataStruct::TrackDataStruct::ResizeCaloHits(size_t nHits)
+{
+  // minimum size is 1, so that we always have an address;
+  // the capacity is kept, so the memory is reused on the next event
+  MaxCaloHits = std::max(nHits, (size_t) 1);
+  
+  trkdedx.resize(MaxCaloHits);
+  trkdqdx.resize(MaxCaloHits);
+  trkresrg.resize(MaxCaloHits);
+  trkxyz.resize(MaxCaloHits);
+  
+} // sbnd::AnalysisTreeDataStruct::TrackDataStruct::ResizeCaloHits()
+
 void sbnd::AnalysisTreeDataStruct::TrackDataStruct::Clear() {
   Resize(MaxTracks);
   ntracks = 0;
   
+  // calorimetry points are only written up to ncalohits, no need to reset them
+  ncalohits = 0;
+  ResizeCaloHits(0);
+  
   FillWith(trkId        , -9999  );
   FillWith(trkncosmictags_tagger, -9999  );
   FillWith(trkcosmicscore_tagger, -99999.);
@@ -1098,12 +1181,7 @@ void sbnd::AnalysisTreeDataStruct::TrackDataStruct::Clear() {
     FillWith(trkpurtruth[iTrk], -99999.);
     FillWith(trkpitchc[iTrk]  , -99999.);
     FillWith(ntrkhits[iTrk]   ,  -9999 );
-    
-    FillWith(trkdedx[iTrk], 0.);
-    FillWith(trkdqdx[iTrk], 0.);
-    FillWith(trkresrg[iTrk], 0.);
-    
-    FillWith(trkxyz[iTrk], 0.);
+    FillWith(trkcalohitidx[iTrk], -1 );
  
     FillWith(trkpidpdg[iTrk]    , -1);
     FillWith(trkpidchi[iTrk]    , -99999.);
@@ -1125,10 +1203,6 @@ void sbnd::AnalysisTreeDataStruct::TrackDataStruct::SetAddresses(
   
   sbnd::AnalysisTreeDataStruct::BranchCreator CreateBranch(pTree);
 
-  AutoResettingStringSteam sstr;
-  sstr() << kMaxTrackHits;
-  std::string MaxTrackHitsIndexStr("[" + sstr.str() + "]");
-  
   std::string TrackLabel = tracker;
   std::string BranchName;
 
@@ -1206,17 +1280,26 @@ void sbnd::AnalysisTreeDataStruct::TrackDataStruct::SetAddresses(
   CreateBranch(BranchName, ntrkhits, BranchName + NTracksIndexStr + "[3]/S");
   
   if (!isCosmics){
+    // calorimetry points of all the tracks, the ones of track i on plane p
+    // start at trkcalohitidx[i][p] and are ntrkhits[i][p]
+    BranchName = "trkcalohitidx_" + TrackLabel;
+    CreateBranch(BranchName, trkcalohitidx, BranchName + NTracksIndexStr + "[3]/I");
+    
+    BranchName = "ncalohits_" + TrackLabel;
+    CreateBranch(BranchName, &ncalohits, BranchName + "/I");
+    std::string NCaloHitsIndexStr = "[" + BranchName + "]";
+    
     BranchName = "trkdedx_" + TrackLabel;
-    CreateBranch(BranchName, trkdedx, BranchName + NTracksIndexStr + "[3]" + MaxTrackHitsIndexStr + "/F");
+    CreateBranch(BranchName, trkdedx, BranchName + NCaloHitsIndexStr + "/F");
   
     BranchName = "trkdqdx_" + TrackLabel;
-    CreateBranch(BranchName, trkdqdx, BranchName + NTracksIndexStr + "[3]" + MaxTrackHitsIndexStr + "/F");
+    CreateBranch(BranchName, trkdqdx, BranchName + NCaloHitsIndexStr + "/F");
     
     BranchName = "trkresrg_" + TrackLabel;
-    CreateBranch(BranchName, trkresrg, BranchName + NTracksIndexStr + "[3]" + MaxTrackHitsIndexStr + "/F");
+    CreateBranch(BranchName, trkresrg, BranchName + NCaloHitsIndexStr + "/F");
     
     BranchName = "trkxyz_" + TrackLabel;
-    CreateBranch(BranchName, trkxyz, BranchName + NTracksIndexStr + "[3]" + MaxTrackHitsIndexStr + "/F");
+    CreateBranch(BranchName, trkxyz, BranchName + NCaloHitsIndexStr + "[3]/F");
   }
 
   BranchName = "trkstartx_" + TrackLabel;
@@ -1506,18 +1589,18 @@ void sbnd::AnalysisTreeDataStruct::ClearLocalData() {
 
   no_hits = 0;
  
-  std::fill(hit_tpc, hit_tpc + sizeof(hit_tpc)/sizeof(hit_tpc[0]), -9999);
-  std::fill(hit_plane, hit_plane + sizeof(hit_plane)/sizeof(hit_plane[0]), -9999);
-  std::fill(hit_wire, hit_wire + sizeof(hit_wire)/sizeof(hit_wire[0]), -9999);
-  std::fill(hit_channel, hit_channel + sizeof(hit_channel)/sizeof(hit_channel[0]), -9999);
-  std::fill(hit_peakT, hit_peakT + sizeof(hit_peakT)/sizeof(hit_peakT[0]), -99999.);
-  std::fill(hit_charge, hit_charge + sizeof(hit_charge)/sizeof(hit_charge[0]), -99999.);
-  std::fill(hit_ph, hit_ph + sizeof(hit_ph)/sizeof(hit_ph[0]), -99999.);
-  std::fill(hit_startT, hit_startT + sizeof(hit_startT)/sizeof(hit_startT[0]), -99999.);
-  std::fill(hit_endT, hit_endT + sizeof(hit_endT)/sizeof(hit_endT[0]), -99999.);
-  std::fill(hit_trkid, hit_trkid + sizeof(hit_trkid)/sizeof(hit_trkid[0]), -9999);
-  std::fill(hit_nelec, hit_nelec + sizeof(hit_nelec)/sizeof(hit_nelec[0]), -99999.);
-  std::fill(hit_energy, hit_energy + sizeof(hit_energy)/sizeof(hit_energy[0]), -99999.);
+  FillWith(hit_tpc, -9999);
+  FillWith(hit_plane, -9999);
+  FillWith(hit_wire, -9999);
+  FillWith(hit_channel, -9999);
+  FillWith(hit_peakT, -99999.);
+  FillWith(hit_charge, -99999.);
+  FillWith(hit_ph, -99999.);
+  FillWith(hit_startT, -99999.);
+  FillWith(hit_endT, -99999.);
+  FillWith(hit_trkid, -9999);
+  FillWith(hit_nelec, -99999.);
+  FillWith(hit_energy, -99999.);
 
   /*
   nvtx = 0;
@@ -1651,6 +1734,26 @@ void sbnd::AnalysisTreeDataStruct::Clear() {
   std::mem_fn(&ShowerDataStruct::Clear);
 } // sbnd::AnalysisTreeDataStruct::Clear()
 
+void sbnd::AnalysisTreeDataStruct::ResizeHits(int nHits) {
+
+  // minimum size is 1, so that we always have an address;
+  // the capacity is kept, so with UseBuffers the memory is reused
+  MaxHits = (size_t) std::max(nHits, 1);
+  hit_tpc.resize(MaxHits);
+  hit_plane.resize(MaxHits);
+  hit_wire.resize(MaxHits);
+  hit_channel.resize(MaxHits);
+  hit_peakT.resize(MaxHits);
+  hit_charge.resize(MaxHits);
+  hit_ph.resize(MaxHits);
+  hit_startT.resize(MaxHits);
+  hit_endT.resize(MaxHits);
+  hit_nelec.resize(MaxHits);
+  hit_energy.resize(MaxHits);
+  hit_trkid.resize(MaxHits);
+
+} // sbnd::AnalysisTreeDataStruct::ResizeHits()
+
 void sbnd::AnalysisTreeDataStruct::ResizeMCNeutrino(int nNeutrinos){
 
   //min size is 1, to guarantee an address
@@ -1838,10 +1941,6 @@ void sbnd::AnalysisTreeDataStruct::SetAddresses(
   }  
 
   if (hasTrackInfo()){
-    AutoResettingStringSteam sstr;
-    sstr() << kMaxTrackHits;
-    std::string MaxTrackHitsIndexStr("[" + sstr.str() + "]");
-
     kNTracker = trackers.size();
     CreateBranch("kNTracker",&kNTracker,"kNTracker/B");
     for(int i=0; i<kNTracker; i++){
@@ -2107,6 +2206,8 @@ void sbnd::AnalysisTree::analyze(const art::Event& evt)
   std::vector<art::Ptr<recob::Hit> > hitlist;
   if (evt.getByLabel(fHitsModuleLabel,hitListHandle))
     art::fill_ptr_vector(hitlist, hitListHandle);
+  // hits are backtracked at most once in the event, when first needed
+  fHitBackTrack.Reset(hitListHandle.isValid()? hitListHandle.id(): art::ProductID(), hitlist.size());
 
 
   // * MC truth information
@@ -2151,14 +2252,13 @@ void sbnd::AnalysisTree::analyze(const art::Event& evt)
         //std::map<art::Ptr<simb::MCTruth>,double> mctruthemap;
       static bool isfirsttime = true;
       if (isfirsttime){
-	      for (size_t i = 0; i<hitlist.size(); i++){
+	      for (size_t i = 0; i<hitlist.size() && !isCosmics; i++){
 	        //if (hitlist[i]->View() == geo::kV){//collection view
           // tbrooks: use TrackIDEs rather than eveTrackIDEs because the eve ID doesn't always seem to correspond to the g4 track FIXME may need further investigation
-                std::vector<sim::TrackIDE> eveIDs = bt_serv->HitToTrackIDEs(clockData, hitlist[i]);
-	        for (size_t e = 0; e<eveIDs.size(); e++){
-	          art::Ptr<simb::MCTruth> ev_mctruth = pi_serv->TrackIdToMCTruth_P(eveIDs[e].trackID);
+	        for (auto const& ide: fHitBackTrack.TrackIDEs(clockData, hitlist[i])){
+	          art::Ptr<simb::MCTruth> ev_mctruth = pi_serv->TrackIdToMCTruth_P(ide.trackID);
 	          //mctruthemap[ev_mctruth]+=eveIDs[e].energy;
-	          if (ev_mctruth->Origin() == simb::kCosmicRay) isCosmics = true;
+	          if (ev_mctruth->Origin() == simb::kCosmicRay) { isCosmics = true; break; }
 	        }
 	        //}
 	      }
@@ -2207,6 +2307,8 @@ void sbnd::AnalysisTree::analyze(const art::Event& evt)
     fData->ResizeCry(nCryPrimaries);
   if (fSaveGeantInfo)    
     fData->ResizeGEANT(nGEANTparticles);
+  if (fSaveHitInfo)
+    fData->ResizeHits(hitlist.size());
   fData->ClearLocalData(); // don't bother clearing tracker data yet
   
 //  const size_t Nplanes       = 3; // number of wire planes; pretty much constant...
@@ -2384,13 +2486,7 @@ void sbnd::AnalysisTree::analyze(const art::Event& evt)
   //hit information
   if (fSaveHitInfo){
     fData->no_hits = (int) NHits;
-    if (NHits > kMaxHits) {
-      // got this error? consider increasing kMaxHits
-      // (or ask for a redesign using vectors)
-      mf::LogError("AnalysisTree:limits") << "event has " << NHits
-        << " hits, only kMaxHits=" << kMaxHits << " stored in tree";
-    }
-    for (size_t i = 0; i < NHits && i < kMaxHits ; ++i){//loop over hits
+    for (size_t i = 0; i < NHits; ++i){//loop over hits
       fData->hit_channel[i] = hitlist[i]->Channel();
       fData->hit_tpc[i]     = hitlist[i]->WireID().TPC;
       fData->hit_plane[i]   = hitlist[i]->WireID().Plane;
@@ -2434,7 +2530,7 @@ void sbnd::AnalysisTree::analyze(const art::Event& evt)
     if (evt.getByLabel(fHitsModuleLabel,hitListHandle)){
       //Find tracks associated with hits
       art::FindManyP<recob::Track> fmtk(hitListHandle,evt,fTrackModuleLabel[0]);
-      for (size_t i = 0; i < NHits && i < kMaxHits ; ++i){//loop over hits
+      for (size_t i = 0; i < NHits; ++i){//loop over hits
         if (fmtk.isValid()){
 	  if (fmtk.at(i).size()!=0){
 	    fData->hit_trkid[i] = fmtk.at(i)[0]->ID();
@@ -2755,21 +2851,18 @@ void sbnd::AnalysisTree::analyze(const art::Event& evt)
             TrackerData.trkpitchc[iTrk][planenum]= calos[ical] -> TrkPitchC();
             const size_t NHits = calos[ical] -> dEdx().size();
             TrackerData.ntrkhits[iTrk][planenum] = (int) NHits;
-            if (NHits > TrackerData.GetMaxHitsPerTrack(iTrk, planenum)) {
-              // if you get this error, you'll have to increase kMaxTrackHits
-              mf::LogError("AnalysisTree:limits")
-                << "the " << fTrackModuleLabel[iTracker] << " track #" << iTrk
-                << " has " << NHits << " hits on calorimetry plane #" << planenum
-                <<", only "
-                << TrackerData.GetMaxHitsPerTrack(iTrk, planenum) << " stored in tree";
-            }
             if (!isCosmics){
-              for(size_t iTrkHit = 0; iTrkHit < NHits && iTrkHit < TrackerData.GetMaxHitsPerTrack(iTrk, planenum); ++iTrkHit) {
-                TrackerData.trkdedx[iTrk][planenum][iTrkHit]  = (calos[ical] -> dEdx())[iTrkHit];
-                TrackerData.trkdqdx[iTrk][planenum][iTrkHit]  = (calos[ical] -> dQdx())[iTrkHit];
-                TrackerData.trkresrg[iTrk][planenum][iTrkHit] = (calos[ical] -> ResidualRange())[iTrkHit];
+              // append the points after the ones of the previous tracks
+              const size_t FirstHit = TrackerData.ncalohits;
+              TrackerData.ncalohits += (int) NHits;
+              TrackerData.ResizeCaloHits(TrackerData.ncalohits);
+              TrackerData.trkcalohitidx[iTrk][planenum] = (int) FirstHit;
+              for(size_t iTrkHit = 0; iTrkHit < NHits; ++iTrkHit) {
+                TrackerData.trkdedx[FirstHit + iTrkHit]  = (calos[ical] -> dEdx())[iTrkHit];
+                TrackerData.trkdqdx[FirstHit + iTrkHit]  = (calos[ical] -> dQdx())[iTrkHit];
+                TrackerData.trkresrg[FirstHit + iTrkHit] = (calos[ical] -> ResidualRange())[iTrkHit];
                 const auto& TrkPos = (calos[ical] -> XYZ())[iTrkHit];
-                auto& TrkXYZ = TrackerData.trkxyz[iTrk][planenum][iTrkHit];
+                auto& TrkXYZ = TrackerData.trkxyz[FirstHit + iTrkHit];
                 TrkXYZ[0] = TrkPos.X();
                 TrkXYZ[1] = TrkPos.Y();
                 TrkXYZ[2] = TrkPos.Z();
@@ -2800,9 +2893,10 @@ void sbnd::AnalysisTree::analyze(const art::Event& evt)
           }
           
           for (size_t ipl = 0; ipl < 3; ++ipl){
-            TrackerData.trkidtruth_recoutils_totaltrueenergy[iTrk][ipl] = RecoUtils::TrueParticleIDFromTotalTrueEnergy(clockData, hits[ipl]);
-            TrackerData.trkidtruth_recoutils_totalrecocharge[iTrk][ipl] = RecoUtils::TrueParticleIDFromTotalRecoCharge(clockData, hits[ipl]);
-            TrackerData.trkidtruth_recoutils_totalrecohits[iTrk][ipl] = RecoUtils::TrueParticleIDFromTotalRecoHits(clockData, hits[ipl]);
+            HitsTrueParticleIDs(clockData, hits[ipl],
+              TrackerData.trkidtruth_recoutils_totaltrueenergy[iTrk][ipl],
+              TrackerData.trkidtruth_recoutils_totalrecocharge[iTrk][ipl],
+              TrackerData.trkidtruth_recoutils_totalrecohits[iTrk][ipl]);
             double maxe = 0;
             HitsPurity(clockData, hits[ipl],TrackerData.trkidtruth[iTrk][ipl],TrackerData.trkpurtruth[iTrk][ipl],maxe);
           //std::cout<<"\n"<<iTracker<<"\t"<<iTrk<<"\t"<<ipl<<"\t"<<trkidtruth[iTracker][iTrk][ipl]<<"\t"<<trkpurtruth[iTracker][iTrk][ipl]<<"\t"<<maxe;
@@ -2842,6 +2936,10 @@ void sbnd::AnalysisTree::analyze(const art::Event& evt)
           TrackerData.trkparentpfpid[iTrk] = tempParticle->Parent();
         } // end save hierarchy info
       }//end loop over track
+      
+      // the calorimetry points may have been moved while being added:
+      // point the branches to their current location
+      SetTrackerAddresses(iTracker);
     }//end loop over track module labels
   }// end (fSaveTrackInfo) 
   
@@ -3230,11 +3328,10 @@ void sbnd::AnalysisTree::analyze(const art::Event& evt)
         logStream << "\n    [" << iTrk << "] "<< tracker->ntrkhits[iTrk][0];
         for (size_t ipl = 1; ipl < tracker->GetMaxPlanesPerTrack(iTrk); ++ipl)
           logStream << " + " << tracker->ntrkhits[iTrk][ipl];
-        logStream << " hits (" << tracker->GetMaxHitsPerTrack(iTrk, 0);
-        for (size_t ipl = 1; ipl < tracker->GetMaxPlanesPerTrack(iTrk); ++ipl)
-          logStream << " + " << tracker->GetMaxHitsPerTrack(iTrk, ipl);
-        logStream << ")";
+        logStream << " hits";
       } // for tracks
+      logStream << "\n    " << tracker->ncalohits << " calorimetry points ("
+        << tracker->GetMaxCaloHits() << ")";
     } // for trackers
   } // if logging enabled
   
@@ -3252,29 +3349,21 @@ void sbnd::AnalysisTree::HitsPurity(detinfo::DetectorClocksData const& clockData
   trackid = -1;
   purity = -1;
 
-  art::ServiceHandle<cheat::BackTrackerService> bt_serv;
-
-  std::map<int,double> trkide;
-
+  fTruthSums.clear();
   for(size_t h = 0; h < hits.size(); ++h){
-
-    art::Ptr<recob::Hit> hit = hits[h];
-    std::vector<sim::IDE> ides;
-    std::vector<sim::TrackIDE> eveIDs = bt_serv->HitToEveTrackIDEs(clockData, hit);
-
-    for(size_t e = 0; e < eveIDs.size(); ++e){
-      //std::cout<<h<<" "<<e<<" "<<eveIDs[e].trackID<<" "<<eveIDs[e].energy<<" "<<eveIDs[e].energyFrac<<std::endl;
-      trkide[eveIDs[e].trackID] += eveIDs[e].energy;
+    for(auto const& ide: fHitBackTrack.EveTrackIDEs(clockData, hits[h])){
+      fTruthSums.emplace_back(ide.trackID, ide.energy);
     }
   }
+  RecoUtils::SumByID(fTruthSums);
 
   maxe = -1;
   double tote = 0;
-  for (std::map<int,double>::iterator ii = trkide.begin(); ii!=trkide.end(); ++ii){
-    tote += ii->second;
-    if ((ii->second)>maxe){
-      maxe = ii->second;
-      trackid = ii->first;
+  for (auto const& trkide: fTruthSums){
+    tote += trkide.second;
+    if ((trkide.second)>maxe){
+      maxe = trkide.second;
+      trackid = trkide.first;
     }
   }
 
@@ -3286,6 +3375,110 @@ void sbnd::AnalysisTree::HitsPurity(detinfo::DetectorClocksData const& clockData
   }
 }
 
+void sbnd::AnalysisTree::HitsTrueParticleIDs(detinfo::DetectorClocksData const& clockData,
+                                             std::vector< art::Ptr<recob::Hit> > const& hits,
+                                             Int_t& fromEnergy, Int_t& fromCharge, Int_t& fromHits){
+
+  // same matching as RecoUtils, with each hit backtracked once per event
+  auto trackIDEs = [&](art::Ptr<recob::Hit> const& hit)
+    { return fHitBackTrack.TrackIDEs(clockData, hit); };
+  auto mainTrackID = [&](art::Ptr<recob::Hit> const& hit)
+    { return fHitBackTrack.MainTrackID(clockData, hit); };
+  fromEnergy = RecoUtils::TrueParticleIDFromTotalTrueEnergy(hits, trackIDEs);
+  fromCharge = RecoUtils::TrueParticleIDFromTotalRecoCharge(hits, mainTrackID);
+  fromHits = RecoUtils::TrueParticleIDFromTotalRecoHits(hits, trackIDEs, mainTrackID);
+}
+
+//------------------------------------------------------------------------------
+//---  HitBackTrackCache
+//---
+
+void sbnd::HitBackTrackCache::Reset(art::ProductID hitProductID, size_t nHits)
+{
+  // the memory of the previous events is reused
+  fHitProductID = hitProductID;
+  fKeyEntries.assign(nHits, kNoEntry);
+  fOtherEntries.clear();
+  fEntries.clear();
+  fTrackIDEs.clear();
+  fEveIDEs.clear();
+} // sbnd::HitBackTrackCache::Reset()
+
+sbnd::HitBackTrackCache::Range_t sbnd::HitBackTrackCache::TrackIDEs(
+  detinfo::DetectorClocksData const& clockData, art::Ptr<recob::Hit> const& hit
+) {
+  const HitEntry_t& entry = Entry(clockData, hit);
+  return { fTrackIDEs.data() + entry.trackBegin, fTrackIDEs.data() + entry.trackEnd };
+} // sbnd::HitBackTrackCache::TrackIDEs()
+
+sbnd::HitBackTrackCache::Range_t sbnd::HitBackTrackCache::EveTrackIDEs(
+  detinfo::DetectorClocksData const& clockData, art::Ptr<recob::Hit> const& hit
+) {
+  const HitEntry_t& entry = Entry(clockData, hit);
+  return { fEveIDEs.data() + entry.eveBegin, fEveIDEs.data() + entry.eveEnd };
+} // sbnd::HitBackTrackCache::EveTrackIDEs()
+
+int sbnd::HitBackTrackCache::MainTrackID(
+  detinfo::DetectorClocksData const& clockData, art::Ptr<recob::Hit> const& hit
+) {
+  return Entry(clockData, hit).mainTrackID;
+} // sbnd::HitBackTrackCache::MainTrackID()
+
+const sbnd::HitBackTrackCache::HitEntry_t& sbnd::HitBackTrackCache::Entry(
+  detinfo::DetectorClocksData const& clockData, art::Ptr<recob::Hit> const& hit
+) {
+  if (hit.id() == fHitProductID && hit.key() < fKeyEntries.size()) {
+    size_t& index = fKeyEntries[hit.key()];
+    if (index == kNoEntry) index = Add(clockData, hit);
+    return fEntries[index];
+  }
+  auto const iOther = fOtherEntries.find(hit);
+  if (iOther != fOtherEntries.end()) return fEntries[iOther->second];
+  const size_t index = Add(clockData, hit);
+  fOtherEntries.emplace(hit, index);
+  return fEntries[index];
+} // sbnd::HitBackTrackCache::Entry()
+
+size_t sbnd::HitBackTrackCache::Add(
+  detinfo::DetectorClocksData const& clockData, art::Ptr<recob::Hit> const& hit
+) {
+  art::ServiceHandle<cheat::BackTrackerService> bt_serv;
+  art::ServiceHandle<cheat::ParticleInventoryService> pi_serv;
+  
+  HitEntry_t entry;
+  entry.trackBegin = fTrackIDEs.size();
+  for (auto const& ide: bt_serv->HitToTrackIDEs(clockData, hit))
+    fTrackIDEs.push_back({ ide.trackID, ide.energy });
+  entry.trackEnd = fTrackIDEs.size();
+  
+  // eve particles, as from BackTracker::HitToEveTrackIDEs()
+  fSums.clear();
+  for (size_t i = entry.trackBegin; i < entry.trackEnd; ++i)
+    fSums.emplace_back(pi_serv->TrackIdToEveTrackId(fTrackIDEs[i].trackID), fTrackIDEs[i].energy);
+  RecoUtils::SumByID(fSums);
+  entry.eveBegin = fEveIDEs.size();
+  for (auto const& eveide: fSums)
+    fEveIDEs.push_back({ eveide.first, (float) eveide.second });
+  entry.eveEnd = fEveIDEs.size();
+  
+  // most contributing particle, as from RecoUtils::TrueParticleID()
+  fSums.clear();
+  for (size_t i = entry.trackBegin; i < entry.trackEnd; ++i)
+    fSums.emplace_back(std::abs(fTrackIDEs[i].trackID), fTrackIDEs[i].energy);
+  RecoUtils::SumByID(fSums);
+  entry.mainTrackID = 0;
+  double maxenergy = -99999;
+  for (auto const& ide: fSums) {
+    if (ide.second > maxenergy) {
+      maxenergy = ide.second;
+      entry.mainTrackID = ide.first;
+    }
+  }
+  
+  fEntries.push_back(entry);
+  return fEntries.size() - 1;
+} // sbnd::HitBackTrackCache::Add()
+
 // Calculate distance to boundary.
 double sbnd::AnalysisTree::bdist(const recob::Track::Point_t& pos)
 {
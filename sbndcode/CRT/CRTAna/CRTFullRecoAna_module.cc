@@ -15,6 +15,7 @@
 #include "sbnobj/Common/CRT/CRTTrack.hh"
 #include "sbndcode/Geometry/GeometryWrappers/CRTGeoAlg.h"
 #include "sbndcode/Geometry/GeometryWrappers/TPCGeoAlg.h"
+#include "sbndcode/Geometry/GeometryWrappers/ParticleCrossingCache.h"
 #include "sbndcode/CRT/CRTUtils/CRTT0MatchAlg.h"
 #include "sbndcode/CRT/CRTUtils/CRTTrackMatchAlg.h"
 #include "sbndcode/CRT/CRTUtils/CRTBackTracker.h"
@@ -60,6 +61,7 @@
 // C++ includes
 #include <map>
 #include <vector>
+#include <iostream>
 #include <string>
 
 namespace sbnd {
@@ -178,6 +180,7 @@ namespace sbnd {
 
     TPCGeoAlg fTpcGeo;
     CRTGeoAlg fCrtGeo;
+    ParticleCrossingCache fCrossingCache;
 
     CRTT0MatchAlg crtT0Alg;
     CRTTrackMatchAlg crtTrackAlg;
@@ -291,6 +294,7 @@ namespace sbnd {
     art::FindManyP<recob::Hit> findManyHits(tpcTrackHandle, event, fTPCTrackLabel);
 
     fCrtBackTrack.Initialize(event);
+    fCrossingCache.Clear();
 
     //----------------------------------------------------------------------------------------------------------
     //                                          TRUTH MATCHING
@@ -329,12 +333,12 @@ namespace sbnd {
       for(size_t i = 0; i < fCrtGeo.NumTaggers(); i++){
         std::string taggerName = fCrtGeo.GetTagger(i).name;
         // Find the intersections between the true particle and each tagger (if exists)
-        geo::Point_t trueCP = fCrtGeo.TaggerCrossingPoint(taggerName, particle);
+        geo::Point_t trueCP = fCrossingCache.TaggerCrossingPoint(i, particle);
         // Make map for each tagger with true ID as key and value an XYZ position
         if(trueCP.X() != -99999){ 
           truthMatch.trueCrosses[taggerName] = trueCP;
         }
-        bool validCP = fCrtGeo.ValidCrossingPoint(taggerName, particle);
+        bool validCP = fCrossingCache.ValidCrossingPoint(taggerName, particle);
         truthMatch.validCrosses[taggerName] = validCP;
       } 
       
@@ -567,28 +571,28 @@ namespace sbnd {
       trackT0Categories.push_back((match.crtTracks.size() > 0 && match.hasTpcTrack));
 
       // - Enters CRT volume
-      bool entersCRT = fCrtGeo.EntersVolume(particles[partID]);
+      bool entersCRT = fCrossingCache.EntersCRT(particles[partID]);
       crtHitCategories.push_back(entersCRT);
       crtTrackCategories.push_back(entersCRT);
       hitT0Categories.push_back((entersCRT && match.hasTpcTrack));
       trackT0Categories.push_back((entersCRT && match.hasTpcTrack));
 
       // - Enters TPC volume
-      bool entersTPC = fTpcGeo.EntersVolume(particles[partID]) && entersCRT;
+      bool entersTPC = fCrossingCache.EntersTPC(particles[partID]) && entersCRT;
       crtHitCategories.push_back(entersTPC);
       crtTrackCategories.push_back(entersTPC);
       hitT0Categories.push_back((entersTPC && match.hasTpcTrack));
       trackT0Categories.push_back((entersTPC && match.hasTpcTrack));
 
       // - Crosses CRT volume
-      bool crossesCRT = fCrtGeo.CrossesVolume(particles[partID]);
+      bool crossesCRT = fCrossingCache.CrossesCRT(particles[partID]);
       crtHitCategories.push_back(crossesCRT);
       crtTrackCategories.push_back(crossesCRT);
       hitT0Categories.push_back((crossesCRT && match.hasTpcTrack));
       trackT0Categories.push_back((crossesCRT && match.hasTpcTrack));
 
       // - Crosses TPC volume
-      bool crossesTPC = fTpcGeo.CrossesVolume(particles[partID]) && entersCRT;
+      bool crossesTPC = fCrossingCache.CrossesTPC(particles[partID]) && entersCRT;
       crtHitCategories.push_back(crossesTPC);
       crtTrackCategories.push_back(crossesTPC);
       hitT0Categories.push_back((crossesTPC && match.hasTpcTrack));
@@ -15,6 +15,7 @@
 #include "sbndcode/CRT/CRTUtils/CRTEventDisplay.h"
 #include "sbndcode/CRT/CRTUtils/CRTBackTracker.h"
 #include "sbndcode/Geometry/GeometryWrappers/CRTGeoAlg.h"
+#include "sbndcode/Geometry/GeometryWrappers/ParticleCrossingCache.h"
 
 // LArSoft includes
 #include "larcoreobj/SimpleTypesAndConstants/geo_types.h"
@@ -160,6 +161,7 @@ namespace sbnd {
 
     // CRT helpers
     CRTGeoAlg fCrtGeo;
+    ParticleCrossingCache fCrossingCache;
     CRTEventDisplay evd;
     CRTBackTracker fCrtBackTrack;
 
@@ -234,6 +236,7 @@ namespace sbnd {
     art::FindManyP<sbnd::crt::CRTData> findManyData(crtHitHandle, event, fCRTHitLabel);
 
     fCrtBackTrack.Initialize(event);
+    fCrossingCache.Clear();
     
     //----------------------------------------------------------------------------------------------------------
     //                                          TRUTH MATCHING
@@ -267,12 +270,12 @@ namespace sbnd {
 
       if(!(std::abs(particle.PdgCode()) == 13 && particle.Mother()==0)) continue;
 
-      std::vector<std::string> stripNames = fCrtGeo.CrossesStrips(particle);
+      std::vector<std::string> stripNames = fCrossingCache.CrossesStrips(particle);
 
       for(auto const& stripName : stripNames){
         std::string tagger = fCrtGeo.GetTaggerName(stripName);
-        if(!fCrtGeo.ValidCrossingPoint(tagger, particle)) continue;
-        geo::Point_t cross = fCrtGeo.StripCrossingPoint(stripName, particle);
+        if(!fCrossingCache.ValidCrossingPoint(tagger, particle)) continue;
+        geo::Point_t cross = fCrossingCache.StripCrossingPoint(stripName, particle);
         double sipmDist = fCrtGeo.DistanceBetweenSipms(cross, stripName);
         double stripDist = fCrtGeo.DistanceDownStrip(cross, stripName);
         hEffWidthTotal[tagger]->Fill(sipmDist);
@@ -336,7 +339,7 @@ namespace sbnd {
         hRecoSipmDist[tagger]->Fill(hitDist);
 
         // Calculate the true position between the sipms
-        geo::Point_t truePos = fCrtGeo.StripCrossingPoint(stripName, particles[trueId]);
+        geo::Point_t truePos = fCrossingCache.StripCrossingPoint(stripName, particles[trueId]);
         double trueDist = fCrtGeo.DistanceBetweenSipms(truePos, stripName);
         hTrueSipmDist[tagger]->Fill(trueDist);
         hTrueRecoSipmDist[tagger]->Fill(trueDist, hitDist);
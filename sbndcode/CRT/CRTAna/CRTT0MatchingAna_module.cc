@@ -54,6 +54,7 @@
 // C++ includes
 #include <map>
 #include <vector>
+#include <iostream>
 #include <string>
 
 namespace sbnd {
@@ -15,6 +15,7 @@
 #include "sbndcode/CRT/CRTUtils/CRTEventDisplay.h"
 #include "sbndcode/CRT/CRTUtils/CRTBackTracker.h"
 #include "sbndcode/Geometry/GeometryWrappers/CRTGeoAlg.h"
+#include "sbndcode/Geometry/GeometryWrappers/ParticleCrossingCache.h"
 
 // LArSoft includes
 #include "larcoreobj/SimpleTypesAndConstants/geo_types.h"
@@ -156,6 +157,7 @@ namespace sbnd {
 
     // Other variables shared between different methods.
     CRTGeoAlg fCrtGeo;
+    ParticleCrossingCache fCrossingCache;
 
     CRTEventDisplay evd;
     CRTBackTracker fCrtBackTrack;
@@ -244,6 +246,7 @@ namespace sbnd {
     std::map<int, std::vector<sbn::crt::CRTTrack>> crtTracks;
     int trk_i = 0;
     fCrtBackTrack.Initialize(event);
+    fCrossingCache.Clear();
     for(auto const& track : (*crtTrackHandle)){
       int trueId = fCrtBackTrack.TrueIdFromTrackId(event, trk_i);
       trk_i++;
@@ -362,7 +365,7 @@ namespace sbnd {
       // Find the taggers and positions of the true crossing points
       sbn::crt::CRTHit startHit, endHit;
       for(auto const& hit : hits){
-        geo::Point_t trueCross = fCrtGeo.TaggerCrossingPoint(hit->tagger, particles[trueId]);
+        geo::Point_t trueCross = fCrossingCache.TaggerCrossingPoint(hit->tagger, particles[trueId]);
         if(trueCross.X() == -99999) continue;
         // For each tagger calculate the distance between the CRT track and true track
         double dist = std::sqrt(std::pow(hit->x_pos - trueCross.X(), 2)
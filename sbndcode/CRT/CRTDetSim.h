@@ -13,8 +13,10 @@
 #include "fhiclcpp/ParameterSet.h"
 
 #include "lardataalg/DetectorInfo/ElecClock.h"
+#include "larcorealg/Geometry/AuxDetSensitiveGeo.h"
 
 #include <string>
+#include <vector>
 
 namespace sbnd {
 namespace crt {
@@ -29,23 +31,70 @@ public:
   CRTDetSim& operator = (CRTDetSim &&) = delete;
   void reconfigure(fhicl::ParameterSet const & p) ;
 
+  void beginJob() override;
   void produce(art::Event & e) override;
   std::string fG4ModuleLabel;
 
 private:
   /**
-   * Get the channel trigger time relative to the start of the MC event.
+   * Location of a strip in the CRT geometry hierarchy, which is the same
+   * for every event.
+   */
+  struct StripInfo {
+    geo::AuxDetSensitiveGeo const* geo;  //!< Strip geometry, for the local transform
+    unsigned planeID;  //!< 1 for z > 0, 0 for z < 0 in the tagger frame
+    bool top;  //!< Readout end at +y in the strip frame
+    size_t taggerID;  //!< Index of the tagger in fTaggerNames
+    std::string taggerName;  //!< Name of the tagger node the strip is in
+    std::string path;  //!< Path to the strip geo node
+    std::string stripName;  //!< Name of the strip node
+    std::string arrayName;  //!< Name of the strip array node
+    std::string moduleName;  //!< Name of the module node
+    double modulePosMother[3];  //!< Module position in the tagger frame
+    double stripPos[3];  //!< Strip position in the world frame
+  };
+
+  /**
+   * Fill fStripInfo from the geometry, for every strip of every CRT module.
+   */
+  void BuildStripInfo();
+
+  /**
+   * Get the channel trigger times relative to the start of the MC event,
+   * for all the hits on a strip.
    *
-   * @param engine The random number generator engine
-   * @param clock The clock to count ticks on
-   * @param t0 The starting time (which delay is added to)
+   * @param t0 The starting times (which delay is added to)
    * @param npe Number of observed photoelectrons
    * @param r Distance between the energy deposit and strip readout end [mm]
-   * @return Trigger clock ticks at this true hit time
+   * @param gaus Three standard normal draws per hit
+   * @param ticks Trigger clock ticks at each true hit time
    */
-  uint32_t getChannelTriggerTicks(CLHEP::HepRandomEngine* engine,
-                                /*detinfo::ElecClock& clock,*/
-                                float t0, float npeMean, float r);
+  void getChannelTriggerTicks(std::vector<double> const& t0,
+                              std::vector<long> const& npe,
+                              std::vector<double> const& r,
+                              double const* gaus,
+                              std::vector<uint32_t>& ticks) const;
+
+  /**
+   * The hits on one strip, after merging the IDEs the SiPMs can't resolve,
+   * with one entry per hit in each array.
+   */
+  struct StripHits {
+    static constexpr size_t kNGausPerHit = 8;  //!< 3 per SiPM for timing, 1 per SiPM for charge
+
+    std::vector<double> x, y, z;  //!< Mean IDE position [cm]
+    std::vector<double> t;  //!< Mean IDE time [ns]
+    std::vector<double> eDep;  //!< Total deposited energy [GeV]
+    std::vector<size_t> ideBegin;  //!< First time-ordered IDE of each hit, plus the end
+    std::vector<double> distToReadout;  //!< Distance to the readout end
+    std::vector<double> npeExp0, npeExp1;  //!< Expected PE on each SiPM
+    std::vector<long> npe0, npe1;  //!< Observed PE on each SiPM
+    std::vector<uint32_t> ppsTicks;  //!< Time relative to PPS
+    std::vector<double> gaus;  //!< Standard normal draws for the strip
+
+    void clear();
+    void resize(size_t n);  //!< Sizes the per-hit response arrays
+  };
 
   double fGlobalT0Offset;  //!< Time delay fit: Gaussian normalization
   double fTDelayNorm;  //!< Time delay fit: Gaussian normalization
@@ -76,6 +125,9 @@ private:
   double fSipmTimeResponse; //!< Minimum time to resolve separate energy deposits [ns]
   short fAdcSaturation; //!< Saturation limit per SiPM in ADC counts
   CLHEP::HepRandomEngine& fEngine; //!< Reference to art-managed random-number engine
+  std::vector<std::vector<StripInfo>> fStripInfo; //!< Strips by [AuxDetID][SensitiveID]
+  std::vector<std::string> fTaggerNames; //!< Tagger names, in name order
+  std::vector<bool> fTaggerIsBottom; //!< Whether each tagger is the bottom one, triggering on any hit
 };
 
 }  // namespace crt
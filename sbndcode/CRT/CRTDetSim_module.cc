@@ -10,6 +10,7 @@
 #include "art/Framework/Principal/Handle.h"
 #include "fhiclcpp/ParameterSet.h"
 #include "messagefacility/MessageLogger/MessageLogger.h"
+#include "cetlib_except/exception.h"
 #include "nurandom/RandomUtils/NuRandomService.h"
 #include "canvas/Persistency/Common/Ptr.h"
 #include "art/Persistency/Common/PtrMaker.h"
@@ -30,14 +31,21 @@
 
 #include "TFile.h"
 #include "TNtuple.h"
-#include "TGeoManager.h"
 #include "TGeoNode.h"
+#include "TGeoVolume.h"
 #include "sbnobj/SBND/CRT/CRTData.hh"
 #include "sbndcode/CRT/CRTDetSim.h"
 
+#include <algorithm>
 #include <cmath>
+#include <iterator>
+#include <map>
+#include <numeric>
 #include <memory>
+#include <set>
 #include <string>
+#include <utility>
+#include <vector>
 
 namespace sbnd {
 namespace crt {
@@ -88,59 +96,192 @@ CRTDetSim::CRTDetSim(fhicl::ParameterSet const & p)
 }
 
 
-uint32_t CRTDetSim::getChannelTriggerTicks(CLHEP::HepRandomEngine* engine,
-                                         /*detinfo::ElecClock& clock,*/
-                                         float t0, float npeMean, float r) {
-  // Hit timing, with smearing and NPE dependence
-  double tDelayMean =
-    fTDelayNorm *
-      exp(-0.5 * pow((npeMean - fTDelayShift) / fTDelaySigma, 2)) +
-    fTDelayOffset;
+void CRTDetSim::getChannelTriggerTicks(std::vector<double> const& t0,
+                                       std::vector<long> const& npe,
+                                       std::vector<double> const& r,
+                                       double const* gaus,
+                                       std::vector<uint32_t>& ticks) const {
+  size_t const n = t0.size();
+  ticks.resize(n);
 
-  double tDelayRMS =
-    fTDelayRMSGausNorm *
-      exp(-pow(npeMean - fTDelayRMSGausShift, 2) / fTDelayRMSGausSigma) +
-    fTDelayRMSExpNorm *
-      exp(-(npeMean - fTDelayRMSExpShift) / fTDelayRMSExpScale);
+  for (size_t i = 0; i < n; i++) {
+    double const npeMean = npe[i];
 
-  double tDelay = CLHEP::RandGauss::shoot(engine, tDelayMean, tDelayRMS);
+    // Hit timing, with smearing and NPE dependence
+    double const dMean = (npeMean - fTDelayShift) / fTDelaySigma;
+    double const tDelayMean =
+      fTDelayNorm * std::exp(-0.5 * dMean * dMean) + fTDelayOffset;
 
-  // Time resolution of the interpolator
-  tDelay += CLHEP::RandGauss::shoot(engine, 0, fTResInterpolator);
+    double const dRMS = npeMean - fTDelayRMSGausShift;
+    double const tDelayRMS =
+      fTDelayRMSGausNorm * std::exp(-dRMS * dRMS / fTDelayRMSGausSigma) +
+      fTDelayRMSExpNorm * std::exp(-(npeMean - fTDelayRMSExpShift) / fTDelayRMSExpScale);
 
-  // Propagation time
-  double tProp = CLHEP::RandGauss::shoot(fPropDelay, fPropDelayError) * r;
+    double tDelay = tDelayMean + tDelayRMS * gaus[3 * i];
 
-  double t = t0 + tProp + tDelay;
+    // Time resolution of the interpolator
+    tDelay += fTResInterpolator * gaus[3 * i + 1];
 
-  // Get clock ticks
-  // FIXME no clock available for CRTs, have to do it by hand
-  //clock.SetTime(t / 1e3);  // SetTime takes microseconds
-  int time = (t / 1e3) * fClockSpeedCRT;
+    // Propagation time
+    double const tProp = (fPropDelay + fPropDelayError * gaus[3 * i + 2]) * r[i];
 
-  mf::LogInfo("CRT")
-    << "CRT TIMING: t0=" << t0
-    << ", tDelayMean=" << tDelayMean << ", tDelayRMS=" << tDelayRMS
-    << ", tDelay=" << tDelay << ", tDelay(interp)="
-    << tDelay << ", tProp=" << tProp << ", t=" << t << /*", ticks=" << clock.Ticks() <<*/ "\n";
+    double const t = t0[i] + tProp + tDelay;
 
-  return time;//clock.Ticks();
+    // Get clock ticks
+    // FIXME no clock available for CRTs, have to do it by hand
+    int const time = (t / 1e3) * fClockSpeedCRT;
+    ticks[i] = time;
+  }
+}
+
+
+void CRTDetSim::StripHits::clear() {
+  x.clear(); y.clear(); z.clear(); t.clear(); eDep.clear();
+  ideBegin.clear();
+}
+
+
+void CRTDetSim::StripHits::resize(size_t n) {
+  distToReadout.resize(n);
+  npeExp0.resize(n);
+  npeExp1.resize(n);
+  npe0.resize(n);
+  npe1.resize(n);
+  ppsTicks.resize(n);
+  gaus.resize(kNGausPerHit * n);
+}
+
+
+void CRTDetSim::beginJob() {
+  BuildStripInfo();
+}
+
+
+void CRTDetSim::BuildStripInfo() {
+  art::ServiceHandle<geo::Geometry> geoService;
+
+  // Find the paths to all strip geo nodes, in a single pass over the geometry
+  std::set<std::string> volNames;
+  for (size_t ad_i = 0; ad_i < geoService->NAuxDets(); ad_i++) {
+    const geo::AuxDetGeo& adGeo = geoService->AuxDet(ad_i);
+    for (size_t sv_i = 0; sv_i < adGeo.NSensitiveVolume(); sv_i++) {
+      volNames.insert(adGeo.SensitiveVolume(sv_i).TotalVolume()->GetName());
+    }
+  }
+  std::vector<std::vector<TGeoNode const*> > paths =
+    geoService->FindAllVolumePaths(volNames);
+
+  // First path found for each volume, as a lookup of that volume alone gives
+  std::map<std::string, std::vector<TGeoNode const*> const*> volPaths;
+  for (auto const& nodes : paths) {
+    volPaths.emplace(nodes.back()->GetVolume()->GetName(), &nodes);
+  }
+
+  fStripInfo.clear();
+  fStripInfo.resize(geoService->NAuxDets());
+  for (size_t ad_i = 0; ad_i < geoService->NAuxDets(); ad_i++) {
+    const geo::AuxDetGeo& adGeo = geoService->AuxDet(ad_i);
+    fStripInfo[ad_i].resize(adGeo.NSensitiveVolume());
+
+    for (size_t sv_i = 0; sv_i < adGeo.NSensitiveVolume(); sv_i++) {
+      const geo::AuxDetSensitiveGeo& adsGeo = adGeo.SensitiveVolume(sv_i);
+      StripInfo& strip = fStripInfo[ad_i][sv_i];
+      strip.geo = nullptr;
+
+      auto const itPath = volPaths.find(adsGeo.TotalVolume()->GetName());
+      if (itPath == volPaths.end() || itPath->second->size() < 4) {
+        mf::LogWarning("CRT") << "No geometry path found for CRT strip " << ad_i << "/" << sv_i << "\n";
+        continue;
+      }
+      std::vector<TGeoNode const*> const& nodes = *itPath->second;
+
+      strip.path = "";
+      for (size_t inode=0; inode<nodes.size(); inode++) {
+        strip.path += nodes.at(inode)->GetName();
+        if (inode < nodes.size() - 1) {
+          strip.path += "/";
+        }
+      }
+
+      // Strip, array, module and tagger are the last four nodes of the path
+      TGeoNode const* nodeStrip = nodes[nodes.size() - 1];
+      TGeoNode const* nodeArray = nodes[nodes.size() - 2];
+      TGeoNode const* nodeModule = nodes[nodes.size() - 3];
+      TGeoNode const* nodeTagger = nodes[nodes.size() - 4];
+      strip.stripName = nodeStrip->GetName();
+      strip.arrayName = nodeArray->GetName();
+      strip.moduleName = nodeModule->GetName();
+      strip.taggerName = nodeTagger->GetName();
+
+      // Module position in parent (tagger) frame
+      double origin[3] = {0, 0, 0};
+      nodeModule->LocalToMaster(origin, strip.modulePosMother);
+
+      // Determine plane ID (1 for z > 0, 0 for z < 0 in local coordinates)
+      strip.planeID = (strip.modulePosMother[2] > 0);
+
+      // Determine module orientation: which way is the top (readout end)?
+      strip.top = (strip.planeID == 1) ? (strip.modulePosMother[1] > 0) : (strip.modulePosMother[0] < 0);
+
+      adsGeo.LocalToWorld(origin, strip.stripPos);
+      strip.geo = &adsGeo;
+    }
+  }
+
+  // Number the taggers in name order, which is the order they are written out
+  std::set<std::string> taggerNames;
+  for (auto const& strips : fStripInfo) {
+    for (auto const& strip : strips) {
+      if (strip.geo) taggerNames.insert(strip.taggerName);
+    }
+  }
+  fTaggerNames.assign(taggerNames.begin(), taggerNames.end());
+  fTaggerIsBottom.clear();
+  for (auto const& name : fTaggerNames) {
+    fTaggerIsBottom.push_back(name.find("TaggerBot") != std::string::npos);
+  }
+  for (auto& strips : fStripInfo) {
+    for (auto& strip : strips) {
+      if (!strip.geo) continue;
+      strip.taggerID = std::distance(taggerNames.begin(), taggerNames.find(strip.taggerName));
+    }
+  }
 }
 
 
+
+namespace {
+
+// Hits of a tagger, before the coincidence requirement
 struct Tagger {
-  std::vector<std::pair<unsigned, uint32_t> > planesHit;
+  std::vector<uint32_t> planeTimes[2];  // strip hit times on each plane
   std::vector<sbnd::crt::CRTData> data;
-  std::vector<std::vector<sim::AuxDetIDE>> ides;
+  std::vector<std::pair<size_t, size_t> > ides;  // range of each data in the event's IDE list
 };
 
 
+// Whether two sorted lists have any pair of times closer than window
+bool HasCoincidence(std::vector<uint32_t> const& a,
+                    std::vector<uint32_t> const& b,
+                    double window) {
+  size_t i = 0, j = 0;
+  while (i < a.size() && j < b.size()) {
+    if (util::absDiff(a[i], b[j]) < window) return true;
+    if (a[i] < b[j]) i++;
+    else j++;
+  }
+  return false;
+}
+
+}  // namespace
+
+
 void CRTDetSim::produce(art::Event & e) {
   // A list of hit taggers, before any coincidence requirement
-  std::map<std::string, Tagger> taggers;
+  std::vector<Tagger> taggers(fTaggerNames.size());
 
-  // Services: Geometry, DetectorClocks, RandomNumberGenerator
-  art::ServiceHandle<geo::Geometry> geoService;
+  // IDEs of all strip hits, referenced by range from the taggers
+  std::vector<sim::AuxDetIDE const*> hitIdes;
 
   /*art::ServiceHandle<detinfo::DetectorClocksService> detClocks;
   detinfo::ElecClock trigClock = detClocks->provider()->TriggerClock();*/
@@ -149,184 +290,178 @@ void CRTDetSim::produce(art::Event & e) {
   art::Handle<std::vector<sim::AuxDetSimChannel> > channels;
   e.getByLabel(fG4ModuleLabel, channels);
 
-  // Loop through truth AD channels
-  for (auto& adsc : *channels) {
-    const geo::AuxDetGeo& adGeo =
-        geoService->AuxDet(adsc.AuxDetID());
-
-    const geo::AuxDetSensitiveGeo& adsGeo =
-        adGeo.SensitiveVolume(adsc.AuxDetSensitiveID());
-
-    // Return the vector of IDEs
-    std::vector<sim::AuxDetIDE> ides = adsc.AuxDetIDEs();
-    std::sort(ides.begin(), ides.end(),
-              [](const sim::AuxDetIDE & a, const sim::AuxDetIDE & b) -> bool{
-                return ((a.entryT + a.exitT)/2) < ((b.entryT + b.exitT)/2);
-              });
+  // Work buffers, reused for each strip
+  std::vector<size_t> order;
+  StripHits hits;
+  std::vector<uint32_t> ticks0, ticks1;
 
-    // Find the path to the strip geo node, to locate it in the hierarchy
-    std::set<std::string> volNames = { adsGeo.TotalVolume()->GetName() };
-    std::vector<std::vector<TGeoNode const*> > paths =
-      geoService->FindAllVolumePaths(volNames);
+  auto midT = [](const sim::AuxDetIDE & ide) { return (ide.entryT + ide.exitT) / 2; };
 
-    std::string path = "";
-    for (size_t inode=0; inode<paths.at(0).size(); inode++) {
-      path += paths.at(0).at(inode)->GetName();
-      if (inode < paths.at(0).size() - 1) {
-        path += "/";
-      }
+  // Loop through truth AD channels
+  for (auto const& adsc : *channels) {
+    // Strip location in the geometry, from the per-job table
+    StripInfo const& strip =
+      fStripInfo.at(adsc.AuxDetID()).at(adsc.AuxDetSensitiveID());
+    if (!strip.geo) {
+      throw cet::exception("CRTDetSim")
+        << "No geometry path found for CRT strip "
+        << adsc.AuxDetID() << "/" << adsc.AuxDetSensitiveID() << "\n";
     }
+    const geo::AuxDetSensitiveGeo& adsGeo = *strip.geo;
+
+    // The IDEs, in time order
+    std::vector<sim::AuxDetIDE> const& ides = adsc.AuxDetIDEs();
+    if (ides.empty()) continue;
+    order.resize(ides.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::sort(order.begin(), order.end(),
+              [&ides, &midT](size_t a, size_t b) -> bool{
+                return midT(ides[a]) < midT(ides[b]);
+              });
 
-    TGeoManager* manager = geoService->ROOTGeoManager();
-    manager->cd(path.c_str());
-
-    TGeoNode* nodeStrip = manager->GetCurrentNode();
-    TGeoNode* nodeArray = manager->GetMother(1);
-    TGeoNode* nodeModule = manager->GetMother(2);
-    TGeoNode* nodeTagger = manager->GetMother(3);
-
-    // Module position in parent (tagger) frame
-    double origin[3] = {0, 0, 0};
-    double modulePosMother[3];
-    nodeModule->LocalToMaster(origin, modulePosMother);
-
-    // Determine plane ID (1 for z > 0, 0 for z < 0 in local coordinates)
-    unsigned planeID = (modulePosMother[2] > 0);
-
-    // Determine module orientation: which way is the top (readout end)?
-    bool top = (planeID == 1) ? (modulePosMother[1] > 0) : (modulePosMother[0] < 0);
-
-    // Simulate the CRT response for each hit
-    for (size_t ide_i = 0; ide_i < ides.size(); ide_i++) {
-
-      sim::AuxDetIDE ide = ides[ide_i];
-
-      // Finally, what is the distance from the hit (centroid of the entry
-      // and exit points) to the readout end?
+    // Merge the IDEs the SiPMs can't resolve into hits, at the centroid
+    // of the entry and exit points
+    //ADD UP HITS AT THE SAME TIME - FIXME 2NS DIFF IS A GUESS -VERY APPROXIMATE
+    hits.clear();
+    for (size_t k = 0; k < order.size(); k++) {
+      const sim::AuxDetIDE& ide = ides[order[k]];
       double x = (ide.entryX + ide.exitX) / 2;
       double y = (ide.entryY + ide.exitY) / 2;
       double z = (ide.entryZ + ide.exitZ) / 2;
-      int nides = 1;
-
-      double tTrue = (ide.entryT + ide.exitT) / 2 + fGlobalT0Offset;
-      double tTrueLast = (ide.entryT + ide.exitT) / 2 + fGlobalT0Offset;
+      double tTrue = midT(ide) + fGlobalT0Offset;
+      double tTrueLast = midT(ide) + fGlobalT0Offset;
       double eDep = ide.energyDeposited;
+      int nides = 1;
 
-      std::vector<sim::AuxDetIDE> trueIdes;
-      trueIdes.push_back(ide);
-
-      //ADD UP HITS AT THE SAME TIME - FIXME 2NS DIFF IS A GUESS -VERY APPROXIMATE
-      if(ide_i < ides.size() - 1){
-        while(ide_i < ides.size() - 1 && std::abs(tTrueLast-((ides[ide_i+1].entryT + ides[ide_i+1].exitT) / 2 + fGlobalT0Offset)) < fSipmTimeResponse){
-          ide_i++;
-          x += (ides[ide_i].entryX + ides[ide_i].exitX) / 2;
-          y += (ides[ide_i].entryY + ides[ide_i].exitY) / 2;
-          z += (ides[ide_i].entryZ + ides[ide_i].exitZ) / 2;
-          eDep += ides[ide_i].energyDeposited;
-          tTrue += (ides[ide_i].entryT + ides[ide_i].exitT) / 2;
-          tTrueLast = (ides[ide_i].entryT + ides[ide_i].exitT) / 2;
-
-          nides++;
-
-          trueIdes.push_back(ides[ide_i]);
-        }
+      hits.ideBegin.push_back(k);
+      while (k < order.size() - 1 &&
+             std::abs(tTrueLast - (midT(ides[order[k+1]]) + fGlobalT0Offset)) < fSipmTimeResponse) {
+        k++;
+        const sim::AuxDetIDE& next = ides[order[k]];
+        x += (next.entryX + next.exitX) / 2;
+        y += (next.entryY + next.exitY) / 2;
+        z += (next.entryZ + next.exitZ) / 2;
+        eDep += next.energyDeposited;
+        tTrue += midT(next);
+        tTrueLast = midT(next);
+        nides++;
       }
 
-      x = x/nides;
-      y = y/nides;
-      z = z/nides;
-      tTrue = tTrue/nides;
+      hits.x.push_back(x / nides);
+      hits.y.push_back(y / nides);
+      hits.z.push_back(z / nides);
+      hits.t.push_back(tTrue / nides);
+      hits.eDep.push_back(eDep);
+    }
+    hits.ideBegin.push_back(order.size());
+
+    size_t const nHits = hits.t.size();
+    hits.resize(nHits);
 
-      double world[3] = {x, y, z};
+    // Expected PE on each SiPM
+    double const halfHeight = adsGeo.HalfHeight();
+    double const halfWidth = adsGeo.HalfWidth1();
+    for (size_t i = 0; i < nHits; i++) {
+      double world[3] = {hits.x[i], hits.y[i], hits.z[i]};
       double svHitPosLocal[3];
       adsGeo.WorldToLocal(world, svHitPosLocal);
 
-      double distToReadout;
-      if (top) {
-        distToReadout = abs( adsGeo.HalfHeight() - svHitPosLocal[1]);
-      }
-      else {
-        distToReadout = abs(-adsGeo.HalfHeight() - svHitPosLocal[1]);
-      }
+      // Distance from the hit to the readout end
+      hits.distToReadout[i] = strip.top ?
+        std::abs( halfHeight - svHitPosLocal[1]) :
+        std::abs(-halfHeight - svHitPosLocal[1]);
 
       // The expected number of PE, using a quadratic model for the distance
       // dependence, and scaling linearly with deposited energy.
-      double qr = fUseEdep ? 1.0 * eDep / fQ0 : 1.0;
-
-      double npeExpected =
-        fNpeScaleNorm / pow(distToReadout - fNpeScaleShift, 2) * qr;
+      double const qr = fUseEdep ? 1.0 * hits.eDep[i] / fQ0 : 1.0;
+      double const dr = hits.distToReadout[i] - fNpeScaleShift;
+      double const npeExpected = fNpeScaleNorm / (dr * dr) * qr;
 
       // Put PE on channels weighted by transverse distance across the strip,
       // using an exponential model
-      double d0 = abs(-adsGeo.HalfWidth1() - svHitPosLocal[0]);  // L
-      double d1 = abs( adsGeo.HalfWidth1() - svHitPosLocal[0]);  // R
-      double abs0 = exp(-d0 / fAbsLenEff);
-      double abs1 = exp(-d1 / fAbsLenEff);
-      double npeExp0 = npeExpected * abs0 / (abs0 + abs1);
-      double npeExp1 = npeExpected * abs1 / (abs0 + abs1);
-
-      // Observed PE (Poisson-fluctuated)
-      long npe0 = CLHEP::RandPoisson::shoot(&fEngine, npeExp0);
-      long npe1 = CLHEP::RandPoisson::shoot(&fEngine, npeExp1);
-
-      // Time relative to trigger, accounting for propagation delay and 'walk'
-      // for the fixed-threshold discriminator
-      uint32_t t0 =
-        getChannelTriggerTicks(&fEngine, /*trigClock,*/ tTrue, npe0, distToReadout);
-      uint32_t t1 =
-        getChannelTriggerTicks(&fEngine, /*trigClock,*/ tTrue, npe1, distToReadout);
-
-      // Time relative to PPS: Random for now! (FIXME)
-      uint32_t ppsTicks =
+      double const d0 = std::abs(-halfWidth - svHitPosLocal[0]);  // L
+      double const d1 = std::abs( halfWidth - svHitPosLocal[0]);  // R
+      double const abs0 = std::exp(-d0 / fAbsLenEff);
+      double const abs1 = std::exp(-d1 / fAbsLenEff);
+      hits.npeExp0[i] = npeExpected * abs0 / (abs0 + abs1);
+      hits.npeExp1[i] = npeExpected * abs1 / (abs0 + abs1);
+    }
+
+    // Random draws for the whole strip: observed PE (Poisson-fluctuated),
+    // time relative to PPS (random for now, FIXME) and the Gaussian smearing
+    for (size_t i = 0; i < nHits; i++) {
+      hits.npe0[i] = CLHEP::RandPoisson::shoot(&fEngine, hits.npeExp0[i]);
+      hits.npe1[i] = CLHEP::RandPoisson::shoot(&fEngine, hits.npeExp1[i]);
+      hits.ppsTicks[i] =
         CLHEP::RandFlat::shootInt(&fEngine, /*trigClock.Frequency()*/ fClockSpeedCRT * 1e6);
+    }
+    CLHEP::RandGauss::shootArray(&fEngine, hits.gaus.size(), hits.gaus.data(), 0., 1.);
+    double const* gausTime0 = hits.gaus.data();
+    double const* gausTime1 = gausTime0 + 3 * nHits;
+    double const* gausQ = gausTime1 + 3 * nHits;
+
+    // Time relative to trigger, accounting for propagation delay and 'walk'
+    // for the fixed-threshold discriminator
+    getChannelTriggerTicks(hits.t, hits.npe0, hits.distToReadout, gausTime0, ticks0);
+    getChannelTriggerTicks(hits.t, hits.npe1, hits.distToReadout, gausTime1, ticks1);
+
+    // Adjacent channels on a strip are numbered sequentially.
+    //
+    // In the AuxDetChannelMapAlg methods, channels are identified by an
+    // AuxDet name (retrievable given the hit AuxDet ID) which specifies a
+    // module, and a channel number from 0 to 32.
+    uint32_t moduleID = adsc.AuxDetID();
+    uint32_t stripID = adsc.AuxDetSensitiveID();
+    uint32_t channel0ID = 32 * moduleID + 2 * stripID + 0;
+    uint32_t channel1ID = 32 * moduleID + 2 * stripID + 1;
+
+    Tagger& tagger = taggers[strip.taggerID];
+
+    for (size_t i = 0; i < nHits; i++) {
+      long const npe0 = hits.npe0[i];
+      long const npe1 = hits.npe1[i];
+      uint32_t const t0 = ticks0[i];
+      uint32_t const t1 = ticks1[i];
 
       // SiPM and ADC response: Npe to ADC counts
-      short q0 =
-        CLHEP::RandGauss::shoot(&fEngine, fQPed + fQSlope * npe0, fQRMS * sqrt(npe0));
+      short q0 = fQPed + fQSlope * npe0 + fQRMS * std::sqrt(npe0) * gausQ[2 * i];
       if(q0 > fAdcSaturation) q0 = fAdcSaturation;
-      short q1 =
-        CLHEP::RandGauss::shoot(&fEngine, fQPed + fQSlope * npe1, fQRMS * sqrt(npe1));
+      short q1 = fQPed + fQSlope * npe1 + fQRMS * std::sqrt(npe1) * gausQ[2 * i + 1];
       if(q1 > fAdcSaturation) q1 = fAdcSaturation;
 
-      // Adjacent channels on a strip are numbered sequentially.
-      //
-      // In the AuxDetChannelMapAlg methods, channels are identified by an
-      // AuxDet name (retrievable given the hit AuxDet ID) which specifies a
-      // module, and a channel number from 0 to 32.
-      uint32_t moduleID = adsc.AuxDetID();
-      uint32_t stripID = adsc.AuxDetSensitiveID();
-      uint32_t channel0ID = 32 * moduleID + 2 * stripID + 0;
-      uint32_t channel1ID = 32 * moduleID + 2 * stripID + 1;
-
       // Apply ADC threshold and strip-level coincidence (both fibers fire)
       if (q0 > fQThreshold &&
           q1 > fQThreshold &&
           util::absDiff(t0, t1) < fStripCoincidenceWindow) {
-        Tagger& tagger = taggers[nodeTagger->GetName()];
-        tagger.planesHit.push_back({planeID, t0});
-        tagger.data.push_back(sbnd::crt::CRTData(channel0ID, t0, ppsTicks, q0));
-        tagger.ides.push_back(trueIdes);
-        tagger.data.push_back(sbnd::crt::CRTData(channel1ID, t1, ppsTicks, q1));
-        tagger.ides.push_back(trueIdes);
+        std::pair<size_t, size_t> const ideRange(hitIdes.size(),
+          hitIdes.size() + hits.ideBegin[i+1] - hits.ideBegin[i]);
+        for (size_t k = hits.ideBegin[i]; k < hits.ideBegin[i+1]; k++) {
+          hitIdes.push_back(&ides[order[k]]);
+        }
+
+        tagger.planeTimes[strip.planeID].push_back(t0);
+        tagger.data.push_back(sbnd::crt::CRTData(channel0ID, t0, hits.ppsTicks[i], q0));
+        tagger.ides.push_back(ideRange);
+        tagger.data.push_back(sbnd::crt::CRTData(channel1ID, t1, hits.ppsTicks[i], q1));
+        tagger.ides.push_back(ideRange);
       }
 
-      double poss[3];
-      adsGeo.LocalToWorld(origin, poss);
       mf::LogInfo("CRT")
         << "CRT HIT in " << adsc.AuxDetID() << "/" << adsc.AuxDetSensitiveID() << "\n"
-        << "CRT HIT POS " << x << " " << y << " " << z << "\n"
-        << "CRT STRIP POS " << poss[0] << " " << poss[1] << " " << poss[2] << "\n"
-        << "CRT MODULE POS " << modulePosMother[0] << " "
-                             << modulePosMother[1] << " "
-                             << modulePosMother[2] << " "
+        << "CRT HIT POS " << hits.x[i] << " " << hits.y[i] << " " << hits.z[i] << "\n"
+        << "CRT STRIP POS " << strip.stripPos[0] << " " << strip.stripPos[1] << " " << strip.stripPos[2] << "\n"
+        << "CRT MODULE POS " << strip.modulePosMother[0] << " "
+                             << strip.modulePosMother[1] << " "
+                             << strip.modulePosMother[2] << " "
                              << "\n"
-        << "CRT PATH: " << path << "\n"
-        << "CRT level 0 (strip): " << nodeStrip->GetName() << "\n"
-        << "CRT level 1 (array): " << nodeArray->GetName() << "\n"
-        << "CRT level 2 (module): " << nodeModule->GetName() << "\n"
-        << "CRT level 3 (tagger): " << nodeTagger->GetName() << "\n"
-        << "CRT PLANE ID: " << planeID << "\n"
-        << "CRT distToReadout: " << distToReadout << " " << (top ? "top" : "bot") << "\n"
+        << "CRT PATH: " << strip.path << "\n"
+        << "CRT level 0 (strip): " << strip.stripName << "\n"
+        << "CRT level 1 (array): " << strip.arrayName << "\n"
+        << "CRT level 2 (module): " << strip.moduleName << "\n"
+        << "CRT level 3 (tagger): " << strip.taggerName << "\n"
+        << "CRT PLANE ID: " << strip.planeID << "\n"
+        << "CRT distToReadout: " << hits.distToReadout[i] << " " << (strip.top ? "top" : "bot") << "\n"
+        << "CRT TIMING: t0=" << hits.t[i] << "\n"
         << "CRT q0: " << q0 << ", q1: " << q1 << ", t0: " << t0 << ", t1: " << t1 << ", dt: " << util::absDiff(t0,t1) << "\n";
     }
   }
@@ -344,36 +479,23 @@ void CRTDetSim::produce(art::Event & e) {
 
   // Logic: For normal taggers, require at least one hit in each perpendicular
   // plane. For the bottom tagger, any hit triggers read out.
-  for (auto trg : taggers) {
-    bool trigger = false;
-
-    // Loop over pairs of hits
-    for (auto t1 : trg.second.planesHit) {
-      for (auto t2 : trg.second.planesHit) {
-        if (t1 == t2) {
-          continue;
-        }
+  for (size_t tagger_i = 0; tagger_i < taggers.size(); tagger_i++) {
+    Tagger& trg = taggers[tagger_i];
+    if (trg.data.empty()) continue;
 
-        // Two hits on different planes with proximal t0 times
-        if (t1.first != t2.first && util::absDiff(t1.second, t2.second) < fTaggerPlaneCoincidenceWindow) {
-          trigger = true;
-          break;
-        }
-      }
-    }
+    // Two hits on different planes with proximal t0 times
+    for (auto& times : trg.planeTimes) std::sort(times.begin(), times.end());
+    bool trigger = HasCoincidence(trg.planeTimes[0], trg.planeTimes[1], fTaggerPlaneCoincidenceWindow);
 
-    if (trigger || trg.first.find("TaggerBot") != std::string::npos) {
+    if (trigger || fTaggerIsBottom[tagger_i]) {
       // Write out all hits on a tagger when there is any coincidence FIXME this reads out everything!
-      //for (auto d : trg.second.data) {
-      for (size_t d_i = 0; d_i < trg.second.data.size(); d_i++) {
-        triggeredCRTHits->push_back(trg.second.data[d_i]);
+      for (size_t d_i = 0; d_i < trg.data.size(); d_i++) {
+        triggeredCRTHits->push_back(trg.data[d_i]);
         art::Ptr<sbnd::crt::CRTData> dataPtr = makeDataPtr(triggeredCRTHits->size()-1);
-        if(trg.second.data.size() == trg.second.ides.size()){
-          for (size_t i_i = 0; i_i < trg.second.ides[d_i].size(); i_i++){
-            auxDetIdes->push_back(trg.second.ides[d_i][i_i]);
-            art::Ptr<sim::AuxDetIDE> idePtr = makeIdePtr(auxDetIdes->size()-1);
-            Dataassn->addSingle(dataPtr, idePtr);
-          }
+        for (size_t i_i = trg.ides[d_i].first; i_i < trg.ides[d_i].second; i_i++){
+          auxDetIdes->push_back(*hitIdes[i_i]);
+          art::Ptr<sim::AuxDetIDE> idePtr = makeIdePtr(auxDetIdes->size()-1);
+          Dataassn->addSingle(dataPtr, idePtr);
         }
       }
     }
@@ -96,6 +96,7 @@ namespace sbnd {
 
     // Params from fcl file.......
     art::InputTag fCrtModuleLabel;      ///< name of crt producer
+    unsigned      fNThreads;            ///< number of threads to reconstruct the taggers with
    
     CRTHitRecoAlg hitAlg;
 
@@ -120,6 +121,7 @@ namespace sbnd {
   {
 
     fCrtModuleLabel       = (p.get<art::InputTag> ("CrtModuleLabel")); 
+    fNThreads             = (p.get<unsigned> ("NThreads", 1));
 
   } // CRTSimHitProducer::reconfigure()
 
@@ -149,12 +151,12 @@ namespace sbnd {
     auto const detProp = art::ServiceHandle<detinfo::DetectorPropertiesService const>()->DataFor(event, clockData);
     // Fill a vector of pairs of time and width direction for each CRT plane
     // The y crossing point of z planes and z crossing point of y planes would be constant
-    std::map<std::pair<std::string, unsigned>, std::vector<CRTStrip>> taggerStrips = hitAlg.CreateTaggerStrips(clockData, detProp, crtList);
+    CRTTaggerStrips taggerStrips = hitAlg.CreateTaggerStripBuffer(clockData, detProp, crtList);
 
     mf::LogInfo("CRTSimHitProducer")
       <<"Number of SiPM hits = "<<crtList.size();
 
-    std::vector<std::pair<sbn::crt::CRTHit, std::vector<int>>> crtHitPairs = hitAlg.CreateCRTHits(taggerStrips);
+    std::vector<std::pair<sbn::crt::CRTHit, std::vector<int>>> crtHitPairs = hitAlg.CreateCRTHits(taggerStrips, fNThreads);
 
     for(auto const& crtHitPair : crtHitPairs){
       CRTHitcol->push_back(crtHitPair.first);
@@ -87,6 +87,7 @@ namespace sbnd {
     // Params got from fcl file.......
     art::InputTag fTpcTrackModuleLabel; ///< name of track producer
     art::InputTag fCrtHitModuleLabel;   ///< name of crt producer
+    unsigned      fNThreads;            ///< number of threads to match the tracks with
 
     CRTT0MatchAlg t0Alg;
 
@@ -112,6 +113,7 @@ namespace sbnd {
 
     fTpcTrackModuleLabel = (p.get<art::InputTag> ("TpcTrackModuleLabel"));
     fCrtHitModuleLabel   = (p.get<art::InputTag> ("CrtHitModuleLabel")); 
+    fNThreads            = (p.get<unsigned> ("NThreads", 1));
 
   } // CRTT0Matching::reconfigure()
 
@@ -152,11 +154,18 @@ namespace sbnd {
     if (trackListHandle.isValid() && crtListHandle.isValid() ){
       
       auto const detProp = art::ServiceHandle<detinfo::DetectorPropertiesService const>()->DataFor(event);
+
+      // Index the CRT hits by time and match all the tracks at once
+      CRTHitTimeIndex crtHitIndex = t0Alg.HitTimeIndex(crtHits);
+      art::FindManyP<recob::Hit> findManyHits(trackListHandle, event, fTpcTrackModuleLabel);
+      std::vector<std::pair<double, double>> matchedTimes = t0Alg.T0sAndDCAsFromCRTHits(detProp, *trackListHandle, findManyHits,
+                                                                                        crtHitIndex, fNThreads);
+
       // Loop over all the reconstructed tracks 
       for(size_t track_i = 0; track_i < trackList.size(); track_i++) {
 
         // Get the closest matched time
-        std::pair<double, double> matchedTime = t0Alg.T0AndDCAFromCRTHits(detProp, *trackList[track_i], crtHits, event);
+        std::pair<double, double> matchedTime = matchedTimes[track_i];
         if(matchedTime.first != -99999){
           mf::LogInfo("CRTT0Matching")
             <<"Matched time = "<<matchedTime.first<<" [us] to track "<<trackList[track_i]->ID()<<" with DCA = "<<matchedTime.second;
@@ -87,6 +87,7 @@ namespace sbnd {
     // Params got from fcl file.......
     art::InputTag fTpcTrackModuleLabel; ///< name of track producer
     art::InputTag fCrtTrackModuleLabel; ///< name of crt producer
+    unsigned      fNThreads;            ///< number of threads to match the tracks with
 
     CRTTrackMatchAlg trackAlg;
     TPCGeoAlg fTpcGeo;
@@ -114,6 +115,7 @@ namespace sbnd {
 
     fTpcTrackModuleLabel = (p.get<art::InputTag> ("TpcTrackModuleLabel"));
     fCrtTrackModuleLabel = (p.get<art::InputTag> ("CrtTrackModuleLabel")); 
+    fNThreads            = (p.get<unsigned> ("NThreads", 1));
 
   } // CRTTrackMatching::reconfigure()
 
@@ -140,9 +142,6 @@ namespace sbnd {
     if (event.getByLabel(fTpcTrackModuleLabel, tpcTrackListHandle))
       art::fill_ptr_vector(tpcTrackList, tpcTrackListHandle);   
 
-    // Get track to hit associations
-    //art::FindManyP<recob::Hit> findManyHits(tpcTrackListHandle, event, fTpcTrackModuleLabel);
-
     // Get CRT tracks
     art::Handle< std::vector<sbn::crt::CRTTrack> > crtTrackListHandle;
     std::vector<art::Ptr<sbn::crt::CRTTrack> > crtTrackList;
@@ -162,10 +161,16 @@ namespace sbnd {
       mf::LogInfo("CRTTrackMatching")
         <<"Number of TPC tracks = "<<tpcTrackList.size()<<"\n"
         <<"Number of CRT tracks = "<<crtTrackList.size();
+
+      // Index the CRT tracks by time and match all the TPC tracks at once
+      CRTTrackTimeIndex crtTrackIndex = trackAlg.TrackTimeIndex(crtTracks);
+      art::FindManyP<recob::Hit> findManyHits(tpcTrackListHandle, event, fTpcTrackModuleLabel);
+      std::vector<std::pair<int,double>> matchedResults = trackAlg.GetMatchedCRTTrackIdsAndScores(detProp, *tpcTrackListHandle, findManyHits,
+                                                                                                   crtTrackIndex, fNThreads);
+
       for (size_t tpc_i = 0; tpc_i < tpcTrackList.size(); tpc_i++){
 
-        std::pair<int,double> matchedResult = trackAlg.GetMatchedCRTTrackIdAndScore(detProp,
-                                                                                    *tpcTrackList[tpc_i], crtTracks, event);
+        std::pair<int,double> matchedResult = matchedResults[tpc_i];
         int matchedID = matchedResult.first;
         double matchedScore = matchedResult.second;
         
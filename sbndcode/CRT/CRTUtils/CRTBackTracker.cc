@@ -30,12 +30,73 @@ void CRTBackTracker::reconfigure(const Config& config){
 
 }
 
+// Start a new, empty table
+void CRTBackTracker::TrueIdTable::Clear(){
+
+  begin.assign(1, 0);
+  ids.clear();
+
+}
+
+// Append the next object, summing repeated true IDs
+void CRTBackTracker::TrueIdTable::Add(std::vector<std::pair<int, double>>& objectIds){
+
+  MergeTrueIds(objectIds);
+  ids.insert(ids.end(), objectIds.begin(), objectIds.end());
+  begin.push_back(ids.size());
+
+}
+
+// True ID with the most energy for an object, -99999 if none
+int CRTBackTracker::TrueIdTable::DominantId(size_t object_i) const{
+
+  if(object_i + 1 >= begin.size()) return -99999;
+  return DominantTrueId(ids.data() + begin[object_i], ids.data() + begin[object_i + 1]);
+
+}
+
+// Sum the energies of repeated true IDs, in order of appearance, and sort by ID
+void CRTBackTracker::MergeTrueIds(std::vector<std::pair<int, double>>& ids){
+
+  std::stable_sort(ids.begin(), ids.end(), 
+                   [](const std::pair<int, double>& a, const std::pair<int, double>& b){
+                     return a.first < b.first;
+                   });
+
+  size_t nIds = 0;
+  for(size_t i = 0; i < ids.size(); i++){
+    if(nIds > 0 && ids[nIds - 1].first == ids[i].first) ids[nIds - 1].second += ids[i].second;
+    else ids[nIds++] = ids[i];
+  }
+  ids.resize(nIds);
+
+}
+
+// True ID with the most energy, the lowest one on ties
+int CRTBackTracker::DominantTrueId(const std::pair<int, double>* begin, const std::pair<int, double>* end){
+
+  double maxEnergy = -1;
+  int trueId = -99999;
+  for(auto id = begin; id != end; ++id){
+    if(id->second > maxEnergy){
+      maxEnergy = id->second;
+      trueId = id->first;
+    }
+  }
+
+  return trueId;
+
+}
+
 void CRTBackTracker::Initialize(const art::Event& event){
 
   // Clear those data structures!
-  fDataTrueIds.clear();
-  fHitTrueIds.clear();
-  fTrackTrueIds.clear();
+  fDataTrueIds.Clear();
+  fHitTrueIds.Clear();
+  fTrackTrueIds.Clear();
+
+  // Buffer for the true IDs of one object
+  std::vector<std::pair<int, double>> objectIds;
   
   // Get a handle to the CRT data in the event
   art::Handle< std::vector<sbnd::crt::CRTData>> crtDataHandle;
@@ -45,19 +106,17 @@ void CRTBackTracker::Initialize(const art::Event& event){
   
   art::FindManyP<sim::AuxDetIDE> findManyIdes(crtDataHandle, event, fCRTDataLabel);
 
-  std::map<art::Ptr<sbnd::crt::CRTData>, int> dataPtrMap;
-
   for(size_t data_i = 0; data_i < crtDataList.size(); data_i++){
 
-    dataPtrMap[crtDataList[data_i]] = data_i;
-
     // Get all the true IDs from all the IDEs in the hit
-    std::vector<art::Ptr<sim::AuxDetIDE>> ides = findManyIdes.at(data_i);
+    objectIds.clear();
+    std::vector<art::Ptr<sim::AuxDetIDE>> const& ides = findManyIdes.at(data_i);
     for(size_t i = 0; i < ides.size(); i++){
       int id = ides[i]->trackID;
       if(fRollupUnsavedIds) id = std::abs(id);
-      fDataTrueIds[data_i][id] += ides[i]->energyDeposited;
+      objectIds.emplace_back(id, ides[i]->energyDeposited);
     }
+    fDataTrueIds.Add(objectIds);
 
   }
 
@@ -68,22 +127,21 @@ void CRTBackTracker::Initialize(const art::Event& event){
 
   art::FindManyP<sbnd::crt::CRTData> findManyData(crtHitHandle, event, fCRTHitLabel);
 
-  std::map<art::Ptr<sbn::crt::CRTHit>, int> hitPtrMap;
-
   for(size_t hit_i = 0; hit_i < crtHitList.size(); hit_i++){
 
-    hitPtrMap[crtHitList[hit_i]] = hit_i;
-
-    std::vector<art::Ptr<sbnd::crt::CRTData>> data = findManyData.at(hit_i);
+    // The data index is the pointer key in the data product
+    objectIds.clear();
+    std::vector<art::Ptr<sbnd::crt::CRTData>> const& data = findManyData.at(hit_i);
     for(size_t data_i = 0; data_i < data.size(); data_i++){
 
-      int dataID = dataPtrMap[data[data_i]];
+      if(data[data_i].id() != crtDataHandle.id() || data[data_i].key() >= crtDataList.size()) continue;
+      size_t dataID = data[data_i].key();
 
-      for(auto const& di : fDataTrueIds[dataID]){
-        fHitTrueIds[hit_i][di.first] += di.second;
-      }
+      objectIds.insert(objectIds.end(), fDataTrueIds.ids.begin() + fDataTrueIds.begin[dataID], 
+                       fDataTrueIds.ids.begin() + fDataTrueIds.begin[dataID + 1]);
 
     }
+    fHitTrueIds.Add(objectIds);
   }
 
   art::Handle< std::vector<sbn::crt::CRTTrack>> crtTrackHandle;
@@ -95,16 +153,18 @@ void CRTBackTracker::Initialize(const art::Event& event){
 
   for(size_t track_i = 0; track_i < crtTrackList.size(); track_i++){
 
-    std::vector<art::Ptr<sbn::crt::CRTHit>> hits = findManyHits.at(track_i);
+    objectIds.clear();
+    std::vector<art::Ptr<sbn::crt::CRTHit>> const& hits = findManyHits.at(track_i);
     for(size_t hit_i = 0; hit_i < hits.size(); hit_i++){
 
-      int hitID = hitPtrMap[hits[hit_i]];
+      if(hits[hit_i].id() != crtHitHandle.id() || hits[hit_i].key() >= crtHitList.size()) continue;
+      size_t hitID = hits[hit_i].key();
 
-      for(auto const& hi : fHitTrueIds[hitID]){
-        fTrackTrueIds[track_i][hi.first] += hi.second;
-      }
+      objectIds.insert(objectIds.end(), fHitTrueIds.ids.begin() + fHitTrueIds.begin[hitID], 
+                       fHitTrueIds.ids.begin() + fHitTrueIds.begin[hitID + 1]);
 
     }
+    fTrackTrueIds.Add(objectIds);
   }
 }
 
@@ -280,7 +340,7 @@ std::vector<int> CRTBackTracker::AllTrueIds(const art::Event& event, const sbn::
 // Get the true particle ID that contributed the most energy to the CRT data product
 int CRTBackTracker::TrueIdFromTotalEnergy(const art::Event& event, const sbnd::crt::CRTData& data){
 
-  std::map<int, double> ids;
+  std::vector<std::pair<int, double>> ids;
 
   // Get a handle to the CRT data in the event
   auto crtDataHandle = event.getValidHandle<std::vector<sbnd::crt::CRTData>>(fCRTDataLabel);
@@ -299,45 +359,27 @@ int CRTBackTracker::TrueIdFromTotalEnergy(const art::Event& event, const sbnd::c
   for(size_t i = 0; i < ides.size(); i++){
     int id = ides[i]->trackID;
     if(fRollupUnsavedIds) id = std::abs(id);
-    ids[id] += ides[i]->energyDeposited;
+    ids.emplace_back(id, ides[i]->energyDeposited);
   }
 
   // Find the true ID that contributed the most energy
-  double maxEnergy = -1;
-  int trueId = -99999;
-  for(auto &id : ids){
-    if(id.second > maxEnergy){
-      maxEnergy = id.second;
-      trueId = id.first;
-    }
-  }
-
-  return trueId;
+  MergeTrueIds(ids);
+  return DominantTrueId(ids.data(), ids.data() + ids.size());
 
 }
 
-int CRTBackTracker::TrueIdFromDataId(const art::Event& event, int data_i){
+int CRTBackTracker::TrueIdFromDataId(const art::Event& event, int data_i) const{
 
-  if(fDataTrueIds.find(data_i) != fDataTrueIds.end()){ 
-    double maxEnergy = -1;
-    int trueId = -99999;
-    for(auto &id : fDataTrueIds[data_i]){
-      if(id.second > maxEnergy){
-        maxEnergy = id.second;
-        trueId = id.first;
-      }
-    }
-    return trueId;
-  }
+  if(data_i < 0) return -99999;
+  return fDataTrueIds.DominantId(data_i);
 
-  return -99999;
 }
 
 
 // Get the true particle ID that contributed the most energy to the CRT hit
 int CRTBackTracker::TrueIdFromTotalEnergy(const art::Event& event, const sbn::crt::CRTHit& hit){
 
-  std::map<int, double> ids;
+  std::vector<std::pair<int, double>> ids;
 
   // Get a handle to the CRT hits in the event
   auto crtHitHandle = event.getValidHandle<std::vector<sbn::crt::CRTHit>>(fCRTHitLabel);
@@ -361,45 +403,27 @@ int CRTBackTracker::TrueIdFromTotalEnergy(const art::Event& event, const sbn::cr
     for(size_t j = 0; j < ides.size(); j++){
       int id = ides[j]->trackID;
       if(fRollupUnsavedIds) id = std::abs(id);
-      ids[id] += ides[j]->energyDeposited;
+      ids.emplace_back(id, ides[j]->energyDeposited);
     }
   }
 
   // Find the true ID that contributed the most energy
-  double maxEnergy = -1;
-  int trueId = -99999;
-  for(auto &id : ids){
-    if(id.second > maxEnergy){
-      maxEnergy = id.second;
-      trueId = id.first;
-    }
-  }
-
-  return trueId;
+  MergeTrueIds(ids);
+  return DominantTrueId(ids.data(), ids.data() + ids.size());
 
 }
 
-int CRTBackTracker::TrueIdFromHitId(const art::Event& event, int hit_i){
+int CRTBackTracker::TrueIdFromHitId(const art::Event& event, int hit_i) const{
 
-  if(fHitTrueIds.find(hit_i) != fHitTrueIds.end()){ 
-    double maxEnergy = -1;
-    int trueId = -99999;
-    for(auto &id : fHitTrueIds[hit_i]){
-      if(id.second > maxEnergy){
-        maxEnergy = id.second;
-        trueId = id.first;
-      }
-    }
-    return trueId;
-  }
+  if(hit_i < 0) return -99999;
+  return fHitTrueIds.DominantId(hit_i);
 
-  return -99999;
 }
 
 // Get the true particle ID that contributed the most energy to the CRT track
 int CRTBackTracker::TrueIdFromTotalEnergy(const art::Event& event, const sbn::crt::CRTTrack& track){
 
-  std::map<int, double> ids;
+  std::vector<std::pair<int, double>> ids;
 
   // Get a handle to the CRT tracks in the event
   auto crtTrackHandle = event.getValidHandle<std::vector<sbn::crt::CRTTrack>>(fCRTTrackLabel);
@@ -426,41 +450,21 @@ int CRTBackTracker::TrueIdFromTotalEnergy(const art::Event& event, const sbn::cr
       for(size_t k = 0; k < ides.size(); k++){
         int id = ides[k]->trackID;
         if(fRollupUnsavedIds) id = std::abs(id);
-        ids[id] += ides[k]->energyDeposited;
+        ids.emplace_back(id, ides[k]->energyDeposited);
       }
     }
   }
 
   // Find the true ID that contributed the most energy
-  double maxEnergy = -1;
-  int trueId = -99999;
-  for(auto &id : ids){
-    if(id.second > maxEnergy){
-      maxEnergy = id.second;
-      trueId = id.first;
-    }
-  }
-
-  return trueId;
+  MergeTrueIds(ids);
+  return DominantTrueId(ids.data(), ids.data() + ids.size());
 
 }
 
-int CRTBackTracker::TrueIdFromTrackId(const art::Event& event, int track_i){
-
-  if(fTrackTrueIds.find(track_i) != fTrackTrueIds.end()){ 
-    double maxEnergy = -1;
-    int trueId = -99999;
-    for(auto &id : fTrackTrueIds[track_i]){
-      if(id.second > maxEnergy){
-        maxEnergy = id.second;
-        trueId = id.first;
-      }
-    }
-
-    return trueId;
-  }
+int CRTBackTracker::TrueIdFromTrackId(const art::Event& event, int track_i) const{
 
-  return -99999;
+  if(track_i < 0) return -99999;
+  return fTrackTrueIds.DominantId(track_i);
 
 }
 
@@ -32,6 +32,8 @@
 
 // c++
 #include <vector>
+#include <utility>
+#include <algorithm>
 
 
 namespace sbnd{
@@ -73,13 +75,13 @@ namespace sbnd{
     void Initialize(const art::Event& event);
 
     // Check that two CRT data products are the same
-    bool DataCompare(const sbnd::crt::CRTData& data1, const sbnd::crt::CRTData& data2);
+    static bool DataCompare(const sbnd::crt::CRTData& data1, const sbnd::crt::CRTData& data2);
 
     // Check that two CRT hits are the same
-    bool HitCompare(const sbn::crt::CRTHit& hit1, const sbn::crt::CRTHit& hit2);
+    static bool HitCompare(const sbn::crt::CRTHit& hit1, const sbn::crt::CRTHit& hit2);
 
     // Check that two CRT tracks are the same
-    bool TrackCompare(const sbn::crt::CRTTrack& track1, const sbn::crt::CRTTrack& track2);
+    static bool TrackCompare(const sbn::crt::CRTTrack& track1, const sbn::crt::CRTTrack& track2);
 
     // Get all the true particle IDs that contributed to the CRT data product
     std::vector<int> AllTrueIds(const art::Event& event, const sbnd::crt::CRTData& data);
@@ -93,29 +95,48 @@ namespace sbnd{
     // Get the true particle ID that contributed the most energy to the CRT data product
     int TrueIdFromTotalEnergy(const art::Event& event, const sbnd::crt::CRTData& data);
     // Faster function - needs Initialize() to be called first
-    int TrueIdFromDataId(const art::Event& event, int data_i);
+    int TrueIdFromDataId(const art::Event& event, int data_i) const;
 
     // Get the true particle ID that contributed the most energy to the CRT hit
     int TrueIdFromTotalEnergy(const art::Event& event, const sbn::crt::CRTHit& hit);
     // Faster function - needs Initialize() to be called first
-    int TrueIdFromHitId(const art::Event& event, int hit_i);
+    int TrueIdFromHitId(const art::Event& event, int hit_i) const;
 
     // Get the true particle ID that contributed the most energy to the CRT track
     int TrueIdFromTotalEnergy(const art::Event& event, const sbn::crt::CRTTrack& track);
     // Faster function - needs Initialize() to be called first
-    int TrueIdFromTrackId(const art::Event& event, int track_i);
+    int TrueIdFromTrackId(const art::Event& event, int track_i) const;
 
   private:
 
+    // (true ID, deposited energy) pairs of every object in a product, stored
+    // contiguously and sorted by true ID within each object
+    struct TrueIdTable {
+      std::vector<size_t> begin; // objects + 1 offsets into ids
+      std::vector<std::pair<int, double>> ids;
+
+      void Clear();
+      // Append the next object, summing repeated true IDs
+      void Add(std::vector<std::pair<int, double>>& objectIds);
+      // True ID with the most energy for an object, -99999 if none
+      int DominantId(size_t object_i) const;
+    };
+
+    // Sum the energies of repeated true IDs, in order of appearance, and sort by ID
+    static void MergeTrueIds(std::vector<std::pair<int, double>>& ids);
+
+    // True ID with the most energy, the lowest one on ties
+    static int DominantTrueId(const std::pair<int, double>* begin, const std::pair<int, double>* end);
+
     art::InputTag fCRTDataLabel;
     art::InputTag fCRTHitLabel;
     art::InputTag fCRTTrackLabel;
 
     bool fRollupUnsavedIds;
 
-    std::map<int, std::map<int, double>> fDataTrueIds;
-    std::map<int, std::map<int, double>> fHitTrueIds;
-    std::map<int, std::map<int, double>> fTrackTrueIds;
+    TrueIdTable fDataTrueIds;
+    TrueIdTable fHitTrueIds;
+    TrueIdTable fTrackTrueIds;
 
   };
 
@@ -1,7 +1,172 @@
 #include "sbndcode/CRT/CRTUtils/CRTCommonUtils.h"
 
+#include <cmath>
+
 namespace sbnd{
 
+namespace{
+
+  // Plain coordinates for the distance kernels, the TVector3 versions forward to these
+  struct Vec { double x; double y; double z; };
+
+  Vec Sub(const Vec& a, const Vec& b){ return {a.x - b.x, a.y - b.y, a.z - b.z}; }
+  double Dot(const Vec& a, const Vec& b){ return a.x*b.x + a.y*b.y + a.z*b.z; }
+  double Mag(const Vec& a){ return std::sqrt(a.x*a.x + a.y*a.y + a.z*a.z); }
+
+  // Distance between infinite line (2) and segment (1)
+  double SegmentDistance(const Vec& start1, const Vec& end1, const Vec& start2, const Vec& end2){
+
+    double smallNum = 0.00001;
+
+    Vec u = Sub(end1, start1);
+    Vec v = Sub(end2, start2);
+    Vec w = Sub(start1, start2);
+
+    double a = Dot(u, u);
+    double b = Dot(u, v);
+    double c = Dot(v, v);
+    double d = Dot(u, w);
+    double e = Dot(v, w);
+    double D = a * c - b * b;
+    double sc, sN, sD = D;
+    double tc, tN, tD = D;
+
+    if(D < smallNum){
+      sN = 0.0;
+      sD = 1.0;
+      tN = e;
+      tD = c;
+    }
+    else{
+      sN = (b * e - c * d)/D;
+      tN = (a * e - b * d)/D;
+      if(sN < 0.){
+        sN = 0.;
+        tN = e;
+        tD = c;
+      }
+      else if(sN > sD){
+        sN = sD;
+        tN = e + b;
+        tD = c;
+      }
+    }
+
+    sc = (std::abs(sN) < smallNum ? 0.0 : sN / sD);
+    tc = (std::abs(tN) < smallNum ? 0.0 : tN / tD);
+    Vec dP {w.x + sc * u.x - tc * v.x, w.y + sc * u.y - tc * v.y, w.z + sc * u.z - tc * v.z};
+
+    return Mag(dP);
+
+  }
+
+  // Line parameters where the infinite line through start and end enters and leaves
+  // an axis-aligned cube, false if it misses the cube
+  bool CubeCrossing(const Vec& min, const Vec& max, const Vec& start, const Vec& end,
+                    double& tmin, double& tmax){
+
+    Vec dir = Sub(end, start);
+    Vec invDir {1./dir.x, 1./dir.y, 1/dir.z};
+
+    double tymin, tymax, tzmin, tzmax;
+
+    // Find the intersections with the X plane
+    if(invDir.x >= 0){
+      tmin = (min.x - start.x) * invDir.x;
+      tmax = (max.x - start.x) * invDir.x;
+    }
+    else{
+      tmin = (max.x - start.x) * invDir.x;
+      tmax = (min.x - start.x) * invDir.x;
+    }
+
+    // Find the intersections with the Y plane
+    if(invDir.y >= 0){
+      tymin = (min.y - start.y) * invDir.y;
+      tymax = (max.y - start.y) * invDir.y;
+    }
+    else{
+      tymin = (max.y - start.y) * invDir.y;
+      tymax = (min.y - start.y) * invDir.y;
+    }
+
+    // Check that it actually intersects
+    if((tmin > tymax) || (tymin > tmax)) return false;
+
+    // Max of the min points and min of the max points are the actual intersections
+    if(tymin > tmin) tmin = tymin;
+    if(tymax < tmax) tmax = tymax;
+
+    // Find the intersection with the Z plane
+    if(invDir.z >= 0){
+      tzmin = (min.z - start.z) * invDir.z;
+      tzmax = (max.z - start.z) * invDir.z;
+    }
+    else{
+      tzmin = (max.z - start.z) * invDir.z;
+      tzmax = (min.z - start.z) * invDir.z;
+    }
+
+    // Check for intersection
+    if((tmin > tzmax) || (tzmin > tmax)) return false;
+
+    // Find final intersection points
+    if(tzmin > tmin) tmin = tzmin;
+    if(tzmax < tmax) tmax = tzmax;
+
+    return true;
+
+  }
+
+  // Same as checking the entry point of CRTCommonUtils::CubeIntersection
+  bool CubeIntersects(const Vec& min, const Vec& max, const Vec& start, const Vec& end){
+
+    double tmin, tmax;
+    if(!CubeCrossing(min, max, start, end, tmin, tmax)) return false;
+
+    // The entry point is used as the no intersection flag
+    return start.x + tmin * (end.x - start.x) != -99999;
+
+  }
+
+  // Same as CRTCommonUtils::DistToCrtHit for a hit box
+  double BoxDistance(double x, double y, double z, double xErr, double yErr, double zErr,
+                     const Vec& start, const Vec& end){
+
+    // Check if track goes inside hit
+    if(CubeIntersects({x - xErr, y - yErr, z - zErr}, {x + xErr, y + yErr, z + zErr}, start, end)) return 0;
+
+    // Calculate the closest distance to each edge of the CRT hit
+    // Assume min error is the fixed position of tagger
+    Vec vertex1 {x, y - yErr, z - zErr};
+    Vec vertex2 {x, y + yErr, z - zErr};
+    Vec vertex3 {x, y - yErr, z + zErr};
+    Vec vertex4 {x, y + yErr, z + zErr};
+    if(yErr < xErr && yErr < zErr){
+      vertex1 = {x - xErr, y, z - zErr};
+      vertex2 = {x + xErr, y, z - zErr};
+      vertex3 = {x - xErr, y, z + zErr};
+      vertex4 = {x + xErr, y, z + zErr};
+    }
+    if(zErr < xErr && zErr < yErr){
+      vertex1 = {x - xErr, y - yErr, z};
+      vertex2 = {x + xErr, y - yErr, z};
+      vertex3 = {x - xErr, y + yErr, z};
+      vertex4 = {x + xErr, y + yErr, z};
+    }
+
+    double dist1 = SegmentDistance(vertex1, vertex2, start, end);
+    double dist2 = SegmentDistance(vertex1, vertex3, start, end);
+    double dist3 = SegmentDistance(vertex4, vertex2, start, end);
+    double dist4 = SegmentDistance(vertex4, vertex3, start, end);
+
+    return std::min(std::min(dist1, dist2), std::min(dist3, dist4));
+
+  }
+
+}
+
+
 // Simple distance of closest approach between infinite track and centre of hit
 double CRTCommonUtils::SimpleDCA(sbn::crt::CRTHit hit, TVector3 start, TVector3 direction){
 
@@ -14,38 +179,10 @@ double CRTCommonUtils::SimpleDCA(sbn::crt::CRTHit hit, TVector3 start, TVector3
 }
 
 // Minimum distance from infinite track to CRT hit assuming that hit is a 2D square
-double CRTCommonUtils::DistToCrtHit(sbn::crt::CRTHit hit, TVector3 start, TVector3 end){
-
-  // Check if track goes inside hit
-  TVector3 min (hit.x_pos - hit.x_err, hit.y_pos - hit.y_err, hit.z_pos - hit.z_err);
-  TVector3 max (hit.x_pos + hit.x_err, hit.y_pos + hit.y_err, hit.z_pos + hit.z_err);
-  if(CubeIntersection(min, max, start, end).first.X() != -99999) return 0;
-
-  // Calculate the closest distance to each edge of the CRT hit
-  // Assume min error is the fixed position of tagger
-  TVector3 vertex1 (hit.x_pos, hit.y_pos - hit.y_err, hit.z_pos - hit.z_err);
-  TVector3 vertex2 (hit.x_pos, hit.y_pos + hit.y_err, hit.z_pos - hit.z_err);
-  TVector3 vertex3 (hit.x_pos, hit.y_pos - hit.y_err, hit.z_pos + hit.z_err);
-  TVector3 vertex4 (hit.x_pos, hit.y_pos + hit.y_err, hit.z_pos + hit.z_err);
-  if(hit.y_err < hit.x_err && hit.y_err < hit.z_err){
-    vertex1.SetXYZ(hit.x_pos - hit.x_err, hit.y_pos, hit.z_pos - hit.z_err);
-    vertex2.SetXYZ(hit.x_pos + hit.x_err, hit.y_pos, hit.z_pos - hit.z_err);
-    vertex3.SetXYZ(hit.x_pos - hit.x_err, hit.y_pos, hit.z_pos + hit.z_err);
-    vertex4.SetXYZ(hit.x_pos + hit.x_err, hit.y_pos, hit.z_pos + hit.z_err);
-  }
-  if(hit.z_err < hit.x_err && hit.z_err < hit.y_err){
-    vertex1.SetXYZ(hit.x_pos - hit.x_err, hit.y_pos - hit.y_err, hit.z_pos);
-    vertex2.SetXYZ(hit.x_pos + hit.x_err, hit.y_pos - hit.y_err, hit.z_pos);
-    vertex3.SetXYZ(hit.x_pos - hit.x_err, hit.y_pos + hit.y_err, hit.z_pos);
-    vertex4.SetXYZ(hit.x_pos + hit.x_err, hit.y_pos + hit.y_err, hit.z_pos);
-  }
-
-  double dist1 = LineSegmentDistance(vertex1, vertex2, start, end);
-  double dist2 = LineSegmentDistance(vertex1, vertex3, start, end);
-  double dist3 = LineSegmentDistance(vertex4, vertex2, start, end);
-  double dist4 = LineSegmentDistance(vertex4, vertex3, start, end);
+double CRTCommonUtils::DistToCrtHit(const sbn::crt::CRTHit& hit, const TVector3& start, const TVector3& end){
 
-  return std::min(std::min(dist1, dist2), std::min(dist3, dist4));
+  return BoxDistance(hit.x_pos, hit.y_pos, hit.z_pos, hit.x_err, hit.y_err, hit.z_err,
+                     {start.X(), start.Y(), start.Z()}, {end.X(), end.Y(), end.Z()});
 
 }
 
@@ -54,54 +191,8 @@ double CRTCommonUtils::DistToCrtHit(sbn::crt::CRTHit hit, TVector3 start, TVecto
 // http://geomalgorithms.com/a07-_distance.html
 double CRTCommonUtils::LineSegmentDistance(TVector3 start1, TVector3 end1, TVector3 start2, TVector3 end2){
 
-  double smallNum = 0.00001;
-
-  // 1 is segment
-  TVector3 direction1 = end1 - start1;
-  // 2 is infinite line
-  TVector3 direction2 = end2 - start2;
-
-  TVector3 u = direction1;
-  TVector3 v = direction2;
-  TVector3 w = start1 - start2;
-
-  double a = u.Dot(u);
-  double b = u.Dot(v);
-  double c = v.Dot(v);
-  double d = u.Dot(w);
-  double e = v.Dot(w);
-  double D = a * c - b * b;
-  double sc, sN, sD = D; // sc = sN/sD
-  double tc, tN, tD = D; // sc = sN/sD
-
-  // Compute the line parameters of the two closest points
-  if(D < smallNum){ // Lines are almost parallel
-    sN = 0.0;
-    sD = 1.0;
-    tN = e;
-    tD = c;
-  }
-  else{
-    sN = (b * e - c * d)/D;
-    tN = (a * e - b * d)/D;
-    if(sN < 0.){ // sc < 0, the s = 0 edge is visible
-      sN = 0.;
-      tN = e;
-      tD = c;
-    }
-    else if(sN > sD){ // sc > 1, the s = 1 edge is visible
-      sN = sD;
-      tN = e + b;
-      tD = c;
-    } 
-  }
-
-  sc = (std::abs(sN) < smallNum ? 0.0 : sN / sD);
-  tc = (std::abs(tN) < smallNum ? 0.0 : tN / tD);
-  // Get the difference of the two closest points
-  TVector3 dP = w + (sc * u) - (tc * v);
-
-  return dP.Mag();
+  return SegmentDistance({start1.X(), start1.Y(), start1.Z()}, {end1.X(), end1.Y(), end1.Z()},
+                         {start2.X(), start2.Y(), start2.Z()}, {end2.X(), end2.Y(), end2.Z()});
 
 }
 
@@ -109,76 +200,79 @@ double CRTCommonUtils::LineSegmentDistance(TVector3 start1, TVector3 end1, TVect
 // (https://www.scratchapixel.com/lessons/3d-basic-rendering/minimal-ray-tracer-rendering-simple-shapes/ray-box-intersection)
 std::pair<TVector3, TVector3> CRTCommonUtils::CubeIntersection(TVector3 min, TVector3 max, TVector3 start, TVector3 end){
 
-  TVector3 dir = (end - start);
-  TVector3 invDir (1./dir.X(), 1./dir.Y(), 1/dir.Z());
-
-  double tmin, tmax, tymin, tymax, tzmin, tzmax;
-
   TVector3 enter (-99999, -99999, -99999);
   TVector3 exit (-99999, -99999, -99999);
 
-  // Find the intersections with the X plane
-  if(invDir.X() >= 0){
-    tmin = (min.X() - start.X()) * invDir.X();
-    tmax = (max.X() - start.X()) * invDir.X();
-  }
-  else{
-    tmin = (max.X() - start.X()) * invDir.X();
-    tmax = (min.X() - start.X()) * invDir.X();
+  double tmin, tmax;
+  if(!CubeCrossing({min.X(), min.Y(), min.Z()}, {max.X(), max.Y(), max.Z()},
+                   {start.X(), start.Y(), start.Z()}, {end.X(), end.Y(), end.Z()}, tmin, tmax)){
+    return std::make_pair(enter, exit);
   }
 
-  // Find the intersections with the Y plane
-  if(invDir.Y() >= 0){
-    tymin = (min.Y() - start.Y()) * invDir.Y();
-    tymax = (max.Y() - start.Y()) * invDir.Y();
-  }
-  else{
-    tymin = (max.Y() - start.Y()) * invDir.Y();
-    tymax = (min.Y() - start.Y()) * invDir.Y();
-  }
+  // Return pair of entry and exit points
+  TVector3 dir = (end - start);
+  enter.SetXYZ(start.X() + tmin * dir.X(), start.Y() + tmin * dir.Y(), start.Z() + tmin * dir.Z());
+  exit.SetXYZ(start.X() + tmax * dir.X(), start.Y() + tmax * dir.Y(), start.Z() + tmax * dir.Z());
+  return std::make_pair(enter, exit);
 
-  // Check that it actually intersects
-  if((tmin > tymax) || (tymin > tmax)) return std::make_pair(enter, exit);
+}
 
-  // Max of the min points is the actual intersection
-  if(tymin > tmin) tmin = tymin;
+void CRTCommonUtils::CRTHitArrays::Reserve(size_t n){
 
-  // Min of the max points is the actual intersection
-  if(tymax < tmax) tmax = tymax;
+  x.reserve(n);
+  y.reserve(n);
+  z.reserve(n);
+  xErr.reserve(n);
+  yErr.reserve(n);
+  zErr.reserve(n);
 
-  // Find the intersection with the Z plane
-  if(invDir.Z() >= 0){
-    tzmin = (min.Z() - start.Z()) * invDir.Z();
-    tzmax = (max.Z() - start.Z()) * invDir.Z();
-  }
-  else{
-    tzmin = (max.Z() - start.Z()) * invDir.Z();
-    tzmax = (min.Z() - start.Z()) * invDir.Z();
-  }
+}
 
-  // Check for intersection
-  if((tmin > tzmax) || (tzmin > tmax)) return std::make_pair(enter, exit);
+void CRTCommonUtils::CRTHitArrays::Add(const sbn::crt::CRTHit& hit){
 
-  // Find final intersection points
-  if(tzmin > tmin) tmin = tzmin;
+  x.push_back(hit.x_pos);
+  y.push_back(hit.y_pos);
+  z.push_back(hit.z_pos);
+  xErr.push_back(hit.x_err);
+  yErr.push_back(hit.y_err);
+  zErr.push_back(hit.z_err);
 
-  // Find final intersection points
-  if(tzmax < tmax) tmax = tzmax;
+}
 
-  // Calculate the actual crossing points
-  double xmin = start.X() + tmin * dir.X();
-  double xmax = start.X() + tmax * dir.X();
-  double ymin = start.Y() + tmin * dir.Y();
-  double ymax = start.Y() + tmax * dir.Y();
-  double zmin = start.Z() + tmin * dir.Z();
-  double zmax = start.Z() + tmax * dir.Z();
+// Same as DistToCrtHit for the hit at i in the arrays
+double CRTCommonUtils::DistToCrtHit(const CRTHitArrays& hits, size_t i, const double start[3], const double end[3]){
 
-  // Return pair of entry and exit points
-  enter.SetXYZ(xmin, ymin, zmin);
-  exit.SetXYZ(xmax, ymax, zmax);
-  return std::make_pair(enter, exit);
+  return BoxDistance(hits.x[i], hits.y[i], hits.z[i], hits.xErr[i], hits.yErr[i], hits.zErr[i],
+                     {start[0], start[1], start[2]}, {end[0], end[1], end[2]});
 
 }
 
+// Average distance of the points shifted in x from the infinite line through start and end
+double CRTCommonUtils::AveDistToLine(const PointArrays& points, double shiftX, const TVector3& start, const TVector3& end){
+
+  const double sx = start.X(), sy = start.Y(), sz = start.Z();
+  const double ex = end.X(), ey = end.Y(), ez = end.Z();
+  const double denominator = Mag({ex - sx, ey - sy, ez - sz});
+
+  const double* px = points.x.data();
+  const double* py = points.y.data();
+  const double* pz = points.z.data();
+  const size_t n = points.Size();
+
+  double aveDist = 0;
+  for(size_t i = 0; i < n; i++){
+    double x = px[i] + shiftX;
+    // (p - start) x (p - end)
+    double ax = x - sx, ay = py[i] - sy, az = pz[i] - sz;
+    double bx = x - ex, by = py[i] - ey, bz = pz[i] - ez;
+    double cx = ay*bz - by*az;
+    double cy = az*bx - bz*ax;
+    double cz = ax*by - bx*ay;
+    aveDist += std::sqrt(cx*cx + cy*cy + cz*cz)/denominator;
+  }
+
+  return aveDist/(int)n;
+
 }
 
+}
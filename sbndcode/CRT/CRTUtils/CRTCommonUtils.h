@@ -12,6 +12,9 @@
 #include "sbnobj/Common/CRT/CRTHit.hh"
 
 // c++
+#include <algorithm>
+#include <exception>
+#include <thread>
 #include <vector>
 #include <utility>
 
@@ -25,7 +28,7 @@ namespace CRTCommonUtils{
   double SimpleDCA(sbn::crt::CRTHit hit, TVector3 start, TVector3 direction);
 
   // Minimum distance from infinite track to CRT hit assuming that hit is a 2D square
-  double DistToCrtHit(sbn::crt::CRTHit hit, TVector3 start, TVector3 end);
+  double DistToCrtHit(const sbn::crt::CRTHit& hit, const TVector3& start, const TVector3& end);
 
   // Distance between infinite line (2) and segment (1)
   // http://geomalgorithms.com/a07-_distance.html
@@ -35,6 +38,66 @@ namespace CRTCommonUtils{
   // (https://www.scratchapixel.com/lessons/3d-basic-rendering/minimal-ray-tracer-rendering-simple-shapes/ray-box-intersection)
   std::pair<TVector3, TVector3> CubeIntersection(TVector3 min, TVector3 max, TVector3 start, TVector3 end);
 
+  // Points stored as one array per coordinate, so that the distance kernels sweep
+  // over contiguous memory
+  struct PointArrays {
+    std::vector<double> x;
+    std::vector<double> y;
+    std::vector<double> z;
+
+    size_t Size() const {return x.size();}
+    void Reserve(size_t n){x.reserve(n); y.reserve(n); z.reserve(n);}
+    void Add(double px, double py, double pz){x.push_back(px); y.push_back(py); z.push_back(pz);}
+  };
+
+  // CRT hit positions and errors stored as one array per coordinate
+  struct CRTHitArrays {
+    std::vector<double> x;
+    std::vector<double> y;
+    std::vector<double> z;
+    std::vector<double> xErr;
+    std::vector<double> yErr;
+    std::vector<double> zErr;
+
+    size_t Size() const {return x.size();}
+    void Reserve(size_t n);
+    void Add(const sbn::crt::CRTHit& hit);
+  };
+
+  // Same as DistToCrtHit for the hit at i in the arrays, start and end are {x, y, z}
+  double DistToCrtHit(const CRTHitArrays& hits, size_t i, const double start[3], const double end[3]);
+
+  // Average distance of the points shifted in x from the infinite line through start and end,
+  // same as averaging |(p - start) x (p - end)|/|end - start| over the points
+  double AveDistToLine(const PointArrays& points, double shiftX, const TVector3& start, const TVector3& end);
+
+  // Call func(i) for i in [0, n), split into contiguous blocks over up to nThreads threads
+  // Exceptions thrown by the workers are rethrown in the calling thread
+  template<class Func>
+  void ParallelFor(size_t n, unsigned nThreads, Func&& func){
+    size_t nBlocks = std::min<size_t>(std::max(nThreads, 1u), n);
+    if(nBlocks <= 1){
+      for(size_t i = 0; i < n; i++) func(i);
+      return;
+    }
+    std::vector<std::thread> threads;
+    std::vector<std::exception_ptr> errors(nBlocks);
+    for(size_t block = 0; block < nBlocks; block++){
+      threads.emplace_back([&, block]{
+        try{
+          for(size_t i = block * n / nBlocks; i < (block + 1) * n / nBlocks; i++) func(i);
+        }
+        catch(...){
+          errors[block] = std::current_exception();
+        }
+      });
+    }
+    for(auto& thread : threads) thread.join();
+    for(auto const& error : errors){
+      if(error) std::rethrow_exception(error);
+    }
+  }
+
 }
 }
 
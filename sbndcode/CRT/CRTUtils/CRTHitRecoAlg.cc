@@ -2,6 +2,9 @@
 
 #include "lardataalg/DetectorInfo/DetectorClocksData.h"
 
+#include <algorithm>
+#include <iterator>
+
 namespace sbnd{
 
 CRTHitRecoAlg::CRTHitRecoAlg(const Config& config){
@@ -10,10 +13,27 @@ CRTHitRecoAlg::CRTHitRecoAlg(const Config& config){
 }
 
 
+CRTHitRecoAlg::CRTHitRecoAlg(const Config& config, geo::GeometryCore const *geometry,
+                             geo::AuxDetGeometryCore const *auxdet_geometry) :
+  fTpcGeo(geometry),
+  fCrtGeo(geometry, auxdet_geometry)
+{
+
+  this->reconfigure(config);
+}
+
+
 CRTHitRecoAlg::CRTHitRecoAlg(){
 }
 
 
+CRTHitRecoAlg::CRTHitRecoAlg(geo::GeometryCore const *geometry, geo::AuxDetGeometryCore const *auxdet_geometry) :
+  fTpcGeo(geometry),
+  fCrtGeo(geometry, auxdet_geometry)
+{
+}
+
+
 CRTHitRecoAlg::~CRTHitRecoAlg(){
 
 }
@@ -95,8 +115,7 @@ CRTStrip CRTHitRecoAlg::CreateCRTStrip(art::Ptr<sbnd::crt::CRTData> sipm1, art::
 std::pair<double, double> CRTHitRecoAlg::DistanceBetweenSipms(art::Ptr<sbnd::crt::CRTData> sipm1, art::Ptr<sbnd::crt::CRTData> sipm2){
   
   uint32_t channel = sipm1->Channel();
-  std::string stripName = fCrtGeo.ChannelToStripName(channel);
-  double width = fCrtGeo.GetStrip(stripName).width;
+  double width = fCrtGeo.ChannelToStrip(channel).width;
 
   // Calculate the number of photoelectrons at each SiPM
   double npe1 = ((double)sipm1->ADC() - fQPed)/fQSlope;
@@ -114,149 +133,248 @@ std::pair<double, double> CRTHitRecoAlg::DistanceBetweenSipms(art::Ptr<sbnd::crt
 }
 
 
-std::vector<std::pair<sbn::crt::CRTHit, std::vector<int>>> CRTHitRecoAlg::CreateCRTHits(std::map<std::pair<std::string, unsigned>, std::vector<CRTStrip>> taggerStrips){
+CRTTaggerStrips CRTHitRecoAlg::CreateTaggerStripBuffer(detinfo::DetectorClocksData const& clockData,
+                                                       detinfo::DetectorPropertiesData const& detProp,
+                                                       const std::vector<art::Ptr<sbnd::crt::CRTData>>& crtList){
 
-  std::vector<std::pair<sbn::crt::CRTHit, std::vector<int>>> returnHits;
+  double readoutWindowMuS  = clockData.TPCTick2Time((double)detProp.ReadOutWindowSize()); // [us]
+  double driftTimeMuS = fTpcGeo.MaxX()/detProp.DriftVelocity(); // [us]
 
-  std::vector<uint8_t> tfeb_id = {0};
-  std::map<uint8_t, std::vector<std::pair<int,float>>> tpesmap;
-  tpesmap[0] = {std::make_pair(0,0)};
-  
-  // Remove any duplicate (same channel and time) hit strips
-  for(auto &tagStrip : taggerStrips){
-    std::sort(tagStrip.second.begin(), tagStrip.second.end(),
+  std::vector<CRTStrip> strips;
+  strips.reserve(crtList.size()/2);
+
+  for (size_t i = 0; i < crtList.size(); i+=2){
+
+    double t1 = (double)(int)crtList[i]->T0()/fClockSpeedCRT; // [tick -> us]
+    if(fUseReadoutWindow){
+      if(!(t1 >= -driftTimeMuS && t1 <= readoutWindowMuS)) continue;
+    }
+
+    strips.push_back(CreateCRTStrip(crtList[i], crtList[i+1], i));
+
+  }
+
+  return GroupTaggerStrips(strips);
+
+}
+
+
+CRTTaggerStrips CRTHitRecoAlg::CreateTaggerStripBuffer(const std::map<std::pair<std::string, unsigned>, std::vector<CRTStrip>>& taggerStrips){
+
+  std::vector<CRTStrip> strips;
+  for(auto const& tagStrip : taggerStrips){
+    strips.insert(strips.end(), tagStrip.second.begin(), tagStrip.second.end());
+  }
+
+  return GroupTaggerStrips(strips);
+
+}
+
+
+// Group strips by tagger and plane, keeping their order, then sort and remove duplicates
+CRTTaggerStrips CRTHitRecoAlg::GroupTaggerStrips(const std::vector<CRTStrip>& strips){
+
+  size_t nGroups = 2 * fCrtGeo.NumTaggers();
+
+  // Group index of each strip from its channel
+  std::vector<size_t> groups(strips.size(), nGroups);
+  std::vector<size_t> counts(nGroups + 1, 0);
+  for(size_t strip_i = 0; strip_i < strips.size(); strip_i++){
+    const CRTModuleGeo& module = fCrtGeo.GetModule(fCrtGeo.ChannelToStrip(strips[strip_i].channel).moduleIndex);
+    if(module.null){
+      mf::LogWarning("CRTHitRecoAlg") << "No CRT strip for channel " << strips[strip_i].channel << ", skipping";
+      continue;
+    }
+    groups[strip_i] = 2 * module.taggerIndex + (module.planeID == 0 ? 0 : 1);
+    counts[groups[strip_i] + 1]++;
+  }
+
+  CRTTaggerStrips taggerStrips;
+  taggerStrips.begin.resize(nGroups);
+  taggerStrips.end.resize(nGroups);
+  for(size_t group = 0; group < nGroups; group++){
+    taggerStrips.begin[group] = counts[group];
+    counts[group + 1] += counts[group];
+  }
+
+  // Stable counting sort into the flat buffer
+  taggerStrips.strips.resize(counts[nGroups]);
+  std::vector<size_t> next = taggerStrips.begin;
+  for(size_t strip_i = 0; strip_i < strips.size(); strip_i++){
+    if(groups[strip_i] == nGroups) continue;
+    taggerStrips.strips[next[groups[strip_i]]++] = strips[strip_i];
+  }
+
+  // Remove any duplicate (same channel and time) hit strips, leaving a gap at the end of the group
+  for(size_t group = 0; group < nGroups; group++){
+    auto begin = taggerStrips.strips.begin() + taggerStrips.begin[group];
+    auto end = taggerStrips.strips.begin() + next[group];
+    std::sort(begin, end,
               [](const CRTStrip & a, const CRTStrip & b) -> bool{
                 return (a.t0 < b.t0) || 
                        ((a.t0 == b.t0) && (a.channel < b.channel));
               });
-    // Remove hits with the same time and channel
-    tagStrip.second.erase(std::unique(tagStrip.second.begin(), tagStrip.second.end(),
-                                         [](const CRTStrip & a, const CRTStrip & b) -> bool{
-                                           return a.t0 == b.t0 && a.channel == b.channel;
-                                          }), tagStrip.second.end());
+    end = std::unique(begin, end,
+                      [](const CRTStrip & a, const CRTStrip & b) -> bool{
+                        return a.t0 == b.t0 && a.channel == b.channel;
+                      });
+    taggerStrips.end[group] = end - taggerStrips.strips.begin();
   }
 
-  std::vector<std::string> usedTaggers;
-
-  for (auto &tagStrip : taggerStrips){
-    if (std::find(usedTaggers.begin(),usedTaggers.end(),tagStrip.first.first)!=usedTaggers.end()) continue;
-    usedTaggers.push_back(tagStrip.first.first);
-    unsigned planeID = 0;
-    if(tagStrip.first.second==0) planeID = 1;
-    std::pair<std::string,unsigned> otherPlane = std::make_pair(tagStrip.first.first, planeID);
-
-    for (size_t hit_i = 0; hit_i < tagStrip.second.size(); hit_i++){
-      // Get the position (in real space) of the 4 corners of the hit, taking charge sharing into account
-      std::vector<double> limits1 =  ChannelToLimits(tagStrip.second[hit_i]);
-
-      // Check for overlaps on the first plane
-      if(CheckModuleOverlap(tagStrip.second[hit_i].channel)){
-
-        // Loop over all the hits on the parallel (odd) plane
-        for (size_t hit_j = 0; hit_j < taggerStrips[otherPlane].size(); hit_j++){
-          // Get the limits in the two variable directions
-          std::vector<double> limits2 = ChannelToLimits(taggerStrips[otherPlane][hit_j]);
-
-          // If the time and position match then record the pair of hits
-          std::vector<double> overlap = CrtOverlap(limits1, limits2);
-          double t0_1 = tagStrip.second[hit_i].t0;
-          double t0_2 = taggerStrips[otherPlane][hit_j].t0;
-          if (overlap[0] != -99999 && std::abs(t0_1 - t0_2) < fTimeCoincidenceLimit){
-            // Calculate the mean and error in x, y, z
-            TVector3 mean((overlap[0] + overlap[1])/2., 
-                          (overlap[2] + overlap[3])/2., 
-                          (overlap[4] + overlap[5])/2.);
-            TVector3 error(std::abs((overlap[1] - overlap[0])/2.), 
-                           std::abs((overlap[3] - overlap[2])/2.), 
-                           std::abs((overlap[5] - overlap[4])/2.));
-
-            // Average the time
-            double time = (t0_1 + t0_2)/2;
-            //double pes = tagStrip.second[hit_i].pes + taggerStrips[otherPlane][hit_j].pes;
-            double pes = CorrectNpe(tagStrip.second[hit_i], taggerStrips[otherPlane][hit_j], mean);
-
-            // Create a CRT hit
-            sbn::crt::CRTHit crtHit = FillCrtHit(tfeb_id, tpesmap, pes, time, 0, mean.X(), error.X(), 
-                                            mean.Y(), error.Y(), mean.Z(), error.Z(), tagStrip.first.first);
-            std::vector<int> dataIds;
-            dataIds.push_back(tagStrip.second[hit_i].dataID);
-            dataIds.push_back(tagStrip.second[hit_i].dataID+1);
-            dataIds.push_back(taggerStrips[otherPlane][hit_j].dataID);
-            dataIds.push_back(taggerStrips[otherPlane][hit_j].dataID+1);
-            returnHits.push_back(std::make_pair(crtHit, dataIds));
-          }
-
-        }
+  return taggerStrips;
 
-      }
-      // If module doesn't overlap with a perpendicular one create 1D hits
-      else{
-        TVector3 mean((limits1[0] + limits1[1])/2., 
-                      (limits1[2] + limits1[3])/2., 
-                      (limits1[4] + limits1[5])/2.);
-        TVector3 error(std::abs((limits1[1] - limits1[0])/2.), 
-                       std::abs((limits1[3] - limits1[2])/2.), 
-                       std::abs((limits1[5] - limits1[4])/2.));
-
-        double time = tagStrip.second[hit_i].t0;
-        double pes = tagStrip.second[hit_i].pes;
-
-        // Just use the single plane limits as the crt hit
-        sbn::crt::CRTHit crtHit = FillCrtHit(tfeb_id, tpesmap, pes, time, 0, mean.X(), error.X(), 
-                                        mean.Y(), error.Y(), mean.Z(), error.Z(), tagStrip.first.first);
-        std::vector<int> dataIds;
-        dataIds.push_back(tagStrip.second[hit_i].dataID);
-        dataIds.push_back(tagStrip.second[hit_i].dataID+1);
-        returnHits.push_back(std::make_pair(crtHit, dataIds));
-      }
+}
 
-    }
-    // Loop over tagger modules on the perpendicular plane to look for 1D hits
-    for (size_t hit_j = 0; hit_j < taggerStrips[otherPlane].size(); hit_j++){
-      // Get the limits in the two variable directions
-      std::vector<double> limits1 = ChannelToLimits(taggerStrips[otherPlane][hit_j]);
-
-      // Check if module overlaps with a perpendicular one
-      if(!CheckModuleOverlap(taggerStrips[otherPlane][hit_j].channel)){
-        TVector3 mean((limits1[0] + limits1[1])/2., 
-                      (limits1[2] + limits1[3])/2., 
-                      (limits1[4] + limits1[5])/2.);
-        TVector3 error(std::abs((limits1[1] - limits1[0])/2.), 
-                       std::abs((limits1[3] - limits1[2])/2.), 
-                       std::abs((limits1[5] - limits1[4])/2.));
-
-        double time = taggerStrips[otherPlane][hit_j].t0;
-        double pes = taggerStrips[otherPlane][hit_j].pes;
-
-        // Just use the single plane limits as the crt hit
+
+std::vector<std::pair<sbn::crt::CRTHit, std::vector<int>>> CRTHitRecoAlg::CreateCRTHits(const std::map<std::pair<std::string, unsigned>, std::vector<CRTStrip>>& taggerStrips){
+
+  return CreateCRTHits(CreateTaggerStripBuffer(taggerStrips));
+
+}
+
+
+std::vector<std::pair<sbn::crt::CRTHit, std::vector<int>>> CRTHitRecoAlg::CreateCRTHits(const CRTTaggerStrips& taggerStrips, unsigned nThreads){
+
+  // Taggers are independent, reconstruct each into its own list
+  size_t nTaggers = taggerStrips.begin.size() / 2;
+  std::vector<std::vector<std::pair<sbn::crt::CRTHit, std::vector<int>>>> taggerHits(nTaggers);
+  CRTCommonUtils::ParallelFor(nTaggers, nThreads, [&](size_t tagger_i){
+    CreateTaggerHits(taggerStrips, tagger_i, taggerHits[tagger_i]);
+  });
+
+  std::vector<std::pair<sbn::crt::CRTHit, std::vector<int>>> returnHits;
+  size_t nHits = 0;
+  for(auto const& hits : taggerHits) nHits += hits.size();
+  returnHits.reserve(nHits);
+  for(auto& hits : taggerHits){
+    std::move(hits.begin(), hits.end(), std::back_inserter(returnHits));
+  }
+
+  return returnHits;
+
+}
+
+
+// Reconstruct the hits of a single tagger
+void CRTHitRecoAlg::CreateTaggerHits(const CRTTaggerStrips& taggerStrips, size_t tagger_i,
+                                     std::vector<std::pair<sbn::crt::CRTHit, std::vector<int>>>& hits){
+
+  std::vector<uint8_t> tfeb_id = {0};
+  std::map<uint8_t, std::vector<std::pair<int,float>>> tpesmap;
+  tpesmap[0] = {std::make_pair(0,0)};
+
+  // Plane 0 strips are matched to the perpendicular plane 1 strips
+  auto const stripBegin = taggerStrips.strips.begin();
+  auto const begin1 = stripBegin + taggerStrips.begin[2 * tagger_i];
+  auto const end1 = stripBegin + taggerStrips.end[2 * tagger_i];
+  auto const begin2 = stripBegin + taggerStrips.begin[2 * tagger_i + 1];
+  auto const end2 = stripBegin + taggerStrips.end[2 * tagger_i + 1];
+  if(begin1 == end1 && begin2 == end2) return;
+
+  const std::string& tagger = fCrtGeo.GetTagger(tagger_i).name;
+
+  // Limits and overlap flags of the second plane are used for every strip on the first
+  std::vector<std::vector<double>> limits2;
+  std::vector<bool> overlap2;
+  for(auto strip = begin2; strip != end2; ++strip){
+    limits2.push_back(ChannelToLimits(*strip));
+    overlap2.push_back(CheckModuleOverlap(strip->channel));
+  }
+
+  for(auto strip1 = begin1; strip1 != end1; ++strip1){
+    // Get the position (in real space) of the 4 corners of the hit, taking charge sharing into account
+    std::vector<double> limits1 = ChannelToLimits(*strip1);
+
+    // Check for overlaps on the first plane
+    if(CheckModuleOverlap(strip1->channel)){
+
+      // Only the strips within the coincidence window can match, plane strips are sorted by time
+      double t0_1 = strip1->t0;
+      auto first = std::lower_bound(begin2, end2, t0_1 - 2 * fTimeCoincidenceLimit,
+                                    [](const CRTStrip& strip, double t0){ return strip.t0 < t0; });
+      for(auto strip2 = first; strip2 != end2 && strip2->t0 <= t0_1 + 2 * fTimeCoincidenceLimit; ++strip2){
+
+        // If the time and position match then record the pair of hits
+        double t0_2 = strip2->t0;
+        if (std::abs(t0_1 - t0_2) >= fTimeCoincidenceLimit) continue;
+        std::vector<double> overlap = CrtOverlap(limits1, limits2[strip2 - begin2]);
+        if (overlap[0] == -99999) continue;
+
+        // Calculate the mean and error in x, y, z
+        TVector3 mean((overlap[0] + overlap[1])/2., 
+                      (overlap[2] + overlap[3])/2., 
+                      (overlap[4] + overlap[5])/2.);
+        TVector3 error(std::abs((overlap[1] - overlap[0])/2.), 
+                       std::abs((overlap[3] - overlap[2])/2.), 
+                       std::abs((overlap[5] - overlap[4])/2.));
+
+        // Average the time
+        double time = (t0_1 + t0_2)/2;
+        double pes = CorrectNpe(*strip1, *strip2, mean);
+
+        // Create a CRT hit
         sbn::crt::CRTHit crtHit = FillCrtHit(tfeb_id, tpesmap, pes, time, 0, mean.X(), error.X(), 
-                                        mean.Y(), error.Y(), mean.Z(), error.Z(), otherPlane.first);
-        std::vector<int> dataIds;
-        dataIds.push_back(taggerStrips[otherPlane][hit_j].dataID);
-        dataIds.push_back(taggerStrips[otherPlane][hit_j].dataID+1);
-        returnHits.push_back(std::make_pair(crtHit, dataIds));
+                                             mean.Y(), error.Y(), mean.Z(), error.Z(), tagger);
+        std::vector<int> dataIds = {(int)strip1->dataID, (int)strip1->dataID+1,
+                                    (int)strip2->dataID, (int)strip2->dataID+1};
+        hits.emplace_back(std::move(crtHit), std::move(dataIds));
       }
 
     }
+    // If module doesn't overlap with a perpendicular one create 1D hits
+    else{
+      TVector3 mean((limits1[0] + limits1[1])/2., 
+                    (limits1[2] + limits1[3])/2., 
+                    (limits1[4] + limits1[5])/2.);
+      TVector3 error(std::abs((limits1[1] - limits1[0])/2.), 
+                     std::abs((limits1[3] - limits1[2])/2.), 
+                     std::abs((limits1[5] - limits1[4])/2.));
+
+      // Just use the single plane limits as the crt hit
+      sbn::crt::CRTHit crtHit = FillCrtHit(tfeb_id, tpesmap, strip1->pes, strip1->t0, 0, mean.X(), error.X(), 
+                                           mean.Y(), error.Y(), mean.Z(), error.Z(), tagger);
+      std::vector<int> dataIds = {(int)strip1->dataID, (int)strip1->dataID+1};
+      hits.emplace_back(std::move(crtHit), std::move(dataIds));
+    }
 
   }
 
-  return returnHits;
+  // Loop over tagger modules on the perpendicular plane to look for 1D hits
+  for(auto strip2 = begin2; strip2 != end2; ++strip2){
+
+    // Check if module overlaps with a perpendicular one
+    if(overlap2[strip2 - begin2]) continue;
+
+    const std::vector<double>& limits = limits2[strip2 - begin2];
+    TVector3 mean((limits[0] + limits[1])/2., 
+                  (limits[2] + limits[3])/2., 
+                  (limits[4] + limits[5])/2.);
+    TVector3 error(std::abs((limits[1] - limits[0])/2.), 
+                   std::abs((limits[3] - limits[2])/2.), 
+                   std::abs((limits[5] - limits[4])/2.));
+
+    // Just use the single plane limits as the crt hit
+    sbn::crt::CRTHit crtHit = FillCrtHit(tfeb_id, tpesmap, strip2->pes, strip2->t0, 0, mean.X(), error.X(), 
+                                         mean.Y(), error.Y(), mean.Z(), error.Z(), tagger);
+    std::vector<int> dataIds = {(int)strip2->dataID, (int)strip2->dataID+1};
+    hits.emplace_back(std::move(crtHit), std::move(dataIds));
+
+  }
 
 }
 
 
 // Function to calculate the strip position limits in real space from channel
-std::vector<double> CRTHitRecoAlg::ChannelToLimits(CRTStrip stripHit){
+std::vector<double> CRTHitRecoAlg::ChannelToLimits(const CRTStrip& stripHit){
 
-  std::string stripName = fCrtGeo.ChannelToStripName(stripHit.channel);
-  return fCrtGeo.StripLimitsWithChargeSharing(stripName, stripHit.x, stripHit.ex);
+  const CRTStripGeo& strip = fCrtGeo.ChannelToStrip(stripHit.channel);
+  return fCrtGeo.StripLimitsWithChargeSharing(strip, stripHit.x, stripHit.ex);
 
 } // CRTHitRecoAlg::ChannelToLimits()
 
 
 // Function to calculate the overlap between two crt strips
-std::vector<double> CRTHitRecoAlg::CrtOverlap(std::vector<double> strip1, std::vector<double> strip2){
+std::vector<double> CRTHitRecoAlg::CrtOverlap(const std::vector<double>& strip1, const std::vector<double>& strip2){
 
   // Get the minimum and maximum X, Y, Z coordinates
   double minX = std::max(strip1[0], strip2[0]);
@@ -280,9 +398,9 @@ std::vector<double> CRTHitRecoAlg::CrtOverlap(std::vector<double> strip1, std::v
 // Function to return the CRT tagger name and module position from the channel ID
 std::pair<std::string,unsigned> CRTHitRecoAlg::ChannelToTagger(uint32_t channel){
 
-  std::string stripName = fCrtGeo.ChannelToStripName(channel);
-  size_t planeID = fCrtGeo.GetModule(fCrtGeo.GetStrip(stripName).module).planeID;
-  std::string tagName = fCrtGeo.GetModule(fCrtGeo.GetStrip(stripName).module).tagger;
+  const CRTModuleGeo& module = fCrtGeo.GetModule(fCrtGeo.ChannelToStrip(channel).moduleIndex);
+  size_t planeID = module.planeID;
+  std::string tagName = module.tagger;
   
   std::pair<std::string, unsigned> output = std::make_pair(tagName, planeID);
 
@@ -294,16 +412,15 @@ std::pair<std::string,unsigned> CRTHitRecoAlg::ChannelToTagger(uint32_t channel)
 // Function to check if a CRT strip overlaps with a perpendicular module
 bool CRTHitRecoAlg::CheckModuleOverlap(uint32_t channel){
 
-  std::string stripName = fCrtGeo.ChannelToStripName(channel);
-  return fCrtGeo.StripHasOverlap(stripName);
+  return fCrtGeo.StripHasOverlap(fCrtGeo.ChannelToStrip(channel));
 
 } // CRTHitRecoAlg::CheckModuleOverlap
 
 
 // Function to make filling a CRTHit a bit faster
-sbn::crt::CRTHit CRTHitRecoAlg::FillCrtHit(std::vector<uint8_t> tfeb_id, std::map<uint8_t, 
-                              std::vector<std::pair<int,float>>> tpesmap, float peshit, double time, int plane, 
-                              double x, double ex, double y, double ey, double z, double ez, std::string tagger){
+sbn::crt::CRTHit CRTHitRecoAlg::FillCrtHit(const std::vector<uint8_t>& tfeb_id, const std::map<uint8_t, 
+                              std::vector<std::pair<int,float>>>& tpesmap, float peshit, double time, int plane, 
+                              double x, double ex, double y, double ey, double z, double ez, const std::string& tagger){
 
   sbn::crt::CRTHit crtHit;
 
@@ -330,16 +447,16 @@ sbn::crt::CRTHit CRTHitRecoAlg::FillCrtHit(std::vector<uint8_t> tfeb_id, std::ma
 
 
 // Function to correct number of photoelectrons by distance down strip
-double CRTHitRecoAlg::CorrectNpe(CRTStrip strip1, CRTStrip strip2, TVector3 position){
+double CRTHitRecoAlg::CorrectNpe(const CRTStrip& strip1, const CRTStrip& strip2, const TVector3& position){
   geo::Point_t pos {position.X(), position.Y(), position.Z()};
 
-  // Get the strip name from the channel ID
-  std::string name1 = fCrtGeo.ChannelToStripName(strip1.channel);
-  std::string name2 = fCrtGeo.ChannelToStripName(strip2.channel);
+  // Get the strips from the channel ID
+  const CRTStripGeo& geo1 = fCrtGeo.ChannelToStrip(strip1.channel);
+  const CRTStripGeo& geo2 = fCrtGeo.ChannelToStrip(strip2.channel);
 
   // Get the distance from the CRT hit to the sipm end
-  double stripDist1 = fCrtGeo.DistanceDownStrip(pos, name1);
-  double stripDist2 = fCrtGeo.DistanceDownStrip(pos, name2);
+  double stripDist1 = fCrtGeo.DistanceDownStrip(pos, geo1);
+  double stripDist2 = fCrtGeo.DistanceDownStrip(pos, geo2);
 
   // Correct the measured pe
   double pesCorr1 = strip1.pes * pow(stripDist1 - fNpeScaleShift, 2) / pow(fNpeScaleShift, 2);
@@ -40,6 +40,7 @@ namespace detinfo {
 #include "sbnobj/SBND/CRT/CRTData.hh"
 #include "sbndcode/Geometry/GeometryWrappers/TPCGeoAlg.h"
 #include "sbndcode/Geometry/GeometryWrappers/CRTGeoAlg.h"
+#include "sbndcode/CRT/CRTUtils/CRTCommonUtils.h"
 
 // c++
 #include <iostream>
@@ -68,6 +69,15 @@ namespace sbnd{
     size_t dataID;
   };
 
+  // Strips of all taggers in one buffer, grouped by tagger index and plane
+  // Each group is sorted by time with duplicate strips removed
+  struct CRTTaggerStrips {
+    std::vector<CRTStrip> strips;
+    // Strips [begin, end) of each group, indexed by tagger_i * 2 + plane
+    std::vector<size_t> begin;
+    std::vector<size_t> end;
+  };
+
 
   class CRTHitRecoAlg {
   public:
@@ -110,11 +120,17 @@ namespace sbnd{
 
     CRTHitRecoAlg(const Config& config);
 
+    // Use the given geometry instead of the geometry services
+    CRTHitRecoAlg(const Config& config, geo::GeometryCore const *geometry,
+                  geo::AuxDetGeometryCore const *auxdet_geometry);
+
     CRTHitRecoAlg(const fhicl::ParameterSet& pset) :
       CRTHitRecoAlg(fhicl::Table<Config>(pset, {})()) {}
 
     CRTHitRecoAlg();
 
+    CRTHitRecoAlg(geo::GeometryCore const *geometry, geo::AuxDetGeometryCore const *auxdet_geometry);
+
     ~CRTHitRecoAlg();
 
     void reconfigure(const Config& config);
@@ -123,17 +139,28 @@ namespace sbnd{
                                                                                          detinfo::DetectorPropertiesData const& detProp,
                                                                                          std::vector<art::Ptr<sbnd::crt::CRTData>> data);
 
+    // Create the strips directly in the flat buffer
+    CRTTaggerStrips CreateTaggerStripBuffer(detinfo::DetectorClocksData const& clockData,
+                                            detinfo::DetectorPropertiesData const& detProp,
+                                            const std::vector<art::Ptr<sbnd::crt::CRTData>>& data);
+
+    // Flatten strips already grouped by tagger name and plane
+    CRTTaggerStrips CreateTaggerStripBuffer(const std::map<std::pair<std::string, unsigned>, std::vector<CRTStrip>>& taggerStrips);
+
     CRTStrip CreateCRTStrip(art::Ptr<sbnd::crt::CRTData> sipm1, art::Ptr<sbnd::crt::CRTData> sipm2, size_t ind);
 
     std::pair<double, double> DistanceBetweenSipms(art::Ptr<sbnd::crt::CRTData> sipm1, art::Ptr<sbnd::crt::CRTData> sipm2);
     
-    std::vector<std::pair<sbn::crt::CRTHit, std::vector<int>>> CreateCRTHits(std::map<std::pair<std::string, unsigned>, std::vector<CRTStrip>> taggerStrips);
+    std::vector<std::pair<sbn::crt::CRTHit, std::vector<int>>> CreateCRTHits(const std::map<std::pair<std::string, unsigned>, std::vector<CRTStrip>>& taggerStrips);
+
+    // Hits are returned in tagger order, the taggers can be reconstructed on up to nThreads threads
+    std::vector<std::pair<sbn::crt::CRTHit, std::vector<int>>> CreateCRTHits(const CRTTaggerStrips& taggerStrips, unsigned nThreads = 1);
 
     // Function to calculate the strip position limits in real space from channel
-    std::vector<double> ChannelToLimits(CRTStrip strip);
+    std::vector<double> ChannelToLimits(const CRTStrip& strip);
  
     // Function to calculate the overlap between two crt strips
-    std::vector<double> CrtOverlap(std::vector<double> strip1, std::vector<double> strip2);
+    std::vector<double> CrtOverlap(const std::vector<double>& strip1, const std::vector<double>& strip2);
  
     // Function to return the CRT tagger name and module position from the channel ID
     std::pair<std::string,unsigned> ChannelToTagger(uint32_t channel);
@@ -142,15 +169,22 @@ namespace sbnd{
     bool CheckModuleOverlap(uint32_t channel);
  
     // Function to make filling a CRTHit a bit faster
-    sbn::crt::CRTHit FillCrtHit(std::vector<uint8_t> tfeb_id, std::map<uint8_t, 
-                           std::vector<std::pair<int,float>>> tpesmap, float peshit, double time, int plane, 
-                           double x, double ex, double y, double ey, double z, double ez, std::string tagger); 
+    sbn::crt::CRTHit FillCrtHit(const std::vector<uint8_t>& tfeb_id, const std::map<uint8_t, 
+                           std::vector<std::pair<int,float>>>& tpesmap, float peshit, double time, int plane, 
+                           double x, double ex, double y, double ey, double z, double ez, const std::string& tagger); 
 
     // Function to correct number of photoelectrons by distance down strip
-    double CorrectNpe(CRTStrip strip1, CRTStrip strip2, TVector3 position);
+    double CorrectNpe(const CRTStrip& strip1, const CRTStrip& strip2, const TVector3& position);
 
   private:
 
+    // Group strips by tagger and plane, keeping their order, then sort and remove duplicates
+    CRTTaggerStrips GroupTaggerStrips(const std::vector<CRTStrip>& strips);
+
+    // Reconstruct the hits of a single tagger
+    void CreateTaggerHits(const CRTTaggerStrips& taggerStrips, size_t tagger_i,
+                          std::vector<std::pair<sbn::crt::CRTHit, std::vector<int>>>& hits);
+
     TPCGeoAlg fTpcGeo;
     CRTGeoAlg fCrtGeo;
 
@@ -72,11 +72,11 @@ double CRTT0MatchAlg::DistOfClosestApproach(detinfo::DetectorPropertiesData cons
 } // CRTT0MatchAlg::DistToOfClosestApproach()
 
 
-std::pair<TVector3, TVector3> CRTT0MatchAlg::TrackDirectionAverage(recob::Track track, double frac){
+std::pair<TVector3, TVector3> CRTT0MatchAlg::TrackDirectionAverage(const recob::Track& track, double frac){
 
   // Calculate direction as an average over directions
   size_t nTrackPoints = track.NumberTrajectoryPoints();
-  recob::TrackTrajectory trajectory  = track.Trajectory();
+  const recob::TrackTrajectory& trajectory = track.Trajectory();
   std::vector<geo::Vector_t> validDirections;
   for(size_t i = 0; i < nTrackPoints; i++){
     if(trajectory.FlagsAtPoint(i)!=recob::TrajectoryPointFlags::InvalidHitIndex) continue;
@@ -105,11 +105,11 @@ std::pair<TVector3, TVector3> CRTT0MatchAlg::TrackDirectionAverage(recob::Track
 } // CRTT0MatchAlg::TrackDirectionAverage()
 
 
-std::pair<TVector3, TVector3> CRTT0MatchAlg::TrackDirectionAverageFromPoints(recob::Track track, double frac){
+std::pair<TVector3, TVector3> CRTT0MatchAlg::TrackDirectionAverageFromPoints(const recob::Track& track, double frac){
 
   // Calculate direction as an average over directions
   size_t nTrackPoints = track.NumberTrajectoryPoints();
-  recob::TrackTrajectory trajectory  = track.Trajectory();
+  const recob::TrackTrajectory& trajectory = track.Trajectory();
   std::vector<TVector3> validPoints;
   for(size_t i = 0; i < nTrackPoints; i++){
     if(trajectory.FlagsAtPoint(i) != recob::TrajectoryPointFlags::InvalidHitIndex) continue;
@@ -127,82 +127,168 @@ std::pair<TVector3, TVector3> CRTT0MatchAlg::TrackDirectionAverageFromPoints(rec
 
 
 std::pair<sbn::crt::CRTHit, double> CRTT0MatchAlg::ClosestCRTHit(detinfo::DetectorPropertiesData const& detProp,
-								 recob::Track tpcTrack, std::vector<sbn::crt::CRTHit> crtHits, const art::Event& event) {
+								 const recob::Track& tpcTrack, const std::vector<sbn::crt::CRTHit>& crtHits, const art::Event& event) {
   auto tpcTrackHandle = event.getValidHandle<std::vector<recob::Track>>(fTPCTrackLabel);
   art::FindManyP<recob::Hit> findManyHits(tpcTrackHandle, event, fTPCTrackLabel);
   std::vector<art::Ptr<recob::Hit>> hits = findManyHits.at(tpcTrack.ID());
   return ClosestCRTHit(detProp, tpcTrack, hits, crtHits);
 }
 
-std::pair<sbn::crt::CRTHit, double> CRTT0MatchAlg::ClosestCRTHit(detinfo::DetectorPropertiesData const& detProp,
-								 recob::Track tpcTrack, std::pair<double, double> t0MinMax, std::vector<sbn::crt::CRTHit> crtHits, int driftDirection) {
-  auto start = tpcTrack.Vertex<TVector3>();
-  auto end = tpcTrack.End<TVector3>();
+// DCA between a CRT hit and the closest end of a track shifted to the hit time
+double CRTT0MatchAlg::EndDCA(const sbn::crt::CRTHit& crtHit, double crtTime, const TrackEnds& ends,
+                             int driftDirection, double driftVelocity) const {
+
+  TVector3 crtPoint(crtHit.x_pos, crtHit.y_pos, crtHit.z_pos);
+  bool useStart = (crtPoint-ends.start).Mag() < (crtPoint-ends.end).Mag();
+  TVector3 trackPos = useStart ? ends.start : ends.end;
+  const TVector3& trackDir = useStart ? ends.startDir : ends.endDir;
+
+  // Convert the t0 into an x shift
+  trackPos[0] += driftDirection * (crtTime * driftVelocity);
+
+  return CRTCommonUtils::DistToCrtHit(crtHit, trackPos, trackPos + trackDir);
+
+} // CRTT0MatchAlg::EndDCA()
+
+// EndDCA for the hits in a range of positions of a time index in one sweep over its hit arrays
+void CRTT0MatchAlg::EndDCAs(const CRTHitTimeIndex& crtHitIndex, size_t begin, size_t end, const TrackEnds& ends,
+                            int driftDirection, double driftVelocity, std::vector<double>& dists) const {
+
+  const CRTCommonUtils::CRTHitArrays& hits = crtHitIndex.SortedHits();
+  const double start[3] = {ends.start.X(), ends.start.Y(), ends.start.Z()};
+  const double stop[3] = {ends.end.X(), ends.end.Y(), ends.end.Z()};
+  const double startDir[3] = {ends.startDir.X(), ends.startDir.Y(), ends.startDir.Z()};
+  const double stopDir[3] = {ends.endDir.X(), ends.endDir.Y(), ends.endDir.Z()};
+
+  dists.resize(end - begin);
+  for(size_t pos = begin; pos < end; pos++){
+    // Use the track end closest to the hit
+    double sx = hits.x[pos] - start[0], sy = hits.y[pos] - start[1], sz = hits.z[pos] - start[2];
+    double ex = hits.x[pos] - stop[0], ey = hits.y[pos] - stop[1], ez = hits.z[pos] - stop[2];
+    bool useStart = std::sqrt(sx*sx + sy*sy + sz*sz) < std::sqrt(ex*ex + ey*ey + ez*ez);
+    const double* trackPos = useStart ? start : stop;
+    const double* trackDir = useStart ? startDir : stopDir;
+
+    // Convert the t0 into an x shift
+    double lineStart[3] = {trackPos[0] + driftDirection * (crtHitIndex.SortedTime(pos) * driftVelocity), trackPos[1], trackPos[2]};
+    double lineEnd[3] = {lineStart[0] + trackDir[0], lineStart[1] + trackDir[1], lineStart[2] + trackDir[2]};
+
+    dists[pos - begin] = CRTCommonUtils::DistToCrtHit(hits, pos, lineStart, lineEnd);
+  }
+
+} // CRTT0MatchAlg::EndDCAs()
+
+CRTT0MatchAlg::TrackEnds CRTT0MatchAlg::GetTrackEnds(const recob::Track& tpcTrack){
 
   // Calculate direction as an average over directions
   std::pair<TVector3, TVector3> startEndDir = TrackDirectionAverage(tpcTrack, fTrackDirectionFrac);
-  TVector3 startDir = startEndDir.first;
-  TVector3 endDir = startEndDir.second;
+  return {tpcTrack.Vertex<TVector3>(), tpcTrack.End<TVector3>(), startEndDir.first, startEndDir.second};
+
+}
+
+std::pair<sbn::crt::CRTHit, double> CRTT0MatchAlg::ClosestCRTHit(detinfo::DetectorPropertiesData const& detProp,
+								 const recob::Track& tpcTrack, std::pair<double, double> t0MinMax, const std::vector<sbn::crt::CRTHit>& crtHits, int driftDirection) {
+
+  TrackEnds ends = GetTrackEnds(tpcTrack);
+  double driftVelocity = detProp.DriftVelocity();
+  // If track is stitched then try all hits
+  bool stitched = t0MinMax.first == t0MinMax.second;
 
   // ====================== Matching Algorithm ========================== //
-  std::vector<std::pair<sbn::crt::CRTHit, double>> t0Candidates;
+  // Keep the first hit with the smallest DCA
+  const sbn::crt::CRTHit* closest = nullptr;
+  double minDist = 0;
 
   // Loop over all the CRT hits
-  for(auto &crtHit : crtHits){
+  for(auto const& crtHit : crtHits){
     // Check if hit is within the allowed t0 range
-    double crtTime = -99999.;
-    if (fTSMode == 1) {
-      crtTime = ((double)(int)crtHit.ts1_ns) * 1e-3 + fTimeCorrection;
-    }
-    else {
-      crtTime = ((double)(int)crtHit.ts0_ns) * 1e-3 + fTimeCorrection;
-    }
-    // If track is stitched then try all hits
-    if (!((crtTime >= t0MinMax.first - 10. && crtTime <= t0MinMax.second + 10.) 
-            || t0MinMax.first == t0MinMax.second)) continue;
-    TVector3 crtPoint(crtHit.x_pos, crtHit.y_pos, crtHit.z_pos);
-  
+    double crtTime = CRTHitTimeIndex::Time(crtHit, fTSMode, fTimeCorrection);
+    if (!((crtTime >= t0MinMax.first - 10. && crtTime <= t0MinMax.second + 10.) || stitched)) continue;
+
     // Calculate the distance between the crossing point and the CRT hit
-    double startDist = DistOfClosestApproach(detProp, start, startDir, crtHit, driftDirection, crtTime);
-    double endDist = DistOfClosestApproach(detProp, end, endDir, crtHit, driftDirection, crtTime);
-    // If the distance is less than some limit record the time
-    if ((crtPoint-start).Mag() < (crtPoint-end).Mag()){ 
-      t0Candidates.push_back(std::make_pair(crtHit, startDist));
-    }
-    else{
-      t0Candidates.push_back(std::make_pair(crtHit, endDist));
+    double dist = EndDCA(crtHit, crtTime, ends, driftDirection, driftVelocity);
+    if(closest == nullptr || dist < minDist){
+      closest = &crtHit;
+      minDist = dist;
     }
-  
   }
 
-  // Sort the candidates by distance
-  std::sort(t0Candidates.begin(), t0Candidates.end(), [](auto& left, auto& right){
-            return left.second < right.second;});
+  if(closest != nullptr) return std::make_pair(*closest, minDist);
 
-  if(t0Candidates.size() > 0){
-    return t0Candidates[0];
-  }
   sbn::crt::CRTHit hit;
   return std::make_pair(hit, -99999);
 
-
 }
 
 std::pair<sbn::crt::CRTHit, double> CRTT0MatchAlg::ClosestCRTHit(detinfo::DetectorPropertiesData const& detProp,
-								 recob::Track tpcTrack, std::vector<art::Ptr<recob::Hit>> hits, std::vector<sbn::crt::CRTHit> crtHits) {
-  auto start = tpcTrack.Vertex<TVector3>();
-  auto end = tpcTrack.End<TVector3>();
+								 const recob::Track& tpcTrack, std::pair<double, double> t0MinMax, const CRTHitTimeIndex& crtHitIndex, int driftDirection) {
+
+  if(crtHitIndex.TSMode() != fTSMode || crtHitIndex.TimeCorrection() != fTimeCorrection){
+    throw cet::exception("CRTT0MatchAlg")
+      << "CRT hit time index built with TSMode " << crtHitIndex.TSMode() << " and time correction "
+      << crtHitIndex.TimeCorrection() << ", expected " << fTSMode << " and " << fTimeCorrection << "\n";
+  }
+
+  TrackEnds ends = GetTrackEnds(tpcTrack);
+  double driftVelocity = detProp.DriftVelocity();
+
+  // Only look at the hits in the allowed t0 range, if track is stitched then try all hits
+  std::pair<size_t, size_t> window = std::make_pair(0, crtHitIndex.Size());
+  if(t0MinMax.first != t0MinMax.second){
+    window = crtHitIndex.Window(t0MinMax.first - 10., t0MinMax.second + 10.);
+  }
+
+  std::vector<double> dists;
+  EndDCAs(crtHitIndex, window.first, window.second, ends, driftDirection, driftVelocity, dists);
+
+  // Keep the hit with the smallest DCA, the first one in the original order if tied
+  size_t closest = crtHitIndex.Size();
+  double minDist = 0;
+  for(size_t pos = window.first; pos < window.second; pos++){
+    size_t hit_i = crtHitIndex.Index(pos);
+    double dist = dists[pos - window.first];
+    if(closest == crtHitIndex.Size() || dist < minDist || (dist == minDist && hit_i < closest)){
+      closest = hit_i;
+      minDist = dist;
+    }
+  }
+
+  if(closest != crtHitIndex.Size()) return std::make_pair(crtHitIndex.Object(closest), minDist);
+
+  sbn::crt::CRTHit hit;
+  return std::make_pair(hit, -99999);
+
+}
+
+std::pair<double, double> CRTT0MatchAlg::TrackT0Range(detinfo::DetectorPropertiesData const& detProp,
+                                                      const recob::Track& tpcTrack, const std::vector<art::Ptr<recob::Hit>>& hits, int& driftDirection){
   // Get the drift direction from the TPC
-  int driftDirection = TPCGeoUtil::DriftDirectionFromHits(fGeometryService, hits);
+  driftDirection = TPCGeoUtil::DriftDirectionFromHits(fGeometryService, hits);
   std::pair<double, double> xLimits = TPCGeoUtil::XLimitsFromHits(fGeometryService, hits);
   // Get the allowed t0 range
-  std::pair<double, double> t0MinMax = TrackT0Range(detProp, start.X(), end.X(), driftDirection, xLimits);
+  return TrackT0Range(detProp, tpcTrack.Vertex().X(), tpcTrack.End().X(), driftDirection, xLimits);
+}
 
+std::pair<sbn::crt::CRTHit, double> CRTT0MatchAlg::ClosestCRTHit(detinfo::DetectorPropertiesData const& detProp,
+								 const recob::Track& tpcTrack, const std::vector<art::Ptr<recob::Hit>>& hits, const std::vector<sbn::crt::CRTHit>& crtHits) {
+  int driftDirection = 0;
+  std::pair<double, double> t0MinMax = TrackT0Range(detProp, tpcTrack, hits, driftDirection);
   return ClosestCRTHit(detProp, tpcTrack, t0MinMax, crtHits, driftDirection);
 }
 
+std::pair<sbn::crt::CRTHit, double> CRTT0MatchAlg::ClosestCRTHit(detinfo::DetectorPropertiesData const& detProp,
+								 const recob::Track& tpcTrack, const std::vector<art::Ptr<recob::Hit>>& hits, const CRTHitTimeIndex& crtHitIndex) {
+  int driftDirection = 0;
+  std::pair<double, double> t0MinMax = TrackT0Range(detProp, tpcTrack, hits, driftDirection);
+  return ClosestCRTHit(detProp, tpcTrack, t0MinMax, crtHitIndex, driftDirection);
+}
+
+CRTHitTimeIndex CRTT0MatchAlg::HitTimeIndex(const std::vector<sbn::crt::CRTHit>& crtHits) const {
+  return CRTHitTimeIndex(crtHits, fTSMode, fTimeCorrection);
+}
+
 double CRTT0MatchAlg::T0FromCRTHits(detinfo::DetectorPropertiesData const& detProp,
-                                    recob::Track tpcTrack, std::vector<sbn::crt::CRTHit> crtHits, const art::Event& event){
+                                    const recob::Track& tpcTrack, const std::vector<sbn::crt::CRTHit>& crtHits, const art::Event& event){
   auto tpcTrackHandle = event.getValidHandle<std::vector<recob::Track>>(fTPCTrackLabel);
   art::FindManyP<recob::Hit> findManyHits(tpcTrackHandle, event, fTPCTrackLabel);
   std::vector<art::Ptr<recob::Hit>> hits = findManyHits.at(tpcTrack.ID());
@@ -210,28 +296,25 @@ double CRTT0MatchAlg::T0FromCRTHits(detinfo::DetectorPropertiesData const& detPr
 }
 
 double CRTT0MatchAlg::T0FromCRTHits(detinfo::DetectorPropertiesData const& detProp,
-                                    recob::Track tpcTrack, std::vector<art::Ptr<recob::Hit>> hits, std::vector<sbn::crt::CRTHit> crtHits) {
+                                    const recob::Track& tpcTrack, const std::vector<art::Ptr<recob::Hit>>& hits, const std::vector<sbn::crt::CRTHit>& crtHits) {
 
   if (tpcTrack.Length() < fMinTrackLength) return -99999; 
 
-  std::pair<sbn::crt::CRTHit, double> closestHit = ClosestCRTHit(detProp, tpcTrack, hits, crtHits);
-  if(closestHit.second == -99999) return -99999;
+  return T0AndDCAFromClosest(ClosestCRTHit(detProp, tpcTrack, hits, crtHits)).first;
 
-  double crtTime;
-  if (fTSMode == 1) {
-    crtTime = ((double)(int)closestHit.first.ts1_ns) * 1e-3 + fTimeCorrection;
-  }
-  else {
-    crtTime = ((double)(int)closestHit.first.ts0_ns) * 1e-3 + fTimeCorrection;
-  }
-  if(closestHit.second < fDistanceLimit) return crtTime;
+}
 
-  return -99999;
+double CRTT0MatchAlg::T0FromCRTHits(detinfo::DetectorPropertiesData const& detProp,
+                                    const recob::Track& tpcTrack, const std::vector<art::Ptr<recob::Hit>>& hits, const CRTHitTimeIndex& crtHitIndex) {
+
+  if (tpcTrack.Length() < fMinTrackLength) return -99999; 
+
+  return T0AndDCAFromClosest(ClosestCRTHit(detProp, tpcTrack, hits, crtHitIndex)).first;
 
 }
 
 std::pair<double, double> CRTT0MatchAlg::T0AndDCAFromCRTHits(detinfo::DetectorPropertiesData const& detProp,
-                                                             recob::Track tpcTrack, std::vector<sbn::crt::CRTHit> crtHits, const art::Event& event){
+                                                             const recob::Track& tpcTrack, const std::vector<sbn::crt::CRTHit>& crtHits, const art::Event& event){
   auto tpcTrackHandle = event.getValidHandle<std::vector<recob::Track>>(fTPCTrackLabel);
   art::FindManyP<recob::Hit> findManyHits(tpcTrackHandle, event, fTPCTrackLabel);
   std::vector<art::Ptr<recob::Hit>> hits = findManyHits.at(tpcTrack.ID());
@@ -239,21 +322,79 @@ std::pair<double, double> CRTT0MatchAlg::T0AndDCAFromCRTHits(detinfo::DetectorPr
 }
 
 std::pair<double, double> CRTT0MatchAlg::T0AndDCAFromCRTHits(detinfo::DetectorPropertiesData const& detProp,
-                                                             recob::Track tpcTrack, std::vector<art::Ptr<recob::Hit>> hits, std::vector<sbn::crt::CRTHit> crtHits) {
+                                                             const recob::Track& tpcTrack, const std::vector<art::Ptr<recob::Hit>>& hits, const std::vector<sbn::crt::CRTHit>& crtHits) {
 
-  std::pair<double, double> null = std::make_pair(-99999, -99999);
-  if (tpcTrack.Length() < fMinTrackLength) return null; 
+  if (tpcTrack.Length() < fMinTrackLength) return std::make_pair(-99999, -99999); 
 
-  std::pair<sbn::crt::CRTHit, double> closestHit = ClosestCRTHit(detProp, tpcTrack, hits, crtHits);
-  if(closestHit.second == -99999) return null;
+  return T0AndDCAFromClosest(ClosestCRTHit(detProp, tpcTrack, hits, crtHits));
 
-  double crtTime;
-  if (fTSMode == 1) {
-    crtTime = ((double)(int)closestHit.first.ts1_ns) * 1e-3 + fTimeCorrection;
-  }
-  else {
-    crtTime = ((double)(int)closestHit.first.ts0_ns) * 1e-3 + fTimeCorrection;
+}
+
+std::pair<double, double> CRTT0MatchAlg::T0AndDCAFromCRTHits(detinfo::DetectorPropertiesData const& detProp,
+                                                             const recob::Track& tpcTrack, const std::vector<art::Ptr<recob::Hit>>& hits, const CRTHitTimeIndex& crtHitIndex) {
+
+  if (tpcTrack.Length() < fMinTrackLength) return std::make_pair(-99999, -99999); 
+
+  return T0AndDCAFromClosest(ClosestCRTHit(detProp, tpcTrack, hits, crtHitIndex));
+
+}
+
+std::vector<std::pair<sbn::crt::CRTHit, double>> CRTT0MatchAlg::ClosestCRTHits(detinfo::DetectorPropertiesData const& detProp,
+                                                                               const std::vector<recob::Track>& tpcTracks, const art::FindManyP<recob::Hit>& hitAssoc,
+                                                                               const CRTHitTimeIndex& crtHitIndex, unsigned nThreads) {
+
+  std::vector<std::pair<sbn::crt::CRTHit, double>> closestHits(tpcTracks.size());
+  CRTCommonUtils::ParallelFor(tpcTracks.size(), nThreads, [&](size_t track_i){
+    const recob::Track& tpcTrack = tpcTracks[track_i];
+    closestHits[track_i] = ClosestCRTHit(detProp, tpcTrack, hitAssoc.at(tpcTrack.ID()), crtHitIndex);
+  });
+
+  return closestHits;
+
+}
+
+std::vector<double> CRTT0MatchAlg::T0sFromCRTHits(detinfo::DetectorPropertiesData const& detProp,
+                                                  const std::vector<recob::Track>& tpcTracks, const art::FindManyP<recob::Hit>& hitAssoc,
+                                                  const CRTHitTimeIndex& crtHitIndex, unsigned nThreads) {
+
+  std::vector<double> t0s;
+  for(auto const& t0AndDCA : T0sAndDCAsFromCRTHits(detProp, tpcTracks, hitAssoc, crtHitIndex, nThreads)){
+    t0s.push_back(t0AndDCA.first);
   }
+
+  return t0s;
+
+}
+
+std::vector<std::pair<double, double>> CRTT0MatchAlg::T0sAndDCAsFromCRTHits(detinfo::DetectorPropertiesData const& detProp,
+                                                                            const std::vector<recob::Track>& tpcTracks, const art::FindManyP<recob::Hit>& hitAssoc,
+                                                                            const CRTHitTimeIndex& crtHitIndex, unsigned nThreads) {
+
+  std::vector<std::pair<double, double>> t0sAndDCAs(tpcTracks.size());
+  CRTCommonUtils::ParallelFor(tpcTracks.size(), nThreads, [&](size_t track_i){
+    const recob::Track& tpcTrack = tpcTracks[track_i];
+    t0sAndDCAs[track_i] = T0AndDCAFromCRTHits(detProp, tpcTrack, hitAssoc.at(tpcTrack.ID()), crtHitIndex);
+  });
+
+  return t0sAndDCAs;
+
+}
+
+std::vector<std::pair<double, double>> CRTT0MatchAlg::T0sAndDCAsFromCRTHits(detinfo::DetectorPropertiesData const& detProp,
+                                                                            const std::vector<sbn::crt::CRTHit>& crtHits, const art::Event& event,
+                                                                            unsigned nThreads) {
+  auto tpcTrackHandle = event.getValidHandle<std::vector<recob::Track>>(fTPCTrackLabel);
+  art::FindManyP<recob::Hit> findManyHits(tpcTrackHandle, event, fTPCTrackLabel);
+  return T0sAndDCAsFromCRTHits(detProp, *tpcTrackHandle, findManyHits, HitTimeIndex(crtHits), nThreads);
+}
+
+// Apply the distance limit to the closest hit and convert to a time
+std::pair<double, double> CRTT0MatchAlg::T0AndDCAFromClosest(const std::pair<sbn::crt::CRTHit, double>& closestHit) const {
+
+  std::pair<double, double> null = std::make_pair(-99999, -99999);
+  if(closestHit.second == -99999) return null;
+
+  double crtTime = CRTHitTimeIndex::Time(closestHit.first, fTSMode, fTimeCorrection);
   if(closestHit.second < fDistanceLimit) return std::make_pair(crtTime, closestHit.second);
 
   return null;
@@ -19,6 +19,7 @@
 #include "art/Framework/Services/Registry/ServiceHandle.h" 
 #include "messagefacility/MessageLogger/MessageLogger.h" 
 #include "canvas/Persistency/Common/FindManyP.h"
+#include "cetlib_except/exception.h"
 
 // LArSoft
 #include "lardataobj/RecoBase/Hit.h"
@@ -40,6 +41,7 @@
 
 #include "sbnobj/Common/CRT/CRTHit.hh"
 #include "sbndcode/CRT/CRTUtils/CRTCommonUtils.h"
+#include "sbndcode/CRT/CRTUtils/CRTTimeIndex.h"
 #include "sbndcode/Geometry/GeometryWrappers/TPCGeoAlg.h"
 #include "sbndcode/CRT/CRTUtils/TPCGeoUtil.h"
 
@@ -122,28 +124,56 @@ namespace sbnd{
     double DistOfClosestApproach(detinfo::DetectorPropertiesData const& detProp,
                                  TVector3 trackPos, TVector3 trackDir, sbn::crt::CRTHit crtHit, int driftDirection, double t0);
 
-    std::pair<TVector3, TVector3> TrackDirectionAverage(recob::Track track, double frac);
-    std::pair<TVector3, TVector3> TrackDirectionAverageFromPoints(recob::Track track, double frac);
+    std::pair<TVector3, TVector3> TrackDirectionAverage(const recob::Track& track, double frac);
+    std::pair<TVector3, TVector3> TrackDirectionAverageFromPoints(const recob::Track& track, double frac);
+
+    // Index of the event CRT hits sorted by time, using this algorithm's time stamp and correction
+    CRTHitTimeIndex HitTimeIndex(const std::vector<sbn::crt::CRTHit>& crtHits) const;
 
     // Return the closest CRT hit to a TPC track and the DCA
     std::pair<sbn::crt::CRTHit, double> ClosestCRTHit(detinfo::DetectorPropertiesData const& detProp,
-						      recob::Track tpcTrack, std::pair<double, double> t0MinMax, std::vector<sbn::crt::CRTHit> crtHits, int driftDirection);
+						      const recob::Track& tpcTrack, std::pair<double, double> t0MinMax, const std::vector<sbn::crt::CRTHit>& crtHits, int driftDirection);
+    std::pair<sbn::crt::CRTHit, double> ClosestCRTHit(detinfo::DetectorPropertiesData const& detProp,
+						      const recob::Track& tpcTrack, std::pair<double, double> t0MinMax, const CRTHitTimeIndex& crtHitIndex, int driftDirection);
     std::pair<sbn::crt::CRTHit, double> ClosestCRTHit(detinfo::DetectorPropertiesData const& detProp,
-						      recob::Track tpcTrack, std::vector<sbn::crt::CRTHit> crtHits, const art::Event& event);
+						      const recob::Track& tpcTrack, const std::vector<sbn::crt::CRTHit>& crtHits, const art::Event& event);
     std::pair<sbn::crt::CRTHit, double> ClosestCRTHit(detinfo::DetectorPropertiesData const& detProp,
-						      recob::Track tpcTrack, std::vector<art::Ptr<recob::Hit>> hits, std::vector<sbn::crt::CRTHit> crtHits);
+						      const recob::Track& tpcTrack, const std::vector<art::Ptr<recob::Hit>>& hits, const std::vector<sbn::crt::CRTHit>& crtHits);
+    std::pair<sbn::crt::CRTHit, double> ClosestCRTHit(detinfo::DetectorPropertiesData const& detProp,
+						      const recob::Track& tpcTrack, const std::vector<art::Ptr<recob::Hit>>& hits, const CRTHitTimeIndex& crtHitIndex);
 
     // Match track to T0 from CRT hits
     double T0FromCRTHits(detinfo::DetectorPropertiesData const& detProp,
-                         recob::Track tpcTrack, std::vector<sbn::crt::CRTHit> crtHits, const art::Event& event);
+                         const recob::Track& tpcTrack, const std::vector<sbn::crt::CRTHit>& crtHits, const art::Event& event);
+    double T0FromCRTHits(detinfo::DetectorPropertiesData const& detProp,
+                         const recob::Track& tpcTrack, const std::vector<art::Ptr<recob::Hit>>& hits, const std::vector<sbn::crt::CRTHit>& crtHits);
     double T0FromCRTHits(detinfo::DetectorPropertiesData const& detProp,
-                         recob::Track tpcTrack, std::vector<art::Ptr<recob::Hit>> hits, std::vector<sbn::crt::CRTHit> crtHits);
+                         const recob::Track& tpcTrack, const std::vector<art::Ptr<recob::Hit>>& hits, const CRTHitTimeIndex& crtHitIndex);
 
     // Match track to T0 from CRT hits, also return the DCA
     std::pair<double, double> T0AndDCAFromCRTHits(detinfo::DetectorPropertiesData const& detProp,
-                                                  recob::Track tpcTrack, std::vector<sbn::crt::CRTHit> crtHits, const art::Event& event);
+                                                  const recob::Track& tpcTrack, const std::vector<sbn::crt::CRTHit>& crtHits, const art::Event& event);
     std::pair<double, double> T0AndDCAFromCRTHits(detinfo::DetectorPropertiesData const& detProp,
-                                                  recob::Track tpcTrack, std::vector<art::Ptr<recob::Hit>> hits, std::vector<sbn::crt::CRTHit> crtHits);
+                                                  const recob::Track& tpcTrack, const std::vector<art::Ptr<recob::Hit>>& hits, const std::vector<sbn::crt::CRTHit>& crtHits);
+    std::pair<double, double> T0AndDCAFromCRTHits(detinfo::DetectorPropertiesData const& detProp,
+                                                  const recob::Track& tpcTrack, const std::vector<art::Ptr<recob::Hit>>& hits, const CRTHitTimeIndex& crtHitIndex);
+
+    // Batch versions for all the tracks of an event, results are in the order of tpcTracks
+    // Hits are taken from hitAssoc by track ID, tracks can be split over nThreads threads
+    std::vector<std::pair<sbn::crt::CRTHit, double>> ClosestCRTHits(detinfo::DetectorPropertiesData const& detProp,
+                                                                    const std::vector<recob::Track>& tpcTracks, const art::FindManyP<recob::Hit>& hitAssoc,
+                                                                    const CRTHitTimeIndex& crtHitIndex, unsigned nThreads = 1);
+    std::vector<double> T0sFromCRTHits(detinfo::DetectorPropertiesData const& detProp,
+                                       const std::vector<recob::Track>& tpcTracks, const art::FindManyP<recob::Hit>& hitAssoc,
+                                       const CRTHitTimeIndex& crtHitIndex, unsigned nThreads = 1);
+    std::vector<std::pair<double, double>> T0sAndDCAsFromCRTHits(detinfo::DetectorPropertiesData const& detProp,
+                                                                 const std::vector<recob::Track>& tpcTracks, const art::FindManyP<recob::Hit>& hitAssoc,
+                                                                 const CRTHitTimeIndex& crtHitIndex, unsigned nThreads = 1);
+
+    // Batch version reading the tracks and associations from the event once
+    std::vector<std::pair<double, double>> T0sAndDCAsFromCRTHits(detinfo::DetectorPropertiesData const& detProp,
+                                                                 const std::vector<sbn::crt::CRTHit>& crtHits, const art::Event& event,
+                                                                 unsigned nThreads = 1);
 
 
   private:
@@ -158,6 +188,29 @@ namespace sbnd{
 
     art::InputTag fTPCTrackLabel;
 
+    // Track end points and average directions used for matching
+    struct TrackEnds {
+      TVector3 start;
+      TVector3 end;
+      TVector3 startDir;
+      TVector3 endDir;
+    };
+
+    TrackEnds GetTrackEnds(const recob::Track& tpcTrack);
+
+    // Allowed t0 range of a track from its hits, also sets the drift direction
+    std::pair<double, double> TrackT0Range(detinfo::DetectorPropertiesData const& detProp,
+                                           const recob::Track& tpcTrack, const std::vector<art::Ptr<recob::Hit>>& hits, int& driftDirection);
+
+    double EndDCA(const sbn::crt::CRTHit& crtHit, double crtTime, const TrackEnds& ends,
+                  int driftDirection, double driftVelocity) const;
+
+    // EndDCA for the hits in a range of positions of a time index in one sweep over its hit arrays
+    void EndDCAs(const CRTHitTimeIndex& crtHitIndex, size_t begin, size_t end, const TrackEnds& ends,
+                 int driftDirection, double driftVelocity, std::vector<double>& dists) const;
+
+    std::pair<double, double> T0AndDCAFromClosest(const std::pair<sbn::crt::CRTHit, double>& closestHit) const;
+
   };
 
 }
@@ -0,0 +1,104 @@
+#ifndef CRTTIMEINDEX_H_SEEN
+#define CRTTIMEINDEX_H_SEEN
+
+
+///////////////////////////////////////////////
+// CRTTimeIndex.h
+//
+// Per-event index of CRT hits or tracks sorted by
+// time, so that matching algorithms can select the
+// objects inside a time window by binary search.
+// Built once per event and shared between tracks.
+///////////////////////////////////////////////
+
+#include "sbnobj/Common/CRT/CRTHit.hh"
+#include "sbnobj/Common/CRT/CRTTrack.hh"
+#include "sbndcode/CRT/CRTUtils/CRTCommonUtils.h"
+
+// c++
+#include <algorithm>
+#include <numeric>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace sbnd{
+
+  template<class T>
+  class CRTTimeIndex {
+  public:
+
+    CRTTimeIndex() = default;
+
+    // Objects are kept in their original order, tsMode 1 uses ts1_ns and
+    // anything else ts0_ns, the correction [us] is added to every time
+    CRTTimeIndex(std::vector<T> objects, int tsMode, double timeCorrection = 0.)
+      : fObjects(std::move(objects))
+      , fTSMode(tsMode)
+      , fTimeCorrection(timeCorrection)
+    {
+      fTimes.reserve(fObjects.size());
+      for(auto const& object : fObjects) fTimes.push_back(Time(object, fTSMode, fTimeCorrection));
+
+      fOrder.resize(fObjects.size());
+      std::iota(fOrder.begin(), fOrder.end(), 0);
+      std::stable_sort(fOrder.begin(), fOrder.end(), [this](size_t left, size_t right){
+                       return fTimes[left] < fTimes[right];});
+
+      fSortedTimes.reserve(fOrder.size());
+      for(auto const i : fOrder) fSortedTimes.push_back(fTimes[i]);
+
+      // CRT hit boxes are also kept as arrays in time order for the distance kernels
+      if constexpr (std::is_same_v<T, sbn::crt::CRTHit>){
+        fSortedHits.Reserve(fOrder.size());
+        for(auto const i : fOrder) fSortedHits.Add(fObjects[i]);
+      }
+    }
+
+    // Time of a CRT object [us], as used by the matching algorithms
+    static double Time(const T& object, int tsMode, double timeCorrection = 0.){
+      if(tsMode == 1) return ((double)(int)object.ts1_ns) * 1e-3 + timeCorrection;
+      return ((double)(int)object.ts0_ns) * 1e-3 + timeCorrection;
+    }
+
+    size_t Size() const { return fObjects.size(); }
+    int TSMode() const { return fTSMode; }
+    double TimeCorrection() const { return fTimeCorrection; }
+
+    // Access by original index
+    const std::vector<T>& Objects() const { return fObjects; }
+    const T& Object(size_t i) const { return fObjects[i]; }
+    double Time(size_t i) const { return fTimes[i]; }
+
+    // Original index of the object at a position in time order
+    size_t Index(size_t pos) const { return fOrder[pos]; }
+    double SortedTime(size_t pos) const { return fSortedTimes[pos]; }
+
+    // CRT hit positions and errors in time order, empty for other objects
+    const CRTCommonUtils::CRTHitArrays& SortedHits() const { return fSortedHits; }
+
+    // Range of positions in time order with tMin <= time <= tMax
+    std::pair<size_t, size_t> Window(double tMin, double tMax) const {
+      auto const begin = std::lower_bound(fSortedTimes.begin(), fSortedTimes.end(), tMin);
+      auto const end = std::upper_bound(begin, fSortedTimes.end(), tMax);
+      return std::make_pair(begin - fSortedTimes.begin(), end - fSortedTimes.begin());
+    }
+
+  private:
+
+    std::vector<T> fObjects;
+    std::vector<double> fTimes;
+    std::vector<size_t> fOrder;
+    std::vector<double> fSortedTimes;
+    CRTCommonUtils::CRTHitArrays fSortedHits;
+    int fTSMode = 1;
+    double fTimeCorrection = 0.;
+
+  };
+
+  using CRTHitTimeIndex = CRTTimeIndex<sbn::crt::CRTHit>;
+  using CRTTrackTimeIndex = CRTTimeIndex<sbn::crt::CRTTrack>;
+
+}
+
+#endif
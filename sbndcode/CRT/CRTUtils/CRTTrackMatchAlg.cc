@@ -40,7 +40,7 @@ void CRTTrackMatchAlg::reconfigure(const Config& config){
 
 // Calculate intersection between CRT track and TPC (AABB Ray-Box intersection)
 // (https://www.scratchapixel.com/lessons/3d-basic-rendering/minimal-ray-tracer-rendering-simple-shapes/ray-box-intersection)
-std::pair<TVector3, TVector3> CRTTrackMatchAlg::TpcIntersection(const geo::TPCGeo& tpcGeo, sbn::crt::CRTTrack track){
+std::pair<TVector3, TVector3> CRTTrackMatchAlg::TpcIntersection(const geo::TPCGeo& tpcGeo, const sbn::crt::CRTTrack& track){
 
   // Find the intersection between the track and the TPC
   TVector3 start (track.x1_pos, track.y1_pos, track.z1_pos);
@@ -81,8 +81,12 @@ bool CRTTrackMatchAlg::CrossesTPC(sbn::crt::CRTTrack track){
 
 } // CRTTrackMatchAlg::CrossesTPC()
 
+CRTTrackTimeIndex CRTTrackMatchAlg::TrackTimeIndex(const std::vector<sbn::crt::CRTTrack>& crtTracks) const {
+  return CRTTrackTimeIndex(crtTracks, 1);
+}
+
 double CRTTrackMatchAlg::T0FromCRTTracks(detinfo::DetectorPropertiesData const& detProp,
-                                         recob::Track tpcTrack, std::vector<sbn::crt::CRTTrack> crtTracks, const art::Event& event) {
+                                         const recob::Track& tpcTrack, const std::vector<sbn::crt::CRTTrack>& crtTracks, const art::Event& event) {
   auto tpcTrackHandle = event.getValidHandle<std::vector<recob::Track>>(fTPCTrackLabel);
   art::FindManyP<recob::Hit> findManyHits(tpcTrackHandle, event, fTPCTrackLabel);
   std::vector<art::Ptr<recob::Hit>> hits = findManyHits.at(tpcTrack.ID());
@@ -90,43 +94,50 @@ double CRTTrackMatchAlg::T0FromCRTTracks(detinfo::DetectorPropertiesData const&
 }
 
 double CRTTrackMatchAlg::T0FromCRTTracks(detinfo::DetectorPropertiesData const& detProp,
-                                         recob::Track tpcTrack, std::vector<art::Ptr<recob::Hit>> hits, std::vector<sbn::crt::CRTTrack> crtTracks) {
+                                         const recob::Track& tpcTrack, const std::vector<art::Ptr<recob::Hit>>& hits, const std::vector<sbn::crt::CRTTrack>& crtTracks) {
 
-  std::pair<sbn::crt::CRTTrack, double> closest;
-  if(fSelectionMetric == "angle"){ 
-    closest = ClosestCRTTrackByAngle(detProp, tpcTrack, hits, crtTracks);
-    if(closest.second == -99999 || closest.second > fMaxAngleDiff) return -99999;
-  }
-  else if(fSelectionMetric == "dca"){ 
-    closest = ClosestCRTTrackByDCA(detProp, tpcTrack, hits, crtTracks);
-    if(closest.second == -99999 || closest.second > fMaxDistance) return -99999;
-  }
-  else{
-    closest = ClosestCRTTrackByScore(detProp, tpcTrack, hits, crtTracks);
-    if(closest.second == -99999 || closest.second > fMaxScore) return -99999;
-  }
+  int driftDirection = TPCGeoUtil::DriftDirectionFromHits(fGeometryService, hits);
+  std::pair<sbn::crt::CRTTrack, double> closest = SelectedCRTTrack(detProp, tpcTrack, driftDirection,
+                                                                   AllPossibleCRTTracks(detProp, tpcTrack, hits, crtTracks));
+  if(closest.second == -99999) return -99999;
 
-  double crtTime = ((double)(int)closest.first.ts1_ns) * 1e-3; // [us]
+  return ((double)(int)closest.first.ts1_ns) * 1e-3; // [us]
 
-  return crtTime;
+}
+
+double CRTTrackMatchAlg::T0FromCRTTracks(detinfo::DetectorPropertiesData const& detProp,
+                                         const recob::Track& tpcTrack, const std::vector<art::Ptr<recob::Hit>>& hits, const CRTTrackTimeIndex& crtTrackIndex) {
+
+  int driftDirection = TPCGeoUtil::DriftDirectionFromHits(fGeometryService, hits);
+  std::pair<sbn::crt::CRTTrack, double> closest = SelectedCRTTrack(detProp, tpcTrack, driftDirection,
+                                                                   AllPossibleCRTTracks(detProp, tpcTrack, hits, crtTrackIndex));
+  if(closest.second == -99999) return -99999;
+
+  return ((double)(int)closest.first.ts1_ns) * 1e-3; // [us]
 
 }
 
 int CRTTrackMatchAlg::GetMatchedCRTTrackId(detinfo::DetectorPropertiesData const& detProp,
-                                           recob::Track tpcTrack, std::vector<sbn::crt::CRTTrack> crtTracks, const art::Event& event){
+                                           const recob::Track& tpcTrack, const std::vector<sbn::crt::CRTTrack>& crtTracks, const art::Event& event){
   std::pair<int, double> result = GetMatchedCRTTrackIdAndScore(detProp, tpcTrack, crtTracks, event);
   return result.first;
 }
 
 // Find the closest valid matching CRT track ID
 int CRTTrackMatchAlg::GetMatchedCRTTrackId(detinfo::DetectorPropertiesData const& detProp,
-                                           recob::Track tpcTrack, std::vector<art::Ptr<recob::Hit>> hits, std::vector<sbn::crt::CRTTrack> crtTracks) {
+                                           const recob::Track& tpcTrack, const std::vector<art::Ptr<recob::Hit>>& hits, const std::vector<sbn::crt::CRTTrack>& crtTracks) {
   std::pair<int, double> result = GetMatchedCRTTrackIdAndScore(detProp, tpcTrack, hits, crtTracks);
   return result.first;
 }
 
+int CRTTrackMatchAlg::GetMatchedCRTTrackId(detinfo::DetectorPropertiesData const& detProp,
+                                           const recob::Track& tpcTrack, const std::vector<art::Ptr<recob::Hit>>& hits, const CRTTrackTimeIndex& crtTrackIndex) {
+  std::pair<int, double> result = GetMatchedCRTTrackIdAndScore(detProp, tpcTrack, hits, crtTrackIndex);
+  return result.first;
+}
+
 std::pair<int,double> CRTTrackMatchAlg::GetMatchedCRTTrackIdAndScore(detinfo::DetectorPropertiesData const& detProp,
-                                                                     recob::Track tpcTrack, std::vector<sbn::crt::CRTTrack> crtTracks, const art::Event& event){
+                                                                     const recob::Track& tpcTrack, const std::vector<sbn::crt::CRTTrack>& crtTracks, const art::Event& event){
   auto tpcTrackHandle = event.getValidHandle<std::vector<recob::Track>>(fTPCTrackLabel);
   art::FindManyP<recob::Hit> findManyHits(tpcTrackHandle, event, fTPCTrackLabel);
   std::vector<art::Ptr<recob::Hit>> hits = findManyHits.at(tpcTrack.ID());
@@ -135,36 +146,106 @@ std::pair<int,double> CRTTrackMatchAlg::GetMatchedCRTTrackIdAndScore(detinfo::De
 
 // Find the closest valid matching CRT track ID
 std::pair<int,double> CRTTrackMatchAlg::GetMatchedCRTTrackIdAndScore(detinfo::DetectorPropertiesData const& detProp,
-                                                                     recob::Track tpcTrack, std::vector<art::Ptr<recob::Hit>> hits, std::vector<sbn::crt::CRTTrack> crtTracks) {
+                                                                     const recob::Track& tpcTrack, const std::vector<art::Ptr<recob::Hit>>& hits, const std::vector<sbn::crt::CRTTrack>& crtTracks) {
+
+  int driftDirection = TPCGeoUtil::DriftDirectionFromHits(fGeometryService, hits);
+  std::pair<sbn::crt::CRTTrack, double> closest = SelectedCRTTrack(detProp, tpcTrack, driftDirection,
+                                                                   AllPossibleCRTTracks(detProp, tpcTrack, hits, crtTracks));
+  return MatchedCRTTrackId(closest, crtTracks);
+
+}
+
+std::pair<int,double> CRTTrackMatchAlg::GetMatchedCRTTrackIdAndScore(detinfo::DetectorPropertiesData const& detProp,
+                                                                     const recob::Track& tpcTrack, const std::vector<art::Ptr<recob::Hit>>& hits, const CRTTrackTimeIndex& crtTrackIndex) {
+
+  int driftDirection = TPCGeoUtil::DriftDirectionFromHits(fGeometryService, hits);
+  std::pair<sbn::crt::CRTTrack, double> closest = SelectedCRTTrack(detProp, tpcTrack, driftDirection,
+                                                                   AllPossibleCRTTracks(detProp, tpcTrack, hits, crtTrackIndex));
+  return MatchedCRTTrackId(closest, crtTrackIndex.Objects());
+
+}
+
+std::vector<double> CRTTrackMatchAlg::T0sFromCRTTracks(detinfo::DetectorPropertiesData const& detProp,
+                                                       const std::vector<recob::Track>& tpcTracks, const art::FindManyP<recob::Hit>& hitAssoc,
+                                                       const CRTTrackTimeIndex& crtTrackIndex, unsigned nThreads) {
+
+  std::vector<double> t0s(tpcTracks.size());
+  CRTCommonUtils::ParallelFor(tpcTracks.size(), nThreads, [&](size_t track_i){
+    const recob::Track& tpcTrack = tpcTracks[track_i];
+    t0s[track_i] = T0FromCRTTracks(detProp, tpcTrack, hitAssoc.at(tpcTrack.ID()), crtTrackIndex);
+  });
+
+  return t0s;
+
+}
+
+std::vector<std::pair<int,double>> CRTTrackMatchAlg::GetMatchedCRTTrackIdsAndScores(detinfo::DetectorPropertiesData const& detProp,
+                                                                                    const std::vector<recob::Track>& tpcTracks, const art::FindManyP<recob::Hit>& hitAssoc,
+                                                                                    const CRTTrackTimeIndex& crtTrackIndex, unsigned nThreads) {
+
+  std::vector<std::pair<int,double>> results(tpcTracks.size());
+  CRTCommonUtils::ParallelFor(tpcTracks.size(), nThreads, [&](size_t track_i){
+    const recob::Track& tpcTrack = tpcTracks[track_i];
+    results[track_i] = GetMatchedCRTTrackIdAndScore(detProp, tpcTrack, hitAssoc.at(tpcTrack.ID()), crtTrackIndex);
+  });
+
+  return results;
+
+}
+
+std::vector<std::pair<int,double>> CRTTrackMatchAlg::GetMatchedCRTTrackIdsAndScores(detinfo::DetectorPropertiesData const& detProp,
+                                                                                    const std::vector<sbn::crt::CRTTrack>& crtTracks, const art::Event& event,
+                                                                                    unsigned nThreads) {
+  auto tpcTrackHandle = event.getValidHandle<std::vector<recob::Track>>(fTPCTrackLabel);
+  art::FindManyP<recob::Hit> findManyHits(tpcTrackHandle, event, fTPCTrackLabel);
+  return GetMatchedCRTTrackIdsAndScores(detProp, *tpcTrackHandle, findManyHits, TrackTimeIndex(crtTracks), nThreads);
+}
+
+// Position of the selected track in the event CRT tracks
+std::pair<int,double> CRTTrackMatchAlg::MatchedCRTTrackId(const std::pair<sbn::crt::CRTTrack, double>& closest,
+                                                          const std::vector<sbn::crt::CRTTrack>& crtTracks) {
 
   std::pair<int, double> null = std::make_pair(-99999, -99999);
+  if(closest.second == -99999) return null;
+
+  int crt_i = 0;
+  for(auto const& track : crtTracks){
+    if(fCrtBackTrack.TrackCompare(closest.first, track)) return std::make_pair(crt_i, closest.second);
+    crt_i++;
+  }
+
+  return null;
+
+}
+
+// Closest track with the configured selection metric, -99999 if none passes its limit
+std::pair<sbn::crt::CRTTrack, double> CRTTrackMatchAlg::SelectedCRTTrack(detinfo::DetectorPropertiesData const& detProp,
+                                                                         const recob::Track& tpcTrack, int driftDirection,
+                                                                         const std::vector<sbn::crt::CRTTrack>& possTracks) {
+
+  sbn::crt::CRTTrack track;
+  std::pair<sbn::crt::CRTTrack, double> null = std::make_pair(track, -99999);
 
   std::pair<sbn::crt::CRTTrack, double> closest;
   if(fSelectionMetric == "angle"){ 
-    closest = ClosestCRTTrackByAngle(detProp, tpcTrack, hits, crtTracks);
+    closest = ClosestByAngle(detProp, tpcTrack, driftDirection, possTracks, 0.);
     if(closest.second == -99999 || closest.second > fMaxAngleDiff) return null;
   }
   else if(fSelectionMetric == "dca"){ 
-    closest = ClosestCRTTrackByDCA(detProp, tpcTrack, hits, crtTracks);
+    closest = ClosestByDCA(detProp, tpcTrack, driftDirection, possTracks, 0.);
     if(closest.second == -99999 || closest.second > fMaxDistance) return null;
   }
   else{
-    closest = ClosestCRTTrackByScore(detProp, tpcTrack, hits, crtTracks);
+    closest = ClosestByScore(detProp, tpcTrack, driftDirection, possTracks);
     if(closest.second == -99999 || closest.second > fMaxScore) return null;
   }
 
-  int crt_i = 0;
-  for(auto const& track : crtTracks){
-    if(fCrtBackTrack.TrackCompare(closest.first, track)) return std::make_pair(crt_i, closest.second);
-    crt_i++;
-  }
-
-  return null;
+  return closest;
 
 }
 
 std::vector<sbn::crt::CRTTrack> CRTTrackMatchAlg::AllPossibleCRTTracks(detinfo::DetectorPropertiesData const& detProp,
-								       recob::Track tpcTrack, std::vector<sbn::crt::CRTTrack> crtTracks, const art::Event& event){
+								       const recob::Track& tpcTrack, const std::vector<sbn::crt::CRTTrack>& crtTracks, const art::Event& event){
   auto tpcTrackHandle = event.getValidHandle<std::vector<recob::Track>>(fTPCTrackLabel);
   art::FindManyP<recob::Hit> findManyHits(tpcTrackHandle, event, fTPCTrackLabel);
   std::vector<art::Ptr<recob::Hit>> hits = findManyHits.at(tpcTrack.ID());
@@ -173,12 +254,10 @@ std::vector<sbn::crt::CRTTrack> CRTTrackMatchAlg::AllPossibleCRTTracks(detinfo::
 
 
 // Get all CRT tracks that cross the right TPC within an allowed time
-  std::vector<sbn::crt::CRTTrack> CRTTrackMatchAlg::AllPossibleCRTTracks(detinfo::DetectorPropertiesData const& detProp,
-									 recob::Track tpcTrack, std::vector<art::Ptr<recob::Hit>> hits, std::vector<sbn::crt::CRTTrack> crtTracks) {
-
-   std::vector<sbn::crt::CRTTrack> trackCandidates;
+std::vector<sbn::crt::CRTTrack> CRTTrackMatchAlg::AllPossibleCRTTracks(detinfo::DetectorPropertiesData const& detProp,
+								       const recob::Track& tpcTrack, const std::vector<art::Ptr<recob::Hit>>& hits, const std::vector<sbn::crt::CRTTrack>& crtTracks) {
 
-  // Get the hits associated with the tpc track
+  std::vector<sbn::crt::CRTTrack> trackCandidates;
 
   // Get the drift direction (0 for stitched tracks)
   int driftDirection = TPCGeoUtil::DriftDirectionFromHits(fGeometryService, hits);
@@ -189,33 +268,96 @@ std::vector<sbn::crt::CRTTrack> CRTTrackMatchAlg::AllPossibleCRTTracks(detinfo::
 
   // Loop over the crt tracks
   for(auto const& crtTrack : crtTracks){
-    // Calculate the intersection points for that TPC
-    std::pair<TVector3, TVector3> intersection = TpcIntersection(tpcGeo, crtTrack);
+    if(PossibleCRTTrack(detProp, tpcTrack, tpcGeo, driftDirection, crtTrack)) trackCandidates.push_back(crtTrack);
+  }
 
-    // Skip if it doesn't intersect
-    if(intersection.first.X() == -99999) continue;
+  return trackCandidates;
+}
 
-    // Shift the track to the CRT track
-    double crtTime = ((double)(int)crtTrack.ts1_ns) * 1e-3; // [us]
-    double shift = driftDirection * crtTime * detProp.DriftVelocity();
-    geo::Point_t start = tpcTrack.Vertex();
-    geo::Point_t end = tpcTrack.End();
-    start.SetX(start.X() + shift);
-    end.SetX(end.X() + shift);
+// Get all CRT tracks that cross the right TPC within an allowed time, only looking at the
+// tracks whose time could shift the TPC track inside the TPC
+std::vector<sbn::crt::CRTTrack> CRTTrackMatchAlg::AllPossibleCRTTracks(detinfo::DetectorPropertiesData const& detProp,
+								       const recob::Track& tpcTrack, const std::vector<art::Ptr<recob::Hit>>& hits, const CRTTrackTimeIndex& crtTrackIndex) {
+
+  if(crtTrackIndex.TSMode() != 1 || crtTrackIndex.TimeCorrection() != 0){
+    throw cet::exception("CRTTrackMatchAlg")
+      << "CRT track time index must use ts1 with no time correction\n";
+  }
+
+  // Get the drift direction (0 for stitched tracks)
+  int driftDirection = TPCGeoUtil::DriftDirectionFromHits(fGeometryService, hits);
 
-    // Check the track is fully contained in the TPC
-    if(!TPCGeoUtil::InsideTPC(start, tpcGeo, 2.) && shift != 0) continue;
-    if(!TPCGeoUtil::InsideTPC(end, tpcGeo, 2.) && shift != 0) continue;
+  // Get the TPC Geo object from the tpc track
+  geo::TPCID tpcID = hits[0]->WireID().asTPCID();
+  const geo::TPCGeo& tpcGeo = fGeometryService->GetElement(tpcID);
+
+  // Original indices of the tracks to check, stitched tracks are never shifted
+  std::vector<size_t> indices;
+  auto addWindow = [&](std::pair<size_t, size_t> window){
+    for(size_t pos = window.first; pos < window.second; pos++) indices.push_back(crtTrackIndex.Index(pos));
+  };
+  if(driftDirection == 0){
+    addWindow(std::make_pair(0, crtTrackIndex.Size()));
+  }
+  else{
+    // Range of shifts keeping both ends inside the TPC in x
+    double startX = tpcTrack.Vertex().X();
+    double endX = tpcTrack.End().X();
+    double minShift = tpcGeo.MinX() - 2. - std::min(startX, endX);
+    double maxShift = tpcGeo.MaxX() + 2. - std::max(startX, endX);
+    if(minShift <= maxShift){
+      double Vd = driftDirection * detProp.DriftVelocity();
+      double t1 = minShift/Vd;
+      double t2 = maxShift/Vd;
+      // Pad for rounding, the exact check is done below
+      double pad = 1e-6 * (std::abs(t1) + std::abs(t2)) + 1e-3;
+      addWindow(crtTrackIndex.Window(std::min(t1, t2) - pad, std::max(t1, t2) + pad));
+    }
+    // Tracks at t = 0 are not shifted so are not checked for containment
+    addWindow(crtTrackIndex.Window(0., 0.));
+  }
 
-    trackCandidates.push_back(crtTrack);
-    
+  // Keep the original order of the tracks
+  std::sort(indices.begin(), indices.end());
+  indices.erase(std::unique(indices.begin(), indices.end()), indices.end());
+
+  std::vector<sbn::crt::CRTTrack> trackCandidates;
+  for(auto const track_i : indices){
+    const sbn::crt::CRTTrack& crtTrack = crtTrackIndex.Object(track_i);
+    if(PossibleCRTTrack(detProp, tpcTrack, tpcGeo, driftDirection, crtTrack)) trackCandidates.push_back(crtTrack);
   }
 
   return trackCandidates;
 }
 
+// Does the CRT track cross the TPC and contain the TPC track when shifted to its time
+bool CRTTrackMatchAlg::PossibleCRTTrack(detinfo::DetectorPropertiesData const& detProp, const recob::Track& tpcTrack,
+                                        const geo::TPCGeo& tpcGeo, int driftDirection, const sbn::crt::CRTTrack& crtTrack){
+
+  // Calculate the intersection points for that TPC
+  std::pair<TVector3, TVector3> intersection = TpcIntersection(tpcGeo, crtTrack);
+
+  // Skip if it doesn't intersect
+  if(intersection.first.X() == -99999) return false;
+
+  // Shift the track to the CRT track
+  double crtTime = ((double)(int)crtTrack.ts1_ns) * 1e-3; // [us]
+  double shift = driftDirection * crtTime * detProp.DriftVelocity();
+  geo::Point_t start = tpcTrack.Vertex();
+  geo::Point_t end = tpcTrack.End();
+  start.SetX(start.X() + shift);
+  end.SetX(end.X() + shift);
+
+  // Check the track is fully contained in the TPC
+  if(!TPCGeoUtil::InsideTPC(start, tpcGeo, 2.) && shift != 0) return false;
+  if(!TPCGeoUtil::InsideTPC(end, tpcGeo, 2.) && shift != 0) return false;
+
+  return true;
+
+}
+
 std::pair<sbn::crt::CRTTrack, double> CRTTrackMatchAlg::ClosestCRTTrackByAngle(detinfo::DetectorPropertiesData const& detProp,
-									       recob::Track tpcTrack, std::vector<sbn::crt::CRTTrack> crtTracks, const art::Event& event, double minDCA){
+									       const recob::Track& tpcTrack, const std::vector<sbn::crt::CRTTrack>& crtTracks, const art::Event& event, double minDCA){
   auto tpcTrackHandle = event.getValidHandle<std::vector<recob::Track>>(fTPCTrackLabel);
   art::FindManyP<recob::Hit> findManyHits(tpcTrackHandle, event, fTPCTrackLabel);
   std::vector<art::Ptr<recob::Hit>> hits = findManyHits.at(tpcTrack.ID());
@@ -224,14 +366,31 @@ std::pair<sbn::crt::CRTTrack, double> CRTTrackMatchAlg::ClosestCRTTrackByAngle(d
 
 // Find the closest matching crt track by angle between tracks within angle and DCA limits
 std::pair<sbn::crt::CRTTrack, double> CRTTrackMatchAlg::ClosestCRTTrackByAngle(detinfo::DetectorPropertiesData const& detProp,
-									       recob::Track tpcTrack, std::vector<art::Ptr<recob::Hit>> hits, std::vector<sbn::crt::CRTTrack> crtTracks, double minDCA){
+									       const recob::Track& tpcTrack, const std::vector<art::Ptr<recob::Hit>>& hits, const std::vector<sbn::crt::CRTTrack>& crtTracks, double minDCA){
 
   // Get the drift direction (0 for stitched tracks)
   int driftDirection = TPCGeoUtil::DriftDirectionFromHits(fGeometryService, hits);
+  return ClosestByAngle(detProp, tpcTrack, driftDirection, AllPossibleCRTTracks(detProp, tpcTrack, hits, crtTracks), minDCA);
+}
 
-  std::vector<sbn::crt::CRTTrack> possTracks = AllPossibleCRTTracks(detProp, tpcTrack, hits, crtTracks);
+std::pair<sbn::crt::CRTTrack, double> CRTTrackMatchAlg::ClosestCRTTrackByAngle(detinfo::DetectorPropertiesData const& detProp,
+									       const recob::Track& tpcTrack, const std::vector<art::Ptr<recob::Hit>>& hits, const CRTTrackTimeIndex& crtTrackIndex, double minDCA){
+
+  int driftDirection = TPCGeoUtil::DriftDirectionFromHits(fGeometryService, hits);
+  return ClosestByAngle(detProp, tpcTrack, driftDirection, AllPossibleCRTTracks(detProp, tpcTrack, hits, crtTrackIndex), minDCA);
+}
+
+std::pair<sbn::crt::CRTTrack, double> CRTTrackMatchAlg::ClosestByAngle(detinfo::DetectorPropertiesData const& detProp,
+                                                                       const recob::Track& tpcTrack, int driftDirection,
+                                                                       const std::vector<sbn::crt::CRTTrack>& possTracks, double minDCA){
 
-  std::vector<std::pair<sbn::crt::CRTTrack, double>> candidates;
+  // Take the track points once for all the CRT tracks
+  CRTCommonUtils::PointArrays points;
+  if(minDCA != -1 && !possTracks.empty()) points = TrackPoints(tpcTrack);
+
+  // Keep the first track with the smallest angle
+  const sbn::crt::CRTTrack* closest = nullptr;
+  double minAngle = 0;
   for(auto const& possTrack : possTracks){
     double angle = AngleBetweenTracks(tpcTrack, possTrack);
 
@@ -239,25 +398,24 @@ std::pair<sbn::crt::CRTTrack, double> CRTTrackMatchAlg::ClosestCRTTrackByAngle(d
       if(minDCA == 0) minDCA = fMaxDistance;
       double crtTime = ((double)(int)possTrack.ts1_ns) * 1e-3; // [us]
       double shift = driftDirection * crtTime * detProp.DriftVelocity();
-      double DCA = AveDCABetweenTracks(tpcTrack, possTrack, shift);
+      double DCA = AveDCABetweenTracks(points, possTrack, shift);
       if(DCA > minDCA) continue;
     }
-      
-    candidates.push_back(std::make_pair(possTrack, angle));
+
+    if(closest == nullptr || angle < minAngle){
+      closest = &possTrack;
+      minAngle = angle;
+    }
   }
 
-  std::sort(candidates.begin(), candidates.end(), [](auto& left, auto& right){
-            return left.second < right.second;});
+  if(closest != nullptr) return std::make_pair(*closest, minAngle);
 
-  if(candidates.size() > 0){
-    return candidates[0];
-  }
   sbn::crt::CRTTrack track;
   return std::make_pair(track, -99999);
 }
 
 std::pair<sbn::crt::CRTTrack, double> CRTTrackMatchAlg::ClosestCRTTrackByDCA(detinfo::DetectorPropertiesData const& detProp,
-									     recob::Track tpcTrack, std::vector<sbn::crt::CRTTrack> crtTracks, const art::Event& event, double minAngle) {
+									     const recob::Track& tpcTrack, const std::vector<sbn::crt::CRTTrack>& crtTracks, const art::Event& event, double minAngle) {
   auto tpcTrackHandle = event.getValidHandle<std::vector<recob::Track>>(fTPCTrackLabel);
   art::FindManyP<recob::Hit> findManyHits(tpcTrackHandle, event, fTPCTrackLabel);
   std::vector<art::Ptr<recob::Hit>> hits = findManyHits.at(tpcTrack.ID());
@@ -266,35 +424,52 @@ std::pair<sbn::crt::CRTTrack, double> CRTTrackMatchAlg::ClosestCRTTrackByDCA(det
 
 // Find the closest matching crt track by average DCA between tracks within angle and DCA limits
 std::pair<sbn::crt::CRTTrack, double> CRTTrackMatchAlg::ClosestCRTTrackByDCA(detinfo::DetectorPropertiesData const& detProp,
-                                                                        recob::Track tpcTrack, std::vector<art::Ptr<recob::Hit>> hits, std::vector<sbn::crt::CRTTrack> crtTracks,  double minAngle){
+                                                                        const recob::Track& tpcTrack, const std::vector<art::Ptr<recob::Hit>>& hits, const std::vector<sbn::crt::CRTTrack>& crtTracks,  double minAngle){
 
   // Get the drift direction (0 for stitched tracks)
   int driftDirection = TPCGeoUtil::DriftDirectionFromHits(fGeometryService, hits);
+  return ClosestByDCA(detProp, tpcTrack, driftDirection, AllPossibleCRTTracks(detProp, tpcTrack, hits, crtTracks), minAngle);
+}
 
-  std::vector<sbn::crt::CRTTrack> possTracks = AllPossibleCRTTracks(detProp, tpcTrack, hits, crtTracks);
+std::pair<sbn::crt::CRTTrack, double> CRTTrackMatchAlg::ClosestCRTTrackByDCA(detinfo::DetectorPropertiesData const& detProp,
+                                                                        const recob::Track& tpcTrack, const std::vector<art::Ptr<recob::Hit>>& hits, const CRTTrackTimeIndex& crtTrackIndex,  double minAngle){
+
+  int driftDirection = TPCGeoUtil::DriftDirectionFromHits(fGeometryService, hits);
+  return ClosestByDCA(detProp, tpcTrack, driftDirection, AllPossibleCRTTracks(detProp, tpcTrack, hits, crtTrackIndex), minAngle);
+}
+
+std::pair<sbn::crt::CRTTrack, double> CRTTrackMatchAlg::ClosestByDCA(detinfo::DetectorPropertiesData const& detProp,
+                                                                     const recob::Track& tpcTrack, int driftDirection,
+                                                                     const std::vector<sbn::crt::CRTTrack>& possTracks, double minAngle){
 
-  std::vector<std::pair<sbn::crt::CRTTrack, double>> candidates;
+  // Take the track points once for all the CRT tracks
+  CRTCommonUtils::PointArrays points;
+  if(!possTracks.empty()) points = TrackPoints(tpcTrack);
+
+  // Keep the first track with the smallest DCA
+  const sbn::crt::CRTTrack* closest = nullptr;
+  double minDCA = 0;
   for(auto const& possTrack : possTracks){
 
     double crtTime = ((double)(int)possTrack.ts1_ns) * 1e-3; // [us]
     double shift = driftDirection * crtTime * detProp.DriftVelocity();
 
-    double DCA = AveDCABetweenTracks(tpcTrack, possTrack, shift);
+    double DCA = AveDCABetweenTracks(points, possTrack, shift);
 
     if(minAngle != -1){
       if(minAngle == 0) minAngle = fMaxAngleDiff;
       double angle = AngleBetweenTracks(tpcTrack, possTrack);
       if(angle > minAngle) continue;
     }
-    candidates.push_back(std::make_pair(possTrack, DCA));
+
+    if(closest == nullptr || DCA < minDCA){
+      closest = &possTrack;
+      minDCA = DCA;
+    }
   }
 
-  std::sort(candidates.begin(), candidates.end(), [](auto& left, auto& right){
-            return left.second < right.second;});
+  if(closest != nullptr) return std::make_pair(*closest, minDCA);
 
-  if(candidates.size() > 0){
-    return candidates[0];
-  }
   sbn::crt::CRTTrack track;
   return std::make_pair(track, -99999);
 
@@ -302,7 +477,7 @@ std::pair<sbn::crt::CRTTrack, double> CRTTrackMatchAlg::ClosestCRTTrackByDCA(det
 
 
 std::pair<sbn::crt::CRTTrack, double> CRTTrackMatchAlg::ClosestCRTTrackByScore(detinfo::DetectorPropertiesData const& detProp,
-									       recob::Track tpcTrack, std::vector<sbn::crt::CRTTrack> crtTracks, const art::Event& event) {
+									       const recob::Track& tpcTrack, const std::vector<sbn::crt::CRTTrack>& crtTracks, const art::Event& event) {
   auto tpcTrackHandle = event.getValidHandle<std::vector<recob::Track>>(fTPCTrackLabel);
   art::FindManyP<recob::Hit> findManyHits(tpcTrackHandle, event, fTPCTrackLabel);
   std::vector<art::Ptr<recob::Hit>> hits = findManyHits.at(tpcTrack.ID());
@@ -311,32 +486,48 @@ std::pair<sbn::crt::CRTTrack, double> CRTTrackMatchAlg::ClosestCRTTrackByScore(d
 
 // Find the closest matching crt track by average DCA between tracks within angle and DCA limits
 std::pair<sbn::crt::CRTTrack, double> CRTTrackMatchAlg::ClosestCRTTrackByScore(detinfo::DetectorPropertiesData const& detProp,
-                                                                          recob::Track tpcTrack, std::vector<art::Ptr<recob::Hit>> hits, std::vector<sbn::crt::CRTTrack> crtTracks){
+                                                                          const recob::Track& tpcTrack, const std::vector<art::Ptr<recob::Hit>>& hits, const std::vector<sbn::crt::CRTTrack>& crtTracks){
 
   // Get the drift direction (0 for stitched tracks)
   int driftDirection = TPCGeoUtil::DriftDirectionFromHits(fGeometryService, hits);
+  return ClosestByScore(detProp, tpcTrack, driftDirection, AllPossibleCRTTracks(detProp, tpcTrack, hits, crtTracks));
+}
+
+std::pair<sbn::crt::CRTTrack, double> CRTTrackMatchAlg::ClosestCRTTrackByScore(detinfo::DetectorPropertiesData const& detProp,
+                                                                          const recob::Track& tpcTrack, const std::vector<art::Ptr<recob::Hit>>& hits, const CRTTrackTimeIndex& crtTrackIndex){
+
+  int driftDirection = TPCGeoUtil::DriftDirectionFromHits(fGeometryService, hits);
+  return ClosestByScore(detProp, tpcTrack, driftDirection, AllPossibleCRTTracks(detProp, tpcTrack, hits, crtTrackIndex));
+}
+
+std::pair<sbn::crt::CRTTrack, double> CRTTrackMatchAlg::ClosestByScore(detinfo::DetectorPropertiesData const& detProp,
+                                                                       const recob::Track& tpcTrack, int driftDirection,
+                                                                       const std::vector<sbn::crt::CRTTrack>& possTracks){
 
-  std::vector<sbn::crt::CRTTrack> possTracks = AllPossibleCRTTracks(detProp, tpcTrack, hits, crtTracks);
+  // Take the track points once for all the CRT tracks
+  CRTCommonUtils::PointArrays points;
+  if(!possTracks.empty()) points = TrackPoints(tpcTrack);
 
-  std::vector<std::pair<sbn::crt::CRTTrack, double>> candidates;
+  // Keep the first track with the smallest score
+  const sbn::crt::CRTTrack* closest = nullptr;
+  double minScore = 0;
   for(auto const& possTrack : possTracks){
 
     double crtTime = ((double)(int)possTrack.ts1_ns) * 1e-3; // [us]
     double shift = driftDirection * crtTime * detProp.DriftVelocity();
 
-    double DCA = AveDCABetweenTracks(tpcTrack, possTrack, shift);
+    double DCA = AveDCABetweenTracks(points, possTrack, shift);
     double angle = AngleBetweenTracks(tpcTrack, possTrack);
     double score = DCA + 4*180/TMath::Pi()*angle;
 
-    candidates.push_back(std::make_pair(possTrack, score));
+    if(closest == nullptr || score < minScore){
+      closest = &possTrack;
+      minScore = score;
+    }
   }
 
-  std::sort(candidates.begin(), candidates.end(), [](auto& left, auto& right){
-            return left.second < right.second;});
+  if(closest != nullptr) return std::make_pair(*closest, minScore);
 
-  if(candidates.size() > 0){
-    return candidates[0];
-  }
   sbn::crt::CRTTrack track;
   return std::make_pair(track, -99999);
 
@@ -344,7 +535,7 @@ std::pair<sbn::crt::CRTTrack, double> CRTTrackMatchAlg::ClosestCRTTrackByScore(d
 
 
 // Calculate the angle between tracks assuming start is at the largest Y
-double CRTTrackMatchAlg::AngleBetweenTracks(recob::Track tpcTrack, sbn::crt::CRTTrack crtTrack){
+double CRTTrackMatchAlg::AngleBetweenTracks(const recob::Track& tpcTrack, const sbn::crt::CRTTrack& crtTrack){
 
   // Calculate the angle between the tracks
   TVector3 crtStart (crtTrack.x1_pos, crtTrack.y1_pos, crtTrack.z1_pos);
@@ -361,29 +552,38 @@ double CRTTrackMatchAlg::AngleBetweenTracks(recob::Track tpcTrack, sbn::crt::CRT
 
 
 // Calculate the average DCA between tracks
-double CRTTrackMatchAlg::AveDCABetweenTracks(recob::Track tpcTrack, sbn::crt::CRTTrack crtTrack, double shift){
+double CRTTrackMatchAlg::AveDCABetweenTracks(const recob::Track& tpcTrack, const sbn::crt::CRTTrack& crtTrack, double shift){
 
-  TVector3 crtStart (crtTrack.x1_pos, crtTrack.y1_pos, crtTrack.z1_pos);
-  TVector3 crtEnd (crtTrack.x2_pos, crtTrack.y2_pos, crtTrack.z2_pos);
-  if(crtStart.Y() < crtEnd.Y()) std::swap(crtStart, crtEnd);
-  double denominator = (crtEnd - crtStart).Mag();
+  return AveDCABetweenTracks(TrackPoints(tpcTrack), crtTrack, shift);
+
+}
+
+// Valid trajectory points of a track as coordinate arrays
+CRTCommonUtils::PointArrays CRTTrackMatchAlg::TrackPoints(const recob::Track& tpcTrack) const {
 
   size_t npts = tpcTrack.NumberTrajectoryPoints();
 
-  double aveDCA = 0;
-  int usedPts = 0;
+  CRTCommonUtils::PointArrays points;
+  points.Reserve(npts);
   for(size_t i = 0; i < npts; i++){
-    TVector3 point = tpcTrack.LocationAtPoint<TVector3>(i);
-
     // Pandora produces dummy points
     if(!tpcTrack.HasValidPoint(i)) continue;
-
-    point.SetX(point.X() + shift);
-    aveDCA += (point - crtStart).Cross(point - crtEnd).Mag()/denominator;
-    usedPts++;
+    auto const& point = tpcTrack.LocationAtPoint(i);
+    points.Add(point.X(), point.Y(), point.Z());
   }
 
-  return aveDCA/usedPts;
+  return points;
+
+}
+
+// Average DCA between the track points shifted in x and a CRT track
+double CRTTrackMatchAlg::AveDCABetweenTracks(const CRTCommonUtils::PointArrays& points, const sbn::crt::CRTTrack& crtTrack, double shift) const {
+
+  TVector3 crtStart (crtTrack.x1_pos, crtTrack.y1_pos, crtTrack.z1_pos);
+  TVector3 crtEnd (crtTrack.x2_pos, crtTrack.y2_pos, crtTrack.z2_pos);
+  if(crtStart.Y() < crtEnd.Y()) std::swap(crtStart, crtEnd);
+
+  return CRTCommonUtils::AveDistToLine(points, shift, crtStart, crtEnd);
 
 }
 
@@ -405,27 +605,7 @@ double CRTTrackMatchAlg::AveDCABetweenTracks(detinfo::DetectorPropertiesData con
   double crtTime = ((double)(int)crtTrack.ts1_ns) * 1e-3; // [us]
   double shift = driftDirection * crtTime * detProp.DriftVelocity();
 
-  TVector3 crtStart (crtTrack.x1_pos, crtTrack.y1_pos, crtTrack.z1_pos);
-  TVector3 crtEnd (crtTrack.x2_pos, crtTrack.y2_pos, crtTrack.z2_pos);
-  if(crtStart.Y() < crtEnd.Y()) std::swap(crtStart, crtEnd);
-  double denominator = (crtEnd - crtStart).Mag();
-
-  size_t npts = tpcTrack.NumberTrajectoryPoints();
-
-  double aveDCA = 0;
-  int usedPts = 0;
-  for(size_t i = 0; i < npts; i++){
-    TVector3 point = tpcTrack.LocationAtPoint<TVector3>(i);
-
-    // Pandora produces dummy points
-    if(!tpcTrack.HasValidPoint(i)) continue;
-
-    point.SetX(point.X() + shift);
-    aveDCA += (point - crtStart).Cross(point - crtEnd).Mag()/denominator;
-    usedPts++;
-  }
-
-  return aveDCA/usedPts;
+  return AveDCABetweenTracks(TrackPoints(tpcTrack), crtTrack, shift);
 
 }
 
@@ -19,6 +19,7 @@
 #include "art/Framework/Services/Registry/ServiceHandle.h" 
 #include "messagefacility/MessageLogger/MessageLogger.h" 
 #include "canvas/Persistency/Common/FindManyP.h"
+#include "cetlib_except/exception.h"
 
 // LArSoft
 #include "lardataobj/RecoBase/Hit.h"
@@ -38,6 +39,7 @@
 #include "sbnobj/Common/CRT/CRTTrack.hh"
 #include "sbndcode/CRT/CRTUtils/CRTBackTracker.h"
 #include "sbndcode/CRT/CRTUtils/CRTCommonUtils.h"
+#include "sbndcode/CRT/CRTUtils/CRTTimeIndex.h"
 #include "sbndcode/CRT/CRTUtils/TPCGeoUtil.h"
 
 // c++
@@ -106,7 +108,7 @@ namespace sbnd{
     void reconfigure(const Config& config);
 
     // Calculate intersection between CRT track and TPC
-    std::pair<TVector3, TVector3> TpcIntersection(const geo::TPCGeo& tpcGeo, sbn::crt::CRTTrack track);
+    std::pair<TVector3, TVector3> TpcIntersection(const geo::TPCGeo& tpcGeo, const sbn::crt::CRTTrack& track);
 
     // Function to calculate if a CRTTrack crosses the TPC volume
     bool CrossesTPC(sbn::crt::CRTTrack track);
@@ -114,71 +116,113 @@ namespace sbnd{
     // Function to calculate if a CRTTrack crosses the TPC volume
     bool CrossesAPA(sbn::crt::CRTTrack track);
 
+    // Index of the event CRT tracks sorted by time, can be shared by all TPC tracks in the event
+    CRTTrackTimeIndex TrackTimeIndex(const std::vector<sbn::crt::CRTTrack>& crtTracks) const;
+
+    double T0FromCRTTracks(detinfo::DetectorPropertiesData const& detProp,
+                           const recob::Track& tpcTrack, const std::vector<sbn::crt::CRTTrack>& crtTracks, const art::Event& event);
     double T0FromCRTTracks(detinfo::DetectorPropertiesData const& detProp,
-                           recob::Track tpcTrack, std::vector<sbn::crt::CRTTrack> crtTracks, const art::Event& event);
+                           const recob::Track& tpcTrack, const std::vector<art::Ptr<recob::Hit>>& hits, const std::vector<sbn::crt::CRTTrack>& crtTracks);
     double T0FromCRTTracks(detinfo::DetectorPropertiesData const& detProp,
-                           recob::Track tpcTrack, std::vector<art::Ptr<recob::Hit>> hits, std::vector<sbn::crt::CRTTrack> crtTracks);
+                           const recob::Track& tpcTrack, const std::vector<art::Ptr<recob::Hit>>& hits, const CRTTrackTimeIndex& crtTrackIndex);
 
     // Find the closest valid matching CRT track ID
     int GetMatchedCRTTrackId(detinfo::DetectorPropertiesData const& detProp,
-                             recob::Track tpcTrack, std::vector<sbn::crt::CRTTrack> crtTracks, const art::Event& event);
+                             const recob::Track& tpcTrack, const std::vector<sbn::crt::CRTTrack>& crtTracks, const art::Event& event);
+    int GetMatchedCRTTrackId(detinfo::DetectorPropertiesData const& detProp,
+                             const recob::Track& tpcTrack, const std::vector<art::Ptr<recob::Hit>>& hits, const std::vector<sbn::crt::CRTTrack>& crtTracks);
     int GetMatchedCRTTrackId(detinfo::DetectorPropertiesData const& detProp,
-                             recob::Track tpcTrack, std::vector<art::Ptr<recob::Hit>> hits, std::vector<sbn::crt::CRTTrack> crtTracks);
+                             const recob::Track& tpcTrack, const std::vector<art::Ptr<recob::Hit>>& hits, const CRTTrackTimeIndex& crtTrackIndex);
 
     // Find the closest valid matching CRT track ID and return the minimised matching metric
     std::pair<int,double> GetMatchedCRTTrackIdAndScore(detinfo::DetectorPropertiesData const& detProp,
-                                                       recob::Track tpcTrack, std::vector<sbn::crt::CRTTrack> crtTracks, const art::Event& event);
+                                                       const recob::Track& tpcTrack, const std::vector<sbn::crt::CRTTrack>& crtTracks, const art::Event& event);
     std::pair<int,double> GetMatchedCRTTrackIdAndScore(detinfo::DetectorPropertiesData const& detProp,
-                                                       recob::Track tpcTrack, std::vector<art::Ptr<recob::Hit>> hits, std::vector<sbn::crt::CRTTrack> crtTracks);
+                                                       const recob::Track& tpcTrack, const std::vector<art::Ptr<recob::Hit>>& hits, const std::vector<sbn::crt::CRTTrack>& crtTracks);
+    std::pair<int,double> GetMatchedCRTTrackIdAndScore(detinfo::DetectorPropertiesData const& detProp,
+                                                       const recob::Track& tpcTrack, const std::vector<art::Ptr<recob::Hit>>& hits, const CRTTrackTimeIndex& crtTrackIndex);
+
+    // Batch versions for all the tracks of an event, results are in the order of tpcTracks
+    // Hits are taken from hitAssoc by track ID, tracks can be split over nThreads threads
+    std::vector<double> T0sFromCRTTracks(detinfo::DetectorPropertiesData const& detProp,
+                                         const std::vector<recob::Track>& tpcTracks, const art::FindManyP<recob::Hit>& hitAssoc,
+                                         const CRTTrackTimeIndex& crtTrackIndex, unsigned nThreads = 1);
+    std::vector<std::pair<int,double>> GetMatchedCRTTrackIdsAndScores(detinfo::DetectorPropertiesData const& detProp,
+                                                                      const std::vector<recob::Track>& tpcTracks, const art::FindManyP<recob::Hit>& hitAssoc,
+                                                                      const CRTTrackTimeIndex& crtTrackIndex, unsigned nThreads = 1);
+
+    // Batch version reading the tracks and associations from the event once
+    std::vector<std::pair<int,double>> GetMatchedCRTTrackIdsAndScores(detinfo::DetectorPropertiesData const& detProp,
+                                                                      const std::vector<sbn::crt::CRTTrack>& crtTracks, const art::Event& event,
+                                                                      unsigned nThreads = 1);
 
     // Get all CRT tracks that cross the right TPC within an allowed time
     std::vector<sbn::crt::CRTTrack> AllPossibleCRTTracks(detinfo::DetectorPropertiesData const& detProp,
-                                                    recob::Track tpcTrack,
-                                                    std::vector<sbn::crt::CRTTrack> crtTracks, 
+                                                    const recob::Track& tpcTrack,
+                                                    const std::vector<sbn::crt::CRTTrack>& crtTracks, 
                                                     const art::Event& event); 
 
     std::vector<sbn::crt::CRTTrack> AllPossibleCRTTracks(detinfo::DetectorPropertiesData const& detProp,
-                                                    recob::Track tpcTrack,
-                                                    std::vector<art::Ptr<recob::Hit>> hits,
-                                                    std::vector<sbn::crt::CRTTrack> crtTracks);
+                                                    const recob::Track& tpcTrack,
+                                                    const std::vector<art::Ptr<recob::Hit>>& hits,
+                                                    const std::vector<sbn::crt::CRTTrack>& crtTracks);
+
+    std::vector<sbn::crt::CRTTrack> AllPossibleCRTTracks(detinfo::DetectorPropertiesData const& detProp,
+                                                    const recob::Track& tpcTrack,
+                                                    const std::vector<art::Ptr<recob::Hit>>& hits,
+                                                    const CRTTrackTimeIndex& crtTrackIndex);
 
     // Find the closest matching crt track by angle between tracks within angle and DCA limits
     std::pair<sbn::crt::CRTTrack, double> ClosestCRTTrackByAngle(detinfo::DetectorPropertiesData const& detProp,
-                                                            recob::Track tpcTrack,
-                                                            std::vector<sbn::crt::CRTTrack> crtTracks, 
+                                                            const recob::Track& tpcTrack,
+                                                            const std::vector<sbn::crt::CRTTrack>& crtTracks, 
                                                             const art::Event& event,
                                                             double minDCA = 0.); 
     std::pair<sbn::crt::CRTTrack, double> ClosestCRTTrackByAngle(detinfo::DetectorPropertiesData const& detProp,
-                                                            recob::Track tpcTrack,
-                                                            std::vector<art::Ptr<recob::Hit>> hits, 
-                                                            std::vector<sbn::crt::CRTTrack> crtTracks, 
+                                                            const recob::Track& tpcTrack,
+                                                            const std::vector<art::Ptr<recob::Hit>>& hits, 
+                                                            const std::vector<sbn::crt::CRTTrack>& crtTracks, 
+                                                            double minDCA = 0.); 
+    std::pair<sbn::crt::CRTTrack, double> ClosestCRTTrackByAngle(detinfo::DetectorPropertiesData const& detProp,
+                                                            const recob::Track& tpcTrack,
+                                                            const std::vector<art::Ptr<recob::Hit>>& hits, 
+                                                            const CRTTrackTimeIndex& crtTrackIndex, 
                                                             double minDCA = 0.); 
     // Find the closest matching crt track by average DCA between tracks within angle and DCA limits
     std::pair<sbn::crt::CRTTrack, double> ClosestCRTTrackByDCA(detinfo::DetectorPropertiesData const& detProp,
-                                                          recob::Track tpcTrack,
-                                                          std::vector<sbn::crt::CRTTrack> crtTracks, 
+                                                          const recob::Track& tpcTrack,
+                                                          const std::vector<sbn::crt::CRTTrack>& crtTracks, 
 							                                            const art::Event& event,
                                                           double minAngle = 0.); 
     std::pair<sbn::crt::CRTTrack, double> ClosestCRTTrackByDCA(detinfo::DetectorPropertiesData const& detProp,
-                                                          recob::Track tpcTrack,
-                                                          std::vector<art::Ptr<recob::Hit>> hits, 
-                                                          std::vector<sbn::crt::CRTTrack> crtTracks, 
+                                                          const recob::Track& tpcTrack,
+                                                          const std::vector<art::Ptr<recob::Hit>>& hits, 
+                                                          const std::vector<sbn::crt::CRTTrack>& crtTracks, 
+                                                          double minAngle = 0.); 
+    std::pair<sbn::crt::CRTTrack, double> ClosestCRTTrackByDCA(detinfo::DetectorPropertiesData const& detProp,
+                                                          const recob::Track& tpcTrack,
+                                                          const std::vector<art::Ptr<recob::Hit>>& hits, 
+                                                          const CRTTrackTimeIndex& crtTrackIndex, 
                                                           double minAngle = 0.); 
     // Find the closest matching crt track by average DCA between tracks within angle and DCA limits
     std::pair<sbn::crt::CRTTrack, double> ClosestCRTTrackByScore(detinfo::DetectorPropertiesData const& detProp,
-                                                            recob::Track tpcTrack,
-							    std::vector<sbn::crt::CRTTrack> crtTracks, 
+                                                            const recob::Track& tpcTrack,
+							    const std::vector<sbn::crt::CRTTrack>& crtTracks, 
 							                                            const art::Event& event); 
     std::pair<sbn::crt::CRTTrack, double> ClosestCRTTrackByScore(detinfo::DetectorPropertiesData const& detProp,
-                                                            recob::Track tpcTrack,
-                                                          std::vector<art::Ptr<recob::Hit>> hits, 
-                                                          std::vector<sbn::crt::CRTTrack> crtTracks);
+                                                            const recob::Track& tpcTrack,
+                                                          const std::vector<art::Ptr<recob::Hit>>& hits, 
+                                                          const std::vector<sbn::crt::CRTTrack>& crtTracks);
+    std::pair<sbn::crt::CRTTrack, double> ClosestCRTTrackByScore(detinfo::DetectorPropertiesData const& detProp,
+                                                            const recob::Track& tpcTrack,
+                                                          const std::vector<art::Ptr<recob::Hit>>& hits, 
+                                                          const CRTTrackTimeIndex& crtTrackIndex);
 
     // Calculate the angle between tracks assuming start is at the largest Y
-    double AngleBetweenTracks(recob::Track tpcTrack, sbn::crt::CRTTrack crtTrack);
+    double AngleBetweenTracks(const recob::Track& tpcTrack, const sbn::crt::CRTTrack& crtTrack);
 
     // Calculate the average DCA between tracks
-    double AveDCABetweenTracks(recob::Track tpcTrack, sbn::crt::CRTTrack crtTrack, double shift);
+    double AveDCABetweenTracks(const recob::Track& tpcTrack, const sbn::crt::CRTTrack& crtTrack, double shift);
     double AveDCABetweenTracks(detinfo::DetectorPropertiesData const& detProp,
                                recob::Track tpcTrack, sbn::crt::CRTTrack crtTrack, const art::Event& event);
     double AveDCABetweenTracks(detinfo::DetectorPropertiesData const& detProp,
@@ -197,6 +241,36 @@ namespace sbnd{
 
     art::InputTag fTPCTrackLabel;
 
+    // Does the CRT track cross the TPC and contain the TPC track when shifted to its time
+    bool PossibleCRTTrack(detinfo::DetectorPropertiesData const& detProp, const recob::Track& tpcTrack,
+                          const geo::TPCGeo& tpcGeo, int driftDirection, const sbn::crt::CRTTrack& crtTrack);
+
+    // Valid trajectory points of a track as coordinate arrays, taken once for all the CRT tracks
+    CRTCommonUtils::PointArrays TrackPoints(const recob::Track& tpcTrack) const;
+
+    // Average DCA between the track points shifted in x and a CRT track
+    double AveDCABetweenTracks(const CRTCommonUtils::PointArrays& points, const sbn::crt::CRTTrack& crtTrack, double shift) const;
+
+    // Select from the possible tracks by each metric
+    std::pair<sbn::crt::CRTTrack, double> ClosestByAngle(detinfo::DetectorPropertiesData const& detProp,
+                                                         const recob::Track& tpcTrack, int driftDirection,
+                                                         const std::vector<sbn::crt::CRTTrack>& possTracks, double minDCA);
+    std::pair<sbn::crt::CRTTrack, double> ClosestByDCA(detinfo::DetectorPropertiesData const& detProp,
+                                                       const recob::Track& tpcTrack, int driftDirection,
+                                                       const std::vector<sbn::crt::CRTTrack>& possTracks, double minAngle);
+    std::pair<sbn::crt::CRTTrack, double> ClosestByScore(detinfo::DetectorPropertiesData const& detProp,
+                                                         const recob::Track& tpcTrack, int driftDirection,
+                                                         const std::vector<sbn::crt::CRTTrack>& possTracks);
+
+    // Closest track with the configured selection metric, -99999 if none passes its limit
+    std::pair<sbn::crt::CRTTrack, double> SelectedCRTTrack(detinfo::DetectorPropertiesData const& detProp,
+                                                           const recob::Track& tpcTrack, int driftDirection,
+                                                           const std::vector<sbn::crt::CRTTrack>& possTracks);
+
+    // Position of the selected track in the event CRT tracks
+    std::pair<int,double> MatchedCRTTrackId(const std::pair<sbn::crt::CRTTrack, double>& closest,
+                                            const std::vector<sbn::crt::CRTTrack>& crtTracks);
+
   };
 
 }
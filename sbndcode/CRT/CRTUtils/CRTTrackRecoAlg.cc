@@ -9,6 +9,15 @@ CRTTrackRecoAlg::CRTTrackRecoAlg(const Config& config)
   
 }
 
+CRTTrackRecoAlg::CRTTrackRecoAlg(const Config& config, geo::GeometryCore const *geometry,
+                                 geo::AuxDetGeometryCore const *auxdet_geometry)
+  : hitAlg(geometry, auxdet_geometry)
+  , fCrtGeo(geometry, auxdet_geometry) {
+
+  this->reconfigure(config);
+
+}
+
 CRTTrackRecoAlg::CRTTrackRecoAlg(double aveHitDist, double distLim)
   : hitAlg() {
 
@@ -38,36 +47,27 @@ std::vector<std::vector<art::Ptr<sbn::crt::CRTHit>>> CRTTrackRecoAlg::CreateCRTT
 {
 
   std::vector<std::vector<art::Ptr<sbn::crt::CRTHit>>> crtTzeroVect;
-  std::vector<int> iflag(hits.size(), 0);
 
   // Sort CRTHits by time
   std::sort(hits.begin(), hits.end(), [](auto& left, auto& right)->bool{
               return left->ts1_ns < right->ts1_ns;});
 
-  // Loop over crt hits
-  for(size_t i = 0; i<hits.size(); i++){
-    if(iflag[i] == 0){
-      std::vector<art::Ptr<sbn::crt::CRTHit>> crtTzero;
-      double time_ns_A = hits[i]->ts1_ns;
-      iflag[i]=1;
-      crtTzero.push_back(hits[i]);
-
-      // Sort into a Tzero collection
-      // Loop over all the other CRT hits
-      for(size_t j = i+1; j<hits.size(); j++){
-        if(iflag[j] == 0){
-          // If ts1_ns - ts1_ns < diff then put them in a vector
-          double time_ns_B = hits[j]->ts1_ns; 
-          double diff = std::abs(time_ns_B - time_ns_A) * 1e-3; // [us]
-          if(diff < fTimeLimit){
-            iflag[j] = 1;
-            crtTzero.push_back(hits[j]);
-          }
-        }
-      }
-
-      crtTzeroVect.push_back(crtTzero);
+  // Each T0 collection is seeded by the earliest hit not yet used and takes all
+  // later hits within the time limit of the seed. As the hits are sorted these
+  // are the hits up to the first one outside the limit, and the next seed is
+  // the hit after them, so one pass over the hits is enough
+  size_t i = 0;
+  while(i < hits.size()){
+    double time_ns_A = hits[i]->ts1_ns;
+
+    size_t j = i+1;
+    // If ts1_ns - ts1_ns < diff then put them in a vector
+    while(j < hits.size() && std::abs(hits[j]->ts1_ns - time_ns_A) * 1e-3 < fTimeLimit){ // [us]
+      j++;
     }
+
+    crtTzeroVect.emplace_back(hits.begin() + i, hits.begin() + j);
+    i = j;
   }
   return crtTzeroVect;
 }
@@ -275,31 +275,101 @@ std::vector<std::pair<sbn::crt::CRTTrack, std::vector<int>>> CRTTrackRecoAlg::Cr
 
   std::vector<std::pair<sbn::crt::CRTTrack, std::vector<int>>> returnTracks;
 
+  size_t nHits = hits.size();
+
+  // Give each tagger an index and record the hits on it, the hit positions and
+  // the radius of the sphere around each hit are kept in plain vectors
+  std::vector<std::string> taggerNames;
+  std::vector<size_t> hitTaggers(nHits);
+  std::vector<float> hitX(nHits), hitY(nHits), hitZ(nHits), hitR(nHits);
+  for(size_t i = 0; i < nHits; i++){
+    const sbn::crt::CRTHit& hit = hits[i].first;
+    size_t tagger_i = std::find(taggerNames.begin(), taggerNames.end(), hit.tagger) - taggerNames.begin();
+    if(tagger_i == taggerNames.size()) taggerNames.push_back(hit.tagger);
+    hitTaggers[i] = tagger_i;
+    hitX[i] = hit.x_pos;
+    hitY[i] = hit.y_pos;
+    hitZ[i] = hit.z_pos;
+    hitR[i] = std::sqrt(hit.x_err*hit.x_err + hit.y_err*hit.y_err + hit.z_err*hit.z_err);
+  }
+
+  // Sphere around all of the hits on each tagger, from their bounding box
+  size_t nTaggers = taggerNames.size();
+  std::vector<std::vector<size_t>> taggerHits(nTaggers);
+  std::vector<float> minX(nTaggers, 99999), minY(nTaggers, 99999), minZ(nTaggers, 99999);
+  std::vector<float> maxX(nTaggers, -99999), maxY(nTaggers, -99999), maxZ(nTaggers, -99999);
+  for(size_t i = 0; i < nHits; i++){
+    const sbn::crt::CRTHit& hit = hits[i].first;
+    size_t t = hitTaggers[i];
+    taggerHits[t].push_back(i);
+    minX[t] = std::min(minX[t], (float)(hit.x_pos - hit.x_err));
+    maxX[t] = std::max(maxX[t], (float)(hit.x_pos + hit.x_err));
+    minY[t] = std::min(minY[t], (float)(hit.y_pos - hit.y_err));
+    maxY[t] = std::max(maxY[t], (float)(hit.y_pos + hit.y_err));
+    minZ[t] = std::min(minZ[t], (float)(hit.z_pos - hit.z_err));
+    maxZ[t] = std::max(maxZ[t], (float)(hit.z_pos + hit.z_err));
+  }
+  std::vector<float> taggerX(nTaggers), taggerY(nTaggers), taggerZ(nTaggers), taggerR(nTaggers);
+  for(size_t t = 0; t < nTaggers; t++){
+    taggerX[t] = (minX[t] + maxX[t])/2.;
+    taggerY[t] = (minY[t] + maxY[t])/2.;
+    taggerZ[t] = (minZ[t] + maxZ[t])/2.;
+    taggerR[t] = std::sqrt((maxX[t]-minX[t])*(maxX[t]-minX[t]) + (maxY[t]-minY[t])*(maxY[t]-minY[t])
+                           + (maxZ[t]-minZ[t])*(maxZ[t]-minZ[t]))/2.;
+  }
+
+  // A hit can only be within the distance limit of the line if the sphere around it is, the
+  // margin keeps the float rounding from removing hits that the full calculation would accept.
+  // Only prune when the direction of the line is well defined
+  const double pruneLimit = fDistanceLimit + 0.1;
+  const double minPruneLength = 1.;
+
   std::vector<std::vector<size_t>> trackCandidates;
   // Loop over all hits
-  for(size_t i = 0; i < hits.size(); i++){
+  for(size_t i = 0; i < nHits; i++){
 
     // Loop over all unique pairs
-    for(size_t j = i+1; j < hits.size(); j++){
-      if(hits[i].first.tagger == hits[j].first.tagger) continue;
+    for(size_t j = i+1; j < nHits; j++){
+      if(hitTaggers[i] == hitTaggers[j]) continue;
 
       // Draw a track between the two hits
       TVector3 start (hits[i].first.x_pos, hits[i].first.y_pos, hits[i].first.z_pos);
       TVector3 end (hits[j].first.x_pos, hits[j].first.y_pos, hits[j].first.z_pos);
-      TVector3 diff = end - start;
+
+      float dx = hitX[j] - hitX[i];
+      float dy = hitY[j] - hitY[i];
+      float dz = hitZ[j] - hitZ[i];
+      float length = std::sqrt(dx*dx + dy*dy + dz*dz);
+      // Distance of a point from the line through the two hits
+      auto lineDist = [&](float x, float y, float z){
+        float wx = x - hitX[i];
+        float wy = y - hitY[i];
+        float wz = z - hitZ[i];
+        float cx = wy*dz - wz*dy;
+        float cy = wz*dx - wx*dz;
+        float cz = wx*dy - wy*dx;
+        return std::sqrt(cx*cx + cy*cy + cz*cz)/length;
+      };
 
       std::vector<size_t> candidate {i, j};
 
       // Loop over all other hits on different taggers and calculate DCA with variations
-      for(size_t k = 0; k < hits.size(); k++){
-        if(k == i || k == j || hits[k].first.tagger == hits[i].first.tagger 
-           || hits[k].first.tagger == hits[j].first.tagger) continue;
+      for(size_t t = 0; t < nTaggers; t++){
+        if(t == hitTaggers[i] || t == hitTaggers[j]) continue;
+        // Skip the whole tagger if all of its hits are too far from the line
+        if(length > minPruneLength && lineDist(taggerX[t], taggerY[t], taggerZ[t]) - taggerR[t] > pruneLimit) continue;
 
-        //  If hit within certain distance then add it to the track candidate
-        if(CRTCommonUtils::DistToCrtHit(hits[k].first, start, end) < fDistanceLimit){
-          candidate.push_back(k);
+        for(size_t k : taggerHits[t]){
+          if(length > minPruneLength && lineDist(hitX[k], hitY[k], hitZ[k]) - hitR[k] > pruneLimit) continue;
+
+          //  If hit within certain distance then add it to the track candidate
+          if(CRTCommonUtils::DistToCrtHit(hits[k].first, start, end) < fDistanceLimit){
+            candidate.push_back(k);
+          }
         }
       }
+      // Keep the other hits in input order
+      std::sort(candidate.begin() + 2, candidate.end());
       trackCandidates.push_back(candidate);
     }
   }
@@ -309,13 +379,13 @@ std::vector<std::pair<sbn::crt::CRTTrack, std::vector<int>>> CRTTrackRecoAlg::Cr
             return left.size() > right.size();});
 
   // Loop over track candidates
-  std::vector<size_t> usedHits;
+  std::vector<bool> usedHits(nHits, false);
   for(auto const& candidate : trackCandidates){
     // Check if hits have been used
     bool used = false;
     for(size_t i = 0; i < candidate.size(); i++){
       //Check if any of the hits have been used
-      if(std::find(usedHits.begin(), usedHits.end(), candidate[i]) != usedHits.end()) used = true;
+      if(usedHits[candidate[i]]) used = true;
     }
     if(used) continue;
 
@@ -330,7 +400,7 @@ std::vector<std::pair<sbn::crt::CRTTrack, std::vector<int>>> CRTTrackRecoAlg::Cr
     // If nhits > 2 then record used hits
     for(size_t i = 0; i < candidate.size(); i++){
       ids.insert(ids.end(), hits[candidate[i]].second.begin(), hits[candidate[i]].second.end());
-      if(candidate.size()>2) usedHits.push_back(candidate[i]);
+      if(candidate.size()>2) usedHits[candidate[i]] = true;
     }
 
     returnTracks.push_back(std::make_pair(crtTrack, ids));
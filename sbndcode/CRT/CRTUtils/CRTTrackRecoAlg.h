@@ -82,6 +82,10 @@ namespace sbnd{
 
     CRTTrackRecoAlg(const Config& config);
 
+    // Use the given geometry instead of the geometry services
+    CRTTrackRecoAlg(const Config& config, geo::GeometryCore const *geometry,
+                    geo::AuxDetGeometryCore const *auxdet_geometry);
+
     CRTTrackRecoAlg(const fhicl::ParameterSet& pset) :
       CRTTrackRecoAlg(fhicl::Table<Config>(pset, {})()) {}
 
@@ -0,0 +1,47 @@
+////////////////////////////////////////////////////////////////////////
+// File:        CRTBenchGeometry.h
+//
+// Builds the SBND TPC and CRT geometry outside of art, from the
+// services.Geometry and services.AuxDetGeometry configuration, for the
+// CRT benchmarks.
+////////////////////////////////////////////////////////////////////////
+
+#ifndef SBND_CRTUTILS_BENCH_CRTBENCHGEOMETRY_H
+#define SBND_CRTUTILS_BENCH_CRTBENCHGEOMETRY_H
+
+#include "sbndcode/CRT/CRTChannelMapAlg.h"
+#include "sbndcode/Geometry/ChannelMapSBNDAlg.h"
+
+#include "larcorealg/Geometry/StandaloneGeometrySetup.h"
+#include "larcorealg/Geometry/AuxDetGeometryCore.h"
+#include "larcorealg/Geometry/GeometryCore.h"
+
+#include "fhiclcpp/ParameterSet.h"
+
+#include <memory>
+
+namespace sbnd {
+
+  struct CRTBenchGeometry {
+    std::unique_ptr<geo::GeometryCore> geometry;
+    std::unique_ptr<geo::AuxDetGeometryCore> auxDetGeometry;
+  };
+
+  // As the Geometry and AuxDetGeometry services would build them
+  inline CRTBenchGeometry SetupCRTBenchGeometry(fhicl::ParameterSet const& config)
+  {
+    CRTBenchGeometry bench;
+    bench.geometry = lar::standalone::SetupGeometry<geo::ChannelMapSBNDAlg>(
+      config.get<fhicl::ParameterSet>("services.Geometry"));
+
+    auto const auxDetConfig = config.get<fhicl::ParameterSet>("services.AuxDetGeometry");
+    bench.auxDetGeometry = std::make_unique<geo::AuxDetGeometryCore>(auxDetConfig);
+    bench.auxDetGeometry->LoadGeometryFile(bench.geometry->GDMLFile(), bench.geometry->ROOTFile());
+    bench.auxDetGeometry->ApplyChannelMap(std::make_unique<geo::CRTChannelMapAlg>(
+      auxDetConfig.get<fhicl::ParameterSet>("SortingParameters", {})));
+    return bench;
+  }
+
+}
+
+#endif // SBND_CRTUTILS_BENCH_CRTBENCHGEOMETRY_H
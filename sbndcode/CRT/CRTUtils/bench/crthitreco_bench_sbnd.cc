@@ -0,0 +1,196 @@
+////////////////////////////////////////////////////////////////////////
+// File:        crthitreco_bench_sbnd.cc
+//
+// Benchmark of the CRT hit reconstruction, run outside of the art event
+// loop on the SBND geometry. Synthetic strip hits are made from
+// particles crossing both planes of a tagger plus random noise strips,
+// then:
+//  - the per-strip geometry lookups done by CRTHitRecoAlg are timed
+//    through the strip name accessors and through the channel indexed
+//    accessors of CRTGeoAlg;
+//  - CRTHitRecoAlg::CreateCRTHits is timed on the full events, from the
+//    per tagger map and from the flat strip buffer on NThreads threads,
+//    and the two are checked to give the same hits.
+//
+// Usage: crthitreco_bench_sbnd [config.fcl]   (default: crthitreco_bench_sbnd.fcl)
+// Output: one "key value" pair per line on stdout.
+////////////////////////////////////////////////////////////////////////
+
+#include "sbndcode/CRT/CRTUtils/CRTHitRecoAlg.h"
+#include "sbndcode/CRT/CRTUtils/bench/CRTBenchGeometry.h"
+#include "sbndcode/Geometry/GeometryWrappers/CRTGeoAlg.h"
+
+#include "larcorealg/Geometry/StandaloneBasicSetup.h"
+
+#include "fhiclcpp/ParameterSet.h"
+#include "fhiclcpp/types/Table.h"
+
+#include <array>
+#include <chrono>
+#include <iostream>
+#include <map>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace {
+
+  using TaggerStrips = std::map<std::pair<std::string, unsigned>, std::vector<sbnd::CRTStrip>>;
+
+  double Seconds(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  }
+
+  // Strip hit on the first sipm of a strip, anywhere across its width
+  sbnd::CRTStrip MakeStrip(sbnd::CRTHitRecoAlg& alg, sbnd::CRTStripGeo const& strip, double t0,
+                           std::mt19937& rng, size_t& dataID) {
+    std::uniform_real_distribution<double> ux(0., strip.width);
+    std::uniform_real_distribution<double> upe(10., 200.);
+    uint32_t const channel = strip.sipms.first;
+    sbnd::CRTStrip hit = {t0, channel, ux(rng), 1., upe(rng), alg.ChannelToTagger(channel), dataID};
+    dataID += 2;
+    return hit;
+  }
+
+}
+
+int main(int argc, char** argv)
+{
+  std::string const configFile = argc > 1 ? argv[1] : "crthitreco_bench_sbnd.fcl";
+  fhicl::ParameterSet const config = lar::standalone::ParseConfiguration(configFile);
+  lar::standalone::SetupMessageFacility(config, "crthitreco_bench_sbnd");
+
+  auto const geom = sbnd::SetupCRTBenchGeometry(config);
+
+  auto const& benchConfig = config.get<fhicl::ParameterSet>("benchmark");
+  unsigned const nEvents       = benchConfig.get<unsigned>("NEvents");
+  unsigned const nParticles    = benchConfig.get<unsigned>("ParticlesPerEvent");
+  unsigned const nNoise        = benchConfig.get<unsigned>("NoiseStrips");
+  auto const timeWindow        = benchConfig.get<std::array<double, 2>>("TimeWindow"); // us
+  unsigned const lookupRepeats = benchConfig.get<unsigned>("LookupRepeats");
+  unsigned const nThreads      = benchConfig.get<unsigned>("NThreads");
+
+  auto const start_setup = std::chrono::steady_clock::now();
+  sbnd::CRTGeoAlg crtGeo(geom.geometry.get(), geom.auxDetGeometry.get());
+  sbnd::CRTHitRecoAlg hitAlg(fhicl::Table<sbnd::CRTHitRecoAlg::Config>(
+                               benchConfig.get<fhicl::ParameterSet>("HitRecoAlg"), {})(),
+                             geom.geometry.get(), geom.auxDetGeometry.get());
+  double const t_setup = Seconds(start_setup);
+
+  // Generate the events
+  std::mt19937 rng(benchConfig.get<long>("Seed"));
+  std::uniform_real_distribution<double> ut(timeWindow[0], timeWindow[1]);
+  std::uniform_int_distribution<size_t> utagger(0, crtGeo.NumTaggers() - 1);
+  std::uniform_int_distribution<size_t> ustrip(0, crtGeo.NumStrips() - 1);
+
+  std::vector<TaggerStrips> events(nEvents);
+  std::vector<sbnd::CRTStrip> allStrips;
+  for (auto& event : events) {
+    size_t dataID = 0;
+    for (unsigned p = 0; p < nParticles; p++) {
+      double const t0 = ut(rng);
+      // One strip in each plane of the tagger, if it has two
+      auto const& tagger = crtGeo.GetTagger(utagger(rng));
+      for (size_t plane = 0; plane < 2; plane++) {
+        std::vector<size_t> planeModules;
+        for (auto const module_i : tagger.modules) {
+          if (crtGeo.GetModule(module_i).planeID == plane) planeModules.push_back(module_i);
+        }
+        if (planeModules.empty()) continue;
+        auto const& module = crtGeo.GetModule(planeModules[rng() % planeModules.size()]);
+        auto const& strip = crtGeo.GetStrip(module.strips[rng() % module.strips.size()]);
+        auto hit = MakeStrip(hitAlg, strip, t0, rng, dataID);
+        event[hit.tagger].push_back(hit);
+        allStrips.push_back(hit);
+      }
+    }
+    for (unsigned n = 0; n < nNoise; n++) {
+      auto hit = MakeStrip(hitAlg, crtGeo.GetStrip(ustrip(rng)), ut(rng), rng, dataID);
+      event[hit.tagger].push_back(hit);
+      allStrips.push_back(hit);
+    }
+  }
+
+  // Per-strip lookups of the hit reconstruction, by strip name
+  double checksum_name = 0.;
+  auto start = std::chrono::steady_clock::now();
+  for (unsigned r = 0; r < lookupRepeats; r++) {
+    for (auto const& hit : allStrips) {
+      std::string const name = crtGeo.ChannelToStripName(hit.channel);
+      auto const& module = crtGeo.GetModule(crtGeo.GetStrip(name).module);
+      auto const limits = crtGeo.StripLimitsWithChargeSharing(name, hit.x, hit.ex);
+      geo::Point_t const pos {(limits[0] + limits[1])/2., (limits[2] + limits[3])/2., (limits[4] + limits[5])/2.};
+      checksum_name += crtGeo.GetStrip(name).width + module.planeID + crtGeo.DistanceDownStrip(pos, name)
+                       + crtGeo.StripHasOverlap(name);
+    }
+  }
+  double const t_name = Seconds(start);
+
+  // The same lookups, by channel index
+  double checksum_index = 0.;
+  start = std::chrono::steady_clock::now();
+  for (unsigned r = 0; r < lookupRepeats; r++) {
+    for (auto const& hit : allStrips) {
+      auto const& strip = crtGeo.ChannelToStrip(hit.channel);
+      auto const& module = crtGeo.GetModule(strip.moduleIndex);
+      auto const limits = crtGeo.StripLimitsWithChargeSharing(strip, hit.x, hit.ex);
+      geo::Point_t const pos {(limits[0] + limits[1])/2., (limits[2] + limits[3])/2., (limits[4] + limits[5])/2.};
+      checksum_index += strip.width + module.planeID + crtGeo.DistanceDownStrip(pos, strip)
+                        + crtGeo.StripHasOverlap(strip);
+    }
+  }
+  double const t_index = Seconds(start);
+
+  // Full hit reconstruction
+  size_t nHits = 0;
+  std::vector<std::vector<std::pair<sbn::crt::CRTHit, std::vector<int>>>> mapHits;
+  start = std::chrono::steady_clock::now();
+  for (auto const& event : events) {
+    mapHits.push_back(hitAlg.CreateCRTHits(event));
+    nHits += mapHits.back().size();
+  }
+  double const t_reco = Seconds(start);
+
+  // The same reconstruction from the flat strip buffer
+  std::vector<sbnd::CRTTaggerStrips> buffers;
+  for (auto const& event : events) buffers.push_back(hitAlg.CreateTaggerStripBuffer(event));
+  bool sameHits = true;
+  start = std::chrono::steady_clock::now();
+  for (size_t i = 0; i < buffers.size(); i++) {
+    auto const hits = hitAlg.CreateCRTHits(buffers[i], nThreads);
+    sameHits &= hits.size() == mapHits[i].size();
+    for (size_t j = 0; sameHits && j < hits.size(); j++) {
+      auto const& a = hits[j].first;
+      auto const& b = mapHits[i][j].first;
+      sameHits &= a.x_pos == b.x_pos && a.y_pos == b.y_pos && a.z_pos == b.z_pos
+                  && a.ts0_ns == b.ts0_ns && a.peshit == b.peshit && a.tagger == b.tagger
+                  && hits[j].second == mapHits[i][j].second;
+    }
+  }
+  double const t_buffer = Seconds(start);
+
+  size_t const nLookups = allStrips.size() * lookupRepeats;
+  std::cout << "n_taggers " << crtGeo.NumTaggers() << "\n"
+            << "n_modules " << crtGeo.NumModules() << "\n"
+            << "n_strips " << crtGeo.NumStrips() << "\n"
+            << "geometry_setup_s " << t_setup << "\n"
+            << "n_events " << nEvents << "\n"
+            << "n_strip_hits " << allStrips.size() << "\n"
+            << "n_crt_hits " << nHits << "\n"
+            << "name_lookup_s " << t_name << "\n"
+            << "index_lookup_s " << t_index << "\n"
+            << "name_lookups_per_s " << nLookups / t_name << "\n"
+            << "index_lookups_per_s " << nLookups / t_index << "\n"
+            << "lookup_speedup " << t_name / t_index << "\n"
+            << "lookup_checksum_match " << (checksum_name == checksum_index) << "\n"
+            << "hit_reco_s " << t_reco << "\n"
+            << "hit_reco_events_per_s " << nEvents / t_reco << "\n"
+            << "hit_reco_strips_per_s " << allStrips.size() / t_reco << "\n"
+            << "n_threads " << nThreads << "\n"
+            << "buffer_hit_reco_s " << t_buffer << "\n"
+            << "buffer_hit_reco_speedup " << t_reco / t_buffer << "\n"
+            << "buffer_hits_match " << sameHits << "\n";
+
+  return 0;
+}
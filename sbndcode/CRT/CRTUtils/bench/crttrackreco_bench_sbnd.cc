@@ -0,0 +1,263 @@
+////////////////////////////////////////////////////////////////////////
+// File:        crttrackreco_bench_sbnd.cc
+//
+// Scaling benchmark of the CRT track reconstruction, run outside of the
+// art event loop on the SBND geometry. For each hit density in
+// HitsPerEvent, synthetic CRTHits are made from particles crossing
+// several taggers at random times in the readout window, then:
+//  - CRTTrackRecoAlg::CreateCRTTzeros is timed against the pairwise
+//    grouping it replaced;
+//  - CRTTrackRecoAlg::CreateTracks is run on every T0 group and timed
+//    against the exhaustive candidate search it replaced.
+// The results of the old and new versions are checked to be identical.
+//
+// Usage: crttrackreco_bench_sbnd [config.fcl]   (default: crttrackreco_bench_sbnd.fcl)
+// Output: one "key value" pair per line on stdout, keys of the per
+// density results end with the number of hits per event.
+////////////////////////////////////////////////////////////////////////
+
+#include "sbndcode/CRT/CRTUtils/CRTTrackRecoAlg.h"
+#include "sbndcode/CRT/CRTUtils/CRTCommonUtils.h"
+#include "sbndcode/CRT/CRTUtils/bench/CRTBenchGeometry.h"
+#include "sbndcode/Geometry/GeometryWrappers/CRTGeoAlg.h"
+
+#include "larcorealg/Geometry/StandaloneBasicSetup.h"
+
+#include "canvas/Persistency/Common/Ptr.h"
+#include "canvas/Persistency/Provenance/ProductID.h"
+
+#include "fhiclcpp/ParameterSet.h"
+#include "fhiclcpp/types/Table.h"
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace {
+
+  using HitPtrs = std::vector<art::Ptr<sbn::crt::CRTHit>>;
+  using HitsWithIds = std::vector<std::pair<sbn::crt::CRTHit, std::vector<int>>>;
+  using TracksWithIds = std::vector<std::pair<sbn::crt::CRTTrack, std::vector<int>>>;
+
+  double Seconds(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  }
+
+  // The pairwise grouping CreateCRTTzeros used before, kept as the reference
+  std::vector<HitPtrs> PairwiseTzeros(HitPtrs hits, double timeLimit) {
+    std::vector<HitPtrs> crtTzeroVect;
+    std::vector<int> iflag(hits.size(), 0);
+    std::sort(hits.begin(), hits.end(), [](auto& left, auto& right)->bool{
+                return left->ts1_ns < right->ts1_ns;});
+    for (size_t i = 0; i < hits.size(); i++) {
+      if (iflag[i] != 0) continue;
+      HitPtrs crtTzero;
+      double const time_ns_A = hits[i]->ts1_ns;
+      iflag[i] = 1;
+      crtTzero.push_back(hits[i]);
+      for (size_t j = i + 1; j < hits.size(); j++) {
+        if (iflag[j] != 0) continue;
+        double const diff = std::abs(hits[j]->ts1_ns - time_ns_A) * 1e-3;
+        if (diff < timeLimit) {
+          iflag[j] = 1;
+          crtTzero.push_back(hits[j]);
+        }
+      }
+      crtTzeroVect.push_back(crtTzero);
+    }
+    return crtTzeroVect;
+  }
+
+  // The exhaustive candidate search CreateTracks used before, kept as the reference
+  TracksWithIds ExhaustiveTracks(sbnd::CRTTrackRecoAlg& alg, HitsWithIds const& hits, double distanceLimit) {
+    std::vector<std::vector<size_t>> trackCandidates;
+    for (size_t i = 0; i < hits.size(); i++) {
+      for (size_t j = i + 1; j < hits.size(); j++) {
+        if (hits[i].first.tagger == hits[j].first.tagger) continue;
+        TVector3 start(hits[i].first.x_pos, hits[i].first.y_pos, hits[i].first.z_pos);
+        TVector3 end(hits[j].first.x_pos, hits[j].first.y_pos, hits[j].first.z_pos);
+        std::vector<size_t> candidate {i, j};
+        for (size_t k = 0; k < hits.size(); k++) {
+          if (k == i || k == j || hits[k].first.tagger == hits[i].first.tagger
+              || hits[k].first.tagger == hits[j].first.tagger) continue;
+          if (sbnd::CRTCommonUtils::DistToCrtHit(hits[k].first, start, end) < distanceLimit) {
+            candidate.push_back(k);
+          }
+        }
+        trackCandidates.push_back(candidate);
+      }
+    }
+    std::sort(trackCandidates.begin(), trackCandidates.end(), [](auto& left, auto& right){
+              return left.size() > right.size();});
+    TracksWithIds tracks;
+    std::vector<size_t> usedHits;
+    for (auto const& candidate : trackCandidates) {
+      bool used = false;
+      for (auto const k : candidate) {
+        if (std::find(usedHits.begin(), usedHits.end(), k) != usedHits.end()) used = true;
+      }
+      if (used || candidate.size() < 2) continue;
+      std::vector<int> ids;
+      for (auto const k : candidate) {
+        ids.insert(ids.end(), hits[k].second.begin(), hits[k].second.end());
+        if (candidate.size() > 2) usedHits.push_back(k);
+      }
+      tracks.emplace_back(alg.FillCrtTrack(hits[candidate[0]].first, hits[candidate[1]].first, candidate.size()), ids);
+    }
+    return tracks;
+  }
+
+  // Hit somewhere in the tagger box
+  sbn::crt::CRTHit MakeHit(sbnd::CRTTaggerGeo const& tagger, double t_ns, std::mt19937& rng) {
+    std::uniform_real_distribution<double> u(0., 1.);
+    sbn::crt::CRTHit hit;
+    hit.x_pos = tagger.minX + u(rng) * (tagger.maxX - tagger.minX);
+    hit.y_pos = tagger.minY + u(rng) * (tagger.maxY - tagger.minY);
+    hit.z_pos = tagger.minZ + u(rng) * (tagger.maxZ - tagger.minZ);
+    hit.x_err = hit.y_err = hit.z_err = 2.;
+    hit.ts0_ns = hit.ts1_ns = t_ns;
+    hit.peshit = 100.;
+    hit.tagger = tagger.name;
+    return hit;
+  }
+
+}
+
+int main(int argc, char** argv)
+{
+  std::string const configFile = argc > 1 ? argv[1] : "crttrackreco_bench_sbnd.fcl";
+  fhicl::ParameterSet const config = lar::standalone::ParseConfiguration(configFile);
+  lar::standalone::SetupMessageFacility(config, "crttrackreco_bench_sbnd");
+
+  auto const geom = sbnd::SetupCRTBenchGeometry(config);
+
+  auto const& benchConfig = config.get<fhicl::ParameterSet>("benchmark");
+  unsigned const nEvents      = benchConfig.get<unsigned>("NEvents");
+  auto const hitsPerEvent     = benchConfig.get<std::vector<unsigned>>("HitsPerEvent");
+  unsigned const hitsPerTrack = benchConfig.get<unsigned>("HitsPerParticle");
+  unsigned const nPerT0       = benchConfig.get<unsigned>("ParticlesPerT0");
+  double const hitTimeSpread  = benchConfig.get<double>("HitTimeSpread"); // ns
+  auto const timeWindow       = benchConfig.get<std::array<double, 2>>("TimeWindow"); // us
+
+  sbnd::CRTGeoAlg crtGeo(geom.geometry.get(), geom.auxDetGeometry.get());
+  auto const trackAlgConfig = fhicl::Table<sbnd::CRTTrackRecoAlg::Config>(
+    benchConfig.get<fhicl::ParameterSet>("TrackRecoAlg"), {})();
+  sbnd::CRTTrackRecoAlg trackAlg(trackAlgConfig, geom.geometry.get(), geom.auxDetGeometry.get());
+
+  std::mt19937 rng(benchConfig.get<long>("Seed"));
+  std::uniform_real_distribution<double> ut(timeWindow[0] * 1e3, timeWindow[1] * 1e3);
+  std::uniform_real_distribution<double> udt(0., hitTimeSpread);
+  std::uniform_int_distribution<size_t> utagger(0, crtGeo.NumTaggers() - 1);
+
+  std::cout << "n_events " << nEvents << "\n"
+            << "time_limit_us " << trackAlgConfig.TimeLimit() << "\n";
+
+  for (unsigned const nHits : hitsPerEvent) {
+
+    // Hits are stored per event and referred to through Ptrs, as in the producers
+    std::vector<std::vector<sbn::crt::CRTHit>> eventHits(nEvents);
+    std::vector<HitPtrs> eventPtrs(nEvents);
+    for (unsigned ev = 0; ev < nEvents; ev++) {
+      auto& hits = eventHits[ev];
+      hits.reserve(nHits);
+      while (hits.size() < nHits) {
+        double const t0 = ut(rng);
+        for (unsigned h = 0; h < nPerT0 * hitsPerTrack && hits.size() < nHits; h++) {
+          hits.push_back(MakeHit(crtGeo.GetTagger(utagger(rng)), t0 + udt(rng), rng));
+        }
+      }
+      // Unsorted, as the hits come from the different taggers
+      std::shuffle(hits.begin(), hits.end(), rng);
+      for (size_t i = 0; i < hits.size(); i++) {
+        eventPtrs[ev].emplace_back(art::ProductID(1), &hits[i], i);
+      }
+    }
+
+    size_t nGroupsPairwise = 0, nGroupsWindow = 0;
+    bool identical = true;
+
+    auto start = std::chrono::steady_clock::now();
+    std::vector<std::vector<HitPtrs>> pairwise;
+    for (auto const& ptrs : eventPtrs) {
+      pairwise.push_back(PairwiseTzeros(ptrs, trackAlgConfig.TimeLimit()));
+      nGroupsPairwise += pairwise.back().size();
+    }
+    double const t_pairwise = Seconds(start);
+
+    start = std::chrono::steady_clock::now();
+    std::vector<std::vector<HitPtrs>> window;
+    for (auto const& ptrs : eventPtrs) {
+      window.push_back(trackAlg.CreateCRTTzeros(ptrs));
+      nGroupsWindow += window.back().size();
+    }
+    double const t_window = Seconds(start);
+
+    for (unsigned ev = 0; ev < nEvents; ev++) {
+      if (pairwise[ev].size() != window[ev].size()) { identical = false; break; }
+      for (size_t g = 0; g < window[ev].size(); g++) {
+        if (pairwise[ev][g].size() != window[ev][g].size()) { identical = false; break; }
+        for (size_t h = 0; h < window[ev][g].size(); h++) {
+          if (pairwise[ev][g][h].get() != window[ev][g][h].get()) { identical = false; break; }
+        }
+      }
+    }
+
+    // Track candidates in each T0 group, the ids are the hit indices in the event
+    std::vector<HitsWithIds> groups;
+    for (unsigned ev = 0; ev < nEvents; ev++) {
+      for (auto const& tzero : window[ev]) {
+        HitsWithIds group;
+        for (auto const& ptr : tzero) group.emplace_back(*ptr, std::vector<int>{(int)ptr.key()});
+        groups.push_back(std::move(group));
+      }
+    }
+
+    size_t nTracksExhaustive = 0, nTracksPruned = 0;
+    bool tracksIdentical = true;
+
+    start = std::chrono::steady_clock::now();
+    std::vector<TracksWithIds> exhaustive;
+    for (auto const& group : groups) {
+      exhaustive.push_back(ExhaustiveTracks(trackAlg, group, trackAlgConfig.DistanceLimit()));
+      nTracksExhaustive += exhaustive.back().size();
+    }
+    double const t_exhaustive = Seconds(start);
+
+    start = std::chrono::steady_clock::now();
+    std::vector<TracksWithIds> pruned;
+    for (auto const& group : groups) {
+      pruned.push_back(trackAlg.CreateTracks(group));
+      nTracksPruned += pruned.back().size();
+    }
+    double const t_pruned = Seconds(start);
+
+    for (size_t g = 0; g < groups.size() && tracksIdentical; g++) {
+      if (exhaustive[g].size() != pruned[g].size()) { tracksIdentical = false; break; }
+      for (size_t t = 0; t < pruned[g].size(); t++) {
+        if (exhaustive[g][t].second != pruned[g][t].second) { tracksIdentical = false; break; }
+      }
+    }
+
+    std::string const suffix = "_" + std::to_string(nHits);
+    std::cout << "n_tzeros" << suffix << " " << nGroupsWindow << "\n"
+              << "tzero_pairwise_s" << suffix << " " << t_pairwise << "\n"
+              << "tzero_window_s" << suffix << " " << t_window << "\n"
+              << "tzero_pairwise_hits_per_s" << suffix << " " << nEvents * nHits / t_pairwise << "\n"
+              << "tzero_window_hits_per_s" << suffix << " " << nEvents * nHits / t_window << "\n"
+              << "tzero_speedup" << suffix << " " << t_pairwise / t_window << "\n"
+              << "tzero_identical" << suffix << " " << (identical && nGroupsPairwise == nGroupsWindow) << "\n"
+              << "n_tracks" << suffix << " " << nTracksPruned << "\n"
+              << "tracks_exhaustive_s" << suffix << " " << t_exhaustive << "\n"
+              << "tracks_pruned_s" << suffix << " " << t_pruned << "\n"
+              << "tracks_speedup" << suffix << " " << t_exhaustive / t_pruned << "\n"
+              << "tracks_identical" << suffix << " " << (tracksIdentical && nTracksExhaustive == nTracksPruned) << "\n";
+  }
+
+  return 0;
+}
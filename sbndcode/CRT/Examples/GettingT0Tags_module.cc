@@ -36,6 +36,7 @@
 // C++ includes
 #include <map>
 #include <vector>
+#include <iostream>
 
 namespace sbnd {
 
@@ -38,6 +38,7 @@
 // C++ includes
 #include <map>
 #include <vector>
+#include <iostream>
 
 namespace sbnd {
 
@@ -195,8 +196,15 @@ namespace sbnd {
     auto const clockData = art::ServiceHandle<detinfo::DetectorClocksService const>()->DataFor(event);
     auto const detProp = art::ServiceHandle<detinfo::DetectorPropertiesService const>()->DataFor(event, clockData);
 
+    // Match all the reconstructed tracks to CRT hits and tracks at once
+    std::vector<double> hitT0s = fCRTHitMatch.T0sFromCRTHits(detProp, *tpcTrackHandle, findManyHits,
+                                                            fCRTHitMatch.HitTimeIndex(crtHits));
+    std::vector<double> trackT0s = fCRTTrackMatch.T0sFromCRTTracks(detProp, *tpcTrackHandle, findManyHits,
+                                                                  fCRTTrackMatch.TrackTimeIndex(crtTracks));
+
     // Loop over reconstructed tracks
-    for (auto const& tpcTrack : (*tpcTrackHandle)){
+    for (size_t track_i = 0; track_i < tpcTrackHandle->size(); track_i++){
+      const recob::Track& tpcTrack = tpcTrackHandle->at(track_i);
       // Get the associated hits
       std::vector<art::Ptr<recob::Hit>> hits = findManyHits.at(tpcTrack.ID());
 
@@ -214,7 +222,7 @@ namespace sbnd {
       nTotal++;
 
       // Calculate t0 from CRT hit matching
-      double hitT0 = fCRTHitMatch.T0FromCRTHits(detProp, tpcTrack, crtHits, event);
+      double hitT0 = hitT0s[track_i];
       if(hitT0 == -99999){
         if(fVerbose) std::cout<<"Couldn't match to CRT hit.\n";
       }
@@ -224,7 +232,7 @@ namespace sbnd {
         if(std::abs(trueTime - hitT0) < 2) nCrtHitCorrect++;
       }
       // Calculate t0 from CRT track matching
-      double trackT0 = fCRTTrackMatch.T0FromCRTTracks(detProp, tpcTrack, crtTracks, event);
+      double trackT0 = trackT0s[track_i];
       if(trackT0 == -99999){
         if(fVerbose) std::cout<<"Couldn't match to CRT track.\n";
       }
@@ -34,7 +34,7 @@ void ApaCrossCosmicIdAlg::reconfigure(const Config& config){
 
 // Get the minimum distance from track to APA for different times
   std::pair<double, double> ApaCrossCosmicIdAlg::MinApaDistance(detinfo::DetectorPropertiesData const& detProp,
-                                                                recob::Track track, std::vector<double> t0List, int tpc){
+                                                                const recob::Track& track, const std::vector<double>& t0List, int tpc){
 
   double crossTime = -99999;
   double xmax = fTpcGeo.MaxX();
@@ -57,33 +57,18 @@ void ApaCrossCosmicIdAlg::reconfigure(const Config& config){
   // If in both TPCs (stitched) return null values
   if(tpc == -1) return std::make_pair(minDist, crossTime);
 
-  // Shift track by all t0's
-  for(auto const& t0 : t0List){
-    // If particle crosses the APA before t = 0 the crossing point won't be reconstructed
-    if(t0 < 0) continue;
-    double shiftedX = point.X();
-    double shift = t0 * detProp.DriftVelocity();
-    if(tpc == 0) shiftedX = point.X() - shift;
-    if(tpc == 1) shiftedX = point.X() + shift;
-
-    //Check track still in TPC
-    if(std::abs(shiftedX) > (xmax + fDistanceLimit)) continue;
-    //Calculate distance between start/end and APA
-    double dist = std::abs(std::abs(shiftedX) - xmax);
-    if(dist < minDist) {
-      minDist = dist;
-      crossTime = t0;
-    }
-  }
-
-  return std::make_pair(minDist, crossTime);
+  // Shift track by all t0's towards the APA and find the closest
+  int driftDirection = 0;
+  if(tpc == 0) driftDirection = -1;
+  if(tpc == 1) driftDirection = 1;
+  return CosmicIdUtils::MinApaDistance(point.X(), driftDirection, t0List, detProp.DriftVelocity(), xmax, fDistanceLimit);
 
 }
 
 
 // Get time by matching tracks which cross the APA
 double ApaCrossCosmicIdAlg::T0FromApaCross(detinfo::DetectorPropertiesData const& detProp,
-                                           recob::Track track, std::vector<double> t0List, int tpc){
+                                           const recob::Track& track, const std::vector<double>& t0List, int tpc){
 
   // Get the minimum distance to the APA and corresponding time
   std::pair<double, double> min = MinApaDistance(detProp, track, t0List, tpc);
@@ -96,7 +81,7 @@ double ApaCrossCosmicIdAlg::T0FromApaCross(detinfo::DetectorPropertiesData const
 
 // Get the distance from track to APA at fixed time
 double ApaCrossCosmicIdAlg::ApaDistance(detinfo::DetectorPropertiesData const& detProp,
-                                        recob::Track track, double t0, std::vector<art::Ptr<recob::Hit>> hits){
+                                        const recob::Track& track, double t0, const std::vector<art::Ptr<recob::Hit>>& hits){
 
   std::vector<double> t0List {t0};
   // Determine the TPC from hit collection
@@ -109,7 +94,7 @@ double ApaCrossCosmicIdAlg::ApaDistance(detinfo::DetectorPropertiesData const& d
 
 // Work out what TPC track is in and get the minimum distance from track to APA for different times
 std::pair<double, double> ApaCrossCosmicIdAlg::MinApaDistance(detinfo::DetectorPropertiesData const& detProp,
-                                                              recob::Track track, std::vector<art::Ptr<recob::Hit>> hits, std::vector<double> t0Tpc0, std::vector<double> t0Tpc1){
+                                                              const recob::Track& track, const std::vector<art::Ptr<recob::Hit>>& hits, const std::vector<double>& t0Tpc0, const std::vector<double>& t0Tpc1){
 
   // Determine the TPC from hit collection
   int tpc = fTpcGeo.DetectedInTPC(hits);
@@ -126,7 +111,7 @@ std::pair<double, double> ApaCrossCosmicIdAlg::MinApaDistance(detinfo::DetectorP
 
 // Tag tracks with times outside the beam
 bool ApaCrossCosmicIdAlg::ApaCrossCosmicId(detinfo::DetectorPropertiesData const& detProp,
-                                           recob::Track track, std::vector<art::Ptr<recob::Hit>> hits, std::vector<double> t0Tpc0, std::vector<double> t0Tpc1){
+                                           const recob::Track& track, const std::vector<art::Ptr<recob::Hit>>& hits, const std::vector<double>& t0Tpc0, const std::vector<double>& t0Tpc1){
 
   // Determine the TPC from hit collection
   int tpc = fTpcGeo.DetectedInTPC(hits);
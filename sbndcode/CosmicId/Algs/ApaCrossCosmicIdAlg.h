@@ -11,6 +11,7 @@
 
 // sbndcode
 #include "sbndcode/Geometry/GeometryWrappers/TPCGeoAlg.h"
+#include "sbndcode/CosmicId/Utils/CosmicIdUtils.h"
 
 // framework
 #include "fhiclcpp/ParameterSet.h" 
@@ -85,23 +86,23 @@ namespace sbnd{
 
     // Get the minimum distance from track to APA for different times
     std::pair<double, double> MinApaDistance(detinfo::DetectorPropertiesData const& detProp,
-                                             recob::Track track, std::vector<double> t0List, int tpc);
+                                             const recob::Track& track, const std::vector<double>& t0List, int tpc);
 
     // Get time by matching tracks which cross the APA
     double T0FromApaCross(detinfo::DetectorPropertiesData const& detProp,
-                          recob::Track track, std::vector<double> t0List, int tpc);
+                          const recob::Track& track, const std::vector<double>& t0List, int tpc);
 
     // Get the distance from track to APA at fixed time
     double ApaDistance(detinfo::DetectorPropertiesData const& detProp,
-                       recob::Track track, double t0, std::vector<art::Ptr<recob::Hit>> hits);
+                       const recob::Track& track, double t0, const std::vector<art::Ptr<recob::Hit>>& hits);
 
     // Work out what TPC track is in and get the minimum distance from track to APA for different times
     std::pair<double, double> MinApaDistance(detinfo::DetectorPropertiesData const& detProp,
-                                             recob::Track track, std::vector<art::Ptr<recob::Hit>> hits, std::vector<double> t0Tpc0, std::vector<double> t0Tpc1);
+                                             const recob::Track& track, const std::vector<art::Ptr<recob::Hit>>& hits, const std::vector<double>& t0Tpc0, const std::vector<double>& t0Tpc1);
 
     // Tag tracks with times outside the beam
     bool ApaCrossCosmicId(detinfo::DetectorPropertiesData const& detProp,
-                          recob::Track track, std::vector<art::Ptr<recob::Hit>> hits, std::vector<double> t0Tpc0, std::vector<double> t0Tpc1);
+                          const recob::Track& track, const std::vector<art::Ptr<recob::Hit>>& hits, const std::vector<double>& t0Tpc0, const std::vector<double>& t0Tpc1);
 
   private:
 
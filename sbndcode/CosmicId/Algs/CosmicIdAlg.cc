@@ -1,6 +1,9 @@
 #include "CosmicIdAlg.h"
 
 #include "lardata/DetectorInfoServices/DetectorPropertiesService.h"
+#include "messagefacility/MessageLogger/MessageLogger.h"
+
+#include <iomanip>
 
 namespace sbnd{
 
@@ -66,6 +69,8 @@ void CosmicIdAlg::reconfigure(const Config& config){
   fBeamTimeMin = config.BeamTimeLimits().BeamTimeMin();
   fBeamTimeMax = config.BeamTimeLimits().BeamTimeMax();
 
+  fNThreads = config.NThreads();
+
   return;
 }
 
@@ -99,75 +104,220 @@ void CosmicIdAlg::ResetCuts(){
 
 }
 
+// Name of a cut as used in the counters
+std::string CosmicIdAlg::CutName(size_t cut){
+
+  switch(cut){
+    case kPandoraNuScore: return "PandoraNuScore";
+    case kPandoraT0:      return "PandoraT0";
+    case kFiducial:       return "Fiducial";
+    case kStopping:       return "Stopping";
+    case kGeometry:       return "Geometry";
+    case kCpaCross:       return "CpaCross";
+    case kApaCross:       return "ApaCross";
+    case kCrtTrack:       return "CrtTrack";
+    case kCrtHit:         return "CrtHit";
+  }
+  return "Unknown";
+
+}
+
+// Reset the cut counters
+void CosmicIdAlg::ResetCutCounters(){
+
+  fCutCounters = CutCounters();
+
+}
+
+// Print how often each cut was run, how often it tagged a cosmic and the time it took
+void CosmicIdAlg::PrintCutCounters() const {
+
+  mf::LogInfo log("CosmicIdAlg");
+  log << "Cut              Calls     Tagged    Time [ms]";
+  for(size_t cut = 0; cut < kNCuts; cut++){
+    log << "\n" << std::left << std::setw(15) << CutName(cut)
+        << std::right << std::setw(7) << fCutCounters[cut].calls
+        << std::setw(11) << fCutCounters[cut].tagged
+        << std::setw(13) << std::fixed << std::setprecision(2) << fCutCounters[cut].time;
+  }
+
+}
+
+// Add a set of counters to the total
+void CosmicIdAlg::AddCutCounters(CutCounters& total, const CutCounters& counters){
+
+  for(size_t cut = 0; cut < kNCuts; cut++){
+    total[cut].calls += counters[cut].calls;
+    total[cut].tagged += counters[cut].tagged;
+    total[cut].time += counters[cut].time;
+  }
+
+}
+
+// Read everything the enabled cuts need from the event
+CosmicIdEventContext CosmicIdAlg::EventContext(const art::Event& event, std::vector<double> t0Tpc0, std::vector<double> t0Tpc1,
+                                               bool allCuts, bool pfParticles) const {
+
+  auto const detProp = art::ServiceHandle<detinfo::DetectorPropertiesService const>()->DataFor(event);
+  return EventContext(detProp, event, t0Tpc0, t0Tpc1, allCuts, pfParticles);
+
+}
+
+CosmicIdEventContext CosmicIdAlg::EventContext(detinfo::DetectorPropertiesData const& detProp, const art::Event& event,
+                                               std::vector<double> t0Tpc0, std::vector<double> t0Tpc1, bool allCuts,
+                                               bool pfParticles) const {
+
+  // Get associations between tracks and hit/calorimetry collections
+  auto tpcTrackHandle = event.getValidHandle<std::vector<recob::Track>>(fTpcTrackModuleLabel);
+  CosmicIdEventContext context(detProp, tpcTrackHandle, event, fTpcTrackModuleLabel, fCaloModuleLabel);
+
+  context.tpc0Flash = CosmicIdUtils::BeamFlash(t0Tpc0, fBeamTimeMin, fBeamTimeMax);
+  context.tpc1Flash = CosmicIdUtils::BeamFlash(t0Tpc1, fBeamTimeMin, fBeamTimeMax);
+  context.t0Tpc0 = std::move(t0Tpc0);
+  context.t0Tpc1 = std::move(t0Tpc1);
+
+  // Get the PFParticles and their associations if they exist and something needs them
+  bool const needPandora = allCuts || pfParticles || fApplyPandoraT0Cut || fApplyPandoraNuScoreCut;
+  art::Handle< std::vector<recob::PFParticle> > pfParticleHandle;
+  if(needPandora) event.getByLabel(fPandoraLabel, pfParticleHandle);
+  if(needPandora && pfParticleHandle.isValid()){
+    context.pfParticles = pfParticleHandle.product();
+    context.pfPartToTrackAssoc.emplace(pfParticleHandle, event, fTpcTrackModuleLabel);
+    context.pandoraLookup.emplace(*context.pfParticles, *context.pfPartToTrackAssoc);
+    if(allCuts || fApplyPandoraT0Cut){
+      context.findManyT0.emplace(pfParticleHandle, event, fPandoraLabel);
+      ptTag.FillLookup(*context.pandoraLookup, *context.findManyT0);
+    }
+    if(allCuts || fApplyPandoraNuScoreCut){
+      context.findManyPFPMetadata.emplace(pfParticleHandle, event, fPandoraLabel);
+      pnTag.FillLookup(*context.pandoraLookup, *context.findManyPFPMetadata);
+    }
+  }
+
+  // Index the CRT tracks and hits by time once for all the TPC tracks
+  if(allCuts || fApplyCrtTrackCut){
+    auto crtTrackHandle = event.getValidHandle<std::vector<sbn::crt::CRTTrack>>(fCrtTrackModuleLabel);
+    context.crtTrackIndex.emplace(ctTag.TrackTimeIndex(*crtTrackHandle));
+  }
+  if(allCuts || fApplyCrtHitCut){
+    auto crtHitHandle = event.getValidHandle<std::vector<sbn::crt::CRTHit>>(fCrtHitModuleLabel);
+    context.crtHitIndex.emplace(chTag.HitTimeIndex(*crtHitHandle));
+  }
+
+  // Stitch all the tracks across the CPA in one pass
+  if(allCuts || fApplyCpaCrossCut){
+    context.cpaStitchIndex.emplace(ccTag.StitchIndex(context.Tracks(), context.findManyHits));
+    context.cpaStitches = ccTag.T0sFromCpaStitching(detProp, *context.cpaStitchIndex);
+  }
+
+  return context;
+
+}
+
+// Throw if a product needed by the enabled cuts is missing from the event context
+void CosmicIdAlg::CheckEventContext(const CosmicIdEventContext& context, bool pfparticle) const {
+
+  std::string missing = "";
+  if(pfparticle && !context.pfPartToTrackAssoc) missing = "PFParticle to track associations (build it with pfParticles)";
+  else if(fApplyPandoraT0Cut && (!context.pfPartToTrackAssoc || !context.findManyT0)) missing = "PFParticle T0 associations";
+  else if(fApplyPandoraNuScoreCut && (!context.pfPartToTrackAssoc || !context.findManyPFPMetadata)) missing = "PFParticle metadata associations";
+  else if(fApplyCrtTrackCut && !context.crtTrackIndex) missing = "CRT tracks";
+  else if(fApplyCrtHitCut && !context.crtHitIndex) missing = "CRT hits";
+  else if(fApplyCpaCrossCut && !context.cpaStitchIndex) missing = "CPA stitching index";
+
+  if(missing != ""){
+    throw cet::exception("CosmicIdAlg")
+      << missing << " not in the event context, build it with allCuts to change the cuts after it is made\n";
+  }
+
+}
+
+// CPA stitching result of a track from the event context, stitched on the fly if it is not in the event
+std::pair<double, bool> CosmicIdAlg::CpaStitch(const CosmicIdEventContext& context, const recob::Track& track) const {
+
+  size_t track_i = context.cpaStitchIndex->Position(track.ID());
+  if(track_i < context.cpaStitches.size()) return context.cpaStitches[track_i];
+  return ccTag.T0FromCpaStitching(context.detProp, track, context.findManyHits.at(track.ID()), *context.cpaStitchIndex);
+
+}
+
 // Run cuts to decide if track looks like a cosmic
 bool CosmicIdAlg::CosmicId(recob::Track track, const art::Event& event, std::vector<double> t0Tpc0, std::vector<double> t0Tpc1){
 
-  // Get associations between tracks and hit collections
-  auto tpcTrackHandle = event.getValidHandle<std::vector<recob::Track>>(fTpcTrackModuleLabel);
-  art::FindManyP<recob::Hit> findManyHits(tpcTrackHandle, event, fTpcTrackModuleLabel);
-  std::vector<art::Ptr<recob::Hit>> hits = findManyHits.at(track.ID());
-  // Get associations between track and calorimetry collections
-  art::FindManyP<anab::Calorimetry> findManyCalo(tpcTrackHandle, event, fCaloModuleLabel);
+  return CosmicId(EventContext(event, t0Tpc0, t0Tpc1), track);
 
-  auto const detProp = art::ServiceHandle<detinfo::DetectorPropertiesService const>()->DataFor(event);
+}
+
+bool CosmicIdAlg::CosmicId(const CosmicIdEventContext& context, const recob::Track& track){
+
+  CheckEventContext(context, false);
+  return RunCuts(context, track, fCutCounters);
+
+}
+
+// Run cuts on every track in the event
+std::vector<bool> CosmicIdAlg::CosmicIds(const CosmicIdEventContext& context){
+
+  CheckEventContext(context, false);
+
+  const std::vector<recob::Track>& tracks = context.Tracks();
+  return RunCutChains(tracks.size(), fNThreads, fCutCounters, [&](size_t track_i, CutCounters& counters){
+    return RunCuts(context, tracks[track_i], counters);
+  });
+
+}
+
+bool CosmicIdAlg::RunCuts(const CosmicIdEventContext& context, const recob::Track& track, CutCounters& counters){
+
+  auto const& detProp = context.detProp;
+  auto const& hits = context.findManyHits.at(track.ID());
 
   // Tag cosmics from pandora T0 associations
   if(fApplyPandoraNuScoreCut){
-    if(pnTag.PandoraNuScoreCosmicId(track, event)) return true;
+    if(RunCut(counters, kPandoraNuScore, [&]{
+          return pnTag.PandoraNuScoreCosmicId(track, *context.pandoraLookup);})) return true;
   }    
 
   // Tag cosmics from pandora T0 associations
   if(fApplyPandoraT0Cut){
-    if(ptTag.PandoraT0CosmicId(track, event)) return true;
+    if(RunCut(counters, kPandoraT0, [&]{
+          return ptTag.PandoraT0CosmicId(track, *context.pandoraLookup);})) return true;
   }    
 
   // Tag cosmics which enter and exit the TPC
   if(fApplyFiducialCut){
-    if(fvTag.FiducialVolumeCosmicId(track)) return true;
+    if(RunCut(counters, kFiducial, [&]{return fvTag.FiducialVolumeCosmicId(track);})) return true;
   }
 
   // Tag cosmics which enter the TPC and stop
   if(fApplyStoppingCut){
-    std::vector<art::Ptr<anab::Calorimetry>> calos = findManyCalo.at(track.ID());
-    if(spTag.StoppingParticleCosmicId(track, calos)) return true;
+    if(RunCut(counters, kStopping, [&]{
+          return spTag.StoppingParticleCosmicId(track, context.findManyCalo.at(track.ID()));})) return true;
   }
 
   // Tag cosmics in other TPC to beam activity
   if(fApplyGeometryCut){
-    bool tpc0Flash = CosmicIdUtils::BeamFlash(t0Tpc0, fBeamTimeMin, fBeamTimeMax);
-    bool tpc1Flash = CosmicIdUtils::BeamFlash(t0Tpc1, fBeamTimeMin, fBeamTimeMax);
-    if(geoTag.GeometryCosmicId(track, hits, tpc0Flash, tpc1Flash)) return true;
+    if(RunCut(counters, kGeometry, [&]{return geoTag.GeometryCosmicId(track, hits, context.tpc0Flash, context.tpc1Flash);})) return true;
   }
 
   // Tag cosmics which cross the CPA
   if(fApplyCpaCrossCut){
-    std::vector<recob::Track> tracks;
-    for(auto const& tpcTrack : (*tpcTrackHandle)){
-      tracks.push_back(tpcTrack);
-    }
-
-    if(ccTag.CpaCrossCosmicId(detProp, track, tracks, findManyHits)) return true;
+    if(RunCut(counters, kCpaCross, [&]{return ccTag.CpaCrossCosmicId(CpaStitch(context, track));})) return true;
   }
 
   // Tag cosmics which cross the APA
   if(fApplyApaCrossCut){
-    if(acTag.ApaCrossCosmicId(detProp, track, hits, t0Tpc0, t0Tpc1)) return true;
+    if(RunCut(counters, kApaCross, [&]{return acTag.ApaCrossCosmicId(detProp, track, hits, context.t0Tpc0, context.t0Tpc1);})) return true;
   }
 
   // Tag cosmics which match CRT tracks
   if(fApplyCrtTrackCut){
-    auto crtTrackHandle = event.getValidHandle<std::vector<sbn::crt::CRTTrack>>(fCrtTrackModuleLabel);
-    std::vector<sbn::crt::CRTTrack> crtTracks = (*crtTrackHandle);
-
-    if(ctTag.CrtTrackCosmicId(detProp, track, crtTracks, event)) return true;
+    if(RunCut(counters, kCrtTrack, [&]{return ctTag.CrtTrackCosmicId(detProp, track, hits, *context.crtTrackIndex);})) return true;
   }
 
   // Tag cosmics which match CRT hits
   if(fApplyCrtHitCut){
-    auto crtHitHandle = event.getValidHandle<std::vector<sbn::crt::CRTHit>>(fCrtHitModuleLabel);
-    std::vector<sbn::crt::CRTHit> crtHits = (*crtHitHandle);
-
-    if(chTag.CrtHitCosmicId(detProp, track, crtHits, event)) return true;
+    if(RunCut(counters, kCrtHit, [&]{return chTag.CrtHitCosmicId(detProp, track, hits, *context.crtHitIndex);})) return true;
   }
 
   return false;
@@ -178,15 +328,37 @@ bool CosmicIdAlg::CosmicId(recob::Track track, const art::Event& event, std::vec
 bool CosmicIdAlg::CosmicId(detinfo::DetectorPropertiesData const& detProp,
                            recob::PFParticle pfparticle, std::map< size_t, art::Ptr<recob::PFParticle> > pfParticleMap, const art::Event& event, std::vector<double> t0Tpc0, std::vector<double> t0Tpc1){
 
-  // Get associations between pfparticles and tracks
-  art::Handle< std::vector<recob::PFParticle> > pfParticleHandle;
-  event.getByLabel(fPandoraLabel, pfParticleHandle);
-  art::FindManyP< recob::Track > pfPartToTrackAssoc(pfParticleHandle, event, fTpcTrackModuleLabel);
+  return CosmicId(EventContext(detProp, event, t0Tpc0, t0Tpc1, false, true), pfparticle, pfParticleMap);
 
-  // Get associations between tracks and hits/calorimetry collections
-  auto tpcTrackHandle = event.getValidHandle<std::vector<recob::Track>>(fTpcTrackModuleLabel);
-  art::FindManyP<recob::Hit> findManyHits(tpcTrackHandle, event, fTpcTrackModuleLabel);
-  art::FindManyP<anab::Calorimetry> findManyCalo(tpcTrackHandle, event, fCaloModuleLabel);
+}
+
+bool CosmicIdAlg::CosmicId(const CosmicIdEventContext& context,
+                           const recob::PFParticle& pfparticle, const std::map< size_t, art::Ptr<recob::PFParticle> >& pfParticleMap){
+
+  CheckEventContext(context, true);
+  return RunCuts(context, pfparticle, pfParticleMap, fCutCounters);
+
+}
+
+// Run cuts on a set of PFParticles in the event
+std::vector<bool> CosmicIdAlg::CosmicIds(const CosmicIdEventContext& context, const std::vector<recob::PFParticle>& pfparticles,
+                                         const std::map< size_t, art::Ptr<recob::PFParticle> >& pfParticleMap){
+
+  CheckEventContext(context, true);
+
+  return RunCutChains(pfparticles.size(), fNThreads, fCutCounters, [&](size_t pfp_i, CutCounters& counters){
+    return RunCuts(context, pfparticles[pfp_i], pfParticleMap, counters);
+  });
+
+}
+
+bool CosmicIdAlg::RunCuts(const CosmicIdEventContext& context, const recob::PFParticle& pfparticle,
+                          const std::map< size_t, art::Ptr<recob::PFParticle> >& pfParticleMap, CutCounters& counters){
+
+  auto const& detProp = context.detProp;
+  auto const& pfPartToTrackAssoc = *context.pfPartToTrackAssoc;
+  auto const& findManyHits = context.findManyHits;
+  auto const& findManyCalo = context.findManyCalo;
 
   // Loop over all the daughters of the PFParticles and get associated tracks
   std::vector<recob::Track> nuTracks;
@@ -205,12 +377,13 @@ bool CosmicIdAlg::CosmicId(detinfo::DetectorPropertiesData const& detProp,
   
   // Tag cosmics from pandora MVA score
   if(fApplyPandoraNuScoreCut){
-    if(pnTag.PandoraNuScoreCosmicId(pfparticle, pfParticleMap, event)) return true;
+    if(RunCut(counters, kPandoraNuScore, [&]{
+          return pnTag.PandoraNuScoreCosmicId(pfparticle, pfParticleMap, *context.findManyPFPMetadata);})) return true;
   }    
 
   // Tag cosmics from pandora T0 associations
   if(fApplyPandoraT0Cut){
-    if(ptTag.PandoraT0CosmicId(pfparticle, pfParticleMap, event)) return true;
+    if(RunCut(counters, kPandoraT0, [&]{return ptTag.PandoraT0CosmicId(pfparticle, pfParticleMap, *context.findManyT0);})) return true;
   }
 
   // Not a cosmic if there are only showers assiciated with PFParticle
@@ -222,36 +395,26 @@ bool CosmicIdAlg::CosmicId(detinfo::DetectorPropertiesData const& detProp,
 
   // Select longest track as the cosmic candidate
   recob::Track track = nuTracks[0];
-  std::vector<art::Ptr<recob::Hit>> hits = findManyHits.at(track.ID());
+  auto const& hits = findManyHits.at(track.ID());
 
   // Tag cosmics which enter and exit the TPC
   if(fApplyFiducialCut){
-    if(fvTag.FiducialVolumeCosmicId(track)) return true;
+    if(RunCut(counters, kFiducial, [&]{return fvTag.FiducialVolumeCosmicId(track);})) return true;
   }
 
   // Tag cosmics in other TPC to beam activity
   if(fApplyGeometryCut){
-    bool tpc0Flash = CosmicIdUtils::BeamFlash(t0Tpc0, fBeamTimeMin, fBeamTimeMax);
-    bool tpc1Flash = CosmicIdUtils::BeamFlash(t0Tpc1, fBeamTimeMin, fBeamTimeMax);
-    if(geoTag.GeometryCosmicId(track, hits, tpc0Flash, tpc1Flash)) return true;
+    if(RunCut(counters, kGeometry, [&]{return geoTag.GeometryCosmicId(track, hits, context.tpc0Flash, context.tpc1Flash);})) return true;
   }
 
   // Tag cosmics which match CRT tracks
   if(fApplyCrtTrackCut){
-    auto crtTrackHandle = event.getValidHandle<std::vector<sbn::crt::CRTTrack>>(fCrtTrackModuleLabel);
-    std::vector<sbn::crt::CRTTrack> crtTracks = (*crtTrackHandle);
-
-    if(ctTag.CrtTrackCosmicId(detProp, track, crtTracks, event)) return true;
+    if(RunCut(counters, kCrtTrack, [&]{return ctTag.CrtTrackCosmicId(detProp, track, hits, *context.crtTrackIndex);})) return true;
   }
 
   // Tag cosmics which cross the CPA
   if(fApplyCpaCrossCut){
-    std::vector<recob::Track> tracks;
-    for(auto const& tpcTrack : (*tpcTrackHandle)){
-      tracks.push_back(tpcTrack);
-    }
-
-    if(ccTag.CpaCrossCosmicId(detProp, track, tracks, findManyHits)) return true;
+    if(RunCut(counters, kCpaCross, [&]{return ccTag.CpaCrossCosmicId(CpaStitch(context, track));})) return true;
   }
 
   // Find second longest particle if trying to merge tracks
@@ -287,35 +450,36 @@ bool CosmicIdAlg::CosmicId(detinfo::DetectorPropertiesData const& detProp,
 
       // Check fiducial volume containment assuming merged track
       if(fApplyFiducialCut){
-        if(!fvTag.InFiducial(track.End()) && !fvTag.InFiducial(track2.End())) return true;
+        if(RunCut(counters, kFiducial, [&]{return !fvTag.InFiducial(track.End()) && !fvTag.InFiducial(track2.End());})) return true;
       }
 
       // Check if stopping applies to merged track
       if(fApplyStoppingCut){
         // Apply stopping cut to the longest track
-        std::vector<art::Ptr<anab::Calorimetry>> calos = findManyCalo.at(track.ID());
-        if(spTag.StoppingParticleCosmicId(track, calos)) return true;
+        auto const& calos = findManyCalo.at(track.ID());
+        if(RunCut(counters, kStopping, [&]{
+              return spTag.StoppingParticleCosmicId(track, calos);})) return true;
         // Apply stopping cut assuming the tracks are split
-        std::vector<art::Ptr<anab::Calorimetry>> calos2 = findManyCalo.at(track2.ID());
-        if(spTag.StoppingParticleCosmicId(track, track2, calos, calos2)) return true;
+        auto const& calos2 = findManyCalo.at(track2.ID());
+        if(RunCut(counters, kStopping, [&]{
+              return spTag.StoppingParticleCosmicId(track, track2, calos, calos2);})) return true;
       }
 
       // Check if either track crosses APA
       if(fApplyApaCrossCut){
         // Apply apa crossing cut to the longest track
-        if(acTag.ApaCrossCosmicId(detProp, track, hits, t0Tpc0, t0Tpc1)) return true;
+        if(RunCut(counters, kApaCross, [&]{return acTag.ApaCrossCosmicId(detProp, track, hits, context.t0Tpc0, context.t0Tpc1);})) return true;
         // Also apply to secondary track FIXME need to check primary track doesn't go out of bounds
-        std::vector<art::Ptr<recob::Hit>> hits2 = findManyHits.at(track2.ID());
-        if(acTag.ApaCrossCosmicId(detProp, track2, hits2, t0Tpc0, t0Tpc1)) return true;
+        auto const& hits2 = findManyHits.at(track2.ID());
+        if(RunCut(counters, kApaCross, [&]{return acTag.ApaCrossCosmicId(detProp, track2, hits2, context.t0Tpc0, context.t0Tpc1);})) return true;
       }
 
       // Check if either track matches CRT hit
       if(fApplyCrtHitCut){
         // Apply crt hit match cut to both tracks
-	auto crtHitHandle = event.getValidHandle<std::vector<sbn::crt::CRTHit>>(fCrtHitModuleLabel);
-        std::vector<sbn::crt::CRTHit> crtHits = (*crtHitHandle);
-        if(chTag.CrtHitCosmicId(detProp, track, crtHits, event)) return true;
-        if(chTag.CrtHitCosmicId(detProp, track2, crtHits, event)) return true;
+        if(RunCut(counters, kCrtHit, [&]{return chTag.CrtHitCosmicId(detProp, track, hits, *context.crtHitIndex);})) return true;
+        if(RunCut(counters, kCrtHit, [&]{
+              return chTag.CrtHitCosmicId(detProp, track2, findManyHits.at(track2.ID()), *context.crtHitIndex);})) return true;
       }
     }
     // Don't apply other cuts if angle between tracks is consistent with neutrino interaction
@@ -326,21 +490,18 @@ bool CosmicIdAlg::CosmicId(detinfo::DetectorPropertiesData const& detProp,
 
     // Tag cosmics which enter the TPC and stop
     if(fApplyStoppingCut){
-      std::vector<art::Ptr<anab::Calorimetry>> calos = findManyCalo.at(track.ID());
-      if(spTag.StoppingParticleCosmicId(track, calos)) return true;
+      if(RunCut(counters, kStopping, [&]{
+            return spTag.StoppingParticleCosmicId(track, findManyCalo.at(track.ID()));})) return true;
     }
 
     // Tag cosmics which cross the APA
     if(fApplyApaCrossCut){
-      if(acTag.ApaCrossCosmicId(detProp, track, hits, t0Tpc0, t0Tpc1)) return true;
+      if(RunCut(counters, kApaCross, [&]{return acTag.ApaCrossCosmicId(detProp, track, hits, context.t0Tpc0, context.t0Tpc1);})) return true;
     }
 
     // Tag cosmics which match CRT hits
     if(fApplyCrtHitCut){
-      auto crtHitHandle = event.getValidHandle<std::vector<sbn::crt::CRTHit>>(fCrtHitModuleLabel);
-      std::vector<sbn::crt::CRTHit> crtHits = (*crtHitHandle);
-
-      if(chTag.CrtHitCosmicId(detProp, track, crtHits, event)) return true;
+      if(RunCut(counters, kCrtHit, [&]{return chTag.CrtHitCosmicId(detProp, track, hits, *context.crtHitIndex);})) return true;
     }
   }
 
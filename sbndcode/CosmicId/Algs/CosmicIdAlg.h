@@ -19,6 +19,8 @@
 #include "sbndcode/CosmicId/Algs/PandoraT0CosmicIdAlg.h"
 #include "sbndcode/CosmicId/Algs/PandoraNuScoreCosmicIdAlg.h"
 #include "sbndcode/CosmicId/Utils/CosmicIdUtils.h"
+#include "sbndcode/CRT/CRTUtils/CRTTimeIndex.h"
+#include "sbndcode/CRT/CRTUtils/CRTCommonUtils.h"
 
 // framework
 #include "art/Framework/Principal/Event.h"
@@ -27,6 +29,8 @@
 #include "fhiclcpp/types/Atom.h"
 #include "art/Framework/Principal/Handle.h" 
 #include "canvas/Persistency/Common/Ptr.h" 
+#include "canvas/Persistency/Common/FindManyP.h"
+#include "cetlib_except/exception.h"
 
 // LArSoft
 #include "lardataobj/RecoBase/Track.h"
@@ -34,17 +38,81 @@
 #include "lardataobj/RecoBase/PFParticle.h"
 #include "lardataobj/AnalysisBase/T0.h"
 #include "lardataobj/AnalysisBase/Calorimetry.h"
+#include "lardataobj/RecoBase/PFParticleMetadata.h"
+#include "lardataalg/DetectorInfo/DetectorPropertiesData.h"
 
 // c++
 #include <vector>
 #include <utility>
+#include <map>
+#include <optional>
+#include <array>
+#include <string>
+#include <chrono>
 
 
 namespace sbnd{
 
+  // Everything the cuts read from an event, built once per event with
+  // CosmicIdAlg::EventContext and shared by all the tracks and PFParticles
+  struct CosmicIdEventContext {
+
+    CosmicIdEventContext(detinfo::DetectorPropertiesData const& detProp,
+                         const art::ValidHandle<std::vector<recob::Track>>& tpcTrackHandle,
+                         const art::Event& event, const art::InputTag& tpcTrackLabel, const art::InputTag& caloLabel)
+      : detProp(detProp)
+      , tpcTrackHandle(tpcTrackHandle)
+      , findManyHits(tpcTrackHandle, event, tpcTrackLabel)
+      , findManyCalo(tpcTrackHandle, event, caloLabel)
+    {}
+
+    const std::vector<recob::Track>& Tracks() const {return *tpcTrackHandle;}
+
+    detinfo::DetectorPropertiesData detProp;
+
+    // TPC tracks and their hit and calorimetry associations
+    art::ValidHandle<std::vector<recob::Track>> tpcTrackHandle;
+    art::FindManyP<recob::Hit> findManyHits;
+    art::FindManyP<anab::Calorimetry> findManyCalo;
+
+    // Flash times in each TPC and whether any are in time with the beam
+    std::vector<double> t0Tpc0;
+    std::vector<double> t0Tpc1;
+    bool tpc0Flash = false;
+    bool tpc1Flash = false;
+
+    // Pandora PFParticles and associations, empty if not in the event or not needed
+    const std::vector<recob::PFParticle>* pfParticles = nullptr;
+    std::optional<art::FindManyP<recob::Track>> pfPartToTrackAssoc;
+    std::optional<art::FindManyP<anab::T0>> findManyT0;
+    std::optional<art::FindManyP<larpandoraobj::PFParticleMetadata>> findManyPFPMetadata;
+    // Pandora T0s and neutrino scores of the PFParticles owning each track
+    std::optional<PandoraTrackLookup> pandoraLookup;
+
+    // CRT hits and tracks sorted by time, empty if not needed
+    std::optional<CRTHitTimeIndex> crtHitIndex;
+    std::optional<CRTTrackTimeIndex> crtTrackIndex;
+
+    // Track ends near the CPA and the stitching results of every track in event order, empty if not needed
+    std::optional<CpaStitchIndex> cpaStitchIndex;
+    std::vector<std::pair<double, bool>> cpaStitches;
+
+  };
+
+  // How often a cut was run and tagged a cosmic, and the time spent in it
+  struct CosmicIdCutCounter {
+    unsigned long calls = 0;
+    unsigned long tagged = 0;
+    double time = 0; // [ms]
+  };
+
   class CosmicIdAlg {
   public:
 
+    // Cuts in the order they are counted
+    enum Cut {kPandoraNuScore = 0, kPandoraT0, kFiducial, kStopping, kGeometry, kCpaCross, kApaCross, kCrtTrack, kCrtHit, kNCuts};
+    using CutCounters = std::array<CosmicIdCutCounter, kNCuts>;
+
     struct BeamTime {
       using Name = fhicl::Name;
       using Comment = fhicl::Comment;
@@ -192,6 +260,12 @@ namespace sbnd{
         Comment("")
       };
 
+      fhicl::Atom<unsigned> NThreads {
+        Name("NThreads"),
+        Comment("number of threads to run the cuts over the tracks or PFParticles with"),
+        1
+      };
+
     };
 
     CosmicIdAlg(const Config& config);
@@ -211,15 +285,54 @@ namespace sbnd{
     // Reset which cuts are run from fhicl parameters
     void ResetCuts();
 
+    // Read everything the enabled cuts need from the event, with allCuts the products
+    // for every cut are read so the cuts can be changed with SetCuts afterwards
+    // The PFParticle to track associations are only read if a Pandora cut needs them,
+    // with allCuts, or with pfParticles for running the cuts on PFParticles
+    CosmicIdEventContext EventContext(const art::Event& event, std::vector<double> t0Tpc0, std::vector<double> t0Tpc1,
+                                      bool allCuts = false, bool pfParticles = false) const;
+    CosmicIdEventContext EventContext(detinfo::DetectorPropertiesData const& detProp, const art::Event& event,
+                                      std::vector<double> t0Tpc0, std::vector<double> t0Tpc1, bool allCuts = false,
+                                      bool pfParticles = false) const;
+
     // Run cuts to decide if track looks like a cosmic
     bool CosmicId(recob::Track track, const art::Event& event, std::vector<double> t0Tpc0, std::vector<double> t0Tpc1);
+    bool CosmicId(const CosmicIdEventContext& context, const recob::Track& track);
+
+    // Run cuts on every track in the event, results are in the order of the track collection
+    // Tracks are split over NThreads threads
+    std::vector<bool> CosmicIds(const CosmicIdEventContext& context);
 
     // Run cuts to decide if PFParticle looks like a cosmic
     bool CosmicId(detinfo::DetectorPropertiesData const& detProp,
                   recob::PFParticle pfparticle, std::map< size_t, art::Ptr<recob::PFParticle> > pfParticleMap, const art::Event& event, std::vector<double> t0Tpc0, std::vector<double> t0Tpc1);
+    bool CosmicId(const CosmicIdEventContext& context,
+                  const recob::PFParticle& pfparticle, const std::map< size_t, art::Ptr<recob::PFParticle> >& pfParticleMap);
+
+    // Run cuts on a set of PFParticles, results are in the order of pfparticles
+    // PFParticles are split over NThreads threads
+    std::vector<bool> CosmicIds(const CosmicIdEventContext& context, const std::vector<recob::PFParticle>& pfparticles,
+                                const std::map< size_t, art::Ptr<recob::PFParticle> >& pfParticleMap);
+
+    // Counters for each cut summed over all calls since the last reset
+    static std::string CutName(size_t cut);
+    const CutCounters& GetCutCounters() const {return fCutCounters;}
+    void ResetCutCounters();
+    void PrintCutCounters() const;
+    static void AddCutCounters(CutCounters& total, const CutCounters& counters);
+
+    // Run a single cut and add it to counters
+    template<class CutFunc>
+    static bool RunCut(CutCounters& counters, Cut cut, CutFunc&& cutFunc);
+
+    // Run the cut chain itemCuts(i, counters) of n items split over nThreads threads, each item
+    // has its own counters which are added to total in input order, results are in input order
+    template<class ItemCuts>
+    static std::vector<bool> RunCutChains(size_t n, unsigned nThreads, CutCounters& total, ItemCuts&& itemCuts);
 
     // Getters for the underlying algorithms
     StoppingParticleCosmicIdAlg StoppingAlg() const {return spTag;}
+    CpaCrossCosmicIdAlg CpaAlg() const {return ccTag;}
     CrtHitCosmicIdAlg CrtHitAlg() const {return chTag;}
     CrtTrackCosmicIdAlg CrtTrackAlg() const {return ctTag;}
     ApaCrossCosmicIdAlg ApaAlg() const {return acTag;}
@@ -227,6 +340,18 @@ namespace sbnd{
 
   private:
 
+    // Throw if a product needed by the enabled cuts is missing from the event context
+    void CheckEventContext(const CosmicIdEventContext& context, bool pfparticle) const;
+
+    // Run the enabled cuts and record them in counters, safe to call from several threads
+    // with different counters
+    bool RunCuts(const CosmicIdEventContext& context, const recob::Track& track, CutCounters& counters);
+    bool RunCuts(const CosmicIdEventContext& context, const recob::PFParticle& pfparticle,
+                 const std::map< size_t, art::Ptr<recob::PFParticle> >& pfParticleMap, CutCounters& counters);
+
+    // CPA stitching result of a track from the event context, stitched on the fly if it is not in the event
+    std::pair<double, bool> CpaStitch(const CosmicIdEventContext& context, const recob::Track& track) const;
+
     double fBeamTimeMin;
     double fBeamTimeMax;
 
@@ -263,8 +388,47 @@ namespace sbnd{
     PandoraT0CosmicIdAlg         ptTag;
     PandoraNuScoreCosmicIdAlg    pnTag;
 
+    unsigned fNThreads = 1;
+
+    CutCounters fCutCounters;
+
   };
 
+  template<class CutFunc>
+  bool CosmicIdAlg::RunCut(CutCounters& counters, Cut cut, CutFunc&& cutFunc){
+
+    auto const start = std::chrono::steady_clock::now();
+    bool const tagged = cutFunc();
+    std::chrono::duration<double, std::milli> const elapsed = std::chrono::steady_clock::now() - start;
+
+    counters[cut].calls++;
+    if(tagged) counters[cut].tagged++;
+    counters[cut].time += elapsed.count();
+
+    return tagged;
+
+  }
+
+  template<class ItemCuts>
+  std::vector<bool> CosmicIdAlg::RunCutChains(size_t n, unsigned nThreads, CutCounters& total, ItemCuts&& itemCuts){
+
+    // Each item keeps its own result and counters so the threads never share an output,
+    // the results go through chars as a vector<bool> packs neighbouring items in one word
+    std::vector<char> tagged(n, false);
+    std::vector<CutCounters> counters(n);
+    CRTCommonUtils::ParallelFor(n, nThreads, [&](size_t i){
+      tagged[i] = itemCuts(i, counters[i]);
+    });
+
+    std::vector<bool> cosmicIds(n, false);
+    for(size_t i = 0; i < n; i++){
+      cosmicIds[i] = tagged[i];
+      AddCutCounters(total, counters[i]);
+    }
+    return cosmicIds;
+
+  }
+
 }
 
 #endif
@@ -2,6 +2,10 @@
 
 #include "lardataalg/DetectorInfo/DetectorPropertiesData.h"
 
+// c++
+#include <algorithm>
+#include <cmath>
+
 namespace sbnd{
 
 CpaCrossCosmicIdAlg::CpaCrossCosmicIdAlg(const Config& config){
@@ -40,7 +44,7 @@ void CpaCrossCosmicIdAlg::reconfigure(const Config& config){
 
 // Calculate the time by stitching tracks across the CPA
   std::pair<double, bool> CpaCrossCosmicIdAlg::T0FromCpaStitching(detinfo::DetectorPropertiesData const& detProp,
-                                                                  recob::Track t1, std::vector<recob::Track> tracks){
+                                                                  const recob::Track& t1, const std::vector<recob::Track>& tracks){
   
   std::vector<std::pair<double, std::pair<double, bool>>> matchCandidates;
   double matchedTime = -99999;
@@ -51,7 +55,7 @@ void CpaCrossCosmicIdAlg::reconfigure(const Config& config){
   double closestX1 = std::min(std::abs(trk1Front.X()), std::abs(trk1Back.X()));
 
   // Loop over all tracks in other TPC
-  for(auto & track : tracks){
+  for(auto const& track : tracks){
 
     TVector3 trk2Front = track.Vertex<TVector3>();
     TVector3 trk2Back = track.End<TVector3>();
@@ -111,41 +115,221 @@ void CpaCrossCosmicIdAlg::reconfigure(const Config& config){
   return returnVal;
 }
 
-// Tag tracks as cosmics from CPA stitching t0
-bool CpaCrossCosmicIdAlg::CpaCrossCosmicId(detinfo::DetectorPropertiesData const& detProp,
-                                           recob::Track track, std::vector<recob::Track> tracks, art::FindManyP<recob::Hit> hitAssoc){
+// Position of a track in the event by ID, size of the index if not found
+size_t CpaStitchIndex::Position(int trackId) const {
+
+  // Track IDs are normally their position in the event
+  if(trackId >= 0 && (size_t)trackId < trackIds.size() && trackIds[trackId] == trackId) return trackId;
+  for(size_t i = 0; i < trackIds.size(); i++){
+    if(trackIds[i] == trackId) return i;
+  }
+  return trackIds.size();
+
+}
+
+// End of a track nearest the CPA
+CpaStitchIndex::TrackEnd CpaCrossCosmicIdAlg::CpaEnd(const recob::Track& track, int tpc) const {
+
+  CpaStitchIndex::TrackEnd end;
+  end.tpc = tpc;
+
+  TVector3 trkFront = track.Vertex<TVector3>();
+  TVector3 trkBack = track.End<TVector3>();
+  end.closestX = std::min(std::abs(trkFront.X()), std::abs(trkBack.X()));
 
-  // Sort tracks by tpc
-  std::vector<recob::Track> tpcTracksTPC0;
-  std::vector<recob::Track> tpcTracksTPC1;
-  // Loop over the tpc tracks
+  // Find which point is closest to CPA
+  end.cpaPos = trkFront;
+  TVector3 farEnd = trkBack;
+  end.cpaDir = track.VertexDirection<TVector3>();
+  if(std::abs(trkBack.X()) == end.closestX){
+    end.cpaPos = trkBack;
+    farEnd = trkFront;
+    end.cpaDir = track.EndDirection<TVector3>();
+  }
+  end.cpaPos[0] = 0.;
+
+  geo::Point_t farPoint {farEnd.X(), farEnd.Y(), farEnd.Z()};
+  end.farEndOutside = !fTpcGeo.InFiducial(farPoint, fMinX, fMinY, fMinZ, fMaxX, fMaxY, fMaxZ);
+
+  return end;
+
+}
+
+// Index the ends of an event's tracks nearest the CPA
+CpaStitchIndex CpaCrossCosmicIdAlg::StitchIndex(const std::vector<recob::Track>& tracks, const art::FindManyP<recob::Hit>& hitAssoc) const {
+
+  CpaStitchIndex index;
+  index.trackIds.reserve(tracks.size());
+  index.ends.reserve(tracks.size());
+
+  // Tracks contained in one TPC can be stitched to from the other
+  std::array<std::vector<size_t>, 2> stitchable;
   for(auto const& tpcTrack : tracks){
     // Work out where the associated wire hits were detected
-    std::vector<art::Ptr<recob::Hit>> hits = hitAssoc.at(tpcTrack.ID());
-    int tpc = fTpcGeo.DetectedInTPC(hits);
+    int tpc = fTpcGeo.DetectedInTPC(hitAssoc.at(tpcTrack.ID()));
+    size_t track_i = index.ends.size();
+    index.trackIds.push_back(tpcTrack.ID());
+    index.ends.push_back(CpaEnd(tpcTrack, tpc));
+
+    // Tracks without a finite end position can never be stitched
+    const TVector3& pos = index.ends.back().cpaPos;
+    if(!std::isfinite(pos.Y()) || !std::isfinite(pos.Z())) continue;
+
     double startX = tpcTrack.Start().X();
     double endX = tpcTrack.End().X();
-    if(tpc == 0 && !(startX>0 || endX>0)) tpcTracksTPC0.push_back(tpcTrack);
-    else if(tpc == 1 && !(startX<0 || endX<0)) tpcTracksTPC1.push_back(tpcTrack);
+    if(tpc == 0 && !(startX>0 || endX>0)) stitchable[0].push_back(track_i);
+    else if(tpc == 1 && !(startX<0 || endX<0)) stitchable[1].push_back(track_i);
+  }
+
+  // Nothing can be stitched closer than a non-positive distance
+  if(!(fCpaStitchDistance > 0) || (stitchable[0].empty() && stitchable[1].empty())) return index;
+
+  double maxY = 0;
+  double maxZ = 0;
+  bool first = true;
+  for(auto const& tracks_i : stitchable){
+    for(auto const& track_i : tracks_i){
+      const TVector3& pos = index.ends[track_i].cpaPos;
+      if(first || pos.Y() < index.minY) index.minY = pos.Y();
+      if(first || pos.Z() < index.minZ) index.minZ = pos.Z();
+      if(first || pos.Y() > maxY) maxY = pos.Y();
+      if(first || pos.Z() > maxZ) maxZ = pos.Z();
+      first = false;
+    }
+  }
+
+  // Cells are at least as large as the stitching distance, limit the number for sparse events
+  const double maxCells = 100.;
+  index.cellSize = std::max({fCpaStitchDistance, (maxY - index.minY)/maxCells, (maxZ - index.minZ)/maxCells});
+  index.nY = (size_t)std::floor((maxY - index.minY)/index.cellSize) + 1;
+  index.nZ = (size_t)std::floor((maxZ - index.minZ)/index.cellSize) + 1;
+
+  auto cell = [&](const TVector3& pos){
+    size_t y_i = std::min((size_t)std::floor((pos.Y() - index.minY)/index.cellSize), index.nY - 1);
+    size_t z_i = std::min((size_t)std::floor((pos.Z() - index.minZ)/index.cellSize), index.nZ - 1);
+    return y_i * index.nZ + z_i;
+  };
+
+  // Count the tracks in each cell and fill them in event order
+  for(size_t tpc = 0; tpc < 2; tpc++){
+    auto& cellBegin = index.cellBegin[tpc];
+    auto& cellTracks = index.cellTracks[tpc];
+    cellBegin.assign(index.nY * index.nZ + 1, 0);
+    for(auto const& track_i : stitchable[tpc]) cellBegin[cell(index.ends[track_i].cpaPos) + 1]++;
+    for(size_t cell_i = 1; cell_i < cellBegin.size(); cell_i++) cellBegin[cell_i] += cellBegin[cell_i - 1];
+    cellTracks.resize(stitchable[tpc].size());
+    std::vector<size_t> fill(cellBegin.begin(), cellBegin.end() - 1);
+    for(auto const& track_i : stitchable[tpc]) cellTracks[fill[cell(index.ends[track_i].cpaPos)]++] = track_i;
+  }
+
+  return index;
+
+}
+
+// Stitch a track end to the indexed tracks in the other TPC
+std::pair<double, bool> CpaCrossCosmicIdAlg::Stitch(detinfo::DetectorPropertiesData const& detProp,
+                                                    const CpaStitchIndex::TrackEnd& end, const CpaStitchIndex& index) const {
+
+  double matchedTime = -99999;
+  std::pair<double, bool> returnVal = std::make_pair(matchedTime, false);
+
+  if(end.tpc != 0 && end.tpc != 1) return returnVal;
+  if(index.nY == 0 || index.nZ == 0) return returnVal;
+  if(!std::isfinite(end.cpaPos.Y()) || !std::isfinite(end.cpaPos.Z())) return returnVal;
+
+  // Collect the tracks in the other TPC from the cells within twice the stitching distance
+  // so that rounding can't lose any, and put them back in event order
+  auto cellRange = [&](double pos, double min, size_t n){
+    double low = std::floor((pos - 2.*fCpaStitchDistance - min)/index.cellSize);
+    double high = std::floor((pos + 2.*fCpaStitchDistance - min)/index.cellSize);
+    if(high < 0 || low > (double)(n - 1)) return std::make_pair((size_t)1, (size_t)0);
+    return std::make_pair((size_t)std::max(low, 0.), (size_t)std::min(high, (double)(n - 1)));
+  };
+  std::pair<size_t, size_t> yRange = cellRange(end.cpaPos.Y(), index.minY, index.nY);
+  std::pair<size_t, size_t> zRange = cellRange(end.cpaPos.Z(), index.minZ, index.nZ);
+
+  size_t other = (end.tpc == 0) ? 1 : 0;
+  auto const& cellBegin = index.cellBegin[other];
+  auto const& cellTracks = index.cellTracks[other];
+  std::vector<size_t> candidates;
+  for(size_t y_i = yRange.first; y_i <= yRange.second; y_i++){
+    for(size_t z_i = zRange.first; z_i <= zRange.second; z_i++){
+      size_t cell_i = y_i * index.nZ + z_i;
+      candidates.insert(candidates.end(), cellTracks.begin() + cellBegin[cell_i], cellTracks.begin() + cellBegin[cell_i + 1]);
+    }
   }
+  std::sort(candidates.begin(), candidates.end());
+
+  std::vector<std::pair<double, std::pair<double, bool>>> matchCandidates;
+  double minCos = cos(TMath::Pi() * fCpaStitchAngle / 180.);
+  for(auto const& track_i : candidates){
 
-  std::vector<art::Ptr<recob::Hit>> hits = hitAssoc.at(track.ID());
-  int tpc = fTpcGeo.DetectedInTPC(hits);
+    const CpaStitchIndex::TrackEnd& candidate = index.ends[track_i];
 
-  double stitchTime = -99999;
-  bool stitchExit = false;
-  // Try to match tracks from CPA crossers
-  if(tpc == 0){
-    std::pair<double, bool> stitchResults = T0FromCpaStitching(detProp, track, tpcTracksTPC1);
-    stitchTime = stitchResults.first;
-    stitchExit = stitchResults.second;
+    // Try to match if their ends have similar x positions
+    if(std::abs(end.closestX-candidate.closestX) > fCpaXDifference) continue;
+
+    // Calculate the angle between the tracks
+    double trkCos = std::abs(end.cpaDir.Dot(candidate.cpaDir));
+    // Calculate the distance between the tracks at the middle of the CPA
+    double dist = (end.cpaPos-candidate.cpaPos).Mag();
+
+    // Does the track enter and exit the fiducial volume when merged?
+    bool exits = end.farEndOutside && candidate.farEndOutside;
+
+    // If the distance and angle are within the acceptable limits then record candidate
+    if(dist < fCpaStitchDistance && trkCos > minCos){
+      matchCandidates.push_back(std::make_pair(trkCos, std::make_pair(end.closestX, exits)));
+    }
   }
-  else if(tpc == 1){
-    std::pair<double, bool> stitchResults = T0FromCpaStitching(detProp, track, tpcTracksTPC0);
-    stitchTime = stitchResults.first;
-    stitchExit = stitchResults.second;
+
+  // Choose the candidate with the smallest angle
+  if(matchCandidates.size() > 0){
+    std::sort(matchCandidates.begin(), matchCandidates.end(), [](auto& left, auto& right){
+              return left.first < right.first;});
+    double shiftX = matchCandidates[0].second.first;
+    matchedTime = -((shiftX - fTpcGeo.CpaWidth())/detProp.DriftVelocity()); //subtract CPA width
+    returnVal = std::make_pair(matchedTime, matchCandidates[0].second.second);
   }
 
+  return returnVal;
+
+}
+
+// Calculate the time of a track by stitching it to the indexed tracks in the other TPC
+std::pair<double, bool> CpaCrossCosmicIdAlg::T0FromCpaStitching(detinfo::DetectorPropertiesData const& detProp, const recob::Track& track,
+                                                                const std::vector<art::Ptr<recob::Hit>>& hits, const CpaStitchIndex& index) const {
+
+  return Stitch(detProp, CpaEnd(track, fTpcGeo.DetectedInTPC(hits)), index);
+
+}
+
+// Calculate the stitching times of all the indexed tracks in one pass, in event order
+std::vector<std::pair<double, bool>> CpaCrossCosmicIdAlg::T0sFromCpaStitching(detinfo::DetectorPropertiesData const& detProp,
+                                                                              const CpaStitchIndex& index) const {
+
+  std::vector<std::pair<double, bool>> stitches;
+  stitches.reserve(index.Size());
+  for(auto const& end : index.ends) stitches.push_back(Stitch(detProp, end, index));
+  return stitches;
+
+}
+
+// Tag tracks as cosmics from CPA stitching t0
+bool CpaCrossCosmicIdAlg::CpaCrossCosmicId(detinfo::DetectorPropertiesData const& detProp,
+                                           const recob::Track& track, const std::vector<recob::Track>& tracks, const art::FindManyP<recob::Hit>& hitAssoc){
+
+  CpaStitchIndex index = StitchIndex(tracks, hitAssoc);
+  return CpaCrossCosmicId(T0FromCpaStitching(detProp, track, hitAssoc.at(track.ID()), index));
+
+}
+
+// Tag tracks as cosmics from a CPA stitching result
+bool CpaCrossCosmicIdAlg::CpaCrossCosmicId(const std::pair<double, bool>& stitchResults) const {
+
+  double stitchTime = stitchResults.first;
+  bool stitchExit = stitchResults.second;
+
   // If tracks are stitched, get time and remove any outside of beam window
   if(stitchTime != -99999 && (stitchTime < fBeamTimeMin || stitchTime > fBeamTimeMax || stitchExit)) return true;
   
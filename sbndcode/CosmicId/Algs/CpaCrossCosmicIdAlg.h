@@ -31,10 +31,47 @@ namespace detinfo {
 // c++
 #include <vector>
 #include <utility>
+#include <array>
+
+// ROOT
+#include "TVector3.h"
 
 
 namespace sbnd{
 
+  // Ends of an event's tracks nearest the CPA. Tracks which can be stitched to from
+  // the other TPC are bucketed by TPC, y and z so that each track is only compared
+  // with the tracks near its own end. Built once per event and shared between tracks
+  struct CpaStitchIndex {
+
+    struct TrackEnd {
+      int tpc = -1;
+      double closestX = 0;
+      // Position at the CPA with x set to 0 and direction of the end nearest the CPA
+      TVector3 cpaPos;
+      TVector3 cpaDir;
+      // The other end is outside the fiducial volume
+      bool farEndOutside = false;
+    };
+
+    // Position of a track in the event by ID, size of the index if not found
+    size_t Position(int trackId) const;
+    size_t Size() const {return trackIds.size();}
+
+    std::vector<int> trackIds;
+    std::vector<TrackEnd> ends;
+
+    // Stitchable tracks of each TPC by (y, z) cell, in event order inside a cell
+    double cellSize = 0;
+    double minY = 0;
+    double minZ = 0;
+    size_t nY = 0;
+    size_t nZ = 0;
+    std::array<std::vector<size_t>, 2> cellBegin;
+    std::array<std::vector<size_t>, 2> cellTracks;
+
+  };
+
   class CpaCrossCosmicIdAlg {
   public:
 
@@ -110,14 +147,35 @@ namespace sbnd{
 
     // Calculate the time by stitching tracks across the CPA
     std::pair<double, bool> T0FromCpaStitching(detinfo::DetectorPropertiesData const& detProp,
-                                               recob::Track t1, std::vector<recob::Track> tracks);
+                                               const recob::Track& t1, const std::vector<recob::Track>& tracks);
+
+    // Index the ends of an event's tracks nearest the CPA
+    CpaStitchIndex StitchIndex(const std::vector<recob::Track>& tracks, const art::FindManyP<recob::Hit>& hitAssoc) const;
+
+    // Calculate the time of a track by stitching it to the indexed tracks in the other TPC
+    std::pair<double, bool> T0FromCpaStitching(detinfo::DetectorPropertiesData const& detProp, const recob::Track& track,
+                                               const std::vector<art::Ptr<recob::Hit>>& hits, const CpaStitchIndex& index) const;
+
+    // Calculate the stitching times of all the indexed tracks in one pass, in event order
+    std::vector<std::pair<double, bool>> T0sFromCpaStitching(detinfo::DetectorPropertiesData const& detProp,
+                                                             const CpaStitchIndex& index) const;
 
     // Tag tracks as cosmics from CPA stitching t0
     bool CpaCrossCosmicId(detinfo::DetectorPropertiesData const& detProp,
-                          recob::Track track, std::vector<recob::Track> tracks, art::FindManyP<recob::Hit> hitAssoc);
+                          const recob::Track& track, const std::vector<recob::Track>& tracks, const art::FindManyP<recob::Hit>& hitAssoc);
+
+    // Tag tracks as cosmics from a CPA stitching result
+    bool CpaCrossCosmicId(const std::pair<double, bool>& stitchResults) const;
 
   private:
 
+    // End of a track nearest the CPA
+    CpaStitchIndex::TrackEnd CpaEnd(const recob::Track& track, int tpc) const;
+
+    // Stitch a track end to the indexed tracks in the other TPC
+    std::pair<double, bool> Stitch(detinfo::DetectorPropertiesData const& detProp,
+                                   const CpaStitchIndex::TrackEnd& end, const CpaStitchIndex& index) const;
+
     double fCpaStitchDistance;
     double fCpaStitchAngle;
     double fCpaXDifference;
@@ -42,5 +42,16 @@ bool CrtHitCosmicIdAlg::CrtHitCosmicId(detinfo::DetectorPropertiesData const& de
   return false;
 
 } //CrtHitCosmicId()
+
+bool CrtHitCosmicIdAlg::CrtHitCosmicId(detinfo::DetectorPropertiesData const& detProp,
+                                       const recob::Track& track, const std::vector<art::Ptr<recob::Hit>>& hits, const CRTHitTimeIndex& crtHitIndex){
+
+  double crtHitTime = t0Alg.T0FromCRTHits(detProp, track, hits, crtHitIndex);
+
+  if(crtHitTime != -99999 && (crtHitTime < fBeamTimeMin || crtHitTime > fBeamTimeMax)) return true;
+
+  return false;
+
+} //CrtHitCosmicId()
  
 }
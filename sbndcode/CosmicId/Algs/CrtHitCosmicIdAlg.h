@@ -77,6 +77,11 @@ namespace sbnd{
     // Returns true if matched to CRTHit outside beam time
     bool CrtHitCosmicId(detinfo::DetectorPropertiesData const& detProp,
                         recob::Track track, std::vector<sbn::crt::CRTHit> crtHits, const art::Event& event);
+    bool CrtHitCosmicId(detinfo::DetectorPropertiesData const& detProp,
+                        const recob::Track& track, const std::vector<art::Ptr<recob::Hit>>& hits, const CRTHitTimeIndex& crtHitIndex);
+
+    // Index of the event CRT hits sorted by time, can be shared by all tracks in the event
+    CRTHitTimeIndex HitTimeIndex(const std::vector<sbn::crt::CRTHit>& crtHits) const {return t0Alg.HitTimeIndex(crtHits);}
 
     // Getter for matching algorithm
     CRTT0MatchAlg T0Alg() const {return t0Alg;}
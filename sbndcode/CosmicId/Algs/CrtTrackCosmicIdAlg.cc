@@ -49,5 +49,22 @@ bool CrtTrackCosmicIdAlg::CrtTrackCosmicId(detinfo::DetectorPropertiesData const
   return false;
 
 }
+
+bool CrtTrackCosmicIdAlg::CrtTrackCosmicId(detinfo::DetectorPropertiesData const& detProp,
+                                           const recob::Track& track, const std::vector<art::Ptr<recob::Hit>>& hits, const CRTTrackTimeIndex& crtTrackIndex){
+
+  int crtID = trackMatchAlg.GetMatchedCRTTrackId(detProp, track, hits, crtTrackIndex);
+
+  if(crtID == -99999) return false;
+
+  const sbn::crt::CRTTrack& crtTrack = crtTrackIndex.Object(crtID);
+  if(crtTrack.complete) return true;
+
+  double crtTime = ((double)(int)crtTrack.ts1_ns) * 1e-3; // [us]
+  if(crtTime < fBeamTimeMin || crtTime > fBeamTimeMax) return true;
+
+  return false;
+
+}
  
 }
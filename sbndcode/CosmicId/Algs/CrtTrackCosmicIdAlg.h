@@ -77,6 +77,11 @@ namespace sbnd{
     // Tags track as cosmic if it matches a CRTTrack
     bool CrtTrackCosmicId(detinfo::DetectorPropertiesData const& detProp,
                           recob::Track track, std::vector<sbn::crt::CRTTrack> crtTracks, const art::Event& event);
+    bool CrtTrackCosmicId(detinfo::DetectorPropertiesData const& detProp,
+                          const recob::Track& track, const std::vector<art::Ptr<recob::Hit>>& hits, const CRTTrackTimeIndex& crtTrackIndex);
+
+    // Index of the event CRT tracks sorted by time, can be shared by all tracks in the event
+    CRTTrackTimeIndex TrackTimeIndex(const std::vector<sbn::crt::CRTTrack>& crtTracks) const {return trackMatchAlg.TrackTimeIndex(crtTracks);}
 
     // Getter for matching algorithm
     CRTTrackMatchAlg TrackAlg() const {return trackMatchAlg;}
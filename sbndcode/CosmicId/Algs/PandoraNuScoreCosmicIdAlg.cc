@@ -1,5 +1,9 @@
 #include "PandoraNuScoreCosmicIdAlg.h"
 
+#include "messagefacility/MessageLogger/MessageLogger.h"
+
+#include <unordered_map>
+
 namespace sbnd{
 
   PandoraNuScoreCosmicIdAlg::PandoraNuScoreCosmicIdAlg(const Config& config){
@@ -37,15 +41,23 @@ namespace sbnd{
     art::FindManyP<recob::Track> pfPartToTrackAssoc(pfParticleHandle, event, fTpcTrackModuleLabel);
     art::FindManyP<larpandoraobj::PFParticleMetadata> PFPMetaDataAssoc(pfParticleHandle, event, fPandoraLabel);
 
+    return PandoraNuScoreCosmicId(track, *pfParticleHandle, pfPartToTrackAssoc, PFPMetaDataAssoc);
+
+  }
+
+  bool PandoraNuScoreCosmicIdAlg::PandoraNuScoreCosmicId(const recob::Track& track, const std::vector<recob::PFParticle>& pfParticles,
+      const art::FindManyP<recob::Track>& pfPartToTrackAssoc,
+      const art::FindManyP<larpandoraobj::PFParticleMetadata>& PFPMetaDataAssoc){
+
     // Loop over all the pfps
-    for(auto const pfp : (*pfParticleHandle)){
+    for(auto const& pfp : pfParticles){
       // Get the associated track if there is one
       const std::vector< art::Ptr<recob::Track> > associatedTracks(pfPartToTrackAssoc.at(pfp.Self()));
       if(associatedTracks.size() != 1) continue;
       recob::Track trk = *associatedTracks.front();
       if(trk.ID() != track.ID()) continue;
 
-      recob::PFParticle PFPNeutrino = GetPFPNeutrino(pfp, (*pfParticleHandle));
+      recob::PFParticle PFPNeutrino = GetPFPNeutrino(pfp, pfParticles);
 
       float pfpNuScore = GetPandoraNuScore(PFPNeutrino, PFPMetaDataAssoc);
       if (pfpNuScore < fNuScoreCut){
@@ -58,6 +70,19 @@ namespace sbnd{
 
   }
 
+  bool PandoraNuScoreCosmicIdAlg::PandoraNuScoreCosmicId(const recob::Track& track, const PandoraTrackLookup& lookup) const {
+
+    // Use the first pfp owning the track
+    auto const& pfps = lookup.TrackPFParticles(track.ID());
+    if(pfps.empty()) return false;
+
+    if (lookup.NuScore(pfps.front()) < fNuScoreCut){
+      return true;
+    }
+    return false;
+
+  }
+
   // Finds any t0s associated with pfparticle by pandora, tags if outside beam
   bool PandoraNuScoreCosmicIdAlg::PandoraNuScoreCosmicId(recob::PFParticle pfparticle,
       std::map< size_t, art::Ptr<recob::PFParticle> > pfParticleMap, const art::Event& event){
@@ -68,6 +93,13 @@ namespace sbnd{
 
     art::FindManyP<larpandoraobj::PFParticleMetadata> PFPMetaDataAssoc(pfParticleHandle, event, fPandoraLabel);
 
+    return PandoraNuScoreCosmicId(pfparticle, pfParticleMap, PFPMetaDataAssoc);
+  }
+
+  bool PandoraNuScoreCosmicIdAlg::PandoraNuScoreCosmicId(const recob::PFParticle& pfparticle,
+      const std::map< size_t, art::Ptr<recob::PFParticle> >& pfParticleMap,
+      const art::FindManyP<larpandoraobj::PFParticleMetadata>& PFPMetaDataAssoc){
+
     recob::PFParticle PFPNeutrino = GetPFPNeutrino(pfparticle, pfParticleMap);
 
     float pfpNuScore = GetPandoraNuScore(PFPNeutrino, PFPMetaDataAssoc);
@@ -79,7 +111,7 @@ namespace sbnd{
   }
 
 
-  recob::PFParticle PandoraNuScoreCosmicIdAlg::GetPFPNeutrino(recob::PFParticle pfparticle, std::map< size_t, art::Ptr<recob::PFParticle> >& pfParticleMap){
+  recob::PFParticle PandoraNuScoreCosmicIdAlg::GetPFPNeutrino(recob::PFParticle pfparticle, const std::map< size_t, art::Ptr<recob::PFParticle> >& pfParticleMap) const {
 
     if ((pfparticle.PdgCode()==12) ||(pfparticle.PdgCode()==14)){
       return pfparticle;
@@ -90,7 +122,7 @@ namespace sbnd{
   }
 
   recob::PFParticle PandoraNuScoreCosmicIdAlg::GetPFPNeutrino(recob::PFParticle pfparticle,
-      const std::vector<recob::PFParticle>& pfpVec){
+      const std::vector<recob::PFParticle>& pfpVec) const {
 
     if ((pfparticle.PdgCode()==12) ||(pfparticle.PdgCode()==14)){
       return pfparticle;
@@ -108,13 +140,13 @@ namespace sbnd{
   }
 
   float PandoraNuScoreCosmicIdAlg::GetPandoraNuScore(recob::PFParticle pfparticle,
-      art::FindManyP<larpandoraobj::PFParticleMetadata> PFPMetaDataAssoc){
+      const art::FindManyP<larpandoraobj::PFParticleMetadata>& PFPMetaDataAssoc) const {
 
     const std::vector<art::Ptr<larpandoraobj::PFParticleMetadata> > pfpMetaVec =
       PFPMetaDataAssoc.at(pfparticle.Self());
 
     if (pfpMetaVec.size() !=1){
-      std::cout<<"Cannot get PFPMetadata"<<std::endl;
+      mf::LogDebug("PandoraNuScoreCosmicIdAlg") << "Cannot get PFPMetadata";
       return 99999;
     }
 
@@ -123,12 +155,34 @@ namespace sbnd{
     larpandoraobj::PFParticleMetadata::PropertiesMap propertiesMap = pfpMeta->GetPropertiesMap();
     auto propertiesMapIter = propertiesMap.find("NuScore");
     if (propertiesMapIter == propertiesMap.end()){
-      std::cout<<"Cannot get PFP Nu Score in Metadata"<<std::endl;
-      std::cout<<"PFP pdg: "<<pfparticle.PdgCode()<<std::endl;
+      mf::LogDebug("PandoraNuScoreCosmicIdAlg") << "Cannot get PFP Nu Score in Metadata\n"
+                                                << "PFP pdg: " << pfparticle.PdgCode();
       return 99999;
     }
 
     return propertiesMapIter->second;
   }
 
+  // Fill the neutrino scores of the pfparticles owning tracks in a per-event track lookup,
+  // this runs on cosmics without metadata too so the missing score messages are debug only
+  void PandoraNuScoreCosmicIdAlg::FillLookup(PandoraTrackLookup& lookup,
+      const art::FindManyP<larpandoraobj::PFParticleMetadata>& PFPMetaDataAssoc) const {
+
+    auto const& pfParticles = lookup.PFParticles();
+    std::vector<float> nuScores(pfParticles.size(), 99999);
+    // Many pfps come from the same neutrino, only get each score once
+    std::unordered_map<size_t, float> neutrinoScores;
+    for(size_t pfp_i = 0; pfp_i < pfParticles.size(); pfp_i++){
+      if(!lookup.OwnsTrack(pfp_i)) continue;
+      size_t nu_i = lookup.Neutrino(pfp_i);
+      auto scoreIter = neutrinoScores.find(nu_i);
+      if(scoreIter == neutrinoScores.end()){
+        scoreIter = neutrinoScores.emplace(nu_i, GetPandoraNuScore(pfParticles[nu_i], PFPMetaDataAssoc)).first;
+      }
+      nuScores[pfp_i] = scoreIter->second;
+    }
+    lookup.SetNuScores(std::move(nuScores));
+
+  }
+
 }
@@ -19,6 +19,9 @@
 #include "canvas/Persistency/Common/Ptr.h"
 #include "canvas/Persistency/Common/FindManyP.h"
 
+// sbndcode
+#include "sbndcode/CosmicId/Algs/PandoraTrackLookup.h"
+
 // LArSoft
 #include "lardataobj/RecoBase/Track.h"
 #include "lardataobj/RecoBase/Hit.h"
@@ -68,16 +71,25 @@ namespace sbnd{
 
       // Finds any t0s associated with track by pandora, tags if outside beam
       bool PandoraNuScoreCosmicId(recob::Track track, const art::Event& event);
+      bool PandoraNuScoreCosmicId(const recob::Track& track, const std::vector<recob::PFParticle>& pfParticles,
+                                  const art::FindManyP<recob::Track>& pfPartToTrackAssoc,
+                                  const art::FindManyP<larpandoraobj::PFParticleMetadata>& PFPMetaDataAssoc);
+      bool PandoraNuScoreCosmicId(const recob::Track& track, const PandoraTrackLookup& lookup) const;
 
       // Finds any t0s associated with pfparticle by pandora, tags if outside beam
       bool PandoraNuScoreCosmicId(recob::PFParticle pfparticle, std::map< size_t, art::Ptr<recob::PFParticle> > pfParticleMap, const art::Event& event);
+      bool PandoraNuScoreCosmicId(const recob::PFParticle& pfparticle, const std::map< size_t, art::Ptr<recob::PFParticle> >& pfParticleMap,
+                                  const art::FindManyP<larpandoraobj::PFParticleMetadata>& PFPMetaDataAssoc);
 
-      recob::PFParticle GetPFPNeutrino(recob::PFParticle pfparticle, std::map< size_t, art::Ptr<recob::PFParticle> >& pfParticleMap);
+      recob::PFParticle GetPFPNeutrino(recob::PFParticle pfparticle, const std::map< size_t, art::Ptr<recob::PFParticle> >& pfParticleMap) const;
 
-      recob::PFParticle GetPFPNeutrino(recob::PFParticle pfp, const std::vector<recob::PFParticle>& pfpVec);
+      recob::PFParticle GetPFPNeutrino(recob::PFParticle pfp, const std::vector<recob::PFParticle>& pfpVec) const;
 
       float GetPandoraNuScore(recob::PFParticle pfparticle,
-          art::FindManyP<larpandoraobj::PFParticleMetadata> PFPMetaDataAssoc);
+          const art::FindManyP<larpandoraobj::PFParticleMetadata>& PFPMetaDataAssoc) const;
+
+      // Fill the neutrino scores of the pfparticles owning tracks in a per-event track lookup
+      void FillLookup(PandoraTrackLookup& lookup, const art::FindManyP<larpandoraobj::PFParticleMetadata>& PFPMetaDataAssoc) const;
 
     private:
 
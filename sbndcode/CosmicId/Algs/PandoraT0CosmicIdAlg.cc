@@ -38,8 +38,15 @@ bool PandoraT0CosmicIdAlg::PandoraT0CosmicId(recob::Track track, const art::Even
   art::FindManyP<recob::Track> pfPartToTrackAssoc(pfParticleHandle, event, fTpcTrackModuleLabel);
   art::FindManyP<anab::T0> findManyT0(pfParticleHandle, event, fPandoraLabel);
 
+  return PandoraT0CosmicId(track, *pfParticleHandle, pfPartToTrackAssoc, findManyT0);
+
+}
+
+bool PandoraT0CosmicIdAlg::PandoraT0CosmicId(const recob::Track& track, const std::vector<recob::PFParticle>& pfParticles,
+                                             const art::FindManyP<recob::Track>& pfPartToTrackAssoc, const art::FindManyP<anab::T0>& findManyT0){
+
   // Loop over all the pfps
-  for(auto const pfp : (*pfParticleHandle)){
+  for(auto const& pfp : pfParticles){
     // Get the associated track if there is one
     const std::vector< art::Ptr<recob::Track> > associatedTracks(pfPartToTrackAssoc.at(pfp.Self()));
     if(associatedTracks.size() != 1) continue;
@@ -59,6 +66,20 @@ bool PandoraT0CosmicIdAlg::PandoraT0CosmicId(recob::Track track, const art::Even
 
 }
 
+bool PandoraT0CosmicIdAlg::PandoraT0CosmicId(const recob::Track& track, const PandoraTrackLookup& lookup) const {
+
+  // Loop over the pfps owning the track
+  for(auto const& pfp_i : lookup.TrackPFParticles(track.ID())){
+    // If any t0 outside of beam limits then remove
+    for(auto const& pandoraTime : lookup.T0s(pfp_i)){
+      if(pandoraTime < fBeamTimeMin || pandoraTime > fBeamTimeMax) return true;
+    }
+  }
+
+  return false;
+
+}
+
 // Finds any t0s associated with pfparticle by pandora, tags if outside beam
 bool PandoraT0CosmicIdAlg::PandoraT0CosmicId(recob::PFParticle pfparticle, std::map< size_t, art::Ptr<recob::PFParticle> > pfParticleMap, const art::Event& event){
 
@@ -67,6 +88,13 @@ bool PandoraT0CosmicIdAlg::PandoraT0CosmicId(recob::PFParticle pfparticle, std::
   event.getByLabel(fPandoraLabel, pfParticleHandle);
   art::FindManyP<anab::T0> findManyT0(pfParticleHandle, event, fPandoraLabel);
 
+  return PandoraT0CosmicId(pfparticle, pfParticleMap, findManyT0);
+
+}
+
+bool PandoraT0CosmicIdAlg::PandoraT0CosmicId(const recob::PFParticle& pfparticle, const std::map< size_t, art::Ptr<recob::PFParticle> >& pfParticleMap,
+                                             const art::FindManyP<anab::T0>& findManyT0){
+
   // Loop over daughters
   for (const size_t daughterId : pfparticle.Daughters()){
     // Get associated t0s
@@ -84,5 +112,19 @@ bool PandoraT0CosmicIdAlg::PandoraT0CosmicId(recob::PFParticle pfparticle, std::
 
 }
 
+// Fill the pandora t0s of every pfparticle in a per-event track lookup
+void PandoraT0CosmicIdAlg::FillLookup(PandoraTrackLookup& lookup, const art::FindManyP<anab::T0>& findManyT0) const {
+
+  auto const& pfParticles = lookup.PFParticles();
+  std::vector<std::vector<double>> t0s(pfParticles.size());
+  for(size_t pfp_i = 0; pfp_i < pfParticles.size(); pfp_i++){
+    for(auto const& t0 : findManyT0.at(pfParticles[pfp_i].Self())){
+      t0s[pfp_i].push_back(t0->Time()*1e-3); // [us]
+    }
+  }
+  lookup.SetT0s(std::move(t0s));
+
+}
+
 
 }
@@ -19,6 +19,9 @@
 #include "canvas/Persistency/Common/Ptr.h" 
 #include "canvas/Persistency/Common/FindManyP.h"
 
+// sbndcode
+#include "sbndcode/CosmicId/Algs/PandoraTrackLookup.h"
+
 // LArSoft
 #include "lardataobj/RecoBase/Track.h"
 #include "lardataobj/RecoBase/Hit.h"
@@ -84,9 +87,17 @@ namespace sbnd{
 
     // Finds any t0s associated with track by pandora, tags if outside beam
     bool PandoraT0CosmicId(recob::Track track, const art::Event& event);
+    bool PandoraT0CosmicId(const recob::Track& track, const std::vector<recob::PFParticle>& pfParticles,
+                           const art::FindManyP<recob::Track>& pfPartToTrackAssoc, const art::FindManyP<anab::T0>& findManyT0);
+    bool PandoraT0CosmicId(const recob::Track& track, const PandoraTrackLookup& lookup) const;
 
     // Finds any t0s associated with pfparticle by pandora, tags if outside beam
     bool PandoraT0CosmicId(recob::PFParticle pfparticle, std::map< size_t, art::Ptr<recob::PFParticle> > pfParticleMap, const art::Event& event);
+    bool PandoraT0CosmicId(const recob::PFParticle& pfparticle, const std::map< size_t, art::Ptr<recob::PFParticle> >& pfParticleMap,
+                           const art::FindManyP<anab::T0>& findManyT0);
+
+    // Fill the pandora t0s of every pfparticle in a per-event track lookup
+    void FillLookup(PandoraTrackLookup& lookup, const art::FindManyP<anab::T0>& findManyT0) const;
 
   private:
 
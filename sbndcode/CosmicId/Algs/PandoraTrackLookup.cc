@@ -0,0 +1,56 @@
+#include "PandoraTrackLookup.h"
+
+namespace sbnd{
+
+// Map every track to the PFParticles which have it as their only associated track
+PandoraTrackLookup::PandoraTrackLookup(const std::vector<recob::PFParticle>& pfParticles, const art::FindManyP<recob::Track>& pfPartToTrackAssoc)
+  : fPFParticles(&pfParticles)
+{
+
+  fOwnsTrack.resize(pfParticles.size(), false);
+  fSelfPosition.reserve(pfParticles.size());
+  for(size_t pfp_i = 0; pfp_i < pfParticles.size(); pfp_i++){
+    auto const& pfp = pfParticles[pfp_i];
+    fSelfPosition.emplace(pfp.Self(), pfp_i);
+    // Get the associated track if there is one
+    auto const& associatedTracks = pfPartToTrackAssoc.at(pfp.Self());
+    if(associatedTracks.size() != 1) continue;
+    fOwnsTrack[pfp_i] = true;
+    fTrackPFParticles[associatedTracks.front()->ID()].push_back(pfp_i);
+  }
+
+}
+
+// Positions of the PFParticles owning a track, in event order
+const std::vector<size_t>& PandoraTrackLookup::TrackPFParticles(int trackId) const {
+
+  static const std::vector<size_t> none;
+  auto const it = fTrackPFParticles.find(trackId);
+  if(it == fTrackPFParticles.end()) return none;
+  return it->second;
+
+}
+
+// Position of the first PFParticle with an ID, size of the event if not found
+size_t PandoraTrackLookup::Position(size_t self) const {
+
+  auto const it = fSelfPosition.find(self);
+  if(it == fSelfPosition.end()) return fPFParticles->size();
+  return it->second;
+
+}
+
+// Position of the neutrino a PFParticle comes from
+size_t PandoraTrackLookup::Neutrino(size_t pfp_i) const {
+
+  auto const& pfParticles = *fPFParticles;
+  while(pfParticles[pfp_i].PdgCode() != 12 && pfParticles[pfp_i].PdgCode() != 14){
+    size_t parent_i = Position(pfParticles[pfp_i].Parent());
+    if(parent_i == pfParticles.size()) break;
+    pfp_i = parent_i;
+  }
+  return pfp_i;
+
+}
+
+}
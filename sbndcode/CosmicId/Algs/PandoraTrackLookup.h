@@ -0,0 +1,76 @@
+#ifndef PANDORATRACKLOOKUP_H_SEEN
+#define PANDORATRACKLOOKUP_H_SEEN
+
+
+///////////////////////////////////////////////
+// PandoraTrackLookup.h
+//
+// Per-event map from track ID to the PFParticles
+// owning the track and their Pandora T0s and
+// neutrino scores. Built once per event so that the
+// Pandora cuts look tracks up instead of looping
+// over all the PFParticles for every track
+///////////////////////////////////////////////
+
+// framework
+#include "canvas/Persistency/Common/Ptr.h" 
+#include "canvas/Persistency/Common/FindManyP.h"
+
+// LArSoft
+#include "lardataobj/RecoBase/Track.h"
+#include "lardataobj/RecoBase/PFParticle.h"
+
+// c++
+#include <vector>
+#include <unordered_map>
+#include <utility>
+
+
+namespace sbnd{
+
+  class PandoraTrackLookup {
+  public:
+
+    PandoraTrackLookup() = default;
+
+    // Map every track to the PFParticles which have it as their only associated track
+    PandoraTrackLookup(const std::vector<recob::PFParticle>& pfParticles, const art::FindManyP<recob::Track>& pfPartToTrackAssoc);
+
+    const std::vector<recob::PFParticle>& PFParticles() const {return *fPFParticles;}
+
+    // Does a PFParticle have exactly one associated track
+    bool OwnsTrack(size_t pfp_i) const {return fOwnsTrack[pfp_i];}
+
+    // Positions of the PFParticles owning a track, in event order
+    const std::vector<size_t>& TrackPFParticles(int trackId) const;
+
+    // Position of the first PFParticle with an ID, size of the event if not found
+    size_t Position(size_t self) const;
+
+    // Position of the neutrino a PFParticle comes from, following the parents until a
+    // neutrino or a missing parent is found
+    size_t Neutrino(size_t pfp_i) const;
+
+    // Pandora T0s [us] of every PFParticle, filled by PandoraT0CosmicIdAlg
+    const std::vector<double>& T0s(size_t pfp_i) const {return fT0s[pfp_i];}
+    void SetT0s(std::vector<std::vector<double>> t0s) {fT0s = std::move(t0s);}
+
+    // Neutrino score of the neutrino each PFParticle comes from, filled by PandoraNuScoreCosmicIdAlg
+    // for the PFParticles owning tracks
+    float NuScore(size_t pfp_i) const {return fNuScores[pfp_i];}
+    void SetNuScores(std::vector<float> nuScores) {fNuScores = std::move(nuScores);}
+
+  private:
+
+    const std::vector<recob::PFParticle>* fPFParticles = nullptr;
+    std::vector<bool> fOwnsTrack;
+    std::unordered_map<int, std::vector<size_t>> fTrackPFParticles;
+    std::unordered_map<size_t, size_t> fSelfPosition;
+    std::vector<std::vector<double>> fT0s;
+    std::vector<float> fNuScores;
+
+  };
+
+}
+
+#endif
@@ -36,7 +36,7 @@ void StoppingParticleCosmicIdAlg::reconfigure(const Config& config){
 }
 
 // Calculate the chi2 ratio of pol0 and exp fit to dE/dx vs residual range
-double StoppingParticleCosmicIdAlg::StoppingChiSq(geo::Point_t end, std::vector<art::Ptr<anab::Calorimetry>> calos){
+double StoppingParticleCosmicIdAlg::StoppingChiSq(geo::Point_t end, const std::vector<art::Ptr<anab::Calorimetry>>& calos){
 
   // If calorimetry object is null then return 0
   if(calos.size()==0) return -99999;
@@ -98,25 +98,117 @@ double StoppingParticleCosmicIdAlg::StoppingChiSq(geo::Point_t end, std::vector<
   // Return null value if not enough points to do fits
   if(v_dedx.size() < 10) return -99999;
 
-  // Try to do a pol0 fit
-  TGraph *gdedx = new TGraph(v_dedx.size(), &v_resrg[0], &v_dedx[0]);
-  try{ gdedx->Fit("pol0", "Q"); } catch(...){ return -99999; }
-  TF1* polfit = gdedx->GetFunction("pol0");
-  double polchi2 = polfit->GetChisquare();
+  // Do a pol0 fit
+  double polchi2 = Pol0ChiSq(v_dedx);
 
-  // Try to do and exp fit
-  try{ gdedx->Fit("expo", "Q"); } catch(...){ return -99999; }
-  TF1* expfit = gdedx->GetFunction("expo");
-  double expchi2 = expfit->GetChisquare();
+  // Do an exp fit
+  double expchi2 = ExpoChiSq(v_resrg, v_dedx);
 
   // Return the chi2 ratio
   return polchi2/expchi2;
 
 }
 
+// Chi2 of a least squares fit of a constant to y, same as a pol0 fit to a graph without errors
+double StoppingParticleCosmicIdAlg::Pol0ChiSq(const std::vector<double>& y){
+
+  double mean = 0;
+  for(auto const& yi : y) mean += yi;
+  mean /= y.size();
+
+  double chi2 = 0;
+  for(auto const& yi : y) chi2 += (yi - mean) * (yi - mean);
+
+  return chi2;
+
+}
+
+// Chi2 of a least squares fit of exp(p0 + p1*x) to y, same as an expo fit to a graph without errors
+double StoppingParticleCosmicIdAlg::ExpoChiSq(const std::vector<double>& x, const std::vector<double>& y){
+
+  auto chiSq = [&](double p0, double p1){
+    double chi2 = 0;
+    for(size_t i = 0; i < x.size(); i++){
+      double res = y[i] - std::exp(p0 + p1 * x[i]);
+      chi2 += res * res;
+    }
+    return chi2;
+  };
+
+  // Start from a straight line fit to log(y) of the positive points, as ROOT does
+  double sw = 0, sx = 0, sy = 0, sxx = 0, sxy = 0;
+  for(size_t i = 0; i < x.size(); i++){
+    if(y[i] <= 0) continue;
+    double logy = std::log(y[i]);
+    sw += 1;
+    sx += x[i];
+    sy += logy;
+    sxx += x[i] * x[i];
+    sxy += x[i] * logy;
+  }
+  double p0 = 0;
+  double p1 = 0;
+  double det = sw * sxx - sx * sx;
+  if(sw > 0 && det != 0){
+    p1 = (sw * sxy - sx * sy) / det;
+    p0 = (sy - p1 * sx) / sw;
+  }
+  else if(sw > 0){
+    p0 = sy / sw;
+  }
+
+  // Refine the parameters with Levenberg-Marquardt steps until chi2 stops improving
+  double chi2 = chiSq(p0, p1);
+  double lambda = 1e-3;
+  for(size_t iter = 0; iter < 200; iter++){
+
+    // Gradient and approximate Hessian of chi2/2
+    double h00 = 0, h01 = 0, h11 = 0, g0 = 0, g1 = 0;
+    for(size_t i = 0; i < x.size(); i++){
+      double f = std::exp(p0 + p1 * x[i]);
+      double res = y[i] - f;
+      double j1 = x[i] * f;
+      h00 += f * f;
+      h01 += f * j1;
+      h11 += j1 * j1;
+      g0 += f * res;
+      g1 += j1 * res;
+    }
+
+    // Increase the damping until a step reduces chi2
+    bool improved = false;
+    double change = 0;
+    while(lambda < 1e10){
+      double a00 = h00 * (1 + lambda);
+      double a11 = h11 * (1 + lambda);
+      double a = a00 * a11 - h01 * h01;
+      if(a > 0){
+        double d0 = (g0 * a11 - g1 * h01) / a;
+        double d1 = (a00 * g1 - h01 * g0) / a;
+        double newChi2 = chiSq(p0 + d0, p1 + d1);
+        if(newChi2 < chi2){
+          p0 += d0;
+          p1 += d1;
+          change = chi2 - newChi2;
+          chi2 = newChi2;
+          lambda = std::max(lambda / 10., 1e-12);
+          improved = true;
+          break;
+        }
+      }
+      lambda *= 10.;
+    }
+
+    if(!improved || change <= 1e-12 * chi2) break;
+  }
+
+  return chi2;
+
+}
+
 
 // Determine if the track end looks like it stops
-bool StoppingParticleCosmicIdAlg::StoppingEnd(geo::Point_t end, std::vector<art::Ptr<anab::Calorimetry>> calos){
+bool StoppingParticleCosmicIdAlg::StoppingEnd(geo::Point_t end, const std::vector<art::Ptr<anab::Calorimetry>>& calos){
   
   // Get the chi2 ratio
   double chiSqRatio = StoppingChiSq(end, calos);
@@ -128,7 +220,7 @@ bool StoppingParticleCosmicIdAlg::StoppingEnd(geo::Point_t end, std::vector<art:
 }
 
 // Determine if a track looks like a stopping cosmic
-bool StoppingParticleCosmicIdAlg::StoppingParticleCosmicId(recob::Track track, std::vector<art::Ptr<anab::Calorimetry>> calos){
+bool StoppingParticleCosmicIdAlg::StoppingParticleCosmicId(const recob::Track& track, const std::vector<art::Ptr<anab::Calorimetry>>& calos){
 
   // Check if start and end of track is inside the fiducial volume
   bool startInFiducial = fTpcGeo.InFiducial(track.Vertex(), fMinX, fMinY, fMinZ, fMaxX, fMaxY, fMaxZ);
@@ -149,7 +241,7 @@ bool StoppingParticleCosmicIdAlg::StoppingParticleCosmicId(recob::Track track, s
 }
 
 // Determine if two tracks look like a stopping cosmic if they are merged
-bool StoppingParticleCosmicIdAlg::StoppingParticleCosmicId(recob::Track track, recob::Track track2, std::vector<art::Ptr<anab::Calorimetry>> calos, std::vector<art::Ptr<anab::Calorimetry>> calos2){
+bool StoppingParticleCosmicIdAlg::StoppingParticleCosmicId(const recob::Track& track, const recob::Track& track2, const std::vector<art::Ptr<anab::Calorimetry>>& calos, const std::vector<art::Ptr<anab::Calorimetry>>& calos2){
 
   // Assume both tracks start from the same vertex so take end points as new start/end
   bool startInFiducial = fTpcGeo.InFiducial(track.End(), fMinX, fMinY, fMinZ, fMaxX, fMaxY, fMaxZ);
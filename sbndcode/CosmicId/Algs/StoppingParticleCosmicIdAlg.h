@@ -21,12 +21,10 @@
 #include "lardataobj/RecoBase/Track.h"
 #include "lardataobj/AnalysisBase/Calorimetry.h"
 
-// ROOT
-#include "TGraph.h"
-#include "TF1.h"
-
 // c++
 #include <vector>
+#include <cmath>
+#include <algorithm>
 
 namespace sbnd{
 
@@ -88,16 +86,22 @@ namespace sbnd{
     void reconfigure(const Config& config);
 
     // Calculate the chi2 ratio of pol0 and exp fit to dE/dx vs residual range
-    double StoppingChiSq(geo::Point_t end, std::vector<art::Ptr<anab::Calorimetry>> calos);
+    double StoppingChiSq(geo::Point_t end, const std::vector<art::Ptr<anab::Calorimetry>>& calos);
 
     // Determine if the track end looks like it stops
-    bool StoppingEnd(geo::Point_t end, std::vector<art::Ptr<anab::Calorimetry>> calos);
+    bool StoppingEnd(geo::Point_t end, const std::vector<art::Ptr<anab::Calorimetry>>& calos);
 
     // Determine if a track looks like a stopping cosmic
-    bool StoppingParticleCosmicId(recob::Track track, std::vector<art::Ptr<anab::Calorimetry>> calos);
+    bool StoppingParticleCosmicId(const recob::Track& track, const std::vector<art::Ptr<anab::Calorimetry>>& calos);
 
     // Determine if two tracks look like a stopping cosmic if they are merged
-    bool StoppingParticleCosmicId(recob::Track track, recob::Track track2, std::vector<art::Ptr<anab::Calorimetry>> calos, std::vector<art::Ptr<anab::Calorimetry>> calos2);
+    bool StoppingParticleCosmicId(const recob::Track& track, const recob::Track& track2, const std::vector<art::Ptr<anab::Calorimetry>>& calos, const std::vector<art::Ptr<anab::Calorimetry>>& calos2);
+
+    // Chi2 of least squares pol0 and expo fits, as ROOT's fits to a graph without errors
+    // (checked against the ROOT fits in test/CosmicId)
+    // Neither touches global or member state, so CosmicIdAlg::CosmicIds can run them from several threads
+    static double Pol0ChiSq(const std::vector<double>& y);
+    static double ExpoChiSq(const std::vector<double>& x, const std::vector<double>& y);
 
   private:
 
@@ -10,9 +10,8 @@
 #include "sbndcode/RecoUtils/RecoUtils.h"
 #include "sbnobj/Common/CRT/CRTHit.hh"
 #include "sbndcode/CRT/CRTUtils/CRTT0MatchAlg.h"
-#include "sbndcode/CRT/CRTUtils/CRTBackTracker.h"
 #include "sbndcode/CosmicId/Algs/CrtHitCosmicIdAlg.h"
-#include "sbndcode/Geometry/GeometryWrappers/TPCGeoAlg.h"
+#include "sbndcode/CosmicId/Services/CosmicIdTruthService.h"
 
 // LArSoft includes
 #include "lardata/DetectorInfoServices/DetectorClocksService.h"
@@ -20,8 +19,6 @@
 #include "lardataobj/RecoBase/Hit.h"
 #include "lardataobj/RecoBase/Track.h"
 #include "lardataobj/RecoBase/PFParticle.h"
-#include "larcoreobj/SimpleTypesAndConstants/geo_types.h"
-#include "nusimdata/SimulationBase/MCParticle.h"
 
 // Framework includes
 #include "art/Framework/Core/EDAnalyzer.h"
@@ -30,8 +27,6 @@
 #include "art/Framework/Services/Registry/ServiceHandle.h"
 #include "art_root_io/TFileService.h"
 #include "canvas/Persistency/Common/FindManyP.h"
-#include "larsim/MCCheater/BackTrackerService.h"
-#include "larsim/MCCheater/ParticleInventoryService.h"
 
 // Utility libraries
 #include "fhiclcpp/ParameterSet.h"
@@ -49,6 +44,7 @@
 // C++ includes
 #include <map>
 #include <vector>
+#include <iostream>
 #include <string>
 
 namespace sbnd {
@@ -62,16 +58,6 @@ namespace sbnd {
       using Comment = fhicl::Comment;
  
       // One Atom for each parameter
-      fhicl::Atom<art::InputTag> SimModuleLabel {
-        Name("SimModuleLabel"),
-        Comment("tag of detector simulation data product")
-      };
-
-      fhicl::Atom<art::InputTag> CRTHitLabel {
-        Name("CRTHitLabel"),
-        Comment("tag of CRT hit producer data product")
-      };
-
       fhicl::Atom<art::InputTag> TPCTrackLabel {
         Name("TPCTrackLabel"),
         Comment("tag of tpc track producer data product")
@@ -91,10 +77,6 @@ namespace sbnd {
         Name("CRTT0Alg"),
       };
 
-      fhicl::Table<CRTBackTracker::Config> CrtBackTrack {
-        Name("CrtBackTrack"),
-      };
-
       fhicl::Table<CrtHitCosmicIdAlg::Config> CHTagAlg {
         Name("CHTagAlg"),
       };
@@ -123,17 +105,12 @@ namespace sbnd {
     void GetPFParticleIdMap(const PFParticleHandle &pfParticleHandle, PFParticleIdMap &pfParticleMap);
     
     // fcl file parameters
-    art::InputTag fSimModuleLabel;      ///< name of detsim producer
-    art::InputTag fCRTHitLabel;   ///< name of CRT producer
     art::InputTag fTPCTrackLabel; ///< name of CRT producer
     art::InputTag fPandoraLabel;
     bool          fVerbose;             ///< print information about what's going on
 
     CRTT0MatchAlg t0Alg;
 
-    TPCGeoAlg fTpcGeo;
-
-    CRTBackTracker fCrtBackTrack;
     CrtHitCosmicIdAlg  chTag;
 
     // Histograms
@@ -152,13 +129,10 @@ namespace sbnd {
   // Constructor
   CRTHitCosmicIdAna::CRTHitCosmicIdAna(Parameters const& config)
     : EDAnalyzer(config)
-    , fSimModuleLabel      (config().SimModuleLabel())
-    , fCRTHitLabel         (config().CRTHitLabel())
     , fTPCTrackLabel       (config().TPCTrackLabel())
     , fPandoraLabel        (config().PandoraLabel())
     , fVerbose             (config().Verbose())
     , t0Alg                (config().CRTT0Alg())
-    , fCrtBackTrack        (config().CrtBackTrack())
     , chTag                (config().CHTagAlg())
   {
 
@@ -200,27 +174,16 @@ namespace sbnd {
     //                                          GETTING PRODUCTS
     //----------------------------------------------------------------------------------------------------------
 
-    // Get g4 particles
-    art::ServiceHandle<cheat::ParticleInventoryService> pi_serv;
-    auto particleHandle = event.getValidHandle<std::vector<simb::MCParticle>>(fSimModuleLabel);
-
-    // Get CRT hits from the event
-    art::Handle< std::vector<sbn::crt::CRTHit>> crtHitHandle;
-    std::vector<art::Ptr<sbn::crt::CRTHit> > crtHitList;
-    if (event.getByLabel(fCRTHitLabel, crtHitHandle))
-      art::fill_ptr_vector(crtHitList, crtHitHandle);
+    // Get the truth summary shared by the cosmic ID analysers, with the CRT hits and their true IDs
+    art::ServiceHandle<CosmicIdTruthService> truthServ;
+    const CosmicIdTruthSummary& truth = truthServ->Summary(event);
 
-    fCrtBackTrack.Initialize(event);
-    std::vector<sbn::crt::CRTHit> crtHits;
+    const std::vector<sbn::crt::CRTHit>& crtHits = truth.crtHits;
     std::map<int, int> numHitMap;
-    int hit_i = 0;
-    for(auto const& hit : (crtHitList)){
-      crtHits.push_back(*hit);
-      int hitTrueID = fCrtBackTrack.TrueIdFromHitId(event, hit_i);
-      hit_i++;
-      double hitTime = hit->ts1_ns * 1e-3;
+    for(size_t hit_i = 0; hit_i < crtHits.size(); hit_i++){
+      double hitTime = crtHits[hit_i].ts1_ns * 1e-3;
       if(hitTime > 0 && hitTime < 4) continue;
-      numHitMap[hitTrueID]++;
+      numHitMap[truth.crtHitTrueIds[hit_i]]++;
     }
 
     // Get reconstructed tracks from the event
@@ -239,51 +202,6 @@ namespace sbnd {
     // Get PFParticle to track associations
     art::FindManyP< recob::Track > pfPartToTrackAssoc(pfParticleHandle, event, fTPCTrackLabel);
 
-    //----------------------------------------------------------------------------------------------------------
-    //                                          TRUTH MATCHING
-    //----------------------------------------------------------------------------------------------------------
-    
-    std::map<int, simb::MCParticle> particles;
-    std::vector<int> nuParticleIds;
-    std::vector<int> lepParticleIds;
-    std::vector<int> dirtParticleIds;
-    std::vector<int> crParticleIds;
-    // Loop over the true particles
-    for (auto const& particle: (*particleHandle)){
-      
-      // Make map with ID
-      int partID = particle.TrackId();
-      particles[partID] = particle;
-
-      // Get MCTruth
-      art::Ptr<simb::MCTruth> truth = pi_serv->TrackIdToMCTruth_P(partID);
-      int pdg = std::abs(particle.PdgCode());
-
-      // If origin is a neutrino
-      if(truth->Origin() == simb::kBeamNeutrino){
-        geo::Point_t vtx;
-        vtx.SetX(truth->GetNeutrino().Nu().Vx()); vtx.SetY(truth->GetNeutrino().Nu().Vy()); vtx.SetZ(truth->GetNeutrino().Nu().Vz());
-        // If neutrino vertex is not inside the TPC then call it a dirt particle
-        if(!fTpcGeo.InFiducial(vtx, 0, 0)){ 
-          dirtParticleIds.push_back(partID);
-        }
-        // If it's a primary muon
-        else if(pdg==13 && particle.Mother()==0){ 
-          lepParticleIds.push_back(partID);
-        }
-        // Other nu particles
-        else{
-          nuParticleIds.push_back(partID);
-        }
-      }
-
-      // If origin is a cosmic ray
-      else if(truth->Origin() == simb::kCosmicRay){
-        crParticleIds.push_back(partID);
-      }
-      
-    }
-
     //----------------------------------------------------------------------------------------------------------
     //                                DISTANCE OF CLOSEST APPROACH ANALYSIS
     //----------------------------------------------------------------------------------------------------------
@@ -295,18 +213,19 @@ namespace sbnd {
       // Get the associated hits
       std::vector<art::Ptr<recob::Hit>> hits = findManyHits.at(tpcTrack.ID());
       int trackTrueID = RecoUtils::TrueParticleIDFromTotalRecoHits(clockData, hits, false);
+      CosmicIdTruthType trueType = truth.Type(trackTrueID);
       std::string type = "none";
-      if(std::find(lepParticleIds.begin(), lepParticleIds.end(), trackTrueID) != lepParticleIds.end()) type = "NuMuTrack";
-      if(std::find(nuParticleIds.begin(), nuParticleIds.end(), trackTrueID) != nuParticleIds.end()) type = "NuTrack";
-      if(std::find(crParticleIds.begin(), crParticleIds.end(), trackTrueID) != crParticleIds.end()) type = "CrTrack";
-      if(std::find(dirtParticleIds.begin(), dirtParticleIds.end(), trackTrueID) != dirtParticleIds.end()) type = "DirtTrack";
+      if(trueType == CosmicIdTruthType::kNuMu) type = "NuMuTrack";
+      if(trueType == CosmicIdTruthType::kNu) type = "NuTrack";
+      if(trueType == CosmicIdTruthType::kCr) type = "CrTrack";
+      if(trueType == CosmicIdTruthType::kDirt) type = "DirtTrack";
       if(type == "none") continue;
 
       // Calculate t0 from CRT Hit matching
       std::pair<sbn::crt::CRTHit, double> closest = t0Alg.ClosestCRTHit(detProp, tpcTrack, crtHits, event);
 
       if(closest.second != -99999){
-        int hitTrueID = fCrtBackTrack.TrueIdFromTotalEnergy(event, closest.first);
+        int hitTrueID = truth.CrtHitTrueId(closest.first);
         if(hitTrueID == trackTrueID && hitTrueID != -99999){
           hMatchDCA[type]->Fill(closest.second);
         }
@@ -373,16 +292,17 @@ namespace sbnd {
         // Truth match muon tracks and pfps
         std::vector<art::Ptr<recob::Hit>> hits = findManyHits.at(tpcTrack.ID());
         int trueId = RecoUtils::TrueParticleIDFromTotalRecoHits(clockData, hits, false);
-        if(std::find(lepParticleIds.begin(), lepParticleIds.end(), trueId) != lepParticleIds.end()){ 
+        CosmicIdTruthType trueType = truth.Type(trueId);
+        if(trueType == CosmicIdTruthType::kNuMu){ 
           type = "NuMuPfp";
         }
-        else if(std::find(nuParticleIds.begin(), nuParticleIds.end(), trueId) != nuParticleIds.end()){ 
+        else if(trueType == CosmicIdTruthType::kNu){ 
           if(type != "NuMuPfp") type = "NuPfp";
         }
-        else if(std::find(dirtParticleIds.begin(), dirtParticleIds.end(), trueId) != dirtParticleIds.end()){ 
+        else if(trueType == CosmicIdTruthType::kDirt){ 
           if(type != "NuMuPfp" && type != "NuPfp") type = "DirtPfp";
         }
-        else if(std::find(crParticleIds.begin(), crParticleIds.end(), trueId) != crParticleIds.end()){
+        else if(trueType == CosmicIdTruthType::kCr){
           if(type != "NuMuPfp" && type != "NuPfp" && type != "DirtPfp") type = "CrPfp";
         }
       }
@@ -407,7 +327,7 @@ namespace sbnd {
       std::pair<sbn::crt::CRTHit, double> closest = t0Alg.ClosestCRTHit(detProp, tpcTrack, crtHits, event);
 
       if(closest.second != -99999){
-        int hitTrueID = fCrtBackTrack.TrueIdFromTotalEnergy(event, closest.first);
+        int hitTrueID = truth.CrtHitTrueId(closest.first);
         if(hitTrueID == trackTrueID && hitTrueID != -99999){
           hMatchDCA[type]->Fill(closest.second);
         }
@@ -10,17 +10,14 @@
 #include "sbndcode/RecoUtils/RecoUtils.h"
 #include "sbnobj/Common/CRT/CRTTrack.hh"
 #include "sbndcode/CRT/CRTUtils/CRTTrackMatchAlg.h"
-#include "sbndcode/CRT/CRTUtils/CRTBackTracker.h"
 #include "sbndcode/CosmicId/Algs/CrtTrackCosmicIdAlg.h"
-#include "sbndcode/Geometry/GeometryWrappers/TPCGeoAlg.h"
+#include "sbndcode/CosmicId/Services/CosmicIdTruthService.h"
 
 // LArSoft includes
 #include "lardata/DetectorInfoServices/DetectorClocksService.h"
 #include "lardataobj/RecoBase/Hit.h"
 #include "lardataobj/RecoBase/Track.h"
 #include "lardataobj/RecoBase/PFParticle.h"
-#include "larcoreobj/SimpleTypesAndConstants/geo_types.h"
-#include "nusimdata/SimulationBase/MCParticle.h"
 
 // Framework includes
 #include "art/Framework/Core/EDAnalyzer.h"
@@ -29,8 +26,6 @@
 #include "art/Framework/Services/Registry/ServiceHandle.h"
 #include "art_root_io/TFileService.h"
 #include "canvas/Persistency/Common/FindManyP.h"
-#include "larsim/MCCheater/BackTrackerService.h"
-#include "larsim/MCCheater/ParticleInventoryService.h"
 
 // Utility libraries
 #include "fhiclcpp/ParameterSet.h"
@@ -48,6 +43,7 @@
 // C++ includes
 #include <map>
 #include <vector>
+#include <iostream>
 #include <string>
 
 namespace sbnd {
@@ -61,16 +57,6 @@ namespace sbnd {
       using Comment = fhicl::Comment;
  
       // One Atom for each parameter
-      fhicl::Atom<art::InputTag> SimModuleLabel {
-        Name("SimModuleLabel"),
-        Comment("tag of detector simulation data product")
-      };
-
-      fhicl::Atom<art::InputTag> CRTTrackLabel {
-        Name("CRTTrackLabel"),
-        Comment("tag of CRT track producer data product")
-      };
-
       fhicl::Atom<art::InputTag> TPCTrackLabel {
         Name("TPCTrackLabel"),
         Comment("tag of tpc track producer data product")
@@ -90,10 +76,6 @@ namespace sbnd {
         Name("TrackMatchAlg"),
       };
 
-      fhicl::Table<CRTBackTracker::Config> CrtBackTrack {
-        Name("CrtBackTrack"),
-      };
-
       fhicl::Table<CrtTrackCosmicIdAlg::Config> CTTagAlg {
         Name("CTTagAlg"),
       };
@@ -122,17 +104,12 @@ namespace sbnd {
     void GetPFParticleIdMap(const PFParticleHandle &pfParticleHandle, PFParticleIdMap &pfParticleMap);
     
     // fcl file parameters
-    art::InputTag fSimModuleLabel;      ///< name of detsim producer
-    art::InputTag fCRTTrackLabel;   ///< name of CRT producer
     art::InputTag fTPCTrackLabel; ///< name of CRT producer
     art::InputTag fPandoraLabel;
     bool          fVerbose;             ///< print information about what's going on
 
     CRTTrackMatchAlg trackAlg;
 
-    TPCGeoAlg fTpcGeo;
-
-    CRTBackTracker fCrtBackTrack;
     CrtTrackCosmicIdAlg  ctTag;
 
     // Histograms
@@ -153,13 +130,10 @@ namespace sbnd {
   // Constructor
   CRTTrackCosmicIdAna::CRTTrackCosmicIdAna(Parameters const& config)
     : EDAnalyzer(config)
-    , fSimModuleLabel      (config().SimModuleLabel())
-    , fCRTTrackLabel       (config().CRTTrackLabel())
     , fTPCTrackLabel       (config().TPCTrackLabel())
     , fPandoraLabel        (config().PandoraLabel())
     , fVerbose             (config().Verbose())
     , trackAlg             (config().TrackMatchAlg())
-    , fCrtBackTrack        (config().CrtBackTrack())
     , ctTag                (config().CTTagAlg())
   {
 
@@ -203,27 +177,16 @@ namespace sbnd {
     //                                          GETTING PRODUCTS
     //----------------------------------------------------------------------------------------------------------
 
-    // Get g4 particles
-    art::ServiceHandle<cheat::ParticleInventoryService> pi_serv;
-    auto particleHandle = event.getValidHandle<std::vector<simb::MCParticle>>(fSimModuleLabel);
-
-    // Get CRT hits from the event
-    art::Handle< std::vector<sbn::crt::CRTTrack>> crtTrackHandle;
-    std::vector<art::Ptr<sbn::crt::CRTTrack> > crtTrackList;
-    if (event.getByLabel(fCRTTrackLabel, crtTrackHandle))
-      art::fill_ptr_vector(crtTrackList, crtTrackHandle);
+    // Get the truth summary shared by the cosmic ID analysers, with the CRT tracks and their true IDs
+    art::ServiceHandle<CosmicIdTruthService> truthServ;
+    const CosmicIdTruthSummary& truth = truthServ->Summary(event);
 
-    fCrtBackTrack.Initialize(event);
-    std::vector<sbn::crt::CRTTrack> crtTracks;
+    const std::vector<sbn::crt::CRTTrack>& crtTracks = truth.crtTracks;
     std::map<int, int> numCrtTrackMap;
-    int track_i = 0;
-    for(auto const& track : (crtTrackList)){
-      crtTracks.push_back(*track);
-      int trackTrueID = fCrtBackTrack.TrueIdFromTrackId(event, track_i);
-      track_i++;
-      double trackTime = track->ts1_ns * 1e-3;
+    for(size_t track_i = 0; track_i < crtTracks.size(); track_i++){
+      double trackTime = crtTracks[track_i].ts1_ns * 1e-3;
       if(trackTime > 0 && trackTime < 4) continue;
-      numCrtTrackMap[trackTrueID]++;
+      numCrtTrackMap[truth.crtTrackTrueIds[track_i]]++;
     }
 
     // Get reconstructed tracks from the event
@@ -242,51 +205,6 @@ namespace sbnd {
     // Get PFParticle to track associations
     art::FindManyP< recob::Track > pfPartToTrackAssoc(pfParticleHandle, event, fTPCTrackLabel);
 
-    //----------------------------------------------------------------------------------------------------------
-    //                                          TRUTH MATCHING
-    //----------------------------------------------------------------------------------------------------------
-    
-    std::map<int, simb::MCParticle> particles;
-    std::vector<int> nuParticleIds;
-    std::vector<int> lepParticleIds;
-    std::vector<int> dirtParticleIds;
-    std::vector<int> crParticleIds;
-    // Loop over the true particles
-    for (auto const& particle: (*particleHandle)){
-      
-      // Make map with ID
-      int partID = particle.TrackId();
-      particles[partID] = particle;
-
-      // Get MCTruth
-      art::Ptr<simb::MCTruth> truth = pi_serv->TrackIdToMCTruth_P(partID);
-      int pdg = std::abs(particle.PdgCode());
-
-      // If origin is a neutrino
-      if(truth->Origin() == simb::kBeamNeutrino){
-        geo::Point_t vtx;
-        vtx.SetX(truth->GetNeutrino().Nu().Vx()); vtx.SetY(truth->GetNeutrino().Nu().Vy()); vtx.SetZ(truth->GetNeutrino().Nu().Vz());
-        // If neutrino vertex is not inside the TPC then call it a dirt particle
-        if(!fTpcGeo.InFiducial(vtx, 0, 0)){ 
-          dirtParticleIds.push_back(partID);
-        }
-        // If it's a primary muon
-        else if(pdg==13 && particle.Mother()==0){ 
-          lepParticleIds.push_back(partID);
-        }
-        // Other nu particles
-        else{
-          nuParticleIds.push_back(partID);
-        }
-      }
-
-      // If origin is a cosmic ray
-      else if(truth->Origin() == simb::kCosmicRay){
-        crParticleIds.push_back(partID);
-      }
-      
-    }
-
     //----------------------------------------------------------------------------------------------------------
     //                                DISTANCE OF CLOSEST APPROACH ANALYSIS
     //----------------------------------------------------------------------------------------------------------
@@ -298,11 +216,12 @@ namespace sbnd {
       // Get the associated hits
       std::vector<art::Ptr<recob::Hit>> hits = findManyHits.at(tpcTrack.ID());
       int trackTrueID = RecoUtils::TrueParticleIDFromTotalRecoHits(clockData, hits, false);
+      CosmicIdTruthType trueType = truth.Type(trackTrueID);
       std::string type = "none";
-      if(std::find(lepParticleIds.begin(), lepParticleIds.end(), trackTrueID) != lepParticleIds.end()) type = "NuMuTrack";
-      if(std::find(nuParticleIds.begin(), nuParticleIds.end(), trackTrueID) != nuParticleIds.end()) type = "NuTrack";
-      if(std::find(crParticleIds.begin(), crParticleIds.end(), trackTrueID) != crParticleIds.end()) type = "CrTrack";
-      if(std::find(dirtParticleIds.begin(), dirtParticleIds.end(), trackTrueID) != dirtParticleIds.end()) type = "DirtTrack";
+      if(trueType == CosmicIdTruthType::kNuMu) type = "NuMuTrack";
+      if(trueType == CosmicIdTruthType::kNu) type = "NuTrack";
+      if(trueType == CosmicIdTruthType::kCr) type = "CrTrack";
+      if(trueType == CosmicIdTruthType::kDirt) type = "DirtTrack";
       if(type == "none") continue;
 
       if(numCrtTrackMap.find(trackTrueID) != numCrtTrackMap.end()){
@@ -317,7 +236,7 @@ namespace sbnd {
       std::pair<sbn::crt::CRTTrack, double> closestDCA = trackAlg.ClosestCRTTrackByDCA(detProp, tpcTrack, crtTracks, event);
 
       if(closestAngle.second != -99999){
-        int crtTrackTrueID = fCrtBackTrack.TrueIdFromTotalEnergy(event, closestAngle.first);
+        int crtTrackTrueID = truth.CrtTrackTrueId(closestAngle.first);
         if(crtTrackTrueID == trackTrueID && crtTrackTrueID != -99999){
           hMatchAngle[type]->Fill(closestAngle.second);
         }
@@ -327,7 +246,7 @@ namespace sbnd {
       }
 
       if(closestDCA.second != -99999){
-        int crtTrackTrueID = fCrtBackTrack.TrueIdFromTotalEnergy(event, closestDCA.first);
+        int crtTrackTrueID = truth.CrtTrackTrueId(closestDCA.first);
         if(crtTrackTrueID == trackTrueID && crtTrackTrueID != -99999){
           hMatchDCA[type]->Fill(closestDCA.second);
         }
@@ -389,16 +308,17 @@ namespace sbnd {
         // Truth match muon tracks and pfps
         std::vector<art::Ptr<recob::Hit>> hits = findManyHits.at(tpcTrack.ID());
         int trueId = RecoUtils::TrueParticleIDFromTotalRecoHits(clockData, hits, false);
-        if(std::find(lepParticleIds.begin(), lepParticleIds.end(), trueId) != lepParticleIds.end()){ 
+        CosmicIdTruthType trueType = truth.Type(trueId);
+        if(trueType == CosmicIdTruthType::kNuMu){ 
           type = "NuMuPfp";
         }
-        else if(std::find(nuParticleIds.begin(), nuParticleIds.end(), trueId) != nuParticleIds.end()){ 
+        else if(trueType == CosmicIdTruthType::kNu){ 
           if(type != "NuMuPfp") type = "NuPfp";
         }
-        else if(std::find(dirtParticleIds.begin(), dirtParticleIds.end(), trueId) != dirtParticleIds.end()){ 
+        else if(trueType == CosmicIdTruthType::kDirt){ 
           if(type != "NuMuPfp" && type != "NuPfp") type = "DirtPfp";
         }
-        else if(std::find(crParticleIds.begin(), crParticleIds.end(), trueId) != crParticleIds.end()){
+        else if(trueType == CosmicIdTruthType::kCr){
           if(type != "NuMuPfp" && type != "NuPfp" && type != "DirtPfp") type = "CrPfp";
         }
       }
@@ -423,7 +343,7 @@ namespace sbnd {
       std::pair<sbn::crt::CRTTrack, double> closestDCA = trackAlg.ClosestCRTTrackByDCA(detProp, tpcTrack, crtTracks, event);
 
       if(closestAngle.second != -99999){
-        int crtTrackTrueID = fCrtBackTrack.TrueIdFromTotalEnergy(event, closestAngle.first);
+        int crtTrackTrueID = truth.CrtTrackTrueId(closestAngle.first);
         if(crtTrackTrueID == trackTrueID && crtTrackTrueID != -99999){
           hMatchAngle[type]->Fill(closestAngle.second);
         }
@@ -433,7 +353,7 @@ namespace sbnd {
       }
 
       if(closestDCA.second != -99999){
-        int crtTrackTrueID = fCrtBackTrack.TrueIdFromTotalEnergy(event, closestDCA.first);
+        int crtTrackTrueID = truth.CrtTrackTrueId(closestDCA.first);
         if(crtTrackTrueID == trackTrueID && crtTrackTrueID != -99999){
           hMatchDCA[type]->Fill(closestDCA.second);
         }
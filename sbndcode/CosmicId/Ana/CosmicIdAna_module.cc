@@ -10,6 +10,7 @@
 #include "sbndcode/RecoUtils/RecoUtils.h"
 #include "sbndcode/CosmicId/Utils/CosmicIdUtils.h"
 #include "sbndcode/CosmicId/Algs/CosmicIdAlg.h"
+#include "sbndcode/CosmicId/Services/CosmicIdTruthService.h"
 #include "sbndcode/Geometry/GeometryWrappers/TPCGeoAlg.h"
 
 // LArSoft includes
@@ -20,9 +21,6 @@
 #include "lardataobj/AnalysisBase/Calorimetry.h"
 #include "larcoreobj/SimpleTypesAndConstants/geo_types.h"
 #include "nusimdata/SimulationBase/MCParticle.h"
-#include "nusimdata/SimulationBase/MCTruth.h"
-#include "larsim/MCCheater/BackTrackerService.h"
-#include "larsim/MCCheater/ParticleInventoryService.h"
 #include "lardataobj/RecoBase/MCSFitResult.h"
 #include "larreco/RecoAlg/TrajectoryMCSFitter.h"
 #include "larreco/RecoAlg/TrackMomentumCalculator.h"
@@ -48,6 +46,7 @@
 // C++ includes
 #include <map>
 #include <vector>
+#include <iostream>
 #include <string>
 
 namespace sbnd {
@@ -77,11 +76,6 @@ namespace sbnd {
       using Comment = fhicl::Comment;
  
       // One Atom for each parameter
-      fhicl::Atom<art::InputTag> SimModuleLabel {
-        Name("SimModuleLabel"),
-        Comment("tag of detector simulation data product")
-      };
-
       fhicl::Atom<art::InputTag> TpcTrackModuleLabel {
         Name("TpcTrackModuleLabel"),
         Comment("tag of TPC track producer data product")
@@ -132,7 +126,7 @@ namespace sbnd {
   private:
 
     // fcl file parameters
-    art::InputTag fSimModuleLabel;      ///< name of detsim producer
+    art::InputTag fSimModuleLabel;      ///< name of detsim producer, from CosmicIdTruthService
     art::InputTag fTpcTrackModuleLabel; ///< name of TPC track producer
     art::InputTag fPandoraLabel;
     bool          fVerbose;             ///< print information about what's going on
@@ -175,7 +169,7 @@ namespace sbnd {
   // Constructor
   CosmicIdAna::CosmicIdAna(Parameters const& config)
     : EDAnalyzer(config)
-    , fSimModuleLabel       (config().SimModuleLabel())
+    , fSimModuleLabel       (art::ServiceHandle<CosmicIdTruthService>()->SimModuleLabel())
     , fTpcTrackModuleLabel  (config().TpcTrackModuleLabel())
     , fPandoraLabel         (config().PandoraLabel())
     , fVerbose              (config().Verbose())
@@ -241,8 +235,9 @@ namespace sbnd {
     //                                          GETTING PRODUCTS
     //----------------------------------------------------------------------------------------------------------
 
-    // Get truth info and matching
-    art::ServiceHandle<cheat::ParticleInventoryService> pi_serv;
+    // Get the truth summary shared by the cosmic ID analysers
+    art::ServiceHandle<CosmicIdTruthService> truthServ;
+    const CosmicIdTruthSummary& truth = truthServ->Summary(event);
     // Retrieve all the truth info in the events
     auto particleHandle = event.getValidHandle<std::vector<simb::MCParticle>>(fSimModuleLabel);
 
@@ -266,46 +261,11 @@ namespace sbnd {
     //                                          TRUTH MATCHING
     //----------------------------------------------------------------------------------------------------------
 
-    // Record all true particles and sort by type
-    std::map<int, simb::MCParticle> particles;
-    std::vector<simb::MCParticle> parts;
-    std::vector<int> nuParticleIds;
-    std::vector<int> lepParticleIds;
-    std::vector<int> dirtParticleIds;
-    std::vector<int> crParticleIds;
-
-    // Loop over all true particles
-    for (auto const& particle: (*particleHandle)){
-      // Store particle
-      int partId = particle.TrackId();
-      particles[partId] = particle;
-      parts.push_back(particle);
-      // Get MCTruth
-      art::Ptr<simb::MCTruth> truth = pi_serv->TrackIdToMCTruth_P(partId);
-      int pdg = std::abs(particle.PdgCode());
-
-      // If origin is a neutrino
-      if(truth->Origin() == simb::kBeamNeutrino){
-        geo::Point_t vtx;
-        vtx.SetX(truth->GetNeutrino().Nu().Vx()); vtx.SetY(truth->GetNeutrino().Nu().Vy()); vtx.SetZ(truth->GetNeutrino().Nu().Vz());
-        // If neutrino vertex is not inside the TPC then call it a dirt particle
-        if(!fTpcGeo.InFiducial(vtx, 0.)){ 
-          dirtParticleIds.push_back(partId);
-        }
-        // If it's a primary muon
-        else if(pdg==13 && particle.Mother()==0){ 
-          lepParticleIds.push_back(partId);
-        }
-        // Other nu particles
-        else{
-          nuParticleIds.push_back(partId);
-        }
-        hBeamTime->Fill(particle.T() * 1e-3);
-      }
-
-      // If origin is a cosmic ray
-      else if(truth->Origin() == simb::kCosmicRay){
-        crParticleIds.push_back(partId);
+    // Record the true times of the neutrino particles
+    for (auto const& particle : truth.particles){
+      if(particle.type == CosmicIdTruthType::kNuMu || particle.type == CosmicIdTruthType::kNu
+         || particle.type == CosmicIdTruthType::kDirt){
+        hBeamTime->Fill(particle.time * 1e-3);
       }
     }
 
@@ -314,7 +274,7 @@ namespace sbnd {
     //----------------------------------------------------------------------------------------------------------
 
     // Create fake flashes in each tpc
-    std::pair<std::vector<double>, std::vector<double>> fakeFlashes = CosmicIdUtils::FakeTpcFlashes(parts);
+    std::pair<std::vector<double>, std::vector<double>> fakeFlashes = CosmicIdUtils::FakeTpcFlashes(*particleHandle);
     std::vector<double> fakeTpc0Flashes = fakeFlashes.first;
     std::vector<double> fakeTpc1Flashes = fakeFlashes.second;
     bool tpc0BeamFlash = CosmicIdUtils::BeamFlash(fakeTpc0Flashes, fBeamTimeMin, fBeamTimeMax);
@@ -330,17 +290,38 @@ namespace sbnd {
     auto const clockData = art::ServiceHandle<detinfo::DetectorClocksService const>()->DataFor(event);
     auto const detProp = art::ServiceHandle<detinfo::DetectorPropertiesService const>()->DataFor(event, clockData);
 
-    //Loop over the pfparticle map
-    for (PFParticleIdMap::const_iterator it = pfParticleMap.begin(); it != pfParticleMap.end(); ++it){
+    // Read the cosmic ID inputs once per event, for every cut as they are switched on one at a time
+    CosmicIdEventContext cosIdContext = cosIdAlg.EventContext(detProp, event, fakeTpc0Flashes, fakeTpc1Flashes, true);
 
+    // Get the primary neutrino PFParticles
+    std::vector<art::Ptr<recob::PFParticle>> nuParticlePtrs;
+    for (PFParticleIdMap::const_iterator it = pfParticleMap.begin(); it != pfParticleMap.end(); ++it){
       const art::Ptr<recob::PFParticle> pParticle(it->second);
       // Only look for primary particles
       if (!pParticle->IsPrimary()) continue;
       // Check if this particle is identified as the neutrino
       const int pdg(pParticle->PdgCode());
       const bool isNeutrino(std::abs(pdg) == pandora::NU_E || std::abs(pdg) == pandora::NU_MU || std::abs(pdg) == pandora::NU_TAU);
-      //Find neutrino pfparticle
-      if(!isNeutrino) continue;
+      if(isNeutrino) nuParticlePtrs.push_back(pParticle);
+    }
+    std::vector<recob::PFParticle> nuParticles;
+    for(auto const& pParticle : nuParticlePtrs) nuParticles.push_back(*pParticle);
+
+    // Switch on each cut individually and run it over all the tracks and neutrino PFParticles at once,
+    // then return to the cuts specified in the fhicl file
+    std::vector<std::vector<bool>> trackCosmicIds(nCuts);
+    std::vector<std::vector<bool>> pfpCosmicIds(nCuts);
+    for(size_t j = 1; j <= 10; j++){
+      if(j == 10) cosIdAlg.ResetCuts();
+      else cosIdAlg.SetCuts(j == 1, j == 2, j == 3, j == 4, j == 5, j == 6, j == 7, j == 8, j == 9);
+      trackCosmicIds[j] = cosIdAlg.CosmicIds(cosIdContext);
+      pfpCosmicIds[j] = cosIdAlg.CosmicIds(cosIdContext, nuParticles, pfParticleMap);
+    }
+
+    //Loop over the neutrino pfparticles
+    for (size_t pfp_i = 0; pfp_i < nuParticlePtrs.size(); pfp_i++){
+
+      const art::Ptr<recob::PFParticle> pParticle = nuParticlePtrs[pfp_i];
 
       int pfpType = 3;
       std::vector<recob::Track> nuTracks;
@@ -355,85 +336,47 @@ namespace sbnd {
 
         // Get the first associated track
         recob::Track tpcTrack = *associatedTracks.front();
+        size_t const track_i = associatedTracks.front().key();
         nuTracks.push_back(tpcTrack);
 
         // Truth match muon tracks and pfps
         std::vector<art::Ptr<recob::Hit>> hits = findManyHits.at(tpcTrack.ID());
         int trueId = RecoUtils::TrueParticleIDFromTotalRecoHits(clockData, hits, false);
         int trackType = 3;
-        if(std::find(lepParticleIds.begin(), lepParticleIds.end(), trueId) != lepParticleIds.end()){ 
+        CosmicIdTruthType trueType = truth.Type(trueId);
+        if(trueType == CosmicIdTruthType::kNuMu){ 
           trackType = 0;
           pfpType = 0;
         }
-        else if(std::find(nuParticleIds.begin(), nuParticleIds.end(), trueId) != nuParticleIds.end()){ 
+        else if(trueType == CosmicIdTruthType::kNu){ 
           if(pfpType != 0) pfpType = 4;
         }
-        else if(std::find(dirtParticleIds.begin(), dirtParticleIds.end(), trueId) != dirtParticleIds.end()){ 
+        else if(trueType == CosmicIdTruthType::kDirt){ 
           trackType = 1;
           if(pfpType != 0 && pfpType != 4) pfpType = 1;
         }
-        else if(std::find(crParticleIds.begin(), crParticleIds.end(), trueId) != crParticleIds.end()){
+        else if(trueType == CosmicIdTruthType::kCr){
           trackType = 2;
           if(pfpType != 0 && pfpType != 4 && pfpType != 1) pfpType = 2;
         }
         
         // Fill cut histograms per track
-        if(particles.find(trueId) != particles.end()){
+        const CosmicIdTrueParticle* trueParticle = truth.Particle(trueId);
+        if(trueParticle){
           // Only look at muons
-          if(std::abs(particles[trueId].PdgCode()) == 13){
+          if(std::abs(trueParticle->pdg) == 13){
             // Calculate the true variables
-            std::pair<TVector3, TVector3> se = fTpcGeo.CrossingPoints(particles[trueId]);
-            double momentum = particles[trueId].P();
-            double length = fTpcGeo.TpcLength(particles[trueId]);
+            std::pair<TVector3, TVector3> se = std::make_pair(trueParticle->tpcStart, trueParticle->tpcEnd);
+            double momentum = trueParticle->momentum;
+            double length = trueParticle->tpcLength;
             double theta = (se.second-se.first).Theta();
             double phi = (se.second-se.first).Phi();
-            // Switch on each cut individually
+            // Plot the tracks ID'd by each cut
             for(size_t j = 0; j < nCuts; j++){
               bool plot = false;
               if(j == 0) plot = true;
-              if(j == 1){
-                cosIdAlg.SetCuts(true, false, false, false, false, false, false, false, false);
-                if(cosIdAlg.CosmicId(tpcTrack, event, fakeTpc0Flashes, fakeTpc1Flashes)) plot = true;
-              }
-              if(j == 2){
-                cosIdAlg.SetCuts(false, true, false, false, false, false, false, false, false);
-                if(cosIdAlg.CosmicId(tpcTrack, event, fakeTpc0Flashes, fakeTpc1Flashes)) plot = true;
-              }
-              if(j == 3){
-                cosIdAlg.SetCuts(false, false, true, false, false, false, false, false, false);
-                if(cosIdAlg.CosmicId(tpcTrack, event, fakeTpc0Flashes, fakeTpc1Flashes)) plot = true;
-              }
-              if(j == 4){
-
-                cosIdAlg.SetCuts(false, false, false, true, false, false, false, false, false);
-                if(cosIdAlg.CosmicId(tpcTrack, event, fakeTpc0Flashes, fakeTpc1Flashes)) plot = true;
-              }
-              if(j == 5){
-                cosIdAlg.SetCuts(false, false, false, false, true, false, false, false, false);
-                if(cosIdAlg.CosmicId(tpcTrack, event, fakeTpc0Flashes, fakeTpc1Flashes)) plot = true;
-              }
-              if(j == 6){
-                cosIdAlg.SetCuts(false, false, false, false, false, true, false, false, false);
-                if(cosIdAlg.CosmicId(tpcTrack, event, fakeTpc0Flashes, fakeTpc1Flashes)) plot = true;
-              }
-              if(j == 7){
-                cosIdAlg.SetCuts(false, false, false, false, false, false, true, false, false);
-                if(cosIdAlg.CosmicId(tpcTrack, event, fakeTpc0Flashes, fakeTpc1Flashes)) plot = true;
-              }
-              if(j == 8){
-                cosIdAlg.SetCuts(false, false, false, false, false, false, false, true, false);
-                if(cosIdAlg.CosmicId(tpcTrack, event, fakeTpc0Flashes, fakeTpc1Flashes)) plot = true;
-              }
-              if(j == 9){
-                cosIdAlg.SetCuts(false, false, false, false, false, false, false, false, true);
-                if(cosIdAlg.CosmicId(tpcTrack, event, fakeTpc0Flashes, fakeTpc1Flashes)) plot = true;
-              }
-              // Return to the cuts specified in the fhicl file
-              if(j == 10){
-                cosIdAlg.ResetCuts();
-                if(cosIdAlg.CosmicId(tpcTrack, event, fakeTpc0Flashes, fakeTpc1Flashes)) plot = true;
-              }
-              if(j == 11 && !cosIdAlg.CosmicId(tpcTrack, event, fakeTpc0Flashes, fakeTpc1Flashes)) plot = true;
+              if(j >= 1 && j <= 10 && trackCosmicIds[j][track_i]) plot = true;
+              if(j == 11 && !trackCosmicIds[10][track_i]) plot = true;
               if(!plot) continue;
               // Fill histograms if track ID'd as cosmic
               hTrueMom[trackType][j]->Fill(momentum);
@@ -467,72 +410,12 @@ namespace sbnd {
       else{
         recoMuMomentum = fRangeFitter.GetTrackMomentum(length, 13);
       }
-      // Turn on each cut individually
+      // Plot the PFParticles ID'd by each cut
       for(size_t j = 0; j < nCuts; j++){
         bool plot = false;
         if(j == 0) plot = true;
-        if(j == 1){
-          cosIdAlg.SetCuts(true, false, false, false, false, false, false, false, false);
-          if(cosIdAlg.CosmicId(detProp, *pParticle, pfParticleMap, event, fakeTpc0Flashes, fakeTpc1Flashes)){
-            plot = true;
-          }
-        }
-        if(j == 2){
-          cosIdAlg.SetCuts(false, true, false, false, false, false, false, false, false);
-          if(cosIdAlg.CosmicId(detProp, *pParticle, pfParticleMap, event, fakeTpc0Flashes, fakeTpc1Flashes)){
-            plot = true;
-          }
-        }
-        if(j == 3){
-          cosIdAlg.SetCuts(false, false, true, false, false, false, false, false, false);
-          if(cosIdAlg.CosmicId(detProp, *pParticle, pfParticleMap, event, fakeTpc0Flashes, fakeTpc1Flashes)){
-            plot = true;
-          }
-        }
-        if(j == 4){
-          cosIdAlg.SetCuts(false, false, false, true, false, false, false, false, false);
-          if(cosIdAlg.CosmicId(detProp, *pParticle, pfParticleMap, event, fakeTpc0Flashes, fakeTpc1Flashes)){
-            plot = true;
-          }
-        }
-        if(j == 5){
-          cosIdAlg.SetCuts(false, false, false, false, true, false, false, false, false);
-          if(cosIdAlg.CosmicId(detProp, *pParticle, pfParticleMap, event, fakeTpc0Flashes, fakeTpc1Flashes)){
-            plot = true;
-          }
-        }
-        if(j == 6){
-          cosIdAlg.SetCuts(false, false, false, false, false, true, false, false, false);
-          if(cosIdAlg.CosmicId(detProp, *pParticle, pfParticleMap, event, fakeTpc0Flashes, fakeTpc1Flashes)){
-            plot = true;
-          }
-        }
-        if(j == 7){
-          cosIdAlg.SetCuts(false, false, false, false, false, false, true, false, false);
-          if(cosIdAlg.CosmicId(detProp, *pParticle, pfParticleMap, event, fakeTpc0Flashes, fakeTpc1Flashes)){
-            plot = true;
-          }
-        }
-        if(j == 8){
-          cosIdAlg.SetCuts(false, false, false, false, false, false, false, true, false);
-          if(cosIdAlg.CosmicId(detProp, *pParticle, pfParticleMap, event, fakeTpc0Flashes, fakeTpc1Flashes)){
-            plot = true;
-          }
-        }
-        if(j == 9){
-          cosIdAlg.SetCuts(false, false, false, false, false, false, false, false, true);
-          if(cosIdAlg.CosmicId(detProp, *pParticle, pfParticleMap, event, fakeTpc0Flashes, fakeTpc1Flashes)){
-            plot = true;
-          }
-        }
-        // Return to the cuts specified in the fhicl file
-        if(j == 10){
-          cosIdAlg.ResetCuts();
-          if(cosIdAlg.CosmicId(detProp, *pParticle, pfParticleMap, event, fakeTpc0Flashes, fakeTpc1Flashes)) plot = true;
-        }
-        if(j == 11 && !cosIdAlg.CosmicId(detProp, *pParticle, pfParticleMap, event, fakeTpc0Flashes, fakeTpc1Flashes)){
-          plot = true;
-        }
+        if(j >= 1 && j <= 10 && pfpCosmicIds[j][pfp_i]) plot = true;
+        if(j == 11 && !pfpCosmicIds[10][pfp_i]) plot = true;
         if(!plot) continue;
         //Fill histograms if PFP ID'd as a cosmic
         hRecoMom[pfpType][j]->Fill(recoMuMomentum);
@@ -548,6 +431,9 @@ namespace sbnd {
 
   void CosmicIdAna::endJob(){
 
+    // Summary of the time spent in each cut
+    if(fVerbose) cosIdAlg.PrintCutCounters();
+
   } // CosmicIdAna::endJob()
 
   void CosmicIdAna::GetPFParticleIdMap(const PFParticleHandle &pfParticleHandle, PFParticleIdMap &pfParticleMap){
@@ -14,6 +14,7 @@
 #include "sbndcode/CosmicId/Utils/CosmicIdUtils.h"
 #include "sbndcode/CosmicId/Algs/CosmicIdAlg.h"
 #include "sbndcode/Geometry/GeometryWrappers/TPCGeoAlg.h"
+#include "sbndcode/Geometry/GeometryWrappers/ParticleCrossingCache.h"
 
 // LArSoft includes
 #include "lardata/DetectorInfoServices/DetectorClocksService.h"
@@ -41,10 +42,13 @@
 // use the ROOT web site; e.g.,
 // <https://root.cern.ch/doc/master/annotated.html>
 #include "TVector3.h"
+#include "TTree.h"
+#include "TBranch.h"
 
 // C++ includes
 #include <map>
 #include <vector>
+#include <iostream>
 #include <string>
 
 namespace sbnd {
@@ -121,6 +125,24 @@ namespace sbnd {
         Name("BeamTimeLimits"),
         Comment("")
       };
+
+      fhicl::Atom<bool> ColumnarOutput {
+        Name("ColumnarOutput"),
+        Comment("Write flat tables of tracks, CRT hits, CRT tracks and true particles instead of the tracks and pfps trees"),
+        false
+      };
+
+      fhicl::Atom<int> ColumnarBasketSize {
+        Name("ColumnarBasketSize"),
+        Comment("Basket size [bytes] of every column of the flat tables"),
+        256000
+      };
+
+      fhicl::Atom<int> ColumnarCompression {
+        Name("ColumnarCompression"),
+        Comment("ROOT compression settings (100*algorithm + level) of the flat tables"),
+        404
+      };
       
     }; // Config
 
@@ -148,6 +170,13 @@ namespace sbnd {
   private:
 
     void GetPFParticleIdMap(const PFParticleHandle &pfParticleHandle, PFParticleIdMap &pfParticleMap);
+
+    // Create a flat table with the event index columns
+    TTree* MakeTable(art::TFileService& tfs, const std::string& name);
+    // Set the basket size and compression of every column of a flat table
+    void TuneTable(TTree* table);
+    // Numeric code of a particle type: 0 = none, 1 = NuMu, 2 = Nu, 3 = Cr, 4 = Dirt
+    static int TypeId(const std::string& type);
     
     // fcl file parameters
     art::InputTag fSimModuleLabel;      ///< name of detsim producer
@@ -159,8 +188,12 @@ namespace sbnd {
     bool          fVerbose;             ///< print information about what's going on
     double fBeamTimeMin;
     double fBeamTimeMax;
+    bool fColumnarOutput;
+    int fColumnarBasketSize;
+    int fColumnarCompression;
 
     TPCGeoAlg fTpcGeo;
+    ParticleCrossingCache fCrossingCache;
 
     CRTBackTracker fCrtBackTrack;
 
@@ -170,6 +203,68 @@ namespace sbnd {
     TTree *fTrackTree;
     TTree *fPfpTree;
 
+    // Flat tables for columnar output, one entry per object
+    TTree *fTrackTable;
+    TTree *fCrtHitTable;
+    TTree *fCrtTrackTable;
+    TTree *fParticleTable;
+
+    // Event index columns shared by all flat tables
+    unsigned int evt_run;
+    unsigned int evt_subrun;
+    unsigned int evt_event;
+    int evt_index;
+
+    // Track table parameters, the other columns are shared with the track tree
+    int track_index;
+    int track_type_id;
+
+    // CRT hit table parameters
+    int crt_hit_index;
+    int crt_hit_true_id;
+    double crt_hit_x;
+    double crt_hit_y;
+    double crt_hit_z;
+    double crt_hit_x_err;
+    double crt_hit_y_err;
+    double crt_hit_z_err;
+    double crt_hit_t0;
+    double crt_hit_t1;
+    double crt_hit_pe;
+
+    // CRT track table parameters
+    int crt_track_index;
+    int crt_track_true_id;
+    double crt_track_x1;
+    double crt_track_y1;
+    double crt_track_z1;
+    double crt_track_x2;
+    double crt_track_y2;
+    double crt_track_z2;
+    double crt_track_t0;
+    double crt_track_t1;
+    double crt_track_pe;
+
+    // True particle table parameters
+    int part_track_id;
+    int part_pdg;
+    int part_mother;
+    int part_type_id;
+    double part_time;
+    double part_momentum;
+    double part_start_x;
+    double part_start_y;
+    double part_start_z;
+    double part_end_x;
+    double part_end_y;
+    double part_end_z;
+    bool part_in_tpc;
+    bool part_contained;
+    bool part_crosses_apa;
+    double part_tpc_length;
+    int part_n_crt_hits;
+    int part_n_crt_tracks;
+
     // Track tree parameters
     std::string track_type;
     bool track_pfp_nu;
@@ -246,8 +341,18 @@ namespace sbnd {
     , fVerbose             (config().Verbose())
     , fBeamTimeMin         (config().BeamTimeLimits().BeamTimeMin())
     , fBeamTimeMax         (config().BeamTimeLimits().BeamTimeMax())
+    , fColumnarOutput      (config().ColumnarOutput())
+    , fColumnarBasketSize  (config().ColumnarBasketSize())
+    , fColumnarCompression (config().ColumnarCompression())
     , fCrtBackTrack        (config().CrtBackTrack())
     , fCosId               (config().CosIdAlg())
+    , fTrackTree           (nullptr)
+    , fPfpTree             (nullptr)
+    , fTrackTable          (nullptr)
+    , fCrtHitTable         (nullptr)
+    , fCrtTrackTable       (nullptr)
+    , fParticleTable       (nullptr)
+    , evt_index            (-1)
   {
 
   } //CosmicIdTree()
@@ -259,6 +364,97 @@ namespace sbnd {
     // Access tfileservice to handle creating and writing histograms
     art::ServiceHandle<art::TFileService> tfs;
 
+    if(fColumnarOutput){
+
+      // Track table, same columns as the track tree with the type as a number
+      fTrackTable = MakeTable(*tfs, "track_table");
+
+      fTrackTable->Branch("track_index",                &track_index, "track_index/I");
+      fTrackTable->Branch("track_type",                 &track_type_id, "track_type/I");
+      fTrackTable->Branch("track_pfp_nu",               &track_pfp_nu, "track_pfp_nu/O");
+      fTrackTable->Branch("track_nu_tpc",               &track_nu_tpc, "track_nu_tpc/I");
+      fTrackTable->Branch("track_pdg",                  &track_pdg, "track_pdg/I");
+      fTrackTable->Branch("track_time",                 &track_time, "track_time/D");
+      fTrackTable->Branch("track_length",               &track_length, "track_length/D");
+      fTrackTable->Branch("track_momentum",             &track_momentum, "track_momentum/D");
+      fTrackTable->Branch("track_theta",                &track_theta, "track_theta/D");
+      fTrackTable->Branch("track_phi",                  &track_phi, "track_phi/D");
+      fTrackTable->Branch("track_crt_hit_true_match",   &track_crt_hit_true_match, "track_crt_hit_true_match/O");
+      fTrackTable->Branch("track_crt_hit_dca",          &track_crt_hit_dca, "track_crt_hit_dca/D");
+      fTrackTable->Branch("track_crt_track_true_match", &track_crt_track_true_match, "track_crt_track_true_match/O");
+      fTrackTable->Branch("track_crt_track_dca",        &track_crt_track_dca, "track_crt_track_dca/D");
+      fTrackTable->Branch("track_crt_track_angle",      &track_crt_track_angle, "track_crt_track_angle/D");
+      fTrackTable->Branch("track_stops",                &track_stops, "track_stops/O");
+      fTrackTable->Branch("track_stop_ratio_start",     &track_stop_ratio_start, "track_stop_ratio_start/D");
+      fTrackTable->Branch("track_stop_ratio_end",       &track_stop_ratio_end, "track_stop_ratio_end/D");
+      fTrackTable->Branch("track_fiducial_dist_start",  &track_fiducial_dist_start, "track_fiducial_dist_start/D");
+      fTrackTable->Branch("track_fiducial_dist_end",    &track_fiducial_dist_end, "track_fiducial_dist_end/D");
+      fTrackTable->Branch("track_tpc",                  &track_tpc, "track_tpc/I");
+      fTrackTable->Branch("track_apa_cross",            &track_apa_cross, "track_apa_cross/O");
+      fTrackTable->Branch("track_apa_dist",             &track_apa_dist, "track_apa_dist/D");
+      fTrackTable->Branch("track_apa_min_dist",         &track_apa_min_dist, "track_apa_min_dist/D");
+      fTrackTable->Branch("track_pandora_nu_score",     &track_pandora_nu_score, "track_pandora_nu_score/D");
+      TuneTable(fTrackTable);
+
+      // CRT hit table
+      fCrtHitTable = MakeTable(*tfs, "crt_hit_table");
+
+      fCrtHitTable->Branch("crt_hit_index",   &crt_hit_index, "crt_hit_index/I");
+      fCrtHitTable->Branch("crt_hit_true_id", &crt_hit_true_id, "crt_hit_true_id/I");
+      fCrtHitTable->Branch("crt_hit_x",       &crt_hit_x, "crt_hit_x/D");
+      fCrtHitTable->Branch("crt_hit_y",       &crt_hit_y, "crt_hit_y/D");
+      fCrtHitTable->Branch("crt_hit_z",       &crt_hit_z, "crt_hit_z/D");
+      fCrtHitTable->Branch("crt_hit_x_err",   &crt_hit_x_err, "crt_hit_x_err/D");
+      fCrtHitTable->Branch("crt_hit_y_err",   &crt_hit_y_err, "crt_hit_y_err/D");
+      fCrtHitTable->Branch("crt_hit_z_err",   &crt_hit_z_err, "crt_hit_z_err/D");
+      fCrtHitTable->Branch("crt_hit_t0",      &crt_hit_t0, "crt_hit_t0/D");
+      fCrtHitTable->Branch("crt_hit_t1",      &crt_hit_t1, "crt_hit_t1/D");
+      fCrtHitTable->Branch("crt_hit_pe",      &crt_hit_pe, "crt_hit_pe/D");
+      TuneTable(fCrtHitTable);
+
+      // CRT track table
+      fCrtTrackTable = MakeTable(*tfs, "crt_track_table");
+
+      fCrtTrackTable->Branch("crt_track_index",   &crt_track_index, "crt_track_index/I");
+      fCrtTrackTable->Branch("crt_track_true_id", &crt_track_true_id, "crt_track_true_id/I");
+      fCrtTrackTable->Branch("crt_track_x1",      &crt_track_x1, "crt_track_x1/D");
+      fCrtTrackTable->Branch("crt_track_y1",      &crt_track_y1, "crt_track_y1/D");
+      fCrtTrackTable->Branch("crt_track_z1",      &crt_track_z1, "crt_track_z1/D");
+      fCrtTrackTable->Branch("crt_track_x2",      &crt_track_x2, "crt_track_x2/D");
+      fCrtTrackTable->Branch("crt_track_y2",      &crt_track_y2, "crt_track_y2/D");
+      fCrtTrackTable->Branch("crt_track_z2",      &crt_track_z2, "crt_track_z2/D");
+      fCrtTrackTable->Branch("crt_track_t0",      &crt_track_t0, "crt_track_t0/D");
+      fCrtTrackTable->Branch("crt_track_t1",      &crt_track_t1, "crt_track_t1/D");
+      fCrtTrackTable->Branch("crt_track_pe",      &crt_track_pe, "crt_track_pe/D");
+      TuneTable(fCrtTrackTable);
+
+      // True particle table
+      fParticleTable = MakeTable(*tfs, "particle_table");
+
+      fParticleTable->Branch("part_track_id",     &part_track_id, "part_track_id/I");
+      fParticleTable->Branch("part_pdg",          &part_pdg, "part_pdg/I");
+      fParticleTable->Branch("part_mother",       &part_mother, "part_mother/I");
+      fParticleTable->Branch("part_type",         &part_type_id, "part_type/I");
+      fParticleTable->Branch("part_time",         &part_time, "part_time/D");
+      fParticleTable->Branch("part_momentum",     &part_momentum, "part_momentum/D");
+      fParticleTable->Branch("part_start_x",      &part_start_x, "part_start_x/D");
+      fParticleTable->Branch("part_start_y",      &part_start_y, "part_start_y/D");
+      fParticleTable->Branch("part_start_z",      &part_start_z, "part_start_z/D");
+      fParticleTable->Branch("part_end_x",        &part_end_x, "part_end_x/D");
+      fParticleTable->Branch("part_end_y",        &part_end_y, "part_end_y/D");
+      fParticleTable->Branch("part_end_z",        &part_end_z, "part_end_z/D");
+      fParticleTable->Branch("part_in_tpc",       &part_in_tpc, "part_in_tpc/O");
+      fParticleTable->Branch("part_contained",    &part_contained, "part_contained/O");
+      fParticleTable->Branch("part_crosses_apa",  &part_crosses_apa, "part_crosses_apa/O");
+      fParticleTable->Branch("part_tpc_length",   &part_tpc_length, "part_tpc_length/D");
+      fParticleTable->Branch("part_n_crt_hits",   &part_n_crt_hits, "part_n_crt_hits/I");
+      fParticleTable->Branch("part_n_crt_tracks", &part_n_crt_tracks, "part_n_crt_tracks/I");
+      TuneTable(fParticleTable);
+
+      if(fVerbose) std::cout<<"----------------- Cosmic ID Tree Module -------------------"<<std::endl;
+      return;
+    }
+
     // Track tree
     fTrackTree = tfs->make<TTree>("tracks", "tracks");
 
@@ -358,16 +554,19 @@ namespace sbnd {
 
     // Loop over the CRT hits and match them to true particles
     std::vector<sbn::crt::CRTHit> crtHits;
+    std::vector<int> crtHitTrueIds;
+    std::vector<size_t> crtHitKeys;
     std::map<int, int> numHitMap;
-    int hit_i = 0;
     for(auto const& hit : (crtHitList)){
       // Don't try to match CRT hits in time with the beam
       double hitTime = hit->ts1_ns * 1e-3;
       if(hitTime > fBeamTimeMin && hitTime < fBeamTimeMax) continue;
       crtHits.push_back(*hit);
-      int hitTrueID = fCrtBackTrack.TrueIdFromHitId(event, hit_i);
-      hit_i++;
+      // Backtrack with the position in the hit collection, not in the out of time hits
+      int hitTrueID = fCrtBackTrack.TrueIdFromHitId(event, hit.key());
       numHitMap[hitTrueID]++;
+      crtHitTrueIds.push_back(hitTrueID);
+      crtHitKeys.push_back(hit.key());
     }
 
     // Get CRT tracks from the event
@@ -378,16 +577,18 @@ namespace sbnd {
 
     // Loop over the CRT tracks and match them to true particles
     std::vector<sbn::crt::CRTTrack> crtTracks;
+    std::vector<int> crtTrackTrueIds;
+    std::vector<size_t> crtTrackKeys;
     std::map<int, int> numTrackMap;
-    int track_i = 0;
     for(auto const& track : (crtTrackList)){
       // Don't try to match CRT tracks in time with the beam
       double trackTime = track->ts1_ns * 1e-3;
       if(trackTime > fBeamTimeMin && trackTime < fBeamTimeMax) continue;
       crtTracks.push_back(*track);
-      int trackTrueID = fCrtBackTrack.TrueIdFromTrackId(event, track_i);
-      track_i++;
+      int trackTrueID = fCrtBackTrack.TrueIdFromTrackId(event, track.key());
       numTrackMap[trackTrueID]++;
+      crtTrackTrueIds.push_back(trackTrueID);
+      crtTrackKeys.push_back(track.key());
     }
 
     // Get reconstructed tracks from the event and hit/calorimetry associations
@@ -408,11 +609,16 @@ namespace sbnd {
     art::FindManyP< recob::Track > pfPartToTrackAssoc(pfParticleHandle, event, fTPCTrackLabel);
     art::FindManyP<larpandoraobj::PFParticleMetadata> findManyPFPMetadata(pfParticleHandle,
         event, fPandoraLabel);
+    // Get the PFP neutrino scores of every track once
+    PandoraTrackLookup pandoraLookup(*pfParticleHandle, pfPartToTrackAssoc);
+    fCosId.PandoraNuScoreAlg().FillLookup(pandoraLookup, findManyPFPMetadata);
 
     //----------------------------------------------------------------------------------------------------------
     //                                          TRUTH MATCHING
     //----------------------------------------------------------------------------------------------------------
     
+    fCrossingCache.Clear();
+
     // Sort the true particles by type
     std::map<int, simb::MCParticle> particles;
     std::vector<simb::MCParticle> parts;
@@ -463,7 +669,7 @@ namespace sbnd {
       if(particle.Mother()==0 && 
          (pdg==13||pdg==111||pdg==211||pdg==2212||pdg==11) && 
          time > fBeamTimeMin && time < fBeamTimeMax){
-        std::pair<TVector3, TVector3> cross = fTpcGeo.CrossingPoints(particle);
+        std::pair<TVector3, TVector3> cross = fCrossingCache.TPCCrossingPoints(particle);
         if(cross.first.X() != cross.second.X()){
           if(cross.first.X() < 0 && cross.second.X() < 0 && (nuTpc == 0 || nuTpc == -2)) nuTpc = 0;
           else if(cross.first.X() > 0 && cross.second.X() > 0 && (nuTpc == 1 || nuTpc == -2)) nuTpc = 1;
@@ -487,6 +693,79 @@ namespace sbnd {
     // If there are no flashes in time with the beam then ignore the event
     if(!tpc0BeamFlash && !tpc1BeamFlash) return;
 
+    //----------------------------------------------------------------------------------------------------------
+    //                              FILLING THE CRT AND TRUE PARTICLE TABLES
+    //----------------------------------------------------------------------------------------------------------
+
+    if(fColumnarOutput){
+
+      evt_run = event.run();
+      evt_subrun = event.subRun();
+      evt_event = event.id().event();
+      evt_index++;
+
+      // CRT hits and tracks out of time with the beam, as used by the cuts
+      // The index is the position in the full CRT hit or track collection
+      for(size_t i = 0; i < crtHits.size(); i++){
+        const sbn::crt::CRTHit& hit = crtHits[i];
+        crt_hit_index = crtHitKeys[i];
+        crt_hit_true_id = crtHitTrueIds[i];
+        crt_hit_x = hit.x_pos;
+        crt_hit_y = hit.y_pos;
+        crt_hit_z = hit.z_pos;
+        crt_hit_x_err = hit.x_err;
+        crt_hit_y_err = hit.y_err;
+        crt_hit_z_err = hit.z_err;
+        crt_hit_t0 = (double)(int)hit.ts0_ns * 1e-3;
+        crt_hit_t1 = (double)(int)hit.ts1_ns * 1e-3;
+        crt_hit_pe = hit.peshit;
+        fCrtHitTable->Fill();
+      }
+
+      for(size_t i = 0; i < crtTracks.size(); i++){
+        const sbn::crt::CRTTrack& track = crtTracks[i];
+        crt_track_index = crtTrackKeys[i];
+        crt_track_true_id = crtTrackTrueIds[i];
+        crt_track_x1 = track.x1_pos;
+        crt_track_y1 = track.y1_pos;
+        crt_track_z1 = track.z1_pos;
+        crt_track_x2 = track.x2_pos;
+        crt_track_y2 = track.y2_pos;
+        crt_track_z2 = track.z2_pos;
+        crt_track_t0 = (double)(int)track.ts0_ns * 1e-3;
+        crt_track_t1 = (double)(int)track.ts1_ns * 1e-3;
+        crt_track_pe = track.peshit;
+        fCrtTrackTable->Fill();
+      }
+
+      for(auto const& particle : parts){
+        int partID = particle.TrackId();
+        part_track_id = partID;
+        part_pdg = particle.PdgCode();
+        part_mother = particle.Mother();
+        part_type_id = TypeId("none");
+        if(std::find(lepParticleIds.begin(), lepParticleIds.end(), partID) != lepParticleIds.end()) part_type_id = TypeId("NuMu");
+        if(std::find(nuParticleIds.begin(), nuParticleIds.end(), partID) != nuParticleIds.end()) part_type_id = TypeId("Nu");
+        if(std::find(crParticleIds.begin(), crParticleIds.end(), partID) != crParticleIds.end()) part_type_id = TypeId("Cr");
+        if(std::find(dirtParticleIds.begin(), dirtParticleIds.end(), partID) != dirtParticleIds.end()) part_type_id = TypeId("Dirt");
+        part_time = particle.T();
+        part_momentum = particle.P();
+        part_start_x = particle.Vx();
+        part_start_y = particle.Vy();
+        part_start_z = particle.Vz();
+        part_end_x = particle.EndX();
+        part_end_y = particle.EndY();
+        part_end_z = particle.EndZ();
+        part_in_tpc = fCrossingCache.InTPC(particle);
+        part_contained = fCrossingCache.ContainedInTPC(particle);
+        part_crosses_apa = fCrossingCache.CrossesApa(particle);
+        part_tpc_length = fCrossingCache.TpcLength(particle);
+        part_n_crt_hits = numHitMap.find(partID) != numHitMap.end() ? numHitMap[partID] : 0;
+        part_n_crt_tracks = numTrackMap.find(partID) != numTrackMap.end() ? numTrackMap[partID] : 0;
+        fParticleTable->Fill();
+      }
+    }
+
     //----------------------------------------------------------------------------------------------------------
     //                                FILLING THE PFPARTICLE TREE
     //----------------------------------------------------------------------------------------------------------
@@ -527,6 +806,9 @@ namespace sbnd {
 
         isPfpNu[tpcTrack.ID()] = isNeutrino;
 
+        // Only the neutrino tag of the tracks is needed for the flat tables
+        if(fColumnarOutput) continue;
+
         // Truth match muon tracks and pfps
         std::vector<art::Ptr<recob::Hit>> hits = findManyHits.at(tpcTrack.ID());
         int trueId = RecoUtils::TrueParticleIDFromTotalRecoHits(clockData, hits, false);
@@ -551,7 +833,7 @@ namespace sbnd {
       }
 
       // Don't consider PFParticles with no associated tracks
-      if(nuTracks.size() == 0) continue;
+      if(fColumnarOutput || nuTracks.size() == 0) continue;
 
       pfp_n_tracks = nuTracks.size();
 
@@ -582,7 +864,7 @@ namespace sbnd {
         geo::Point_t end {particles[trueId].EndX(), particles[trueId].EndY(), particles[trueId].EndZ()};
         if(fTpcGeo.InFiducial(end, 0.)) pfp_stops = true;
         // Does the true particle cross the APA?
-        pfp_apa_cross = fTpcGeo.CrossesApa(particles[trueId]);
+        pfp_apa_cross = fCrossingCache.CrossesApa(particles[trueId]);
         // Distance from the APA of the reco track at the true time
         pfp_apa_dist = fCosId.ApaAlg().ApaDistance(detProp, tpcTrack, pfp_time/1e3, hits);
       }
@@ -667,7 +949,9 @@ namespace sbnd {
     //----------------------------------------------------------------------------------------------------------
 
     // Loop over reconstructed tracks
-    for (auto const& tpcTrack : (*tpcTrackHandle)){
+    for (size_t tpcTrack_i = 0; tpcTrack_i < tpcTrackHandle->size(); tpcTrack_i++){
+
+      const recob::Track& tpcTrack = tpcTrackHandle->at(tpcTrack_i);
 
       ResetTrackVars();
       track_nu_tpc = nuTpc;
@@ -705,7 +989,7 @@ namespace sbnd {
         geo::Point_t end {particles[trueId].EndX(), particles[trueId].EndY(), particles[trueId].EndZ()};
         if(fTpcGeo.InFiducial(end, 0.)) track_stops = true;
         // Does the true particle cross the APA?
-        track_apa_cross = fTpcGeo.CrossesApa(particles[trueId]);
+        track_apa_cross = fCrossingCache.CrossesApa(particles[trueId]);
         // Distance from the APA of the reco track at the true time
         track_apa_dist = fCosId.ApaAlg().ApaDistance(detProp, tpcTrack, track_time/1e3, hits);
       }
@@ -741,20 +1025,16 @@ namespace sbnd {
 
       // The PFP Nu Score only exists for PFP Neutrinos
       if (track_pfp_nu){
-        for(auto const pfp : (*pfParticleHandle)){
-          // Get the associated track if there is one
-          const std::vector< art::Ptr<recob::Track> > associatedTracks(pfPartToTrackAssoc.at(pfp.Self()));
-          if(associatedTracks.size() != 1) continue;
-          recob::Track trk = *associatedTracks.front();
-          if(trk.ID() != tpcTrack.ID()) continue;
-
-          recob::PFParticle PFPNeutrino = fCosId.PandoraNuScoreAlg().GetPFPNeutrino(pfp, (*pfParticleHandle));
-          track_pandora_nu_score = fCosId.PandoraNuScoreAlg().GetPandoraNuScore(PFPNeutrino, findManyPFPMetadata);
-          break;
-        }
+        auto const& trackPfps = pandoraLookup.TrackPFParticles(tpcTrack.ID());
+        if(!trackPfps.empty()) track_pandora_nu_score = pandoraLookup.NuScore(trackPfps.front());
       }
-      // Fill the Track tree
-      fTrackTree->Fill();
+      // Fill the Track tree or table
+      if(fColumnarOutput){
+        track_index = tpcTrack_i;
+        track_type_id = TypeId(track_type);
+        fTrackTable->Fill();
+      }
+      else fTrackTree->Fill();
     }
     
   } // CosmicIdTree::analyze()
@@ -774,6 +1054,32 @@ namespace sbnd {
       }
   }
 
+  TTree* CosmicIdTree::MakeTable(art::TFileService& tfs, const std::string& name){
+    TTree* table = tfs.make<TTree>(name.c_str(), name.c_str());
+    table->Branch("run",         &evt_run, "run/i");
+    table->Branch("subrun",      &evt_subrun, "subrun/i");
+    table->Branch("event",       &evt_event, "event/i");
+    table->Branch("event_index", &evt_index, "event_index/I");
+    return table;
+  }
+
+  void CosmicIdTree::TuneTable(TTree* table){
+    // Large baskets and a fast to decompress algorithm so that reading a few columns is cheap
+    table->SetBasketSize("*", fColumnarBasketSize);
+    TIter next(table->GetListOfBranches());
+    while(TBranch* branch = static_cast<TBranch*>(next())){
+      branch->SetCompressionSettings(fColumnarCompression);
+    }
+  }
+
+  int CosmicIdTree::TypeId(const std::string& type){
+    if(type == "NuMu") return 1;
+    if(type == "Nu") return 2;
+    if(type == "Cr") return 3;
+    if(type == "Dirt") return 4;
+    return 0;
+  }
+
   void CosmicIdTree::ResetTrackVars(){
     track_type = "none";
     track_pfp_nu = false;
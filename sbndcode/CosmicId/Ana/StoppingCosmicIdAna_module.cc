@@ -9,6 +9,7 @@
 // sbndcode includes
 #include "sbndcode/RecoUtils/RecoUtils.h"
 #include "sbndcode/CosmicId/Algs/StoppingParticleCosmicIdAlg.h"
+#include "sbndcode/CosmicId/Services/CosmicIdTruthService.h"
 #include "sbndcode/Geometry/GeometryWrappers/TPCGeoAlg.h"
 
 // LArSoft includes
@@ -18,10 +19,6 @@
 #include "lardataobj/RecoBase/PFParticle.h"
 #include "lardataobj/AnalysisBase/Calorimetry.h"
 #include "larcoreobj/SimpleTypesAndConstants/geo_types.h"
-#include "nusimdata/SimulationBase/MCParticle.h"
-#include "nusimdata/SimulationBase/MCTruth.h"
-#include "larsim/MCCheater/BackTrackerService.h"
-#include "larsim/MCCheater/ParticleInventoryService.h"
 
 // Framework includes
 #include "art/Framework/Core/EDAnalyzer.h"
@@ -44,6 +41,7 @@
 // C++ includes
 #include <map>
 #include <vector>
+#include <iostream>
 #include <string>
 #include <algorithm>
 
@@ -58,11 +56,6 @@ namespace sbnd {
       using Comment = fhicl::Comment;
  
       // One Atom for each parameter
-      fhicl::Atom<art::InputTag> SimModuleLabel {
-        Name("SimModuleLabel"),
-        Comment("tag of detector simulation data product")
-      };
-
       fhicl::Atom<art::InputTag> TpcTrackModuleLabel {
         Name("TpcTrackModuleLabel"),
         Comment("tag of TPC track producer data product")
@@ -111,7 +104,6 @@ namespace sbnd {
     void GetPFParticleIdMap(const PFParticleHandle &pfParticleHandle, PFParticleIdMap &pfParticleMap);
     
     // fcl file parameters
-    art::InputTag fSimModuleLabel;      ///< name of detsim producer
     art::InputTag fTpcTrackModuleLabel; ///< name of TPC track producer
     art::InputTag fCaloModuleLabel; ///< name of calorimetry producer
     art::InputTag fPandoraLabel;
@@ -136,7 +128,6 @@ namespace sbnd {
   // Constructor
   StoppingCosmicIdAna::StoppingCosmicIdAna(Parameters const& config)
     : EDAnalyzer(config)
-    , fSimModuleLabel       (config().SimModuleLabel())
     , fTpcTrackModuleLabel  (config().TpcTrackModuleLabel())
     , fCaloModuleLabel      (config().CaloModuleLabel())
     , fPandoraLabel        (config().PandoraLabel())
@@ -169,8 +160,6 @@ namespace sbnd {
 
   void StoppingCosmicIdAna::analyze(const art::Event& event)
   {
-    art::ServiceHandle<cheat::ParticleInventoryService> pi_serv;
-
     // Fetch basic event info
     if(fVerbose){
       std::cout<<"============================================"<<std::endl
@@ -182,8 +171,9 @@ namespace sbnd {
     //                                          GETTING PRODUCTS
     //----------------------------------------------------------------------------------------------------------
     
-    // Retrieve all the truth info in the events
-    auto particleHandle = event.getValidHandle<std::vector<simb::MCParticle>>(fSimModuleLabel);
+    // Get the truth summary shared by the cosmic ID analysers
+    art::ServiceHandle<CosmicIdTruthService> truthServ;
+    const CosmicIdTruthSummary& truth = truthServ->Summary(event);
 
     // Retrieve the TPC tracks
     auto tpcTrackHandle = event.getValidHandle<std::vector<recob::Track>>(fTpcTrackModuleLabel);
@@ -204,51 +194,6 @@ namespace sbnd {
     // Get PFParticle to track associations
     art::FindManyP< recob::Track > pfPartToTrackAssoc(pfParticleHandle, event, fTpcTrackModuleLabel);
 
-    //----------------------------------------------------------------------------------------------------------
-    //                                          TRUTH MATCHING
-    //----------------------------------------------------------------------------------------------------------
-    
-    std::map<int, simb::MCParticle> particles;
-    std::vector<int> nuParticleIds;
-    std::vector<int> lepParticleIds;
-    std::vector<int> dirtParticleIds;
-    std::vector<int> crParticleIds;
-    // Loop over the true particles
-    for (auto const& particle: (*particleHandle)){
-      
-      // Make map with ID
-      int partID = particle.TrackId();
-      particles[partID] = particle;
-
-      // Get MCTruth
-      art::Ptr<simb::MCTruth> truth = pi_serv->TrackIdToMCTruth_P(partID);
-      int pdg = std::abs(particle.PdgCode());
-
-      // If origin is a neutrino
-      if(truth->Origin() == simb::kBeamNeutrino){
-        geo::Point_t vtx;
-        vtx.SetX(truth->GetNeutrino().Nu().Vx()); vtx.SetY(truth->GetNeutrino().Nu().Vy()); vtx.SetZ(truth->GetNeutrino().Nu().Vz());
-        // If neutrino vertex is not inside the TPC then call it a dirt particle
-        if(!fTPCGeo.InFiducial(vtx, 0, 0)){ 
-          dirtParticleIds.push_back(partID);
-        }
-        // If it's a primary muon
-        else if(pdg==13 && particle.Mother()==0){ 
-          lepParticleIds.push_back(partID);
-        }
-        // Other nu particles
-        else{
-          nuParticleIds.push_back(partID);
-        }
-      }
-
-      // If origin is a cosmic ray
-      else if(truth->Origin() == simb::kCosmicRay){
-        crParticleIds.push_back(partID);
-      }
-      
-    }
-
     //----------------------------------------------------------------------------------------------------------
     //                                    STOPPING CHI2 ANALYSIS
     //----------------------------------------------------------------------------------------------------------
@@ -260,28 +205,27 @@ namespace sbnd {
       // Match to the true particle
       std::vector<art::Ptr<recob::Hit>> hits = findManyHits.at(tpcTrack.ID());
       int trueId = RecoUtils::TrueParticleIDFromTotalRecoHits(clockData, hits, false);
+      CosmicIdTruthType trueType = truth.Type(trueId);
       std::string type = "none";
-      if(std::find(lepParticleIds.begin(), lepParticleIds.end(), trueId) != lepParticleIds.end()) type = "NuMuTrack";
-      if(std::find(nuParticleIds.begin(), nuParticleIds.end(), trueId) != nuParticleIds.end()) type = "NuTrack";
-      if(std::find(crParticleIds.begin(), crParticleIds.end(), trueId) != crParticleIds.end()) type = "CrTrack";
-      if(std::find(dirtParticleIds.begin(), dirtParticleIds.end(), trueId) != dirtParticleIds.end()) type = "DirtTrack";
+      if(trueType == CosmicIdTruthType::kNuMu) type = "NuMuTrack";
+      if(trueType == CosmicIdTruthType::kNu) type = "NuTrack";
+      if(trueType == CosmicIdTruthType::kCr) type = "CrTrack";
+      if(trueType == CosmicIdTruthType::kDirt) type = "DirtTrack";
       if(type == "none") continue;
 
       std::vector<art::Ptr<anab::Calorimetry>> calos = findManyCalo.at(tpcTrack.ID());
       if(calos.size()==0) continue;
 
       // Only focus on muon tracks or it'll be too hard
-      if(std::abs(particles[trueId].PdgCode()) != 13) continue;
+      const CosmicIdTrueParticle* trueParticle = truth.Particle(trueId);
+      if(!trueParticle || std::abs(trueParticle->pdg) != 13) continue;
 
-      geo::Point_t trueEnd {particles[trueId].EndX(), particles[trueId].EndY(), particles[trueId].EndZ()};
-      bool stops = false;
-
-      if(fTPCGeo.InFiducial(trueEnd, 0.)) stops = true;
+      bool stops = trueParticle->stops;
 
       if(stops) hStopLength[type]->Fill(tpcTrack.Length());
       else hNoStopLength[type]->Fill(tpcTrack.Length());
 
-      TVector3 trueEndVec (particles[trueId].EndX(), particles[trueId].EndY(), particles[trueId].EndZ());
+      TVector3 trueEndVec = trueParticle->end;
       TVector3 start = tpcTrack.Vertex<TVector3>();
       TVector3 end = tpcTrack.End<TVector3>();
       geo::Point_t recoEnd = tpcTrack.End();
@@ -340,16 +284,17 @@ namespace sbnd {
         // Truth match muon tracks and pfps
         std::vector<art::Ptr<recob::Hit>> hits = findManyHits.at(tpcTrack.ID());
         int trueId = RecoUtils::TrueParticleIDFromTotalRecoHits(clockData, hits, false);
-        if(std::find(lepParticleIds.begin(), lepParticleIds.end(), trueId) != lepParticleIds.end()){ 
+        CosmicIdTruthType trueType = truth.Type(trueId);
+        if(trueType == CosmicIdTruthType::kNuMu){ 
           type = "NuMuPfp";
         }
-        else if(std::find(nuParticleIds.begin(), nuParticleIds.end(), trueId) != nuParticleIds.end()){ 
+        else if(trueType == CosmicIdTruthType::kNu){ 
           if(type != "NuMuPfp") type = "NuPfp";
         }
-        else if(std::find(dirtParticleIds.begin(), dirtParticleIds.end(), trueId) != dirtParticleIds.end()){ 
+        else if(trueType == CosmicIdTruthType::kDirt){ 
           if(type != "NuMuPfp" && type != "NuPfp") type = "DirtPfp";
         }
-        else if(std::find(crParticleIds.begin(), crParticleIds.end(), trueId) != crParticleIds.end()){
+        else if(trueType == CosmicIdTruthType::kCr){
           if(type != "NuMuPfp" && type != "NuPfp" && type != "DirtPfp") type = "CrPfp";
         }
       }
@@ -367,17 +312,15 @@ namespace sbnd {
       if(calos.size()==0) continue;
 
       // Only focus on muon tracks or it'll be too hard
-      if(std::abs(particles[trueId].PdgCode()) != 13) continue;
-
-      geo::Point_t trueEnd {particles[trueId].EndX(), particles[trueId].EndY(), particles[trueId].EndZ()};
-      bool stops = false;
+      const CosmicIdTrueParticle* trueParticle = truth.Particle(trueId);
+      if(!trueParticle || std::abs(trueParticle->pdg) != 13) continue;
 
-      if(fTPCGeo.InFiducial(trueEnd, 0.)) stops = true;
+      bool stops = trueParticle->stops;
 
       if(stops) hStopLength[type]->Fill(tpcTrack.Length());
       else hNoStopLength[type]->Fill(tpcTrack.Length());
 
-      TVector3 trueEndVec (particles[trueId].EndX(), particles[trueId].EndY(), particles[trueId].EndZ());
+      TVector3 trueEndVec = trueParticle->end;
       TVector3 start = tpcTrack.Vertex<TVector3>();
       TVector3 end = tpcTrack.End<TVector3>();
       geo::Point_t recoEnd = tpcTrack.End();
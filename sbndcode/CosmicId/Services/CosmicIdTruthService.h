@@ -0,0 +1,92 @@
+#ifndef COSMICIDTRUTHSERVICE_H_SEEN
+#define COSMICIDTRUTHSERVICE_H_SEEN
+
+
+///////////////////////////////////////////////
+// CosmicIdTruthService.h
+//
+// Builds the CosmicIdTruthSummary of an event the
+// first time it is asked for and hands the same
+// summary to every module in the job, so the truth
+// matching is only done once per event
+///////////////////////////////////////////////
+
+// framework
+#include "art/Framework/Principal/Event.h"
+#include "art/Framework/Services/Registry/ActivityRegistry.h"
+#include "art/Framework/Services/Registry/ServiceDeclarationMacros.h"
+#include "art/Framework/Services/Registry/ServiceTable.h"
+#include "art/Persistency/Provenance/ScheduleContext.h"
+#include "fhiclcpp/types/Atom.h"
+#include "fhiclcpp/types/Table.h"
+
+#include "sbndcode/CosmicId/Services/CosmicIdTruthSummary.h"
+#include "sbndcode/CRT/CRTUtils/CRTBackTracker.h"
+#include "sbndcode/Geometry/GeometryWrappers/TPCGeoAlg.h"
+#include "sbndcode/Geometry/GeometryWrappers/ParticleCrossingCache.h"
+
+namespace sbnd{
+
+  class CosmicIdTruthService {
+  public:
+
+    struct Config {
+      using Name = fhicl::Name;
+      using Comment = fhicl::Comment;
+
+      fhicl::Atom<art::InputTag> SimModuleLabel {
+        Name("SimModuleLabel"),
+        Comment("tag of detector simulation data product")
+      };
+
+      fhicl::Atom<art::InputTag> CRTHitLabel {
+        Name("CRTHitLabel"),
+        Comment("tag of CRT hit producer data product")
+      };
+
+      fhicl::Atom<art::InputTag> CRTTrackLabel {
+        Name("CRTTrackLabel"),
+        Comment("tag of CRT track producer data product")
+      };
+
+      fhicl::Table<CRTBackTracker::Config> CrtBackTrack {
+        Name("CrtBackTrack"),
+      };
+
+    };
+
+    using Parameters = art::ServiceTable<Config>;
+
+    CosmicIdTruthService(Parameters const& config, art::ActivityRegistry& registry);
+
+    // Truth summary of an event, only filled on the first call for each event
+    const CosmicIdTruthSummary& Summary(const art::Event& event);
+
+    // Label of the simulated particles the summary is filled from
+    const art::InputTag& SimModuleLabel() const {return fSimModuleLabel;}
+
+  private:
+
+    // Forget the summary of the last event before the next one is processed
+    void preProcessEvent(const art::Event& event, art::ScheduleContext);
+
+    void Fill(const art::Event& event);
+
+    art::InputTag fSimModuleLabel;
+    art::InputTag fCRTHitLabel;
+    art::InputTag fCRTTrackLabel;
+
+    TPCGeoAlg fTpcGeo;
+    ParticleCrossingCache fCrossingCache;
+    CRTBackTracker fCrtBackTrack;
+
+    CosmicIdTruthSummary fSummary;
+    bool fFilled;
+
+  };
+
+}
+
+DECLARE_ART_SERVICE(sbnd::CosmicIdTruthService, LEGACY)
+
+#endif
@@ -0,0 +1,142 @@
+////////////////////////////////////////////////////////////////////////
+// Class:       CosmicIdTruthService
+// Plugin Type: service
+// File:        CosmicIdTruthService_service.cc
+//
+// Shared per-event truth summary for the cosmic ID analysers
+////////////////////////////////////////////////////////////////////////
+
+#include "sbndcode/CosmicId/Services/CosmicIdTruthService.h"
+
+// LArSoft includes
+#include "larsim/MCCheater/ParticleInventoryService.h"
+#include "nusimdata/SimulationBase/MCParticle.h"
+#include "nusimdata/SimulationBase/MCTruth.h"
+
+// Framework includes
+#include "art/Framework/Principal/Handle.h"
+#include "art/Framework/Services/Registry/ServiceDefinitionMacros.h"
+#include "art/Framework/Services/Registry/ServiceHandle.h"
+
+// C++ includes
+#include <cmath>
+#include <utility>
+
+namespace sbnd{
+
+  CosmicIdTruthService::CosmicIdTruthService(Parameters const& config, art::ActivityRegistry& registry)
+    : fSimModuleLabel (config().SimModuleLabel())
+    , fCRTHitLabel    (config().CRTHitLabel())
+    , fCRTTrackLabel  (config().CRTTrackLabel())
+    , fCrtBackTrack   (config().CrtBackTrack())
+    , fFilled         (false)
+  {
+
+    registry.sPreProcessEvent.watch(this, &CosmicIdTruthService::preProcessEvent);
+
+  }
+
+
+  // Forget the summary of the last event before the next one is processed
+  void CosmicIdTruthService::preProcessEvent(const art::Event&, art::ScheduleContext){
+
+    fFilled = false;
+
+  }
+
+
+  // Truth summary of an event, only filled on the first call for each event
+  const CosmicIdTruthSummary& CosmicIdTruthService::Summary(const art::Event& event){
+
+    if(!fFilled){
+      Fill(event);
+      fFilled = true;
+    }
+    return fSummary;
+
+  }
+
+
+  void CosmicIdTruthService::Fill(const art::Event& event){
+
+    fSummary.Clear();
+    fCrossingCache.Clear();
+
+    // Get g4 particles
+    art::ServiceHandle<cheat::ParticleInventoryService> pi_serv;
+    auto particleHandle = event.getValidHandle<std::vector<simb::MCParticle>>(fSimModuleLabel);
+
+    // Loop over the true particles
+    for (auto const& particle: (*particleHandle)){
+
+      CosmicIdTrueParticle part;
+      part.trackId = particle.TrackId();
+      part.pdg = particle.PdgCode();
+      part.mother = particle.Mother();
+      part.time = particle.T();
+      part.momentum = particle.P();
+      part.end.SetXYZ(particle.EndX(), particle.EndY(), particle.EndZ());
+
+      // Get MCTruth
+      art::Ptr<simb::MCTruth> truth = pi_serv->TrackIdToMCTruth_P(part.trackId);
+      int pdg = std::abs(part.pdg);
+
+      // If origin is a neutrino
+      if(truth->Origin() == simb::kBeamNeutrino){
+        geo::Point_t vtx;
+        vtx.SetX(truth->GetNeutrino().Nu().Vx()); vtx.SetY(truth->GetNeutrino().Nu().Vy()); vtx.SetZ(truth->GetNeutrino().Nu().Vz());
+        // If neutrino vertex is not inside the TPC then call it a dirt particle
+        if(!fTpcGeo.InFiducial(vtx, 0.)) part.type = CosmicIdTruthType::kDirt;
+        // If it's a primary muon
+        else if(pdg==13 && part.mother==0) part.type = CosmicIdTruthType::kNuMu;
+        // Other nu particles
+        else part.type = CosmicIdTruthType::kNu;
+      }
+
+      // If origin is a cosmic ray
+      else if(truth->Origin() == simb::kCosmicRay){
+        part.type = CosmicIdTruthType::kCr;
+      }
+
+      // Does the particle stop in the TPC?
+      geo::Point_t end {particle.EndX(), particle.EndY(), particle.EndZ()};
+      part.stops = fTpcGeo.InFiducial(end, 0.);
+
+      fSummary.Add(part);
+    }
+
+    // Where does it cross the TPC? Only walked for the particles a client looks up
+    const std::vector<simb::MCParticle>* particles = particleHandle.product();
+    fSummary.fillCrossings = [this, particles](CosmicIdTrueParticle& part, size_t particle_i){
+      const simb::MCParticle& particle = (*particles)[particle_i];
+      part.inTPC = fCrossingCache.InTPC(particle);
+      part.containedInTPC = fCrossingCache.ContainedInTPC(particle);
+      part.crossesApa = fCrossingCache.CrossesApa(particle);
+      std::pair<TVector3, TVector3> cross = fCrossingCache.TPCCrossingPoints(particle);
+      part.tpcStart = cross.first;
+      part.tpcEnd = cross.second;
+      part.tpcLength = fCrossingCache.TpcLength(particle);
+    };
+
+    // Match the CRT hits and tracks to true particles
+    fCrtBackTrack.Initialize(event);
+
+    art::Handle< std::vector<sbn::crt::CRTHit>> crtHitHandle;
+    if (event.getByLabel(fCRTHitLabel, crtHitHandle)){
+      for(size_t hit_i = 0; hit_i < crtHitHandle->size(); hit_i++){
+        fSummary.AddCrtHit(crtHitHandle->at(hit_i), fCrtBackTrack.TrueIdFromHitId(event, hit_i));
+      }
+    }
+
+    art::Handle< std::vector<sbn::crt::CRTTrack>> crtTrackHandle;
+    if (event.getByLabel(fCRTTrackLabel, crtTrackHandle)){
+      for(size_t track_i = 0; track_i < crtTrackHandle->size(); track_i++){
+        fSummary.AddCrtTrack(crtTrackHandle->at(track_i), fCrtBackTrack.TrueIdFromTrackId(event, track_i));
+      }
+    }
+
+  }
+
+}
+
+DEFINE_ART_SERVICE(sbnd::CosmicIdTruthService)
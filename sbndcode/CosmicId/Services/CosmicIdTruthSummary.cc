@@ -0,0 +1,125 @@
+#include "CosmicIdTruthSummary.h"
+#include "sbndcode/CRT/CRTUtils/CRTBackTracker.h"
+
+namespace sbnd{
+
+void CosmicIdTruthSummary::Clear(){
+
+  particles.clear();
+  crossingsFilled.clear();
+  trackIdIndex.clear();
+  fillCrossings = nullptr;
+  crtHits.clear();
+  crtHitTrueIds.clear();
+  crtTracks.clear();
+  crtTrackTrueIds.clear();
+  crtHitTimes.clear();
+  crtTrackTimes.clear();
+
+}
+
+// Add a true particle, replacing any earlier particle with the same track ID
+void CosmicIdTruthSummary::Add(const CosmicIdTrueParticle& particle){
+
+  trackIdIndex[particle.trackId] = particles.size();
+  particles.push_back(particle);
+  crossingsFilled.push_back(false);
+
+}
+
+// Add a CRT hit with its true ID, in collection order
+void CosmicIdTruthSummary::AddCrtHit(const sbn::crt::CRTHit& hit, int trueId){
+
+  crtHitTimes.emplace(hit.ts1_ns, crtHits.size());
+  crtHits.push_back(hit);
+  crtHitTrueIds.push_back(trueId);
+
+}
+
+// Add a CRT track with its true ID, in collection order
+void CosmicIdTruthSummary::AddCrtTrack(const sbn::crt::CRTTrack& track, int trueId){
+
+  crtTrackTimes.emplace(track.ts1_ns, crtTracks.size());
+  crtTracks.push_back(track);
+  crtTrackTrueIds.push_back(trueId);
+
+}
+
+// True particle by track ID, nullptr if it is not in the event
+const CosmicIdTrueParticle* CosmicIdTruthSummary::Particle(int trackId) const{
+
+  auto const it = trackIdIndex.find(trackId);
+  if(it == trackIdIndex.end()) return nullptr;
+  size_t const i = it->second;
+  if(!crossingsFilled[i] && fillCrossings){
+    fillCrossings(particles[i], i);
+    crossingsFilled[i] = true;
+  }
+  return &particles[i];
+
+}
+
+// Origin of a true particle by track ID, kNone if it is not in the event
+CosmicIdTruthType CosmicIdTruthSummary::Type(int trackId) const{
+
+  const CosmicIdTrueParticle* particle = Particle(trackId);
+  if(!particle) return CosmicIdTruthType::kNone;
+  return particle->type;
+
+}
+
+// Collection index of a CRT hit from the event, the last matching hit is used as in the backtracker
+size_t CosmicIdTruthSummary::CrtHitIndex(const sbn::crt::CRTHit& hit) const{
+
+  size_t index = crtHits.size();
+  auto const range = crtHitTimes.equal_range(hit.ts1_ns);
+  for(auto it = range.first; it != range.second; ++it){
+    if(CRTBackTracker::HitCompare(crtHits[it->second], hit)) index = it->second;
+  }
+  return index;
+
+}
+
+// Collection index of a CRT track from the event, the last matching track is used as in the backtracker
+size_t CosmicIdTruthSummary::CrtTrackIndex(const sbn::crt::CRTTrack& track) const{
+
+  size_t index = crtTracks.size();
+  auto const range = crtTrackTimes.equal_range(track.ts1_ns);
+  for(auto it = range.first; it != range.second; ++it){
+    if(CRTBackTracker::TrackCompare(crtTracks[it->second], track)) index = it->second;
+  }
+  return index;
+
+}
+
+// True ID of a CRT hit by collection index
+int CosmicIdTruthSummary::CrtHitTrueId(size_t hit_i) const{
+
+  if(hit_i >= crtHitTrueIds.size()) return -99999;
+  return crtHitTrueIds[hit_i];
+
+}
+
+// True ID of a CRT track by collection index
+int CosmicIdTruthSummary::CrtTrackTrueId(size_t track_i) const{
+
+  if(track_i >= crtTrackTrueIds.size()) return -99999;
+  return crtTrackTrueIds[track_i];
+
+}
+
+// True ID of a CRT hit from the event
+int CosmicIdTruthSummary::CrtHitTrueId(const sbn::crt::CRTHit& hit) const{
+
+  return CrtHitTrueId(CrtHitIndex(hit));
+
+}
+
+// True ID of a CRT track from the event
+int CosmicIdTruthSummary::CrtTrackTrueId(const sbn::crt::CRTTrack& track) const{
+
+  return CrtTrackTrueId(CrtTrackIndex(track));
+
+}
+
+}
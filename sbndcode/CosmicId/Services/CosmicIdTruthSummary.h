@@ -0,0 +1,101 @@
+#ifndef COSMICIDTRUTHSUMMARY_H_SEEN
+#define COSMICIDTRUTHSUMMARY_H_SEEN
+
+
+///////////////////////////////////////////////
+// CosmicIdTruthSummary.h
+//
+// Per-event truth information shared by the
+// cosmic ID analysers: the origin, containment and
+// TPC crossing points of every true particle and
+// the true IDs of the CRT hits and tracks.
+// Filled once per event by CosmicIdTruthService
+///////////////////////////////////////////////
+
+#include "sbnobj/Common/CRT/CRTHit.hh"
+#include "sbnobj/Common/CRT/CRTTrack.hh"
+
+// c++
+#include <vector>
+#include <unordered_map>
+#include <map>
+#include <functional>
+
+// ROOT
+#include "TVector3.h"
+
+namespace sbnd{
+
+  // Origin of a true particle as used by the cosmic ID analyses
+  enum class CosmicIdTruthType { kNone, kNuMu, kNu, kCr, kDirt };
+
+  // Truth information of one true particle
+  struct CosmicIdTrueParticle{
+    int trackId = -99999;
+    int pdg = -99999;
+    int mother = -99999;
+    CosmicIdTruthType type = CosmicIdTruthType::kNone;
+    double time = -99999;     // [ns]
+    double momentum = -99999; // [GeV]
+    TVector3 end {-99999, -99999, -99999};
+    // Ends inside the TPC
+    bool stops = false;
+    // Same as the TPCGeoAlg functions of the same meaning, only filled once the
+    // particle is looked up with CosmicIdTruthSummary::Particle
+    bool inTPC = false;
+    bool containedInTPC = false;
+    bool crossesApa = false;
+    TVector3 tpcStart {-99999, -99999, -99999};
+    TVector3 tpcEnd {-99999, -99999, -99999};
+    double tpcLength = 0;
+  };
+
+  struct CosmicIdTruthSummary{
+    // True particles in event order, the TPC crossing fields are filled on the first
+    // lookup with Particle() as most particles are never matched to a track
+    mutable std::vector<CosmicIdTrueParticle> particles;
+    mutable std::vector<bool> crossingsFilled;
+    std::unordered_map<int, size_t> trackIdIndex;
+    // Fills the TPC crossing fields of the particle at a position in the event
+    std::function<void(CosmicIdTrueParticle&, size_t)> fillCrossings;
+    // CRT hits and tracks in collection order with the true ID that deposited the most energy
+    std::vector<sbn::crt::CRTHit> crtHits;
+    std::vector<int> crtHitTrueIds;
+    std::vector<sbn::crt::CRTTrack> crtTracks;
+    std::vector<int> crtTrackTrueIds;
+    // Collection indices of the CRT hits and tracks by ts1_ns
+    std::multimap<double, size_t> crtHitTimes;
+    std::multimap<double, size_t> crtTrackTimes;
+
+    void Clear();
+
+    // Add a true particle, replacing any earlier particle with the same track ID
+    void Add(const CosmicIdTrueParticle& particle);
+
+    // Add a CRT hit or track with its true ID, in collection order
+    void AddCrtHit(const sbn::crt::CRTHit& hit, int trueId);
+    void AddCrtTrack(const sbn::crt::CRTTrack& track, int trueId);
+
+    // True particle by track ID, nullptr if it is not in the event
+    const CosmicIdTrueParticle* Particle(int trackId) const;
+
+    // Origin of a true particle by track ID, kNone if it is not in the event
+    CosmicIdTruthType Type(int trackId) const;
+
+    // Collection index of a CRT hit or track from the event, the size of the collection if
+    // it is not in the event. The last matching object is used as in the backtracker
+    size_t CrtHitIndex(const sbn::crt::CRTHit& hit) const;
+    size_t CrtTrackIndex(const sbn::crt::CRTTrack& track) const;
+
+    // True ID of a CRT hit or track by collection index, -99999 if it is not in the event
+    int CrtHitTrueId(size_t hit_i) const;
+    int CrtTrackTrueId(size_t track_i) const;
+
+    // True ID of a CRT hit or track from the event, -99999 if it is not in the event
+    int CrtHitTrueId(const sbn::crt::CRTHit& hit) const;
+    int CrtTrackTrueId(const sbn::crt::CRTTrack& track) const;
+  };
+
+}
+
+#endif
@@ -87,4 +87,32 @@ namespace sbnd{
     return beamFlash;
   }
 
+  // Minimum distance to the APA of a point drifted by each time and the time giving it
+  std::pair<double, double> CosmicIdUtils::MinApaDistance(double pointX, int driftDirection, const std::vector<double>& t0List,
+                                                          double driftVelocity, double apaX, double distanceLimit){
+
+    const double* t0s = t0List.data();
+    const size_t n = t0List.size();
+    const double maxX = apaX + distanceLimit;
+
+    double minDist = 99999;
+    double crossTime = -99999;
+    for(size_t i = 0; i < n; i++){
+      double t0 = t0s[i];
+      double shiftedX = pointX + driftDirection * (t0 * driftVelocity);
+      double absX = std::abs(shiftedX);
+      double dist = std::abs(absX - apaX);
+      // If particle crosses the APA before t = 0 the crossing point won't be reconstructed
+      // and the point must still be in the TPC
+      bool valid = !(t0 < 0) && !(absX > maxX);
+      if(valid && dist < minDist){
+        minDist = dist;
+        crossTime = t0;
+      }
+    }
+
+    return std::make_pair(minDist, crossTime);
+
+  }
+
 }
@@ -20,6 +20,7 @@
 // c++
 #include <vector>
 #include <utility>
+#include <cmath>
 
 namespace sbnd{
 namespace CosmicIdUtils{
@@ -29,6 +30,12 @@ namespace CosmicIdUtils{
 
   // Determine if there is a PDS flash in time with the neutrino beam
   bool BeamFlash(std::vector<double> flashes, double beamTimeMin, double beamTimeMax);
+
+  // Minimum distance to the APA at |x| = apaX of a point drifted towards it by each time in
+  // one sweep over the times, and the time giving it. Negative times and times moving the
+  // point further than distanceLimit beyond the APA are skipped, 99999 and -99999 if none pass
+  std::pair<double, double> MinApaDistance(double pointX, int driftDirection, const std::vector<double>& t0List,
+                                           double driftVelocity, double apaX, double distanceLimit);
   
 }
 }
@@ -11,14 +11,35 @@ CRTGeoAlg::CRTGeoAlg(geo::GeometryCore const *geometry, geo::AuxDetGeometryCore
   fGeometryService = geometry;
   fAuxDetGeoCore = auxdet_geometry;
 
-  // Keep track of which objects we've recorded
-  std::vector<std::string> usedTaggers;
-  std::vector<std::string> usedModules;
-  std::vector<std::string> usedStrips;
+  fNullTagger = {};
+  fNullTagger.null = true;
+  fNullModule = {};
+  fNullModule.null = true;
+  fNullStrip = {};
+  fNullStrip.null = true;
+
+  // Objects are first collected by name so the indices follow the name ordering
+  std::map<std::string, CRTTaggerGeo> taggers;
+  std::map<std::string, CRTModuleGeo> modules;
+  std::map<std::string, CRTStripGeo> strips;
+  std::map<uint32_t, CRTSipmGeo> sipms;
 
   // Get the auxdets (strip arrays for some reason)
   const std::vector<geo::AuxDetGeo>& auxDets = fAuxDetGeoCore->AuxDetGeoVec();
 
+  // Find the paths to all of the strips in one pass through the geometry
+  std::set<std::string> volNames;
+  for(auto const& auxDet : auxDets){
+    for(size_t i = 0; i < auxDet.NSensitiveVolume(); i++){
+      volNames.insert(auxDet.SensitiveVolume(i).TotalVolume()->GetName());
+    }
+  }
+  std::map<std::string, std::vector<TGeoNode const*>> volPaths;
+  for(auto const& path : fGeometryService->FindAllVolumePaths(volNames)){
+    // Keep the first path found for each volume
+    volPaths.emplace(path.back()->GetVolume()->GetName(), path);
+  }
+
   int ad_i = 0;
   // Loop over them
   for(auto const& auxDet : auxDets){
@@ -29,32 +50,18 @@ CRTGeoAlg::CRTGeoAlg(geo::GeometryCore const *geometry, geo::AuxDetGeometryCore
 
       // Get the geometry object for the strip
       geo::AuxDetSensitiveGeo const& auxDetSensitive = auxDet.SensitiveVolume(i);
-      std::set<std::string> volNames = {auxDetSensitive.TotalVolume()->GetName()};
-      std::vector<std::vector<TGeoNode const*>> paths = fGeometryService->FindAllVolumePaths(volNames);
-
-      // Build up a path that ROOT understands
-      std::string path = "";
-      for (size_t inode = 0; inode < paths.at(0).size(); inode++){
-        path += paths.at(0).at(inode)->GetName();
-        if(inode < paths.at(0).size() - 1){
-          path += "/";
-        }
-      }
-
-      // Access the path
-      TGeoManager* manager = fGeometryService->ROOTGeoManager();
-      manager->cd(path.c_str());
+      std::vector<TGeoNode const*> const& path = volPaths.at(auxDetSensitive.TotalVolume()->GetName());
+      size_t const depth = path.size();
 
       // Get all of the things we're intersted in in the path
-      TGeoNode* nodeStrip = manager->GetCurrentNode();
-      TGeoNode* nodeModule = manager->GetMother(2);
-      TGeoNode* nodeTagger = manager->GetMother(3);
-      TGeoNode* nodeDet = manager->GetMother(4);
+      TGeoNode const* nodeStrip = path[depth - 1];
+      TGeoNode const* nodeModule = path[depth - 3];
+      TGeoNode const* nodeTagger = path[depth - 4];
+      TGeoNode const* nodeDet = path[depth - 5];
 
       // Fill the tagger information
       std::string taggerName = nodeTagger->GetName();
-      if(std::find(usedTaggers.begin(), usedTaggers.end(), taggerName) == usedTaggers.end()){
-        usedTaggers.push_back(taggerName);
+      if(taggers.find(taggerName) == taggers.end()){
 
         // Get the limits in local coords
         double halfWidth = ((TGeoBBox*)nodeTagger->GetVolume()->GetShape())->GetDX();
@@ -84,13 +91,12 @@ CRTGeoAlg::CRTGeoAlg(geo::GeometryCore const *geometry, geo::AuxDetGeometryCore
         tagger.minZ = std::min(limitsWorld[2], limitsWorld2[2]);
         tagger.maxZ = std::max(limitsWorld[2], limitsWorld2[2]);
         tagger.null = false;
-        fTaggers[taggerName] = tagger;
+        taggers[taggerName] = tagger;
       }
 
       // Fill the module information
       std::string moduleName = nodeModule->GetName();
-      if(std::find(usedModules.begin(), usedModules.end(), moduleName) == usedModules.end()){
-        usedModules.push_back(moduleName);
+      if(modules.find(moduleName) == modules.end()){
 
         // Technically the auxdet is the strip array but this is basically the same as the module
         // Get the limits in local coordinates
@@ -130,13 +136,12 @@ CRTGeoAlg::CRTGeoAlg(geo::GeometryCore const *geometry, geo::AuxDetGeometryCore
         module.planeID = planeID;
         module.top = top;
         module.tagger = taggerName;
-        fModules[moduleName] = module;
+        modules[moduleName] = module;
       }
 
       // Fill the strip information
       std::string stripName = nodeStrip->GetName();
-      if(std::find(usedStrips.begin(), usedStrips.end(), stripName) == usedStrips.end()){
-        usedStrips.push_back(stripName);
+      if(strips.find(stripName) == strips.end()){
 
         // Get the limits in local coordinates
         double halfWidth = auxDetSensitive.HalfWidth1();
@@ -175,7 +180,7 @@ CRTGeoAlg::CRTGeoAlg(geo::GeometryCore const *geometry, geo::AuxDetGeometryCore
         double sipm1X = halfWidth;
         // In local coordinates the Y position is at half height (top if top) (bottom if not)
         double sipmY = halfHeight;
-        if(!fModules[moduleName].top) sipmY = - halfHeight;
+        if(!modules.at(moduleName).top) sipmY = - halfHeight;
         double sipm0XYZ[3] = {sipm0X, sipmY, 0};
         double sipm0XYZWorld[3];
         auxDetSensitive.LocalToWorld(sipm0XYZ, sipm0XYZWorld);
@@ -187,7 +192,7 @@ CRTGeoAlg::CRTGeoAlg(geo::GeometryCore const *geometry, geo::AuxDetGeometryCore
         sipm0.z = sipm0XYZWorld[2];
         sipm0.strip = stripName;
         sipm0.null = false;
-        fSipms[channel0] = sipm0;
+        sipms[channel0] = sipm0;
 
         double sipm1XYZ[3] = {sipm1X, sipmY, 0};
         double sipm1XYZWorld[3];
@@ -200,25 +205,68 @@ CRTGeoAlg::CRTGeoAlg(geo::GeometryCore const *geometry, geo::AuxDetGeometryCore
         sipm1.z = sipm1XYZWorld[2];
         sipm1.strip = stripName;
         sipm1.null = false;
-        fSipms[channel1] = sipm1;
+        sipms[channel1] = sipm1;
 
         strip.sipms = std::make_pair(channel0, channel1);
-        fStrips[stripName] = strip;
-        // Add the strip to the relevant module
-        fModules[moduleName].strips[stripName] = strip;
+        strips[stripName] = strip;
       }
       sv_i++;
     }
     ad_i++;
   }
 
-  // Need to fill the tagger modules after all the strip associations have been made
-  // Loop over the modules
-  for(auto const& module : fModules){
-    // Fill the tagger map
-    std::string taggerName = module.second.tagger;
-    std::string moduleName = module.second.name;
-    fTaggers[taggerName].modules[moduleName] = module.second;
+  // Flatten into vectors, the global index of an object is its position in the name ordering
+  for(auto const& tagger : taggers){
+    fTaggerIndices[tagger.first] = fTaggers.size();
+    fTaggers.push_back(tagger.second);
+  }
+  for(auto const& module : modules){
+    fModuleIndices[module.first] = fModules.size();
+    fModules.push_back(module.second);
+  }
+  for(auto const& strip : strips){
+    fStripIndices[strip.first] = fStrips.size();
+    fStrips.push_back(strip.second);
+  }
+
+  // Link the mothers and daughters, looping in index order keeps the daughters in name order
+  for(size_t module_i = 0; module_i < fModules.size(); module_i++){
+    CRTModuleGeo& module = fModules[module_i];
+    module.taggerIndex = fTaggerIndices.at(module.tagger);
+    fTaggers[module.taggerIndex].modules.push_back(module_i);
+  }
+  for(size_t strip_i = 0; strip_i < fStrips.size(); strip_i++){
+    CRTStripGeo& strip = fStrips[strip_i];
+    strip.moduleIndex = fModuleIndices.at(strip.module);
+    fModules[strip.moduleIndex].strips.push_back(strip_i);
+  }
+
+  // Null objects point past the end so chained lookups also give null objects
+  fNullModule.taggerIndex = fTaggers.size();
+  fNullStrip.moduleIndex = fModules.size();
+
+  // Sipms are looked up directly by channel
+  CRTSipmGeo nullSipm = {};
+  nullSipm.stripIndex = fStrips.size();
+  nullSipm.null = true;
+  if(!sipms.empty()) fSipms.resize(sipms.rbegin()->first + 1, nullSipm);
+  for(auto const& sipm : sipms){
+    fSipms[sipm.first] = sipm.second;
+    fSipms[sipm.first].stripIndex = fStripIndices.at(sipm.second.strip);
+  }
+
+  // Volume enclosed by all of the taggers
+  if(!fTaggers.empty()){
+    fCRTLimits = {fTaggers[0].minX, fTaggers[0].minY, fTaggers[0].minZ,
+                  fTaggers[0].maxX, fTaggers[0].maxY, fTaggers[0].maxZ};
+    for(auto const& tagger : fTaggers){
+      fCRTLimits[0] = std::min(fCRTLimits[0], tagger.minX);
+      fCRTLimits[1] = std::min(fCRTLimits[1], tagger.minY);
+      fCRTLimits[2] = std::min(fCRTLimits[2], tagger.minZ);
+      fCRTLimits[3] = std::max(fCRTLimits[3], tagger.maxX);
+      fCRTLimits[4] = std::max(fCRTLimits[4], tagger.maxY);
+      fCRTLimits[5] = std::max(fCRTLimits[5], tagger.maxZ);
+    }
   }
 
 }
@@ -231,30 +279,7 @@ CRTGeoAlg::~CRTGeoAlg(){
 // ----------------------------------------------------------------------------------
 // Return the volume enclosed by the whole CRT system
 std::vector<double> CRTGeoAlg::CRTLimits() const {
-  std::vector<double> limits;
-
-  std::vector<double> minXs;
-  std::vector<double> minYs;
-  std::vector<double> minZs;
-  std::vector<double> maxXs;
-  std::vector<double> maxYs;
-  std::vector<double> maxZs;
-  for(auto const& tagger : fTaggers){
-    minXs.push_back(tagger.second.minX);
-    minYs.push_back(tagger.second.minY);
-    minZs.push_back(tagger.second.minZ);
-    maxXs.push_back(tagger.second.maxX);
-    maxYs.push_back(tagger.second.maxY);
-    maxZs.push_back(tagger.second.maxZ);
-  }
-  limits.push_back(*std::min_element(minXs.begin(), minXs.end()));
-  limits.push_back(*std::min_element(minYs.begin(), minYs.end()));
-  limits.push_back(*std::min_element(minZs.begin(), minZs.end()));
-  limits.push_back(*std::max_element(maxXs.begin(), maxXs.end()));
-  limits.push_back(*std::max_element(maxYs.begin(), maxYs.end()));
-  limits.push_back(*std::max_element(maxZs.begin(), maxZs.end()));
-
-  return limits;
+  return fCRTLimits;
 }
 
 // ----------------------------------------------------------------------------------
@@ -272,16 +297,12 @@ size_t CRTGeoAlg::NumModules() const{
 
 // Get the number of modules in a tagger by name
 size_t CRTGeoAlg::NumModules(std::string taggerName) const{
-  CRTTaggerGeo tagger = GetTagger(taggerName);
-  if(!tagger.null) return tagger.modules.size();
-  return 0;
+  return GetTagger(taggerName).modules.size();
 }
 
 // Get the number of modules in a tagger by index
 size_t CRTGeoAlg::NumModules(size_t tagger_i) const{
-  CRTTaggerGeo tagger = GetTagger(tagger_i);
-  if(!tagger.null) return tagger.modules.size();
-  return 0;
+  return GetTagger(tagger_i).modules.size();
 }
 
 
@@ -293,173 +314,139 @@ size_t CRTGeoAlg::NumStrips() const{
 
 // Get the number of strips in module by name
 size_t CRTGeoAlg::NumStrips(std::string moduleName) const{
-  CRTModuleGeo module = GetModule(moduleName);
-  if(!module.null) return module.strips.size();
-  return 0;
+  return GetModule(moduleName).strips.size();
 }
 
 // Get the number of strips in  module by global index
 size_t CRTGeoAlg::NumStrips(size_t module_i) const{
-  CRTModuleGeo module = GetModule(module_i);
-  if(!module.null) return module.strips.size();
-  return 0;
+  return GetModule(module_i).strips.size();
 }
 
 // Get the number of strips in module by tagger index and local module index
 size_t CRTGeoAlg::NumStrips(size_t tagger_i, size_t module_i) const{
-  CRTModuleGeo module = GetModule(tagger_i, module_i);
-  if(!module.null) return module.strips.size();
-  return 0;
+  return GetModule(tagger_i, module_i).strips.size();
 }
 
 // ----------------------------------------------------------------------------------
 // Get the tagger geometry object by name
-CRTTaggerGeo CRTGeoAlg::GetTagger(std::string taggerName) const{
-  for(auto const& tagger : fTaggers){
-    if(taggerName == tagger.first) return tagger.second;
-  }
-  CRTTaggerGeo nullTagger = {};
-  nullTagger.null = true;
-  return nullTagger;
+const CRTTaggerGeo& CRTGeoAlg::GetTagger(std::string taggerName) const{
+  return GetTagger(TaggerIndex(taggerName));
 }
 
 // Get the tagger geometry object by index
-CRTTaggerGeo CRTGeoAlg::GetTagger(size_t tagger_i) const{
-  size_t index = 0;
-  for(auto const& tagger : fTaggers){
-    if(tagger_i == index) return tagger.second;
-    index++;
-  }
-  CRTTaggerGeo nullTagger = {};
-  nullTagger.null = true;
-  return nullTagger;
+const CRTTaggerGeo& CRTGeoAlg::GetTagger(size_t tagger_i) const{
+  if(tagger_i < fTaggers.size()) return fTaggers[tagger_i];
+  return fNullTagger;
 }
 
 
 // ----------------------------------------------------------------------------------
 // Get the module geometry object by name
-CRTModuleGeo CRTGeoAlg::GetModule(std::string moduleName) const{
-  for(auto const& module : fModules){
-    if(moduleName == module.first) return module.second;
-  }
-  CRTModuleGeo nullModule = {};
-  nullModule.null = true;
-  return nullModule;
+const CRTModuleGeo& CRTGeoAlg::GetModule(std::string moduleName) const{
+  return GetModule(ModuleIndex(moduleName));
 }
 
 // Get the module geometry object by global index
-CRTModuleGeo CRTGeoAlg::GetModule(size_t module_i) const{
-  size_t index = 0;
-  for(auto const& module : fModules){
-    if(module_i == index) return module.second;
-    index++;
-  }
-  CRTModuleGeo nullModule = {};
-  nullModule.null = true;
-  return nullModule;
+const CRTModuleGeo& CRTGeoAlg::GetModule(size_t module_i) const{
+  if(module_i < fModules.size()) return fModules[module_i];
+  return fNullModule;
 }
 
 // Get the module geometry object by tagger index and local module index
-CRTModuleGeo CRTGeoAlg::GetModule(size_t tagger_i, size_t module_i) const{
-  CRTModuleGeo nullModule = {};
-  nullModule.null = true;
-
-  CRTTaggerGeo tagger = GetTagger(tagger_i);
-  if(tagger.null) return nullModule;
-
-  size_t index = 0;
-  for(auto const& module : tagger.modules){
-    if(module_i == index) return module.second;
-    index++;
-  }
-  return nullModule;
+const CRTModuleGeo& CRTGeoAlg::GetModule(size_t tagger_i, size_t module_i) const{
+  const CRTTaggerGeo& tagger = GetTagger(tagger_i);
+  if(module_i < tagger.modules.size()) return fModules[tagger.modules[module_i]];
+  return fNullModule;
 }
 
 
 // ----------------------------------------------------------------------------------
 // Get the strip geometry object by name
-CRTStripGeo CRTGeoAlg::GetStrip(std::string stripName) const{
-  for(auto const& strip : fStrips){
-    if(stripName == strip.first) return strip.second;
-  }
-  CRTStripGeo nullStrip = {};
-  nullStrip.null = true;
-  return nullStrip;
+const CRTStripGeo& CRTGeoAlg::GetStrip(std::string stripName) const{
+  return GetStrip(StripIndex(stripName));
 }
 
 // Get the strip geometry object by global index
-CRTStripGeo CRTGeoAlg::GetStrip(size_t strip_i) const{
-  size_t index = 0;
-  for(auto const& strip : fStrips){
-    if(strip_i == index) return strip.second;
-    index++;
-  }
-  CRTStripGeo nullStrip = {};
-  nullStrip.null = true;
-  return nullStrip;
+const CRTStripGeo& CRTGeoAlg::GetStrip(size_t strip_i) const{
+  if(strip_i < fStrips.size()) return fStrips[strip_i];
+  return fNullStrip;
 }
 
 // Get the strip geometry object by global module index and local strip index
-CRTStripGeo CRTGeoAlg::GetStrip(size_t module_i, size_t strip_i) const{
-  CRTStripGeo nullStrip = {};
-  nullStrip.null = true;
-
-  CRTModuleGeo module = GetModule(module_i);
-  if(module.null) return nullStrip;
-
-  size_t index = 0;
-  for(auto const& strip : module.strips){
-    if(strip_i == index) return strip.second;
-    index++;
-  }
-  return nullStrip;
+const CRTStripGeo& CRTGeoAlg::GetStrip(size_t module_i, size_t strip_i) const{
+  const CRTModuleGeo& module = GetModule(module_i);
+  if(strip_i < module.strips.size()) return fStrips[module.strips[strip_i]];
+  return fNullStrip;
 }
 
 // Get the strip geometry object by tagger index, local module index and local strip index
-CRTStripGeo CRTGeoAlg::GetStrip(size_t tagger_i, size_t module_i, size_t strip_i) const{
-  CRTStripGeo nullStrip = {};
-  nullStrip.null = true;
+const CRTStripGeo& CRTGeoAlg::GetStrip(size_t tagger_i, size_t module_i, size_t strip_i) const{
+  const CRTModuleGeo& module = GetModule(tagger_i, module_i);
+  if(strip_i < module.strips.size()) return fStrips[module.strips[strip_i]];
+  return fNullStrip;
+}
 
-  CRTModuleGeo module = GetModule(tagger_i, module_i);
-  if(module.null) return nullStrip;
 
-  size_t index = 0;
-  for(auto const& strip : module.strips){
-    if(strip_i == index) return strip.second;
-    index++;
-  }
-  return nullStrip;
+// ----------------------------------------------------------------------------------
+// Get the global index of a tagger, module or strip by name
+size_t CRTGeoAlg::TaggerIndex(std::string taggerName) const{
+  auto it = fTaggerIndices.find(taggerName);
+  if(it != fTaggerIndices.end()) return it->second;
+  return fTaggers.size();
+}
+
+size_t CRTGeoAlg::ModuleIndex(std::string moduleName) const{
+  auto it = fModuleIndices.find(moduleName);
+  if(it != fModuleIndices.end()) return it->second;
+  return fModules.size();
+}
+
+size_t CRTGeoAlg::StripIndex(std::string stripName) const{
+  auto it = fStripIndices.find(stripName);
+  if(it != fStripIndices.end()) return it->second;
+  return fStrips.size();
 }
 
 
 // Get the tagger name from strip or module name
-std::string CRTGeoAlg::GetTaggerName(std::string name) const{
-  if(fModules.find(name) != fModules.end()){
-    return fModules.at(name).tagger;
+const std::string& CRTGeoAlg::GetTaggerName(std::string name) const{
+  size_t module_i = ModuleIndex(name);
+  if(module_i < fModules.size()){
+    return fModules[module_i].tagger;
   }
-  if(fStrips.find(name) != fStrips.end()){
-    return fModules.at(fStrips.at(name).module).tagger;
+  size_t strip_i = StripIndex(name);
+  if(strip_i < fStrips.size()){
+    return fModules[fStrips[strip_i].moduleIndex].tagger;
   }
-  return "";
+  return fNullTagger.name;
+}
+
+// Get the strip geometry object from the SiPM channel ID
+const CRTStripGeo& CRTGeoAlg::ChannelToStrip(size_t channel) const{
+  return GetStrip(ChannelToStripIndex(channel));
+}
+
+// Get the global strip index from the SiPM channel ID
+size_t CRTGeoAlg::ChannelToStripIndex(size_t channel) const{
+  if(channel < fSipms.size() && !fSipms[channel].null) return fSipms[channel].stripIndex;
+  return fStrips.size();
 }
 
 // Get the name of the strip from the SiPM channel ID
-std::string CRTGeoAlg::ChannelToStripName(size_t channel) const{
-  for(auto const& sipm : fSipms){
-    if(sipm.second.channel == channel){
-      return sipm.second.strip;
-    }
-  }
-  return "";
+const std::string& CRTGeoAlg::ChannelToStripName(size_t channel) const{
+  return ChannelToStrip(channel).name;
 }
 
 
 // Recalculate strip limits including charge sharing
 std::vector<double> CRTGeoAlg::StripLimitsWithChargeSharing(std::string stripName, double x, double ex){
-  int module = fModules.at(fStrips.at(stripName).module).auxDetID;
-  std::string moduleName = fGeometryService->AuxDet(module).TotalVolume()->GetName();
-  auto const& sensitiveGeo = fAuxDetGeoCore->ChannelToAuxDetSensitive(moduleName,
-                                                                      2*fStrips.at(stripName).sensitiveVolumeID);
+  return StripLimitsWithChargeSharing(fStrips.at(StripIndex(stripName)), x, ex);
+}
+
+std::vector<double> CRTGeoAlg::StripLimitsWithChargeSharing(const CRTStripGeo& strip, double x, double ex) const{
+  // The module auxdet and strip sensitive volume were recorded when building the geometry
+  int module = fModules.at(strip.moduleIndex).auxDetID;
+  auto const& sensitiveGeo = fAuxDetGeoCore->AuxDetGeoVec().at(module).SensitiveVolume(strip.sensitiveVolumeID);
 
   double halfWidth = sensitiveGeo.HalfWidth1();
   double halfHeight = sensitiveGeo.HalfHeight();
@@ -484,11 +471,9 @@ std::vector<double> CRTGeoAlg::StripLimitsWithChargeSharing(std::string stripNam
 
 // Get the world position of Sipm from the channel ID
 geo::Point_t CRTGeoAlg::ChannelToSipmPosition(size_t channel) const{
-  for(auto const& sipm : fSipms){
-    if(sipm.second.channel == channel){
-      geo::Point_t position {sipm.second.x, sipm.second.y, sipm.second.z};
-      return position;
-    }
+  if(channel < fSipms.size() && !fSipms[channel].null){
+    const CRTSipmGeo& sipm = fSipms[channel];
+    return geo::Point_t {sipm.x, sipm.y, sipm.z};
   }
   geo::Point_t null {-99999, -99999, -99999};
   return null;
@@ -496,30 +481,26 @@ geo::Point_t CRTGeoAlg::ChannelToSipmPosition(size_t channel) const{
 
 // Get the sipm channels on a strip
 std::pair<int, int> CRTGeoAlg::GetStripSipmChannels(std::string stripName) const{
-  for(auto const& strip : fStrips){
-    if(stripName == strip.first) return strip.second.sipms;
-  }
+  const CRTStripGeo& strip = GetStrip(stripName);
+  if(!strip.null) return strip.sipms;
   return std::make_pair(-99999, -99999);
 }
 
 // Return the distance to a sipm in the plane of the sipms
 double CRTGeoAlg::DistanceBetweenSipms(geo::Point_t position, size_t channel) const{
   double distance = -99999;
-
-  for(auto const& sipm : fSipms){
-    if(sipm.second.channel == channel){
-      geo::Point_t pos {sipm.second.x, sipm.second.y, sipm.second.z};
-      // Get the other sipm
-      int otherChannel = channel + 1;
-      if(channel % 2) otherChannel = channel - 1;
-      // Work out which coordinate is different
-      if(fSipms.at(otherChannel).x != pos.X()) distance = position.X() - pos.X();
-      if(fSipms.at(otherChannel).y != pos.Y()) distance = position.Y() - pos.Y();
-      if(fSipms.at(otherChannel).z != pos.Z()) distance = position.Z() - pos.Z();
-      // Return distance in that coordinate
-      return distance;
-    }
-  }
+  if(channel >= fSipms.size() || fSipms[channel].null) return distance;
+
+  const CRTSipmGeo& sipm = fSipms[channel];
+  // Get the other sipm
+  size_t otherChannel = channel + 1;
+  if(channel % 2) otherChannel = channel - 1;
+  const CRTSipmGeo& other = fSipms.at(otherChannel);
+  // Work out which coordinate is different
+  if(other.x != sipm.x) distance = position.X() - sipm.x;
+  if(other.y != sipm.y) distance = position.Y() - sipm.y;
+  if(other.z != sipm.z) distance = position.Z() - sipm.z;
+  // Return distance in that coordinate
   return distance;
 }
 
@@ -530,23 +511,28 @@ double CRTGeoAlg::DistanceBetweenSipms(geo::Point_t position, std::string stripN
   return sipmDist;
 }
 
+double CRTGeoAlg::DistanceBetweenSipms(geo::Point_t position, const CRTStripGeo& strip) const{
+  if(strip.null) return -99999;
+  return std::max(DistanceBetweenSipms(position, strip.sipms.first), DistanceBetweenSipms(position, strip.sipms.second));
+}
+
 // Return the distance along the strip (from sipm end)
 double CRTGeoAlg::DistanceDownStrip(geo::Point_t position, std::string stripName) const{
+  return DistanceDownStrip(position, GetStrip(stripName));
+}
+
+double CRTGeoAlg::DistanceDownStrip(geo::Point_t position, const CRTStripGeo& strip) const{
   double distance = -99999;
-  for(auto const& strip : fStrips){
-    if(stripName == strip.first){
-      geo::Point_t pos = ChannelToSipmPosition(strip.second.sipms.first);
-      // Work out the longest dimension of strip
-      double xdiff = std::abs(strip.second.maxX-strip.second.minX);
-      double ydiff = std::abs(strip.second.maxY-strip.second.minY);
-      double zdiff = std::abs(strip.second.maxZ-strip.second.minZ);
-      if(xdiff > ydiff && xdiff > zdiff) distance = position.X() - pos.X();
-      if(ydiff > xdiff && ydiff > zdiff) distance = position.Y() - pos.Y();
-      if(zdiff > xdiff && zdiff > ydiff) distance = position.Z() - pos.Z();
-      return std::abs(distance);
-    }
-  }
-  return distance;
+  if(strip.null) return distance;
+  geo::Point_t pos = ChannelToSipmPosition(strip.sipms.first);
+  // Work out the longest dimension of strip
+  double xdiff = std::abs(strip.maxX-strip.minX);
+  double ydiff = std::abs(strip.maxY-strip.minY);
+  double zdiff = std::abs(strip.maxZ-strip.minZ);
+  if(xdiff > ydiff && xdiff > zdiff) distance = position.X() - pos.X();
+  if(ydiff > xdiff && ydiff > zdiff) distance = position.Y() - pos.Y();
+  if(zdiff > xdiff && zdiff > ydiff) distance = position.Z() - pos.Z();
+  return std::abs(distance);
 }
 
 // ----------------------------------------------------------------------------------
@@ -557,7 +543,7 @@ bool CRTGeoAlg::IsInsideCRT(TVector3 point){
 }
 
 bool CRTGeoAlg::IsInsideCRT(geo::Point_t point){
-  std::vector<double> limits = CRTLimits();
+  const std::vector<double>& limits = fCRTLimits;
   if(point.X() > limits[0] && point.Y() > limits[1] && point.Z() > limits[2]
      && point.X() < limits[3] && point.Y() < limits[4] && point.Z() < limits[5]){
     return true;
@@ -568,7 +554,7 @@ bool CRTGeoAlg::IsInsideCRT(geo::Point_t point){
 // ----------------------------------------------------------------------------------
 // Determine if a point is inside a tagger by name
 bool CRTGeoAlg::IsInsideTagger(std::string taggerName, geo::Point_t point){
-  CRTTaggerGeo tagger = GetTagger(taggerName);
+  const CRTTaggerGeo& tagger = GetTagger(taggerName);
   return IsInsideTagger(tagger, point);
 }
 
@@ -590,7 +576,7 @@ bool CRTGeoAlg::IsInsideTagger(const CRTTaggerGeo& tagger, geo::Point_t point){
 // ----------------------------------------------------------------------------------
 // Determine if a point is inside a module by name
 bool CRTGeoAlg::IsInsideModule(std::string moduleName, geo::Point_t point){
-  CRTModuleGeo module = GetModule(moduleName);
+  const CRTModuleGeo& module = GetModule(moduleName);
   return IsInsideModule(module, point);
 }
 
@@ -616,7 +602,7 @@ bool CRTGeoAlg::IsInsideModule(const CRTModuleGeo& module, geo::Point_t point){
 // ----------------------------------------------------------------------------------
 // Determine if a point is inside a strip by name
 bool CRTGeoAlg::IsInsideStrip(std::string stripName, geo::Point_t point){
-  CRTStripGeo strip = GetStrip(stripName);
+  const CRTStripGeo& strip = GetStrip(stripName);
   return IsInsideStrip(strip, point);
 }
 
@@ -659,27 +645,31 @@ bool CRTGeoAlg::CheckOverlap(const CRTModuleGeo& module1, const CRTModuleGeo& mo
 // ----------------------------------------------------------------------------------
 // Check is a module overlaps with a perpendicual module in the same tagger
 bool CRTGeoAlg::HasOverlap(const CRTModuleGeo& module){
+  if(module.null) return false;
   // Record plane of mother module
   size_t planeID = module.planeID;
-  // Get mother tagger of module
-  std::string taggerName = module.tagger;
-  // Loop over other modules in tagger
-  for(auto const& module2 : fTaggers[taggerName].modules){
+  // Loop over other modules in the mother tagger
+  for(auto const& module2_i : GetTagger(module.taggerIndex).modules){
+    const CRTModuleGeo& module2 = fModules[module2_i];
     // If in other plane loop over strips
-    if(module2.second.planeID == planeID) continue;
+    if(module2.planeID == planeID) continue;
     // Check for overlaps
-    if(CheckOverlap(module, module2.second)) return true;
+    if(CheckOverlap(module, module2)) return true;
   }
   return false;
 }
 
 bool CRTGeoAlg::StripHasOverlap(std::string stripName){
-  return HasOverlap(fModules.at(fStrips.at(stripName).module));
+  return StripHasOverlap(fStrips.at(StripIndex(stripName)));
+}
+
+bool CRTGeoAlg::StripHasOverlap(const CRTStripGeo& strip){
+  return HasOverlap(fModules.at(strip.moduleIndex));
 }
 
 std::vector<double> CRTGeoAlg::StripOverlap(std::string strip1Name, std::string strip2Name){
-  auto const& strip1 = fStrips.at(strip1Name);
-  auto const& strip2 = fStrips.at(strip2Name);
+  auto const& strip1 = fStrips.at(StripIndex(strip1Name));
+  auto const& strip2 = fStrips.at(StripIndex(strip2Name));
 
   double minX = std::max(strip1.minX, strip2.minX);
   double maxX = std::min(strip1.maxX, strip2.maxY);
@@ -700,7 +690,7 @@ std::vector<double> CRTGeoAlg::StripOverlap(std::string strip1Name, std::string
 // ----------------------------------------------------------------------------------
 // Find the average of the tagger entry and exit points of a true particle trajectory
 geo::Point_t CRTGeoAlg::TaggerCrossingPoint(std::string taggerName, const simb::MCParticle& particle){
-  const CRTTaggerGeo& tagger = fTaggers.at(taggerName);
+  const CRTTaggerGeo& tagger = fTaggers.at(TaggerIndex(taggerName));
   return TaggerCrossingPoint(tagger, particle);
 }
 
@@ -734,7 +724,7 @@ bool CRTGeoAlg::CrossesTagger(const CRTTaggerGeo& tagger, const simb::MCParticle
 // ----------------------------------------------------------------------------------
 // Find the average of the module entry and exit points of a true particle trajectory
 geo::Point_t CRTGeoAlg::ModuleCrossingPoint(std::string moduleName, const simb::MCParticle& particle){
-  const CRTModuleGeo& module = fModules.at(moduleName);
+  const CRTModuleGeo& module = fModules.at(ModuleIndex(moduleName));
   return ModuleCrossingPoint(module, particle);
 }
 
@@ -787,7 +777,7 @@ bool CRTGeoAlg::CrossesModule(const CRTModuleGeo& module, const simb::MCParticle
 // ----------------------------------------------------------------------------------
 // Find the average of the strip entry and exit points of a true particle trajectory
 geo::Point_t CRTGeoAlg::StripCrossingPoint(std::string stripName, const simb::MCParticle& particle){
-  const CRTStripGeo& strip = fStrips.at(stripName);
+  const CRTStripGeo& strip = fStrips.at(StripIndex(stripName));
   return StripCrossingPoint(strip, particle);
 }
 
@@ -841,13 +831,15 @@ bool CRTGeoAlg::CrossesStrip(const CRTStripGeo& strip, const simb::MCParticle& p
 std::vector<std::string> CRTGeoAlg::CrossesStrips(const simb::MCParticle& particle){
   std::vector<std::string> stripNames;
   for(auto const& tagger : fTaggers){
-    if(!CrossesTagger(tagger.second, particle)) continue;
-    for(auto const& module : tagger.second.modules){
-      if(!CrossesModule(module.second, particle)) continue;
-      for(auto const& strip : module.second.strips){
-        if(!CrossesStrip(strip.second, particle)) continue;
-        if(std::find(stripNames.begin(), stripNames.end(), strip.first) != stripNames.end()) continue;
-        stripNames.push_back(strip.first);
+    if(!CrossesTagger(tagger, particle)) continue;
+    for(auto const& module_i : tagger.modules){
+      const CRTModuleGeo& module = fModules[module_i];
+      if(!CrossesModule(module, particle)) continue;
+      for(auto const& strip_i : module.strips){
+        const CRTStripGeo& strip = fStrips[strip_i];
+        if(!CrossesStrip(strip, particle)) continue;
+        if(std::find(stripNames.begin(), stripNames.end(), strip.name) != stripNames.end()) continue;
+        stripNames.push_back(strip.name);
       }
     }
   }
@@ -860,8 +852,9 @@ std::vector<std::string> CRTGeoAlg::CrossesStrips(const simb::MCParticle& partic
 double CRTGeoAlg::AngleToTagger(std::string taggerName, const simb::MCParticle& particle){
   // Get normal to tagger using the top modules
   TVector3 normal (0,0,0);
-  for(auto const& module : GetTagger(taggerName).modules){
-    normal.SetXYZ(module.second.normal.X(), module.second.normal.Y(), module.second.normal.Z());
+  for(auto const& module_i : GetTagger(taggerName).modules){
+    const CRTModuleGeo& module = fModules[module_i];
+    normal.SetXYZ(module.normal.X(), module.normal.Y(), module.normal.Z());
     break;
   }
   //FIXME this is pretty horrible
@@ -897,7 +890,6 @@ bool CRTGeoAlg::EntersVolume(const simb::MCParticle& particle){
   bool enters = false;
   bool startOutside = false;
   bool endOutside = false;
-  std::vector<double> limits = CRTLimits();
   for(size_t i = 0; i < particle.NumberTrajectoryPoints(); i++){
     geo::Point_t point {particle.Vx(i), particle.Vy(i), particle.Vz(i)};
     if(IsInsideCRT(point)){
@@ -916,7 +908,6 @@ bool CRTGeoAlg::CrossesVolume(const simb::MCParticle& particle){
   bool enters = false;
   bool startOutside = false;
   bool endOutside = false;
-  std::vector<double> limits = CRTLimits();
   for(size_t i = 0; i < particle.NumberTrajectoryPoints(); i++){
     geo::Point_t point {particle.Vx(i), particle.Vy(i), particle.Vz(i)};
     if(IsInsideCRT(point)){
@@ -935,10 +926,10 @@ bool CRTGeoAlg::CrossesVolume(const simb::MCParticle& particle){
 bool CRTGeoAlg::ValidCrossingPoint(std::string taggerName, const simb::MCParticle& particle){
 
   // Get all the crossed strips in the tagger
-  std::vector<std::string> crossedModules;
-  for(auto const& module : fTaggers[taggerName].modules){
-    geo::Point_t crossPoint = ModuleCrossingPoint(module.second.name, particle);
-    if(crossPoint.X() != -99999) crossedModules.push_back(module.second.name);
+  std::vector<size_t> crossedModules;
+  for(auto const& module_i : GetTagger(taggerName).modules){
+    geo::Point_t crossPoint = ModuleCrossingPoint(fModules[module_i], particle);
+    if(crossPoint.X() != -99999) crossedModules.push_back(module_i);
   }
 
   // Check if the strip has a possible overlap, return true if not
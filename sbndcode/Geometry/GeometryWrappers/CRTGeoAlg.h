@@ -29,6 +29,10 @@
 
 // c++
 #include <vector>
+#include <map>
+#include <set>
+#include <string>
+#include <unordered_map>
 
 // ROOT
 #include "TVector3.h"
@@ -36,12 +40,16 @@
 
 namespace sbnd{
 
+  // Geometry objects are stored in flat vectors inside CRTGeoAlg and refer to
+  // each other by index, names are kept for printing and name based lookups
+
   struct CRTSipmGeo{
     uint32_t channel;
     double x;
     double y;
     double z;
     std::string strip;
+    size_t stripIndex;
     bool null;
   };
 
@@ -58,6 +66,7 @@ namespace sbnd{
     geo::Vector_t normal;
     double width;
     std::string module;
+    size_t moduleIndex;
     std::pair<int, int> sipms;
     bool null;
   };
@@ -76,7 +85,9 @@ namespace sbnd{
     size_t planeID;
     bool top;
     std::string tagger;
-    std::map<std::string, CRTStripGeo> strips;
+    size_t taggerIndex;
+    // Global indices of the daughter strips, in name order
+    std::vector<size_t> strips;
     bool null;
   };
 
@@ -89,8 +100,8 @@ namespace sbnd{
     double maxY;
     double minZ;
     double maxZ;
-    // change to ref?
-    std::map<std::string, CRTModuleGeo> modules;
+    // Global indices of the daughter modules, in name order
+    std::vector<size_t> modules;
     bool null;
   };
 
@@ -126,31 +137,40 @@ namespace sbnd{
     size_t NumStrips(size_t tagger_i, size_t module_i) const;
 
     // Get the tagger geometry object by name
-    CRTTaggerGeo GetTagger(std::string taggerName) const;
+    const CRTTaggerGeo& GetTagger(std::string taggerName) const;
     // Get the tagger geometry object by index
-    CRTTaggerGeo GetTagger(size_t tagger_i) const;
+    const CRTTaggerGeo& GetTagger(size_t tagger_i) const;
 
     // Get the module geometry object by name
-    CRTModuleGeo GetModule(std::string moduleName) const;
+    const CRTModuleGeo& GetModule(std::string moduleName) const;
     // Get the module geometry object by global index
-    CRTModuleGeo GetModule(size_t module_i) const;
+    const CRTModuleGeo& GetModule(size_t module_i) const;
     // Get the module geometry object by tagger index and local module index
-    CRTModuleGeo GetModule(size_t tagger_i, size_t module_i) const;
+    const CRTModuleGeo& GetModule(size_t tagger_i, size_t module_i) const;
 
     // Get the strip geometry object by name
-    CRTStripGeo GetStrip(std::string stripName) const;
+    const CRTStripGeo& GetStrip(std::string stripName) const;
     // Get the strip geometry object by global index
-    CRTStripGeo GetStrip(size_t strip_i) const;
+    const CRTStripGeo& GetStrip(size_t strip_i) const;
     // Get the strip geometry object by global module index and local strip index
-    CRTStripGeo GetStrip(size_t module_i, size_t strip_i) const;
+    const CRTStripGeo& GetStrip(size_t module_i, size_t strip_i) const;
     // Get the strip geometry object by tagger index, local module index and local strip index
-    CRTStripGeo GetStrip(size_t tagger_i, size_t module_i, size_t strip_i) const;
+    const CRTStripGeo& GetStrip(size_t tagger_i, size_t module_i, size_t strip_i) const;
+
+    // Get the global index of a tagger, module or strip by name (NumTaggers(), NumModules() or NumStrips() if not found)
+    size_t TaggerIndex(std::string taggerName) const;
+    size_t ModuleIndex(std::string moduleName) const;
+    size_t StripIndex(std::string stripName) const;
 
     // Get tagger name from strip or module name
-    std::string GetTaggerName(std::string name) const;
+    const std::string& GetTaggerName(std::string name) const;
 
+    // Get the strip geometry object from the SiPM channel ID
+    const CRTStripGeo& ChannelToStrip(size_t channel) const;
+    // Get the global strip index from the SiPM channel ID (NumStrips() if not found)
+    size_t ChannelToStripIndex(size_t channel) const;
     // Get the name of the strip from the SiPM channel ID
-    std::string ChannelToStripName(size_t channel) const;
+    const std::string& ChannelToStripName(size_t channel) const;
 
     // Get the world position of Sipm from the channel ID
     geo::Point_t ChannelToSipmPosition(size_t channel) const;
@@ -160,13 +180,16 @@ namespace sbnd{
 
     // Recalculate strip limits including charge sharing
     std::vector<double> StripLimitsWithChargeSharing(std::string stripName, double x, double ex);
+    std::vector<double> StripLimitsWithChargeSharing(const CRTStripGeo& strip, double x, double ex) const;
 
     // Return the distance to a sipm in the plane of the sipms
     double DistanceBetweenSipms(geo::Point_t position, size_t channel) const;
     // Returns max distance from sipms in strip
     double DistanceBetweenSipms(geo::Point_t position, std::string stripName) const;
+    double DistanceBetweenSipms(geo::Point_t position, const CRTStripGeo& strip) const;
     // Return the distance along the strip (from sipm end)
     double DistanceDownStrip(geo::Point_t position, std::string stripName) const;
+    double DistanceDownStrip(geo::Point_t position, const CRTStripGeo& strip) const;
 
     // Determine if a point is inside CRT volume
     bool IsInsideCRT(TVector3 point);
@@ -186,6 +209,7 @@ namespace sbnd{
     // Check is a module overlaps with a perpendicual module in the same tagger
     bool HasOverlap(const CRTModuleGeo& module);
     bool StripHasOverlap(std::string stripName);
+    bool StripHasOverlap(const CRTStripGeo& strip);
     std::vector<double> StripOverlap(std::string strip1Name, std::string strip2Name);
 
     // Find the average of the tagger entry and exit points of a true particle trajectory
@@ -218,10 +242,25 @@ namespace sbnd{
 
   private:
 
-    std::map<std::string, CRTTaggerGeo> fTaggers;
-    std::map<std::string, CRTModuleGeo> fModules;
-    std::map<std::string, CRTStripGeo> fStrips;
-    std::map<int, CRTSipmGeo> fSipms;
+    // Geometry objects sorted by name, the position in the vector is the global index
+    std::vector<CRTTaggerGeo> fTaggers;
+    std::vector<CRTModuleGeo> fModules;
+    std::vector<CRTStripGeo> fStrips;
+    // Sipms indexed by channel ID, null where there is no channel
+    std::vector<CRTSipmGeo> fSipms;
+
+    // Name to global index, only used by the name based accessors
+    std::unordered_map<std::string, size_t> fTaggerIndices;
+    std::unordered_map<std::string, size_t> fModuleIndices;
+    std::unordered_map<std::string, size_t> fStripIndices;
+
+    // Returned by the accessors when the object doesn't exist
+    CRTTaggerGeo fNullTagger;
+    CRTModuleGeo fNullModule;
+    CRTStripGeo fNullStrip;
+
+    // Volume enclosed by the whole CRT system
+    std::vector<double> fCRTLimits;
 
     geo::GeometryCore const* fGeometryService;
     const geo::AuxDetGeometryCore* fAuxDetGeoCore;
@@ -0,0 +1,525 @@
+#include "ParticleCrossingCache.h"
+
+#include <algorithm>
+
+namespace sbnd{
+
+// ----------------------------------------------------------------------------------
+// Bounding volume hierarchy over the CRT boxes
+
+void ParticleCrossingCache::VolumeTree::Build(const std::vector<std::vector<double>>& limits, const std::vector<bool>& null){
+
+  fLimits = limits;
+  fNull = null;
+  fOrder.clear();
+  fNodes.clear();
+  for(size_t i = 0; i < fLimits.size(); i++){
+    if(!fNull[i]) fOrder.push_back(i);
+  }
+  if(fOrder.empty()) return;
+  fNodes.reserve(2 * fOrder.size());
+  BuildNode(0, fOrder.size());
+
+}
+
+size_t ParticleCrossingCache::VolumeTree::BuildNode(size_t begin, size_t end){
+
+  size_t node_i = fNodes.size();
+  fNodes.emplace_back();
+
+  // Node box is the union of the volume boxes
+  Node node;
+  for(size_t axis = 0; axis < 3; axis++){
+    node.limits[2*axis] = fLimits[fOrder[begin]][2*axis];
+    node.limits[2*axis+1] = fLimits[fOrder[begin]][2*axis+1];
+  }
+  for(size_t i = begin; i < end; i++){
+    for(size_t axis = 0; axis < 3; axis++){
+      node.limits[2*axis] = std::min(node.limits[2*axis], fLimits[fOrder[i]][2*axis]);
+      node.limits[2*axis+1] = std::max(node.limits[2*axis+1], fLimits[fOrder[i]][2*axis+1]);
+    }
+  }
+  node.begin = begin;
+  node.end = end;
+  node.left = 0;
+  node.right = 0;
+  node.leaf = (end - begin <= 4);
+
+  if(!node.leaf){
+    // Split at the median centre along the longest axis
+    size_t axis = 0;
+    for(size_t a = 1; a < 3; a++){
+      if(node.limits[2*a+1] - node.limits[2*a] > node.limits[2*axis+1] - node.limits[2*axis]) axis = a;
+    }
+    size_t mid = (begin + end) / 2;
+    std::nth_element(fOrder.begin() + begin, fOrder.begin() + mid, fOrder.begin() + end,
+                     [this, axis](size_t a, size_t b){
+                       return fLimits[a][2*axis] + fLimits[a][2*axis+1] < fLimits[b][2*axis] + fLimits[b][2*axis+1];
+                     });
+    node.left = BuildNode(begin, mid);
+    node.right = BuildNode(mid, end);
+  }
+
+  fNodes[node_i] = node;
+  return node_i;
+
+}
+
+bool ParticleCrossingCache::VolumeTree::IsInside(size_t volume_i, const geo::Point_t& point) const{
+
+  if(fNull[volume_i]) return false;
+  const std::vector<double>& limits = fLimits[volume_i];
+  double x = point.X();
+  double y = point.Y();
+  double z = point.Z();
+  if(x > limits[0] && x < limits[1] && y > limits[2] && y < limits[3] && z > limits[4] && z < limits[5]) return true;
+  return false;
+
+}
+
+void ParticleCrossingCache::VolumeTree::Find(const geo::Point_t& point, std::vector<size_t>& volumes) const{
+
+  volumes.clear();
+  if(fNodes.empty()) return;
+
+  double pos[3] = {point.X(), point.Y(), point.Z()};
+  size_t stack[64];
+  size_t depth = 0;
+  stack[depth++] = 0;
+  while(depth > 0){
+    const Node& node = fNodes[stack[--depth]];
+    // A point strictly inside a volume is never outside the node box
+    bool outside = false;
+    for(size_t axis = 0; axis < 3; axis++){
+      if(pos[axis] < node.limits[2*axis] || pos[axis] > node.limits[2*axis+1]) outside = true;
+    }
+    if(outside) continue;
+    if(node.leaf){
+      for(size_t i = node.begin; i < node.end; i++){
+        if(IsInside(fOrder[i], point)) volumes.push_back(fOrder[i]);
+      }
+      continue;
+    }
+    stack[depth++] = node.left;
+    stack[depth++] = node.right;
+  }
+
+}
+
+
+// ----------------------------------------------------------------------------------
+// Constructor - build the volume trees from the CRT geometry
+ParticleCrossingCache::ParticleCrossingCache(geo::GeometryCore const *geometry, geo::AuxDetGeometryCore const *auxdet_geometry) :
+  fTpcGeo(geometry),
+  fCrtGeo(geometry, auxdet_geometry)
+{
+
+  std::vector<std::vector<double>> limits;
+  std::vector<bool> null;
+
+  for(size_t i = 0; i < fCrtGeo.NumTaggers(); i++){
+    const CRTTaggerGeo& tagger = fCrtGeo.GetTagger(i);
+    limits.push_back({tagger.minX, tagger.maxX, tagger.minY, tagger.maxY, tagger.minZ, tagger.maxZ});
+    null.push_back(tagger.null);
+  }
+  fTaggerTree.Build(limits, null);
+
+  limits.clear();
+  null.clear();
+  for(size_t i = 0; i < fCrtGeo.NumModules(); i++){
+    const CRTModuleGeo& module = fCrtGeo.GetModule(i);
+    limits.push_back({module.minX, module.maxX, module.minY, module.maxY, module.minZ, module.maxZ});
+    null.push_back(module.null);
+  }
+  fModuleTree.Build(limits, null);
+
+  limits.clear();
+  null.clear();
+  for(size_t i = 0; i < fCrtGeo.NumStrips(); i++){
+    const CRTStripGeo& strip = fCrtGeo.GetStrip(i);
+    limits.push_back({strip.minX, strip.maxX, strip.minY, strip.maxY, strip.minZ, strip.maxZ});
+    null.push_back(strip.null);
+  }
+  fStripTree.Build(limits, null);
+
+  fCRTLimits = fCrtGeo.CRTLimits();
+
+  size_t nVolumes = std::max({fTaggerTree.Size(), fModuleTree.Size(), fStripTree.Size()});
+  fStates.resize(nVolumes);
+  fMarks.resize(nVolumes, 0);
+
+}
+
+ParticleCrossingCache::ParticleCrossingCache() :
+  ParticleCrossingCache::ParticleCrossingCache(lar::providerFrom<geo::Geometry>(), ((const geo::AuxDetGeometry*)&(*art::ServiceHandle<geo::AuxDetGeometry>()))->GetProviderPtr())
+{}
+
+
+ParticleCrossingCache::~ParticleCrossingCache(){
+
+}
+
+// ----------------------------------------------------------------------------------
+// Filling and access
+void ParticleCrossingCache::Clear(){
+
+  fCrossings.clear();
+  fTrackIdIndex.clear();
+
+}
+
+void ParticleCrossingCache::Fill(const std::vector<simb::MCParticle>& particles){
+
+  Clear();
+  fCrossings.resize(particles.size());
+  fTrackIdIndex.reserve(particles.size());
+  for(size_t i = 0; i < particles.size(); i++){
+    WalkVolumes(particles[i], fCrossings[i]);
+    WalkCRT(particles[i], fCrossings[i]);
+    fTrackIdIndex[particles[i].TrackId()] = i;
+  }
+
+}
+
+const ParticleCrossings& ParticleCrossingCache::Crossings(const simb::MCParticle& particle){
+
+  ParticleCrossings& crossings = Entry(particle);
+  if(!crossings.crtVolumesFilled) WalkCRT(particle, crossings);
+  return crossings;
+
+}
+
+// Cached entry of a particle, with the TPC and CRT volume crossings filled
+ParticleCrossings& ParticleCrossingCache::Entry(const simb::MCParticle& particle){
+
+  auto it = fTrackIdIndex.find(particle.TrackId());
+  if(it != fTrackIdIndex.end()) return fCrossings[it->second];
+
+  fTrackIdIndex[particle.TrackId()] = fCrossings.size();
+  fCrossings.emplace_back();
+  WalkVolumes(particle, fCrossings.back());
+  return fCrossings.back();
+
+}
+
+// ----------------------------------------------------------------------------------
+// Walk a trajectory once and record its TPC and CRT volume crossings
+void ParticleCrossingCache::WalkVolumes(const simb::MCParticle& particle, ParticleCrossings& crossings){
+
+  crossings = ParticleCrossings();
+
+  double minX = fTpcGeo.MinX();
+  double minY = fTpcGeo.MinY();
+  double minZ = fTpcGeo.MinZ();
+  double maxX = fTpcGeo.MaxX();
+  double maxY = fTpcGeo.MaxY();
+  double maxZ = fTpcGeo.MaxZ();
+  const std::vector<double>& crt = fCRTLimits;
+
+  size_t nPoints = particle.NumberTrajectoryPoints();
+  bool first = true;
+  TVector3 point, disp;
+  for(size_t i = 0; i < nPoints; i++){
+    double x = particle.Vx(i);
+    double y = particle.Vy(i);
+    double z = particle.Vz(i);
+
+    // TPC volume
+    if(x > minX && y > minY && z > minZ && x < maxX && y < maxY && z < maxZ){
+      crossings.inTPC = true;
+      if(first) crossings.tpcStart.SetXYZ(x, y, z);
+      crossings.tpcEnd.SetXYZ(x, y, z);
+      point.SetXYZ(x, y, z);
+      if(!first){
+        disp -= point;
+        crossings.tpcLength += disp.Mag();
+      }
+      first = false;
+      disp = point;
+    }
+    else if(i == 0) crossings.tpcStartOutside = true;
+    else if(i == nPoints-1) crossings.tpcEndOutside = true;
+
+    if(x < minX || y < minY || z < minZ || x > maxX || y > maxY || z > maxZ){
+      crossings.containedInTPC = false;
+    }
+
+    // APA crossings
+    if(i < nPoints-1 && !crossings.crossesApa){
+      double x1 = particle.Vx(i+1);
+      double y1 = particle.Vy(i+1);
+      double z1 = particle.Vz(i+1);
+      if(y >= minY && z >= minZ && y <= maxY && z <= maxZ
+         && y1 >= minY && z1 >= minZ && y1 <= maxY && z1 <= maxZ){
+        if(x <= minX && x1 >= minX) crossings.crossesApa = true;
+        if(x >= minX && x1 <= minX) crossings.crossesApa = true;
+        if(x <= maxX && x1 >= maxX) crossings.crossesApa = true;
+        if(x >= maxX && x1 <= maxX) crossings.crossesApa = true;
+      }
+    }
+
+    // Whole CRT volume
+    if(x > crt[0] && y > crt[1] && z > crt[2] && x < crt[3] && y < crt[4] && z < crt[5]){
+      crossings.inCRT = true;
+    }
+    else if(i == 0) crossings.crtStartOutside = true;
+    else if(i == nPoints-1) crossings.crtEndOutside = true;
+  }
+
+}
+
+// Walk a trajectory once and record the crossed taggers, modules and strips
+void ParticleCrossingCache::WalkCRT(const simb::MCParticle& particle, ParticleCrossings& crossings){
+
+  WalkPoints(particle, fTaggerTree, crossings.taggers);
+  WalkMidPoints(particle, fModuleTree, crossings.modules);
+  WalkMidPoints(particle, fStripTree, crossings.strips);
+  crossings.crtVolumesFilled = true;
+
+}
+
+// Volumes containing the trajectory points only
+void ParticleCrossingCache::WalkPoints(const simb::MCParticle& particle, const VolumeTree& tree,
+                                       std::vector<std::pair<size_t, geo::Point_t>>& crossed){
+
+  fTouched.clear();
+  for(size_t i = 0; i < particle.NumberTrajectoryPoints(); i++){
+    geo::Point_t point {particle.Vx(i), particle.Vy(i), particle.Vz(i)};
+    tree.Find(point, fPointVolumes);
+    for(auto const volume_i : fPointVolumes){
+      VolumeCrossing& state = fStates[volume_i];
+      if(state.first){
+        state.entry = point;
+        state.first = false;
+        fTouched.push_back(volume_i);
+      }
+      state.exit = point;
+    }
+  }
+
+  std::sort(fTouched.begin(), fTouched.end());
+  crossed.clear();
+  for(auto const volume_i : fTouched){
+    VolumeCrossing& state = fStates[volume_i];
+    geo::Point_t cross {(state.entry.X()+state.exit.X())/2., (state.entry.Y()+state.exit.Y())/2., (state.entry.Z()+state.exit.Z())/2};
+    crossed.emplace_back(volume_i, cross);
+    state = VolumeCrossing();
+  }
+
+}
+
+// Volumes containing the trajectory points or the mid points of the steps
+void ParticleCrossingCache::WalkMidPoints(const simb::MCParticle& particle, const VolumeTree& tree,
+                                          std::vector<std::pair<size_t, geo::Point_t>>& crossed){
+
+  fTouched.clear();
+  size_t nPoints = particle.NumberTrajectoryPoints();
+  for(size_t i = 0; i < nPoints; i++){
+    geo::Point_t point {particle.Vx(i), particle.Vy(i), particle.Vz(i)};
+    bool last = (i == nPoints-1);
+    geo::Point_t next, mid;
+
+    // Mark the volumes containing the mid point with the next point
+    fMark++;
+    tree.Find(point, fPointVolumes);
+    fMidVolumes.clear();
+    if(!last){
+      next = geo::Point_t {particle.Vx(i+1), particle.Vy(i+1), particle.Vz(i+1)};
+      mid = geo::Point_t {(point.X()+next.X())/2, (point.Y()+next.Y())/2, (point.Z()+next.Z())/2};
+      tree.Find(mid, fMidVolumes);
+      for(auto const volume_i : fMidVolumes) fMarks[volume_i] = fMark;
+    }
+
+    // Volumes containing the point, extended to the mid point if that is inside too
+    for(auto const volume_i : fPointVolumes){
+      VolumeCrossing& state = fStates[volume_i];
+      if(state.first){
+        state.entry = point;
+        state.first = false;
+        fTouched.push_back(volume_i);
+      }
+      state.exit = point;
+      if(!last && fMarks[volume_i] == fMark) state.exit = mid;
+      // Don't treat it again as a mid point only volume
+      fMarks[volume_i] = 0;
+    }
+
+    // Volumes containing only the mid point, extended to the next mid point
+    for(auto const volume_i : fMidVolumes){
+      if(fMarks[volume_i] != fMark) continue;
+      VolumeCrossing& state = fStates[volume_i];
+      if(state.first){
+        state.entry = mid;
+        state.first = false;
+        fTouched.push_back(volume_i);
+      }
+      state.exit = mid;
+      geo::Point_t quarter {(mid.X()+next.X())/2, (mid.Y()+next.Y())/2, (mid.Z()+next.Z())/2};
+      if(tree.IsInside(volume_i, quarter)) state.exit = quarter;
+    }
+  }
+
+  std::sort(fTouched.begin(), fTouched.end());
+  crossed.clear();
+  for(auto const volume_i : fTouched){
+    VolumeCrossing& state = fStates[volume_i];
+    geo::Point_t cross {(state.entry.X()+state.exit.X())/2., (state.entry.Y()+state.exit.Y())/2., (state.entry.Z()+state.exit.Z())/2};
+    crossed.emplace_back(volume_i, cross);
+    state = VolumeCrossing();
+  }
+
+}
+
+// Crossing point of a volume, -99999 if not crossed
+geo::Point_t ParticleCrossingCache::CrossingPoint(const std::vector<std::pair<size_t, geo::Point_t>>& crossed, size_t volume_i){
+
+  auto it = std::lower_bound(crossed.begin(), crossed.end(), volume_i,
+                             [](const std::pair<size_t, geo::Point_t>& a, size_t i){ return a.first < i; });
+  if(it != crossed.end() && it->first == volume_i) return it->second;
+  return geo::Point_t {-99999, -99999, -99999};
+
+}
+
+// Check if a volume is crossed
+bool ParticleCrossingCache::IsCrossed(const std::vector<std::pair<size_t, geo::Point_t>>& crossed, size_t volume_i){
+
+  auto it = std::lower_bound(crossed.begin(), crossed.end(), volume_i,
+                             [](const std::pair<size_t, geo::Point_t>& a, size_t i){ return a.first < i; });
+  return it != crossed.end() && it->first == volume_i;
+
+}
+
+// ----------------------------------------------------------------------------------
+// TPC queries
+bool ParticleCrossingCache::InTPC(const simb::MCParticle& particle){
+  return Entry(particle).inTPC;
+}
+
+bool ParticleCrossingCache::ContainedInTPC(const simb::MCParticle& particle){
+  return Entry(particle).containedInTPC;
+}
+
+bool ParticleCrossingCache::EntersTPC(const simb::MCParticle& particle){
+  const ParticleCrossings& crossings = Entry(particle);
+  return crossings.inTPC && (crossings.tpcStartOutside || crossings.tpcEndOutside);
+}
+
+bool ParticleCrossingCache::CrossesTPC(const simb::MCParticle& particle){
+  const ParticleCrossings& crossings = Entry(particle);
+  return crossings.tpcStartOutside && crossings.inTPC && crossings.tpcEndOutside;
+}
+
+bool ParticleCrossingCache::CrossesApa(const simb::MCParticle& particle){
+  return Entry(particle).crossesApa;
+}
+
+std::pair<TVector3, TVector3> ParticleCrossingCache::TPCCrossingPoints(const simb::MCParticle& particle){
+  const ParticleCrossings& crossings = Entry(particle);
+  return std::make_pair(crossings.tpcStart, crossings.tpcEnd);
+}
+
+double ParticleCrossingCache::TpcLength(const simb::MCParticle& particle){
+  return Entry(particle).tpcLength;
+}
+
+// ----------------------------------------------------------------------------------
+// CRT queries
+bool ParticleCrossingCache::EntersCRT(const simb::MCParticle& particle){
+  const ParticleCrossings& crossings = Entry(particle);
+  return crossings.inCRT && (crossings.crtStartOutside || crossings.crtEndOutside);
+}
+
+bool ParticleCrossingCache::CrossesCRT(const simb::MCParticle& particle){
+  const ParticleCrossings& crossings = Entry(particle);
+  return crossings.crtStartOutside && crossings.inCRT && crossings.crtEndOutside;
+}
+
+geo::Point_t ParticleCrossingCache::TaggerCrossingPoint(std::string taggerName, const simb::MCParticle& particle){
+  size_t tagger_i = fCrtGeo.TaggerIndex(taggerName);
+  if(tagger_i >= fCrtGeo.NumTaggers())
+    throw cet::exception("ParticleCrossingCache") << "No CRT tagger called " << taggerName << "\n";
+  return TaggerCrossingPoint(tagger_i, particle);
+}
+
+geo::Point_t ParticleCrossingCache::TaggerCrossingPoint(size_t tagger_i, const simb::MCParticle& particle){
+  return CrossingPoint(Crossings(particle).taggers, tagger_i);
+}
+
+bool ParticleCrossingCache::CrossesTagger(size_t tagger_i, const simb::MCParticle& particle){
+  return IsCrossed(Crossings(particle).taggers, tagger_i);
+}
+
+geo::Point_t ParticleCrossingCache::ModuleCrossingPoint(std::string moduleName, const simb::MCParticle& particle){
+  size_t module_i = fCrtGeo.ModuleIndex(moduleName);
+  if(module_i >= fCrtGeo.NumModules())
+    throw cet::exception("ParticleCrossingCache") << "No CRT module called " << moduleName << "\n";
+  return ModuleCrossingPoint(module_i, particle);
+}
+
+geo::Point_t ParticleCrossingCache::ModuleCrossingPoint(size_t module_i, const simb::MCParticle& particle){
+  return CrossingPoint(Crossings(particle).modules, module_i);
+}
+
+bool ParticleCrossingCache::CrossesModule(size_t module_i, const simb::MCParticle& particle){
+  return IsCrossed(Crossings(particle).modules, module_i);
+}
+
+geo::Point_t ParticleCrossingCache::StripCrossingPoint(std::string stripName, const simb::MCParticle& particle){
+  size_t strip_i = fCrtGeo.StripIndex(stripName);
+  if(strip_i >= fCrtGeo.NumStrips())
+    throw cet::exception("ParticleCrossingCache") << "No CRT strip called " << stripName << "\n";
+  return StripCrossingPoint(strip_i, particle);
+}
+
+geo::Point_t ParticleCrossingCache::StripCrossingPoint(size_t strip_i, const simb::MCParticle& particle){
+  return CrossingPoint(Crossings(particle).strips, strip_i);
+}
+
+bool ParticleCrossingCache::CrossesStrip(size_t strip_i, const simb::MCParticle& particle){
+  return IsCrossed(Crossings(particle).strips, strip_i);
+}
+
+// Work out which strips the true particle crosses
+std::vector<std::string> ParticleCrossingCache::CrossesStrips(const simb::MCParticle& particle){
+  const ParticleCrossings& crossings = Crossings(particle);
+  std::vector<std::string> stripNames;
+  for(size_t tagger_i = 0; tagger_i < fCrtGeo.NumTaggers(); tagger_i++){
+    if(!IsCrossed(crossings.taggers, tagger_i)) continue;
+    for(auto const& module_i : fCrtGeo.GetTagger(tagger_i).modules){
+      if(!IsCrossed(crossings.modules, module_i)) continue;
+      for(auto const& strip_i : fCrtGeo.GetModule(module_i).strips){
+        if(!IsCrossed(crossings.strips, strip_i)) continue;
+        const CRTStripGeo& strip = fCrtGeo.GetStrip(strip_i);
+        if(std::find(stripNames.begin(), stripNames.end(), strip.name) != stripNames.end()) continue;
+        stripNames.push_back(strip.name);
+      }
+    }
+  }
+  return stripNames;
+}
+
+// Determine if a particle would be able to produce a hit in a tagger
+bool ParticleCrossingCache::ValidCrossingPoint(std::string taggerName, const simb::MCParticle& particle){
+
+  const ParticleCrossings& crossings = Crossings(particle);
+
+  // Get all the crossed modules in the tagger
+  std::vector<size_t> crossedModules;
+  for(auto const& module_i : fCrtGeo.GetTagger(taggerName).modules){
+    geo::Point_t crossPoint = CrossingPoint(crossings.modules, module_i);
+    if(crossPoint.X() != -99999) crossedModules.push_back(module_i);
+  }
+
+  // Check if the module has a possible overlap, return true if not
+  for(size_t i = 0; i < crossedModules.size(); i++){
+    if(!fCrtGeo.HasOverlap(fCrtGeo.GetModule(crossedModules[i]))) return true;
+    // Check if any of the crossed modules overlap, return true if they do
+    for(size_t j = i; j < crossedModules.size(); j++){
+      if(fCrtGeo.CheckOverlap(fCrtGeo.GetModule(crossedModules[i]), fCrtGeo.GetModule(crossedModules[j]))) return true;
+    }
+  }
+  return false;
+
+}
+
+}
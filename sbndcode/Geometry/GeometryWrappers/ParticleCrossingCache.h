@@ -0,0 +1,189 @@
+#ifndef PARTICLECROSSINGCACHE_H_SEEN
+#define PARTICLECROSSINGCACHE_H_SEEN
+
+
+///////////////////////////////////////////////
+// ParticleCrossingCache.h
+//
+// Per-event cache of where true particles cross
+// the TPC and the CRT taggers, modules and strips.
+// Each trajectory is walked once when the cache is
+// filled, volumes are found through a bounding
+// volume hierarchy, and the TPCGeoAlg/CRTGeoAlg
+// particle queries are answered from the cache
+// with identical results.
+///////////////////////////////////////////////
+
+// framework
+#include "cetlib_except/exception.h"
+
+// LArSoft
+#include "nusimdata/SimulationBase/MCParticle.h"
+#include "larcoreobj/SimpleTypesAndConstants/geo_types.h"
+
+#include "sbndcode/Geometry/GeometryWrappers/TPCGeoAlg.h"
+#include "sbndcode/Geometry/GeometryWrappers/CRTGeoAlg.h"
+
+// c++
+#include <vector>
+#include <string>
+#include <utility>
+#include <unordered_map>
+
+// ROOT
+#include "TVector3.h"
+
+namespace sbnd{
+
+  // Everything the geometry queries need to know about one true particle
+  struct ParticleCrossings{
+    // TPC volume
+    bool inTPC = false;
+    bool containedInTPC = true;
+    bool tpcStartOutside = false;
+    bool tpcEndOutside = false;
+    bool crossesApa = false;
+    TVector3 tpcStart {-99999, -99999, -99999};
+    TVector3 tpcEnd {-99999, -99999, -99999};
+    double tpcLength = 0;
+    // Whole CRT volume
+    bool inCRT = false;
+    bool crtStartOutside = false;
+    bool crtEndOutside = false;
+    // Crossed taggers, modules and strips by global index, sorted by index,
+    // with the average of the entry and exit points. Only walked once a
+    // tagger, module or strip query is made for the particle
+    bool crtVolumesFilled = false;
+    std::vector<std::pair<size_t, geo::Point_t>> taggers;
+    std::vector<std::pair<size_t, geo::Point_t>> modules;
+    std::vector<std::pair<size_t, geo::Point_t>> strips;
+  };
+
+
+  class ParticleCrossingCache {
+  public:
+
+    ParticleCrossingCache(geo::GeometryCore const *geometry, geo::AuxDetGeometryCore const *auxdet_geometry);
+    ParticleCrossingCache();
+
+    ~ParticleCrossingCache();
+
+    // Remove all the cached particles, call at the start of every event
+    void Clear();
+
+    // Replace the cache with the crossings of a new set of particles
+    void Fill(const std::vector<simb::MCParticle>& particles);
+
+    // All the crossings of a particle by track ID, particles that are not
+    // in the cache yet are walked and added. The reference is only valid
+    // until the next particle is added
+    const ParticleCrossings& Crossings(const simb::MCParticle& particle);
+
+    // Same as the TPCGeoAlg functions of the same meaning
+    bool InTPC(const simb::MCParticle& particle);
+    bool ContainedInTPC(const simb::MCParticle& particle);
+    bool EntersTPC(const simb::MCParticle& particle);
+    bool CrossesTPC(const simb::MCParticle& particle);
+    bool CrossesApa(const simb::MCParticle& particle);
+    std::pair<TVector3, TVector3> TPCCrossingPoints(const simb::MCParticle& particle);
+    double TpcLength(const simb::MCParticle& particle);
+
+    // Same as the CRTGeoAlg functions of the same meaning
+    bool EntersCRT(const simb::MCParticle& particle);
+    bool CrossesCRT(const simb::MCParticle& particle);
+    geo::Point_t TaggerCrossingPoint(std::string taggerName, const simb::MCParticle& particle);
+    geo::Point_t TaggerCrossingPoint(size_t tagger_i, const simb::MCParticle& particle);
+    bool CrossesTagger(size_t tagger_i, const simb::MCParticle& particle);
+    geo::Point_t ModuleCrossingPoint(std::string moduleName, const simb::MCParticle& particle);
+    geo::Point_t ModuleCrossingPoint(size_t module_i, const simb::MCParticle& particle);
+    bool CrossesModule(size_t module_i, const simb::MCParticle& particle);
+    geo::Point_t StripCrossingPoint(std::string stripName, const simb::MCParticle& particle);
+    geo::Point_t StripCrossingPoint(size_t strip_i, const simb::MCParticle& particle);
+    bool CrossesStrip(size_t strip_i, const simb::MCParticle& particle);
+    std::vector<std::string> CrossesStrips(const simb::MCParticle& particle);
+    bool ValidCrossingPoint(std::string taggerName, const simb::MCParticle& particle);
+
+  private:
+
+    // Axis aligned boxes in a flat bounding volume hierarchy
+    class VolumeTree {
+    public:
+      // Box limits as {minX, maxX, minY, maxY, minZ, maxZ}, null boxes are never inside
+      void Build(const std::vector<std::vector<double>>& limits, const std::vector<bool>& null);
+      size_t Size() const { return fLimits.size(); }
+      // Same test as the CRTGeoAlg IsInside functions
+      bool IsInside(size_t volume_i, const geo::Point_t& point) const;
+      // Indices of all the volumes the point is strictly inside
+      void Find(const geo::Point_t& point, std::vector<size_t>& volumes) const;
+
+    private:
+      struct Node{
+        double limits[6];
+        // Children for internal nodes, range of fOrder for leaves
+        size_t left;
+        size_t right;
+        size_t begin;
+        size_t end;
+        bool leaf;
+      };
+
+      size_t BuildNode(size_t begin, size_t end);
+
+      std::vector<std::vector<double>> fLimits;
+      std::vector<bool> fNull;
+      std::vector<size_t> fOrder;
+      std::vector<Node> fNodes;
+    };
+
+    // Per volume state while walking a trajectory
+    struct VolumeCrossing{
+      bool first = true;
+      geo::Point_t entry {-99999, -99999, -99999};
+      geo::Point_t exit {-99999, -99999, -99999};
+    };
+
+    // Cached entry of a particle, with the TPC and CRT volume crossings filled
+    ParticleCrossings& Entry(const simb::MCParticle& particle);
+
+    // Walk a trajectory once and record its TPC and CRT volume crossings
+    void WalkVolumes(const simb::MCParticle& particle, ParticleCrossings& crossings);
+    // Walk a trajectory once and record the crossed taggers, modules and strips
+    void WalkCRT(const simb::MCParticle& particle, ParticleCrossings& crossings);
+
+    // Volumes containing the trajectory points only
+    void WalkPoints(const simb::MCParticle& particle, const VolumeTree& tree,
+                    std::vector<std::pair<size_t, geo::Point_t>>& crossed);
+    // Volumes containing the trajectory points or the mid points of the steps,
+    // as used for the thin modules and strips
+    void WalkMidPoints(const simb::MCParticle& particle, const VolumeTree& tree,
+                       std::vector<std::pair<size_t, geo::Point_t>>& crossed);
+
+    // Crossing point of a volume, -99999 if not crossed
+    static geo::Point_t CrossingPoint(const std::vector<std::pair<size_t, geo::Point_t>>& crossed, size_t volume_i);
+    // Check if a volume is crossed
+    static bool IsCrossed(const std::vector<std::pair<size_t, geo::Point_t>>& crossed, size_t volume_i);
+
+    TPCGeoAlg fTpcGeo;
+    CRTGeoAlg fCrtGeo;
+
+    VolumeTree fTaggerTree;
+    VolumeTree fModuleTree;
+    VolumeTree fStripTree;
+    std::vector<double> fCRTLimits;
+
+    std::vector<ParticleCrossings> fCrossings;
+    std::unordered_map<int, size_t> fTrackIdIndex;
+
+    // Work buffers, reused across particles
+    std::vector<VolumeCrossing> fStates;
+    std::vector<size_t> fMarks;
+    size_t fMark = 0;
+    std::vector<size_t> fTouched;
+    std::vector<size_t> fPointVolumes;
+    std::vector<size_t> fMidVolumes;
+
+  };
+
+}
+
+#endif
@@ -3,7 +3,11 @@
 namespace sbnd{
 
 // Constructor - get values from the geometry service
-TPCGeoAlg::TPCGeoAlg(){
+TPCGeoAlg::TPCGeoAlg():
+  TPCGeoAlg::TPCGeoAlg(lar::providerFrom<geo::Geometry>())
+{}
+
+TPCGeoAlg::TPCGeoAlg(geo::GeometryCore const *geometry){
 
   fMinX = 99999;
   fMinY = 99999;
@@ -13,7 +17,7 @@ TPCGeoAlg::TPCGeoAlg(){
   fMaxZ = -99999;
   fCpaWidth = 0;
 
-  fGeometryService = lar::providerFrom<geo::Geometry>();
+  fGeometryService = geometry;
 
   for(size_t cryo_i = 0; cryo_i < fGeometryService->Ncryostats(); cryo_i++){
     const geo::CryostatGeo& cryostat = fGeometryService->Cryostat(cryo_i);
@@ -78,7 +82,7 @@ bool TPCGeoAlg::InFiducial(geo::Point_t point, double fiducial, double fiducialT
 }
 
 bool TPCGeoAlg::InFiducial(geo::Point_t point, double minXCut, double minYCut, double minZCut, 
-                           double maxXCut, double maxYCut, double maxZCut){
+                           double maxXCut, double maxYCut, double maxZCut) const {
   
   double xmin = fMinX + minXCut;
   double xmax = fMaxX - maxXCut;
@@ -97,7 +101,7 @@ bool TPCGeoAlg::InFiducial(geo::Point_t point, double minXCut, double minYCut, d
 
 // ----------------------------------------------------------------------------------
 // Determine which TPC a collection of hits is detected in (-1 if multiple) 
-int TPCGeoAlg::DetectedInTPC(std::vector<art::Ptr<recob::Hit>> hits){
+int TPCGeoAlg::DetectedInTPC(const std::vector<art::Ptr<recob::Hit>>& hits) const {
   // Return tpc of hit collection or -1 if in multiple
   if(hits.size() == 0) return -1;
   int tpc = hits[0]->WireID().TPC;
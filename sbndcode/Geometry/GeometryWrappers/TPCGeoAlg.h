@@ -34,6 +34,7 @@ namespace sbnd{
   class TPCGeoAlg {
   public:
 
+    TPCGeoAlg(geo::GeometryCore const *geometry);
     TPCGeoAlg();
 
     ~TPCGeoAlg();
@@ -51,13 +52,13 @@ namespace sbnd{
     bool InFiducial(geo::Point_t point, double fiducial);
     bool InFiducial(geo::Point_t point, double fiducial, double fiducialTop);
     bool InFiducial(geo::Point_t point, double minXCut, double minYCut, double minZCut, 
-                    double maxXCut, double maxYCut, double maxZCut);
+                    double maxXCut, double maxYCut, double maxZCut) const;
     
     // Is point inside given TPC
     bool InsideTPC(geo::Point_t point, const geo::TPCGeo& tpc, double buffer=0.);
 
     // Determine which TPC a collection of hits is detected in (-1 if multiple)
-    int DetectedInTPC(std::vector<art::Ptr<recob::Hit>> hits);
+    int DetectedInTPC(const std::vector<art::Ptr<recob::Hit>>& hits) const;
     // Determine the drift direction for a collection of hits (-1, 0 or 1 assuming drift in X)
     int DriftDirectionFromHits(std::vector<art::Ptr<recob::Hit>> hits);
     // Work out the drift limits for a collection of hits
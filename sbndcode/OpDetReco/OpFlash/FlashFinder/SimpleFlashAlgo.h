@@ -38,6 +38,9 @@ namespace lightana
     double _pre_sample;     // time pre-sample
 
     std::vector<double> _pesum_v;        // pw aum array
+    std::vector<double> _mult_v;         // hit multiplicity per time bin
+    std::vector<std::vector<double> > _pespec_v;         // pe per opdet per time bin
+    std::vector<std::vector<unsigned int> > _hitidx_v;   // hit indices per time bin
     std::vector<double> _pe_baseline_v;  // calibration: PEs to be subtracted from each opdet
 
     std::map<double,double> _flash_veto_range_m;  // veto window start
@@ -13,6 +13,7 @@
 #include "art/Framework/Principal/Run.h"
 #include "art/Framework/Principal/SubRun.h"
 #include "canvas/Utilities/InputTag.h"
+#include "cetlib_except/exception.h"
 #include "fhiclcpp/ParameterSet.h"
 #include "messagefacility/MessageLogger/MessageLogger.h"
 
@@ -20,8 +21,10 @@
 #include "lardataobj/RecoBase/OpFlash.h"
 #include "lardata/Utilities/AssociationUtil.h"
 
+#include <algorithm>
 #include <memory>
 #include <string>
+#include <thread>
 #include "sbndcode/OpDetReco/OpFlash/FlashFinder/FlashFinderManager.h"
 #include "sbndcode/OpDetReco/OpFlash/FlashFinder/FlashFinderFMWKInterface.h"
 #include "sbndcode/OpDetReco/OpFlash/FlashFinder/PECalib.h"
@@ -51,7 +54,26 @@ namespace opdet{
     ::lightana::PECalib _pecalib;
     std::vector<std::string> _hit_producers;
 
-    void GetFlashLocation(std::vector<double>, double&, double&, double&, double&);
+    // Multi-TPC mode: one flash finder per TPC and PD class, run
+    // concurrently on the same OpHit input, each writing to its own
+    // product instance
+    std::vector<int> _tpc_v;
+    std::vector<std::string> _instance_v;
+    std::vector<std::unique_ptr<::lightana::FlashAlgoBase>> _algo_v;
+    std::vector<::lightana::FlashFinderManager> _mgr_v;
+    std::vector<int> _opch_to_finder_v; ///< finder index for each channel, -1 if unused
+
+    void GetFlashLocation(const std::vector<double>&, double&, double&, double&, double&);
+
+    void FillFlashes(art::Event& e,
+                     const ::lightana::LiteOpFlashArray_t& flash_v,
+                     const std::vector<art::Ptr<recob::OpHit>>& ophit_v,
+                     const std::vector<size_t>& hit_index_v,
+                     double trigger_time,
+                     const std::string& instance);
+
+    void ProduceMultiTPC(art::Event& e,
+                         const std::vector<art::Ptr<recob::OpHit>>& ophit_v);
 
   };
 
@@ -60,31 +82,90 @@ namespace opdet{
   // Initialize member data here.
   {
     _hit_producers = p.get<std::vector<std::string>>("OpHitProducers");
+    _tpc_v = p.get<std::vector<int>>("TPCs", {});
 
     auto const flash_algo  = p.get<std::string>("FlashFinderAlgo");
     auto const flash_pset = p.get<lightana::Config_t>("AlgoConfig");
-    auto algo_ptr = ::lightana::FlashAlgoFactory::get().create(flash_algo,flash_algo);
-    algo_ptr->Configure(flash_pset);
-    _mgr.SetFlashAlgo(algo_ptr);
     _pecalib.Configure(p.get<lightana::Config_t>("PECalib"));
 
-    produces< std::vector<recob::OpFlash>   >();
-    produces< art::Assns <recob::OpHit, recob::OpFlash> >();
+    if(_tpc_v.empty()) {
+      auto algo_ptr = ::lightana::FlashAlgoFactory::get().create(flash_algo,flash_algo);
+      algo_ptr->Configure(flash_pset);
+      _mgr.SetFlashAlgo(algo_ptr);
+
+      produces< std::vector<recob::OpFlash>   >();
+      produces< art::Assns <recob::OpHit, recob::OpFlash> >();
+      return;
+    }
+
+    // Multi-TPC mode: the AlgoConfig is used as a template, with the TPC and
+    // the PD list overridden for each finder. There is one finder for each
+    // TPC and PD class; without PDClasses, the AlgoConfig PD list is the only
+    // class. The OpHits are split once per event according to the TPC and PD
+    // class each finder uses.
+    if(flash_pset.has_key("OpChannel")) {
+      throw cet::exception("SBNDFlashFinder")
+        << "AlgoConfig.OpChannel cannot be used with TPCs: the channels of each finder"
+        << " are selected by TPC and PDClasses.\n";
+    }
+
+    std::vector<std::string> class_name_v;
+    std::vector<std::vector<std::string>> class_pd_v;
+    for(auto const& pd_class : p.get<std::vector<lightana::Config_t>>("PDClasses", {})) {
+      class_name_v.push_back(pd_class.get<std::string>("Name"));
+      class_pd_v.push_back(pd_class.get<std::vector<std::string>>("PD"));
+    }
+    if(class_pd_v.empty()) {
+      std::vector<std::string> pd_to_use;
+      pd_to_use = flash_pset.get<std::vector<std::string>>("PD", pd_to_use);
+      class_name_v.push_back("");
+      class_pd_v.push_back(pd_to_use);
+    }
+
+    _mgr_v.resize(_tpc_v.size() * class_pd_v.size());
+    size_t i = 0;
+    for(int const tpc : _tpc_v) {
+      if(tpc < 0) {
+        throw cet::exception("SBNDFlashFinder") << "Invalid TPC " << tpc << " in TPCs list.\n";
+      }
+
+      for(size_t c = 0; c < class_pd_v.size(); ++c, ++i) {
+        std::vector<int> const opch_to_use = ::lightana::PDNamesToList(class_pd_v[c]);
+
+        auto finder_pset = flash_pset;
+        finder_pset.put_or_replace("TPC", tpc);
+        finder_pset.put_or_replace("PD", class_pd_v[c]);
+        std::string const instance = "tpc" + std::to_string(tpc) + class_name_v[c];
+        std::string const name = flash_algo + instance;
+        _algo_v.emplace_back(::lightana::FlashAlgoFactory::get().create(flash_algo, name));
+        if(!_algo_v.back()) {
+          throw cet::exception("SBNDFlashFinder") << "Could not create flash algo " << flash_algo << "\n";
+        }
+        _algo_v.back()->Configure(finder_pset);
+        _mgr_v[i].SetFlashAlgo(_algo_v.back().get());
+
+        for(auto const opch : ::lightana::ListOpChannelsByTPC(tpc)) {
+          if(std::find(opch_to_use.begin(), opch_to_use.end(), (int)opch) == opch_to_use.end()) continue;
+          if(opch >= _opch_to_finder_v.size()) _opch_to_finder_v.resize(opch+1, -1);
+          if(_opch_to_finder_v[opch] >= 0) {
+            throw cet::exception("SBNDFlashFinder") << "OpChannel " << opch
+                                                    << " is used by more than one TPC or PD class.\n";
+          }
+          _opch_to_finder_v[opch] = i;
+        }
+
+        _instance_v.push_back(instance);
+        produces< std::vector<recob::OpFlash>   >(_instance_v.back());
+        produces< art::Assns <recob::OpHit, recob::OpFlash> >(_instance_v.back());
+      }
+    }
   }
 
   void SBNDFlashFinder::produce(art::Event & e)
   {
 
-    // produce OpFlash data-product to be filled within module
-    std::unique_ptr< std::vector<recob::OpFlash> > opflashes(new std::vector<recob::OpFlash>);
-    std::unique_ptr< art::Assns <recob::OpHit, recob::OpFlash> > flash2hit_assn_v
-      (new art::Assns<recob::OpHit, recob::OpFlash>);
-
     std::vector<art::Ptr<recob::OpHit>> ophit_v;
 
-    ::lightana::LiteOpHitArray_t ophits;
-    double trigger_time=1.1e20;
-
     for (auto producer : _hit_producers) {
 
       // load OpHits previously created
@@ -102,6 +183,14 @@ namespace opdet{
       ophit_v.insert(ophit_v.end(), temp_v.begin(), temp_v.end());
     }
 
+    if(!_tpc_v.empty()) {
+      ProduceMultiTPC(e, ophit_v);
+      return;
+    }
+
+    ::lightana::LiteOpHitArray_t ophits;
+    double trigger_time=1.1e20;
+
     for(auto const oph : ophit_v) {
       ::lightana::LiteOpHit_t loph;
       if(trigger_time > 1.e20) trigger_time = oph->PeakTimeAbs() - oph->PeakTime();
@@ -115,6 +204,69 @@ namespace opdet{
 
     auto const flash_v = _mgr.RecoFlash(ophits);
 
+    std::vector<size_t> hit_index_v(ophit_v.size());
+    for(size_t i = 0; i < hit_index_v.size(); ++i) hit_index_v[i] = i;
+
+    FillFlashes(e, flash_v, ophit_v, hit_index_v, trigger_time, "");
+  }
+
+  void SBNDFlashFinder::ProduceMultiTPC(art::Event& e,
+                                        const std::vector<art::Ptr<recob::OpHit>>& ophit_v)
+  {
+    size_t const nfinders = _mgr_v.size();
+
+    // Split the OpHits by finder in a single pass, keeping track of the
+    // index of each hit in the full input for the associations
+    std::vector<::lightana::LiteOpHitArray_t> ophits_v(nfinders);
+    std::vector<std::vector<size_t>> hit_index_v(nfinders);
+    double trigger_time=1.1e20;
+
+    for(size_t i = 0; i < ophit_v.size(); ++i) {
+      auto const& oph = ophit_v[i];
+      if(trigger_time > 1.e20) trigger_time = oph->PeakTimeAbs() - oph->PeakTime();
+
+      size_t const opch = oph->OpChannel();
+      if(opch >= _opch_to_finder_v.size() || _opch_to_finder_v[opch] < 0) continue;
+      int const finder = _opch_to_finder_v[opch];
+
+      ::lightana::LiteOpHit_t loph;
+      loph.peak_time = oph->PeakTime();
+      size_t opdet = ::lightana::OpDetFromOpChannel(opch);
+      loph.pe = _pecalib.Calibrate(opdet,oph->Area());
+      loph.channel = opch;
+      ophits_v[finder].emplace_back(std::move(loph));
+      hit_index_v[finder].push_back(i);
+    }
+
+    // Run the finders concurrently, each on its own algo instance
+    std::vector<::lightana::LiteOpFlashArray_t> flash_v(nfinders);
+    std::vector<std::thread> threads;
+    for(size_t i = 1; i < nfinders; ++i) {
+      threads.emplace_back([this, i, &ophits_v, &flash_v] {
+        flash_v[i] = _mgr_v[i].RecoFlash(ophits_v[i]);
+      });
+    }
+    if(nfinders > 0) flash_v[0] = _mgr_v[0].RecoFlash(ophits_v[0]);
+    for(auto& thread : threads) thread.join();
+
+    for(size_t i = 0; i < nfinders; ++i) {
+      FillFlashes(e, flash_v[i], ophit_v, hit_index_v[i], trigger_time, _instance_v[i]);
+    }
+  }
+
+  void SBNDFlashFinder::FillFlashes(art::Event& e,
+                                    const ::lightana::LiteOpFlashArray_t& flash_v,
+                                    const std::vector<art::Ptr<recob::OpHit>>& ophit_v,
+                                    const std::vector<size_t>& hit_index_v,
+                                    double trigger_time,
+                                    const std::string& instance)
+  {
+    // produce OpFlash data-product to be filled within module
+    std::unique_ptr< std::vector<recob::OpFlash> > opflashes(new std::vector<recob::OpFlash>);
+    std::unique_ptr< art::Assns <recob::OpHit, recob::OpFlash> > flash2hit_assn_v
+      (new art::Assns<recob::OpHit, recob::OpFlash>);
+    opflashes->reserve(flash_v.size());
+
     for(const auto& lflash :  flash_v) {
 
       double Ycenter, Zcenter, Ywidth, Zwidth;
@@ -127,16 +279,16 @@ namespace opdet{
 
 
       for(auto const& hitidx : lflash.asshit_idx) {
-        const art::Ptr<recob::OpHit> hit_ptr(ophit_v.at(hitidx));
-        util::CreateAssn(*this, e, *opflashes, hit_ptr, *flash2hit_assn_v);
+        const art::Ptr<recob::OpHit> hit_ptr(ophit_v.at(hit_index_v.at(hitidx)));
+        util::CreateAssn(*this, e, *opflashes, hit_ptr, *flash2hit_assn_v, instance);
       }
     }
 
-    e.put(std::move(opflashes));
-    e.put(std::move(flash2hit_assn_v));
+    e.put(std::move(opflashes), instance);
+    e.put(std::move(flash2hit_assn_v), instance);
   }
 
-  void SBNDFlashFinder::GetFlashLocation(std::vector<double> pePerOpChannel,
+  void SBNDFlashFinder::GetFlashLocation(const std::vector<double>& pePerOpChannel,
                                          double& Ycenter,
                                          double& Zcenter,
                                          double& Ywidth,
@@ -74,9 +74,9 @@ namespace opdet {
     double start_time,
     unsigned n_samples)
   {
-    std::vector<double> waves(n_samples, fParams.Baseline);
-    CreatePDWaveform(simphotons, start_time, waves, pdtype);
-    waveform = std::vector<short unsigned int> (waves.begin(), waves.end());
+    fKernel.Reset(n_samples);
+    CreatePDWaveform(simphotons, start_time, pdtype);
+    fKernel.Build(wsp, fParams.Baseline, saturation, waveform);
   }
 
 
@@ -88,17 +88,16 @@ namespace opdet {
     double start_time,
     unsigned n_samples)
   {
-    std::vector<double> waves(n_samples, fParams.Baseline);
+    fKernel.Reset(n_samples);
     std::map<int, int> const& photonMap = litesimphotons.DetectedPhotons;
-    CreatePDWaveformLite(photonMap, start_time, waves, pdtype);
-    waveform = std::vector<short unsigned int> (waves.begin(), waves.end());
+    CreatePDWaveformLite(photonMap, start_time, pdtype);
+    fKernel.Build(wsp, fParams.Baseline, saturation, waveform);
   }
 
 
   void DigiArapucaSBNDAlg::CreatePDWaveform(
     sim::SimPhotons const& simphotons,
     double t_min,
-    std::vector<double>& wave,
     std::string pdtype)
   {
     int nCT = 1;
@@ -113,7 +112,7 @@ namespace opdet {
           if(fParams.CrossTalk > 0.0 && (CLHEP::RandFlat::shoot(fEngine, 1.0)) < fParams.CrossTalk) nCT = 2;
           else nCT = 1;
           timeBin = std::floor(tphoton * fSampling);
-          if(timeBin < wave.size()) AddSPE(timeBin, wave, nCT);
+          fKernel.AddPE(timeBin, nCT);
         }
       }
     }
@@ -127,7 +126,7 @@ namespace opdet {
           if(fParams.CrossTalk > 0.0 && (CLHEP::RandFlat::shoot(fEngine, 1.0)) < fParams.CrossTalk) nCT = 2;
           else nCT = 1;
           timeBin = std::floor(tphoton * fSampling);
-          if(timeBin < wave.size()) AddSPE(timeBin, wave, nCT);
+          fKernel.AddPE(timeBin, nCT);
         }
       }
     }
@@ -140,7 +139,7 @@ namespace opdet {
           if(fParams.CrossTalk > 0.0 && (CLHEP::RandFlat::shoot(fEngine, 1.0)) < fParams.CrossTalk) nCT = 2;
           else nCT = 1;
           timeBin = std::floor(tphoton * fSampling);
-          if(timeBin < wave.size()) AddSPE(timeBin, wave, nCT);
+          fKernel.AddPE(timeBin, nCT);
         }
       }
     }
@@ -154,52 +153,48 @@ namespace opdet {
           if(fParams.CrossTalk > 0.0 && (CLHEP::RandFlat::shoot(fEngine, 1.0)) < fParams.CrossTalk) nCT = 2;
           else nCT = 1;
           timeBin = std::floor(tphoton * fSampling);
-          if(timeBin < wave.size()) AddSPE(timeBin, wave, nCT);
+          fKernel.AddPE(timeBin, nCT);
         }
       }
     }
     else{
       throw cet::exception("DigiARAPUCASBNDAlg") << "Wrong pdtype: " << pdtype << std::endl;
     }
-    if(fParams.BaselineRMS > 0.0) AddLineNoise(wave);
-    if(fParams.DarkNoiseRate > 0.0) AddDarkNoise(wave);
-    CreateSaturation(wave);
+    if(fParams.BaselineRMS > 0.0) AddLineNoise();
+    if(fParams.DarkNoiseRate > 0.0) AddDarkNoise();
   }
 
 
   void DigiArapucaSBNDAlg::CreatePDWaveformLite(
     std::map<int, int> const& photonMap,
     double t_min,
-    std::vector<double>& wave,
     std::string pdtype)
   {
     if(pdtype == "xarapuca_vuv"){
-      SinglePDWaveformCreatorLite(fXArapucaVUVEff, fTimeXArapucaVUV, wave, photonMap, t_min);
+      SinglePDWaveformCreatorLite(fXArapucaVUVEff, fTimeXArapucaVUV, photonMap, t_min);
     }
     else if(pdtype == "xarapuca_vis"){
       // creating the waveforms for xarapuca_vis is different than the rest
       // so there's an overload for that which lacks the timeHisto
-      SinglePDWaveformCreatorLite(fXArapucaVISEff, wave, photonMap, t_min);
+      SinglePDWaveformCreatorLite(fXArapucaVISEff, photonMap, t_min);
     }
     else if(pdtype == "arapuca_vuv"){
-      SinglePDWaveformCreatorLite(fArapucaVUVEff, fTimeArapucaVUV, wave, photonMap, t_min);
+      SinglePDWaveformCreatorLite(fArapucaVUVEff, fTimeArapucaVUV, photonMap, t_min);
     }
     else if(pdtype == "arapuca_vis"){
-      SinglePDWaveformCreatorLite(fArapucaVISEff, fTimeArapucaVIS, wave, photonMap, t_min);
+      SinglePDWaveformCreatorLite(fArapucaVISEff, fTimeArapucaVIS, photonMap, t_min);
     }
     else{
       throw cet::exception("DigiARAPUCASBNDAlg") << "Wrong pdtype: " << pdtype << std::endl;
     }
-    if(fParams.BaselineRMS > 0.0) AddLineNoise(wave);
-    if(fParams.DarkNoiseRate > 0.0) AddDarkNoise(wave);
-    CreateSaturation(wave);
+    if(fParams.BaselineRMS > 0.0) AddLineNoise();
+    if(fParams.DarkNoiseRate > 0.0) AddDarkNoise();
   }
 
 
   void DigiArapucaSBNDAlg::SinglePDWaveformCreatorLite(
     double effT,
     std::unique_ptr<CLHEP::RandGeneral>& timeHisto,
-    std::vector<double>& wave,
     std::map<int, int> const& photonMap,
     double const& t_min
     )
@@ -224,7 +219,7 @@ namespace opdet {
            (CLHEP::RandFlat::shoot(fEngine, 1.0)) < fParams.CrossTalk) nCT = 2;
         else nCT = 1;
         timeBin = std::floor(tphoton * fSampling);
-        if(timeBin < wave.size()) AddSPE(timeBin, wave, nCT);
+        fKernel.AddPE(timeBin, nCT);
       }
     }
   }
@@ -232,7 +227,6 @@ namespace opdet {
 
   void DigiArapucaSBNDAlg::SinglePDWaveformCreatorLite(
     double effT,
-    std::vector<double>& wave,
     std::map<int, int> const& photonMap,
     double const& t_min
     )
@@ -254,7 +248,7 @@ namespace opdet {
         if(fParams.CrossTalk > 0.0 && (CLHEP::RandFlat::shoot(fEngine, 1.0)) < fParams.CrossTalk) nCT = 2;
         else nCT = 1;
         timeBin = std::floor(tphoton * fSampling);
-        if(timeBin < wave.size()) AddSPE(timeBin, wave, nCT);
+        fKernel.AddPE(timeBin, nCT);
       }
     }
   }
@@ -273,62 +267,27 @@ namespace opdet {
   }
 
 
-  void DigiArapucaSBNDAlg::AddSPE(
-    size_t time_bin,
-    std::vector<double>& wave,
-    int nphotons) //adding single pulse
+  void DigiArapucaSBNDAlg::AddLineNoise()
   {
-    // if(time_bin > wave.size()) return;
-    size_t max = time_bin + pulsesize < wave.size() ? time_bin + pulsesize : wave.size();
-    auto min_it = std::next(wave.begin(), time_bin);
-    auto max_it = std::next(wave.begin(), max);
-    std::transform(min_it, max_it,
-                   wsp.begin(), min_it,
-                   [nphotons](double w, double ws) -> double {
-                     return w + ws*nphotons  ; });
+    // Drawn in bulk into the kernel buffer, in the same order as one
+    // draw per sample
+    CLHEP::RandGaussQ::shootArray(fEngine, fKernel.size(), fKernel.NoiseBuffer(),
+                                  0, fParams.BaselineRMS);
   }
 
 
-  void DigiArapucaSBNDAlg::CreateSaturation(std::vector<double>& wave)
-  {
-    std::replace_if(wave.begin(), wave.end(),
-                    [&](auto w){return w > saturation;}, saturation);
-  }
-
-
-  void DigiArapucaSBNDAlg::AddLineNoise(std::vector< double >& wave)
-  {
-    // TODO: after running the profiler I can see that this is where
-    // most cycles are being used.  Potentially some improvement could
-    // be achieved with the below code but the array dynamic allocation
-    // is not helping. The function would need to have it passed.
-    // ~icaza
-    //
-    // double *array = new double[wave.size()]();
-    // CLHEP::RandGaussQ::shootArray(fEngine, wave.size(), array, 0, fParams.BaselineRMS);
-    // for(size_t i = 0; i<wave.size(); i++) {
-    //   wave[i] += array[i];
-    // }
-    // delete array;
-    //
-    std::transform(wave.begin(), wave.end(), wave.begin(),
-                   [this](double w) -> double {
-                     return w + CLHEP::RandGaussQ::shoot(fEngine, 0, fParams.BaselineRMS) ; });
-  }
-
-
-  void DigiArapucaSBNDAlg::AddDarkNoise(std::vector<double>& wave)
+  void DigiArapucaSBNDAlg::AddDarkNoise()
   {
     int nCT;
     size_t timeBin;
     // Multiply by 10^9 since fDarkNoiseRate is in Hz (conversion from s to ns)
     double mean = 1000000000.0 / fParams.DarkNoiseRate;
     double darkNoiseTime = CLHEP::RandExponential::shoot(fEngine, mean);
-    while(darkNoiseTime < wave.size()) {
+    while(darkNoiseTime < fKernel.size()) {
       timeBin = std::round(darkNoiseTime);
       if(fParams.CrossTalk > 0.0 && (CLHEP::RandFlat::shoot(fEngine, 1.0)) < fParams.CrossTalk) nCT = 2;
       else nCT = 1;
-      if(timeBin < wave.size()) AddSPE(timeBin, wave, nCT);
+      fKernel.AddPE(timeBin, nCT);
       // Find next time to add dark noise
       darkNoiseTime += CLHEP::RandExponential::shoot(fEngine, mean);
     }
@@ -34,6 +34,8 @@
 #include "lardataobj/Simulation/SimPhotons.h"
 #include "lardata/DetectorInfoServices/LArPropertiesService.h"
 
+#include "sbndcode/OpDetSim/DigiWaveformKernel.hh"
+
 #include "TFile.h"
 
 namespace opdet {
@@ -111,32 +113,28 @@ namespace opdet {
     std::unique_ptr<CLHEP::RandGeneral> fTimeTPB; // histogram for getting the TPB emission time for visible (x)arapucas
 
     std::vector<double> wsp; //single photon pulse vector
+    DigiWaveformKernel fKernel; //PE histogram, noise and waveform buffers, reused across channels
     std::unordered_map< raw::Channel_t, std::vector<double> > fFullWaveforms;
 
+    // The waveform creators fill the PE histogram of fKernel
     void CreatePDWaveform(sim::SimPhotons const& SimPhotons,
                           double t_min,
-                          std::vector<double>& wave,
                           std::string pdtype);
     void CreatePDWaveformLite(std::map<int, int> const& photonMap,
                               double t_min,
-                              std::vector<double>& wave,
                               std::string pdtype);
     void SinglePDWaveformCreatorLite(double effT,
                                      std::unique_ptr<CLHEP::RandGeneral>& timeHisto,
-                                     std::vector<double>& wave,
                                      std::map<int, int> const& photonMap,
                                      double const& t_min);
     void SinglePDWaveformCreatorLite(double effT,
-                                     std::vector<double>& wave,
                                      std::map<int, int> const& photonMap,
                                      double const& t_min);
-    void AddSPE(size_t time_bin, std::vector<double>& wave, int nphotons); // add single pulse to auxiliary waveform
     void Pulse1PE(std::vector<double>& wave);
-    void AddLineNoise(std::vector<double>& wave);
-    void AddDarkNoise(std::vector<double>& wave);
+    void AddLineNoise();
+    void AddDarkNoise();
     double FindMinimumTime(sim::SimPhotons const& simphotons);
     double FindMinimumTimeLite(std::map< int, int > const& photonMap);
-    void CreateSaturation(std::vector<double>& wave);//Including saturation effects
   };//class DigiArapucaSBNDAlg
 
   class DigiArapucaSBNDAlgMaker {
@@ -0,0 +1,64 @@
+#include "sbndcode/OpDetSim/DigiWaveformKernel.hh"
+
+#include <algorithm>
+
+//------------------------------------------------------------------------------
+//--- opdet::DigiWaveformKernel implementation
+//------------------------------------------------------------------------------
+
+namespace opdet {
+
+  void DigiWaveformKernel::Reset(size_t n_samples)
+  {
+    for(auto const bin : fBins) fPEHist[bin] = 0.;
+    fBins.clear();
+    fPEHist.resize(n_samples, 0.);
+    fHasNoise = false;
+  }
+
+
+  double* DigiWaveformKernel::NoiseBuffer()
+  {
+    fNoise.resize(fPEHist.size());
+    fHasNoise = true;
+    return fNoise.data();
+  }
+
+
+  void DigiWaveformKernel::Build(std::vector<double> const& spe_template,
+                                 double baseline,
+                                 double saturation,
+                                 std::vector<short unsigned int>& waveform)
+  {
+    size_t const n_samples = fPEHist.size();
+    size_t const pulsesize = spe_template.size();
+
+    // Signal: one template per populated bin, scaled by its PE count
+    fWave.assign(n_samples, 0.);
+    double* __restrict__ wave = fWave.data();
+    double const* __restrict__ spe = spe_template.data();
+    for(auto const bin : fBins) {
+      double const npe = fPEHist[bin];
+      size_t const len = std::min(pulsesize, n_samples - bin);
+      double* __restrict__ out = wave + bin;
+      for(size_t i = 0; i < len; i++) out[i] += npe * spe[i];
+    }
+
+    // Fused baseline + noise + saturation + quantization
+    waveform.resize(n_samples);
+    if(fHasNoise) {
+      double const* __restrict__ noise = fNoise.data();
+      for(size_t i = 0; i < n_samples; i++) {
+        double const w = std::min(baseline + wave[i] + noise[i], saturation);
+        waveform[i] = static_cast<short unsigned int>(w);
+      }
+    }
+    else {
+      for(size_t i = 0; i < n_samples; i++) {
+        double const w = std::min(baseline + wave[i], saturation);
+        waveform[i] = static_cast<short unsigned int>(w);
+      }
+    }
+  }
+
+}
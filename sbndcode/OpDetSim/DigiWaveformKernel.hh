@@ -0,0 +1,57 @@
+////////////////////////////////////////////////////////////////////////
+// File:       DigiWaveformKernel.hh
+//
+// Builds a digitized photodetector waveform from a histogram of PE
+// arrival times: the histogram is convolved with the single PE pulse
+// template, and the line noise, saturation and conversion to ADC counts
+// are applied in a single pass. The buffers are reused across channels.
+////////////////////////////////////////////////////////////////////////
+
+#ifndef SBND_OPDETSIM_DIGIWAVEFORMKERNEL_HH
+#define SBND_OPDETSIM_DIGIWAVEFORMKERNEL_HH
+
+#include <cstddef>
+#include <vector>
+
+namespace opdet {
+
+  class DigiWaveformKernel {
+
+  public:
+
+    /// Clears the PE histogram and the noise for a waveform of n_samples
+    void Reset(size_t n_samples);
+
+    size_t size() const { return fPEHist.size(); }
+
+    /// Adds npe photoelectrons arriving in time_bin (ignored if outside the waveform)
+    void AddPE(size_t time_bin, double npe)
+    {
+      if(time_bin >= fPEHist.size()) return;
+      if(fPEHist[time_bin] == 0.) fBins.push_back(time_bin);
+      fPEHist[time_bin] += npe;
+    }
+
+    /// Buffer of size() samples to be filled with the line noise
+    double* NoiseBuffer();
+
+    /// Convolves the PE histogram with the single PE template and writes the
+    /// waveform: baseline + signal + noise, clamped at saturation
+    void Build(std::vector<double> const& spe_template,
+               double baseline,
+               double saturation,
+               std::vector<short unsigned int>& waveform);
+
+  private:
+
+    std::vector<double> fPEHist;  ///< PE per time bin
+    std::vector<size_t> fBins;    ///< bins with PE, in insertion order
+    std::vector<double> fNoise;   ///< line noise per time bin
+    bool fHasNoise = false;
+    std::vector<double> fWave;    ///< signal accumulator
+
+  };
+
+} //namespace
+
+#endif // SBND_OPDETSIM_DIGIWAVEFORMKERNEL_HH
@@ -0,0 +1,329 @@
+////////////////////////////////////////////////////////////////////////
+// File:        opdetsim_bench_sbnd.cc
+//
+// Throughput benchmark of the optical detector simulation chain, run
+// outside of the art event loop: synthetic SimPhotonsLite are digitized
+// with DigiPMTSBNDAlg/DigiArapucaSBNDAlg, self-triggered with
+// opDetSBNDTriggerAlg, and reconstructed with opHitFinderSBNDAlg.
+// The digitization and the hit finding are timed for each thread count
+// in ThreadCounts; the trigger alg is stateful across channels and runs
+// on a single thread, as in opDetDigitizerSBND.
+//
+// Usage: opdetsim_bench_sbnd [config.fcl]   (default: opdetsim_bench_sbnd.fcl)
+// Output: one "key value" pair per line on stdout.
+////////////////////////////////////////////////////////////////////////
+
+#include "sbndcode/OpDetSim/DigiArapucaSBNDAlg.hh"
+#include "sbndcode/OpDetSim/DigiPMTSBNDAlg.hh"
+#include "sbndcode/OpDetSim/opDetSBNDTriggerAlg.hh"
+#include "sbndcode/OpDetSim/opHitFinderSBNDAlg.hh"
+#include "sbndcode/OpDetSim/sbndPDMapAlg.hh"
+
+#include "lardataalg/DetectorInfo/DetectorClocksStandardTestHelpers.h"
+#include "lardataalg/DetectorInfo/DetectorClocksStandard.h"
+#include "lardataalg/DetectorInfo/LArPropertiesStandardTestHelpers.h"
+#include "lardataalg/DetectorInfo/LArPropertiesStandard.h"
+#include "larcorealg/Geometry/StandaloneBasicSetup.h"
+
+#include "lardataobj/RawData/OpDetWaveform.h"
+#include "lardataobj/RecoBase/OpHit.h"
+#include "lardataobj/Simulation/SimPhotons.h"
+
+#include "fhiclcpp/ParameterSet.h"
+#include "fhiclcpp/types/Table.h"
+
+#include "CLHEP/Random/JamesRandom.h"
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <new>
+#include <random>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+// Count every heap allocation made by the benchmark
+namespace {
+  std::atomic<std::size_t> gAllocations{0};
+}
+
+void* operator new(std::size_t size)
+{
+  gAllocations.fetch_add(1, std::memory_order_relaxed);
+  if (void* p = std::malloc(size ? size : 1)) return p;
+  throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+
+namespace {
+
+  // Photons of one event, keyed by channel, split as in the largeant output
+  struct EventPhotons {
+    std::unordered_map<int, sim::SimPhotonsLite> direct;
+    std::unordered_map<int, sim::SimPhotonsLite> reflected;
+    size_t n_photons = 0;
+  };
+
+  struct ChainSetup {
+    opdet::DigiPMTSBNDAlgMaker makePMTDigi;
+    opdet::DigiArapucaSBNDAlgMaker makeArapucaDigi;
+    fhicl::ParameterSet hitFinderConfig;
+    std::array<double, 2> enableWindow; // us
+    unsigned nSamples;
+    long seed;
+  };
+
+  double Seconds(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  }
+
+  bool SeesDirectLight(std::string const& pdtype) {
+    return pdtype == "pmt_coated" || pdtype == "arapuca_vuv" || pdtype == "xarapuca_vuv";
+  }
+
+  bool SeesReflectedLight(std::string const& pdtype) {
+    return pdtype == "pmt_coated" || pdtype == "pmt_uncoated" ||
+           pdtype == "arapuca_vis" || pdtype == "xarapuca_vis";
+  }
+
+  // Every channel gets an entry, as from largeant; only the occupied ones get photons
+  EventPhotons MakeEvent(opdet::sbndPDMapAlg const& map, std::mt19937& rng,
+                         double occupancy, double photons_per_channel,
+                         double time_start, double time_spread)
+  {
+    std::bernoulli_distribution occupied(occupancy);
+    std::poisson_distribution<int> n_photons(photons_per_channel);
+    std::uniform_real_distribution<double> time(time_start, time_start + time_spread);
+
+    EventPhotons event;
+    for (size_t ch = 0; ch < map.size(); ch++) {
+      std::string const pdtype = map.pdType(ch);
+      sim::SimPhotonsLite photons;
+      photons.OpChannel = ch;
+      if (occupied(rng)) {
+        int const n = n_photons(rng);
+        for (int i = 0; i < n; i++) photons.DetectedPhotons[(int)time(rng)]++;
+        event.n_photons += n;
+      }
+      if (SeesDirectLight(pdtype)) {
+        event.direct.emplace(ch, photons);
+        photons.DetectedPhotons.clear(); // coated PMTs: photons only count once
+      }
+      if (SeesReflectedLight(pdtype)) event.reflected.emplace(ch, std::move(photons));
+    }
+    return event;
+  }
+
+  // Digitizes the channels [start, start + n) of one event, as opDetDigitizerWorker does
+  void Digitize(EventPhotons& event, opdet::sbndPDMapAlg const& map, ChainSetup const& setup,
+                opdet::DigiPMTSBNDAlg& pmtDigitizer, opdet::DigiArapucaSBNDAlg& arapucaDigitizer,
+                unsigned start, unsigned n, std::vector<raw::OpDetWaveform>& waveforms)
+  {
+    double const startTime = setup.enableWindow[0] * 1000 /*ns for digitizer*/;
+    for (unsigned ch = start; ch < start + n; ch++) {
+      std::string const pdtype = map.pdType(ch);
+      std::vector<short unsigned int> waveform;
+      waveform.reserve(setup.nSamples);
+      if (pdtype == "pmt_coated") {
+        pmtDigitizer.ConstructWaveformLiteCoatedPMT(ch, waveform, event.direct, event.reflected,
+                                                    startTime, setup.nSamples);
+      }
+      else if (pdtype == "pmt_uncoated") {
+        pmtDigitizer.ConstructWaveformLite(ch, event.reflected.at(ch), waveform, pdtype,
+                                           startTime, setup.nSamples);
+      }
+      else if (SeesDirectLight(pdtype)) {
+        arapucaDigitizer.ConstructWaveformLite(ch, event.direct.at(ch), waveform, pdtype,
+                                               startTime, setup.nSamples);
+      }
+      else if (SeesReflectedLight(pdtype)) {
+        arapucaDigitizer.ConstructWaveformLite(ch, event.reflected.at(ch), waveform, pdtype,
+                                               startTime, setup.nSamples);
+      }
+      else continue;
+      waveforms[ch] = raw::OpDetWaveform(setup.enableWindow[0], ch, waveform);
+    }
+  }
+
+  // Runs fn(thread, start, n) on n_threads threads, splitting n_items in contiguous blocks
+  template<typename Func>
+  void RunOnThreads(unsigned n_threads, size_t n_items, Func fn)
+  {
+    std::vector<std::thread> threads;
+    for (unsigned t = 0; t < n_threads; t++) {
+      size_t const start = t * n_items / n_threads;
+      size_t const end = (t + 1) * n_items / n_threads;
+      threads.emplace_back(fn, t, start, end - start);
+    }
+    for (auto& thread : threads) thread.join();
+  }
+
+}
+
+int main(int argc, char** argv)
+{
+  std::string const configFile = argc > 1 ? argv[1] : "opdetsim_bench_sbnd.fcl";
+  fhicl::ParameterSet const config = lar::standalone::ParseConfiguration(configFile);
+  lar::standalone::SetupMessageFacility(config, "opdetsim_bench_sbnd");
+
+  auto const larp = testing::setupProvider<detinfo::LArPropertiesStandard>(
+    config.get<fhicl::ParameterSet>("services.LArPropertiesService"));
+  auto const detclk = testing::setupProvider<detinfo::DetectorClocksStandard>(
+    config.get<fhicl::ParameterSet>("services.DetectorClocksService"));
+  detinfo::DetectorClocksData const clockData = detclk->DataForJob();
+
+  auto const& benchConfig = config.get<fhicl::ParameterSet>("benchmark");
+  unsigned const nEvents            = benchConfig.get<unsigned>("NEvents");
+  double const photonsPerChannel    = benchConfig.get<double>("PhotonsPerChannel");
+  double const occupancy            = benchConfig.get<double>("Occupancy");
+  double const photonTimeStart      = benchConfig.get<double>("PhotonTimeStart");  // ns
+  double const photonTimeSpread     = benchConfig.get<double>("PhotonTimeSpread"); // ns
+  auto const threadCounts           = benchConfig.get<std::vector<unsigned>>("ThreadCounts");
+
+  auto const pmtConfig = fhicl::Table<opdet::DigiPMTSBNDAlgMaker::Config>(
+    benchConfig.get<fhicl::ParameterSet>("PMTDigitizer"), {})();
+  auto const arapucaConfig = fhicl::Table<opdet::DigiArapucaSBNDAlgMaker::Config>(
+    benchConfig.get<fhicl::ParameterSet>("ArapucaDigitizer"), {})();
+
+  auto const enableWindow = benchConfig.get<std::array<double, 2>>("EnableWindow"); // us
+  double const sampling = clockData.OpticalClock().Frequency() / 1000.0; // GHz
+  unsigned const nSamples = (enableWindow[1] - enableWindow[0]) * 1000. /*us -> ns*/ * sampling;
+
+  ChainSetup const setup{
+    opdet::DigiPMTSBNDAlgMaker(pmtConfig),
+    opdet::DigiArapucaSBNDAlgMaker(arapucaConfig),
+    benchConfig.get<fhicl::ParameterSet>("HitFinder"),
+    enableWindow,
+    nSamples,
+    benchConfig.get<long>("Seed")
+  };
+
+  opdet::opDetSBNDTriggerAlg triggerAlg(benchConfig.get<fhicl::ParameterSet>("Trigger"));
+  double const pmtBaseline = pmtConfig.pmtbaseline();
+  double const arapucaBaseline = arapucaConfig.baseline();
+
+  opdet::sbndPDMapAlg const map;
+  size_t const nChannels = map.size();
+
+  // Inputs
+  std::mt19937 rng(setup.seed);
+  std::vector<EventPhotons> events;
+  size_t nPhotons = 0;
+  for (unsigned i = 0; i < nEvents; i++) {
+    events.push_back(MakeEvent(map, rng, occupancy, photonsPerChannel, photonTimeStart, photonTimeSpread));
+    nPhotons += events.back().n_photons;
+  }
+
+  std::cout << "n_events " << nEvents << "\n"
+            << "n_channels " << nChannels << "\n"
+            << "n_samples " << nSamples << "\n"
+            << "n_photons " << nPhotons << "\n";
+
+  // Digitization, the full waveforms of the first thread count are kept for the trigger
+  std::vector<std::vector<raw::OpDetWaveform>> fullWaveforms;
+  double digitizeReference = 0.;
+  for (unsigned const nThreads : threadCounts) {
+    std::vector<std::unique_ptr<opdet::DigiPMTSBNDAlg>> pmtDigitizers;
+    std::vector<std::unique_ptr<opdet::DigiArapucaSBNDAlg>> arapucaDigitizers;
+    std::vector<std::unique_ptr<CLHEP::HepJamesRandom>> engines;
+    for (unsigned t = 0; t < nThreads; t++) {
+      engines.push_back(std::make_unique<CLHEP::HepJamesRandom>(setup.seed + t));
+      pmtDigitizers.push_back(setup.makePMTDigi(*larp, clockData, engines.back().get()));
+      arapucaDigitizers.push_back(setup.makeArapucaDigi(*larp, clockData, engines.back().get()));
+    }
+
+    std::vector<std::vector<raw::OpDetWaveform>> waveforms(nEvents, std::vector<raw::OpDetWaveform>(nChannels));
+    size_t const allocations = gAllocations.load();
+    auto const start = std::chrono::steady_clock::now();
+    for (unsigned i = 0; i < nEvents; i++) {
+      RunOnThreads(nThreads, nChannels, [&](unsigned t, size_t first, size_t n) {
+        Digitize(events[i], map, setup, *pmtDigitizers[t], *arapucaDigitizers[t], first, n, waveforms[i]);
+      });
+    }
+    double const elapsed = Seconds(start);
+    if (fullWaveforms.empty()) {
+      fullWaveforms = std::move(waveforms);
+      digitizeReference = elapsed;
+    }
+
+    std::string const key = "digitize_threads_" + std::to_string(nThreads);
+    std::cout << key << "_s " << elapsed << "\n"
+              << key << "_events_per_s " << nEvents / elapsed << "\n"
+              << key << "_waveforms_per_s " << nEvents * nChannels / elapsed << "\n"
+              << key << "_photons_per_s " << nPhotons / elapsed << "\n"
+              << key << "_speedup " << digitizeReference / elapsed << "\n"
+              << key << "_allocations_per_event " << (gAllocations.load() - allocations) / (double)nEvents << "\n";
+  }
+
+  // Self-triggering, one event at a time as in opDetDigitizerSBND
+  std::vector<raw::OpDetWaveform> triggeredWaveforms;
+  {
+    size_t const allocations = gAllocations.load();
+    auto const start = std::chrono::steady_clock::now();
+    for (auto const& waveforms : fullWaveforms) {
+      for (raw::OpDetWaveform const& waveform : waveforms) {
+        raw::Channel_t const ch = waveform.ChannelNumber();
+        if (ch == std::numeric_limits<raw::Channel_t>::max() /* "NULL" value*/) continue;
+        raw::ADC_Count_t const baseline = (map.isPDType(ch, "pmt_uncoated") || map.isPDType(ch, "pmt_coated")) ?
+                                          pmtBaseline : arapucaBaseline;
+        triggerAlg.FindTriggerLocations(clockData, setup.enableWindow, waveform, baseline);
+      }
+      triggerAlg.MergeTriggerLocations();
+      for (raw::OpDetWaveform const& waveform : waveforms) {
+        if (waveform.ChannelNumber() == std::numeric_limits<raw::Channel_t>::max()) continue;
+        std::vector<raw::OpDetWaveform> triggered = triggerAlg.ApplyTriggerLocations(clockData, waveform);
+        std::move(triggered.begin(), triggered.end(), std::back_inserter(triggeredWaveforms));
+      }
+      triggerAlg.ClearTriggerLocations();
+    }
+    double const elapsed = Seconds(start);
+
+    std::cout << "trigger_s " << elapsed << "\n"
+              << "trigger_events_per_s " << nEvents / elapsed << "\n"
+              << "trigger_waveforms_per_s " << nEvents * nChannels / elapsed << "\n"
+              << "trigger_allocations_per_event " << (gAllocations.load() - allocations) / (double)nEvents << "\n"
+              << "n_triggered_waveforms " << triggeredWaveforms.size() << "\n";
+  }
+  fullWaveforms.clear();
+
+  // Hit finding on the triggered waveforms
+  double hitFinderReference = 0.;
+  for (unsigned const nThreads : threadCounts) {
+    std::vector<std::unique_ptr<opdet::opHitFinderSBNDAlg>> hitFinders;
+    for (unsigned t = 0; t < nThreads; t++) {
+      hitFinders.push_back(std::make_unique<opdet::opHitFinderSBNDAlg>(setup.hitFinderConfig,
+                                                                       clockData.OpticalClock().Frequency()));
+    }
+    std::vector<std::vector<recob::OpHit>> hits(nThreads);
+
+    size_t const allocations = gAllocations.load();
+    auto const start = std::chrono::steady_clock::now();
+    RunOnThreads(nThreads, triggeredWaveforms.size(), [&](unsigned t, size_t first, size_t n) {
+      for (size_t i = first; i < first + n; i++) hitFinders[t]->FindHits(triggeredWaveforms[i], hits[t]);
+    });
+    double const elapsed = Seconds(start);
+    if (hitFinderReference == 0.) hitFinderReference = elapsed;
+
+    size_t nHits = 0;
+    for (auto const& h : hits) nHits += h.size();
+
+    std::string const key = "hitfinder_threads_" + std::to_string(nThreads);
+    std::cout << key << "_s " << elapsed << "\n"
+              << key << "_events_per_s " << nEvents / elapsed << "\n"
+              << key << "_waveforms_per_s " << triggeredWaveforms.size() / elapsed << "\n"
+              << key << "_speedup " << hitFinderReference / elapsed << "\n"
+              << key << "_allocations_per_event " << (gAllocations.load() - allocations) / (double)nEvents << "\n"
+              << key << "_n_hits " << nHits << "\n";
+  }
+
+  return 0;
+}
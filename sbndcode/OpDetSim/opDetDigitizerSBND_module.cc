@@ -293,6 +293,7 @@ namespace opdet {
 
     if (fApplyTriggers) {
       // find the trigger locations for the waveforms
+      const std::array<double, 2> trigger_window = fTriggerAlg.TriggerEnableWindow(clockData, detProp);
       for (const raw::OpDetWaveform &waveform : fWaveforms) {
         raw::Channel_t ch = waveform.ChannelNumber();
         // skip light channels which don't correspond to readout channels
@@ -301,7 +302,7 @@ namespace opdet {
         }
         raw::ADC_Count_t baseline = (map.isPDType(ch, "pmt_uncoated") || map.isPDType(ch, "pmt_coated")) ?
                                     fPMTBaseline : fArapucaBaseline;
-        fTriggerAlg.FindTriggerLocations(clockData, detProp, waveform, baseline);
+        fTriggerAlg.FindTriggerLocations(clockData, trigger_window, waveform, baseline);
       }
 
       // combine the triggers
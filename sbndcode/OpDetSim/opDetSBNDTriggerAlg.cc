@@ -62,6 +62,12 @@ opDetSBNDTriggerAlg::opDetSBNDTriggerAlg(const Config &config):
 void opDetSBNDTriggerAlg::FindTriggerLocations(detinfo::DetectorClocksData const& clockData,
                                                detinfo::DetectorPropertiesData const& detProp,
                                                const raw::OpDetWaveform &waveform, raw::ADC_Count_t baseline) {
+  FindTriggerLocations(clockData, TriggerEnableWindow(clockData, detProp), waveform, baseline);
+}
+
+void opDetSBNDTriggerAlg::FindTriggerLocations(detinfo::DetectorClocksData const& clockData,
+                                               std::array<double, 2> const& trigger_window,
+                                               const raw::OpDetWaveform &waveform, raw::ADC_Count_t baseline) {
   std::vector<std::array<raw::TimeStamp_t, 2>> this_trigger_ranges;
   const std::vector<raw::ADC_Count_t> &adcs = waveform; // upcast to get adcs
   raw::Channel_t channel = waveform.ChannelNumber();
@@ -88,20 +94,17 @@ void opDetSBNDTriggerAlg::FindTriggerLocations(detinfo::DetectorClocksData const
   int polarity = is_arapuca ? fConfig.PulsePolarityArapuca() : fConfig.PulsePolarityPMT(); 
 
   // find the start and end points of the trigger window in this waveform
-  std::array<double, 2> trigger_window = TriggerEnableWindow(clockData, detProp);
   raw::TimeStamp_t start = tick_to_timestamp(clockData, waveform.TimeStamp(), 0);
 
   if (start > trigger_window[1]) return;
   size_t start_i = start > trigger_window[0] ? 0 : (size_t)((trigger_window[0] - start) / optical_period(clockData));
 
   // fix rounding on division if necessary
-  if (!IsTriggerEnabled(clockData,
-                        detProp,
+  if (!IsTriggerEnabled(trigger_window,
                         tick_to_timestamp(clockData, waveform.TimeStamp(), start_i))) {
     start_i += 1;
   }
-  assert(IsTriggerEnabled(clockData,
-                          detProp,
+  assert(IsTriggerEnabled(trigger_window,
                           tick_to_timestamp(clockData, waveform.TimeStamp(), start_i)));
 
   // if start is past end of waveform, we can return
@@ -112,13 +115,11 @@ void opDetSBNDTriggerAlg::FindTriggerLocations(detinfo::DetectorClocksData const
   // size_t end_i = end > trigger_window[1] ? adcs.size()-1 : (size_t)((trigger_window[1] - start) / optical_period(clockData));
   size_t end_i = end < trigger_window[1] ? adcs.size()-1 : (size_t)((trigger_window[1] - start) / optical_period(clockData));
   // fix rounding error...
-  if (IsTriggerEnabled(clockData,
-                       detProp,
+  if (IsTriggerEnabled(trigger_window,
                        tick_to_timestamp(clockData, waveform.TimeStamp(), end_i+1)) && end_i+1 < adcs.size()) {
     end_i += 1;
   }
-  assert(end_i+1 == adcs.size() || !IsTriggerEnabled(clockData,
-                                                     detProp,
+  assert(end_i+1 == adcs.size() || !IsTriggerEnabled(trigger_window,
                                                      tick_to_timestamp(clockData, waveform.TimeStamp(), end_i+1)));
 
   std::vector<std::array<raw::TimeStamp_t, 2>> this_trigger_locations; 
@@ -275,14 +276,11 @@ std::array<double, 2> opDetSBNDTriggerAlg::TriggerEnableWindow(detinfo::Detector
   return {{start, end}};
 }
 
-bool opDetSBNDTriggerAlg::IsTriggerEnabled(detinfo::DetectorClocksData const& clockData,
-                                           detinfo::DetectorPropertiesData const& detProp,
+bool opDetSBNDTriggerAlg::IsTriggerEnabled(std::array<double, 2> const& trigger_window,
                                            raw::TimeStamp_t trigger_time) const {
   // otherwise check the start and end
-  std::array<double, 2> trigger_range = TriggerEnableWindow(clockData, detProp);
-
-  return trigger_time >= trigger_range[0] &&
-         trigger_time <= trigger_range[1];
+  return trigger_time >= trigger_window[0] &&
+         trigger_time <= trigger_window[1];
 }
 
 const std::vector<raw::TimeStamp_t> &opDetSBNDTriggerAlg::GetTriggerTimes(raw::Channel_t channel) const {
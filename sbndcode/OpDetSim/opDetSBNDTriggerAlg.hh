@@ -219,6 +219,12 @@ namespace opdet {
                               const raw::OpDetWaveform &waveform,
                               raw::ADC_Count_t baseline);
 
+    // As above, with the trigger enable window [us] already computed
+    void FindTriggerLocations(detinfo::DetectorClocksData const& clockData,
+                              std::array<double, 2> const& trigger_window,
+                              const raw::OpDetWaveform &waveform,
+                              raw::ADC_Count_t baseline);
+
     // Merge all of the triggers together
     void MergeTriggerLocations();
 
@@ -233,8 +239,7 @@ namespace opdet {
 
     // internal functions
     bool IsChannelMasked(raw::Channel_t channel) const;
-    bool IsTriggerEnabled(detinfo::DetectorClocksData const& clockData,
-                          detinfo::DetectorPropertiesData const& detProp,
+    bool IsTriggerEnabled(std::array<double, 2> const& trigger_window,
                           raw::TimeStamp_t trigger_time) const;
     raw::TimeStamp_t Tick2Timestamp(raw::TimeStamp_t waveform_start, size_t waveform_index) const;
     const std::vector<raw::TimeStamp_t> &GetTriggerTimes(raw::Channel_t channel) const;
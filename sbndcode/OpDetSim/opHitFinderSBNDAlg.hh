@@ -0,0 +1,73 @@
+////////////////////////////////////////////////////////////////////////
+// File:        opHitFinderSBNDAlg.hh
+//
+// Hit finding on SBND OpDetWaveforms: baseline subtraction, optional
+// denoising of the arapuca waveforms and iterative peak finding.
+// Used by opHitFinderSBND, and directly by the optical detsim benchmark.
+// Created by L. Paulucci, F. Marinho, and I.L. de Icaza
+////////////////////////////////////////////////////////////////////////
+
+#ifndef SBND_OPDETSIM_OPHITFINDERSBNDALG_HH
+#define SBND_OPDETSIM_OPHITFINDERSBNDALG_HH
+
+#include "fhiclcpp/ParameterSet.h"
+#include "lardataobj/RawData/OpDetWaveform.h"
+#include "lardataobj/RecoBase/OpHit.h"
+
+#include "sbndcode/OpDetSim/sbndPDMapAlg.hh"
+
+#include <string>
+#include <vector>
+
+namespace opdet {
+
+  class opHitFinderSBNDAlg {
+
+  public:
+
+    struct ConfigurationParameters_t {
+      int BaselineSample;          //in ticks
+      double Saturation;           //in number of p.e.
+      double Area1pePMT;           //area of 1 pe in ADC*ns for PMTs
+      double Area1peSiPM;          //area of 1 pe in ADC*ns for Arapucas
+      int ThresholdPMT;            //in ADC
+      int ThresholdArapuca;        //in ADC
+      double PulsePolarityPMT;
+      double PulsePolarityArapuca;
+      bool UseDenoising;
+      double Sampling;             //in MHz
+    };
+
+    opHitFinderSBNDAlg(ConfigurationParameters_t const& config);
+
+    // Reads the configuration from the opHitFinderSBND parameters;
+    // the sampling (in MHz) comes from the DetectorClocks.
+    opHitFinderSBNDAlg(fhicl::ParameterSet const& p, double sampling);
+
+    // Appends the hits found in the waveform to hits
+    void FindHits(raw::OpDetWaveform const& wvf, std::vector<recob::OpHit>& hits);
+
+  private:
+
+    ConfigurationParameters_t fParams;
+    opdet::sbndPDMapAlg map; //map for photon detector types
+
+    // work buffers, reused across waveforms
+    std::vector<double> fwaveform;
+    std::vector<double> outwvform;
+
+    void subtractBaseline(std::vector<double>& waveform, std::string const& pdtype, double& rms) const;
+    bool findAndSuppressPeak(std::vector<double>& waveform, size_t& timebin,
+                             double& Area, double& amplitude,
+                             const int& threshold, const std::string& opdetType) const;
+    void denoise(std::vector<double>& waveform, std::vector<double>& outwaveform) const;
+    bool TV1D_denoise(std::vector<double>& waveform,
+                      std::vector<double>& outwaveform,
+                      const double lambda) const;
+    void TV1D_denoise_v2(std::vector<double>& input, std::vector<double>& output,
+                         unsigned int width, const double lambda) const;
+  };
+
+} // namespace opdet
+
+#endif // SBND_OPDETSIM_OPHITFINDERSBNDALG_HH
@@ -0,0 +1,102 @@
+////////////////////////////////////////////////////////////////////////
+// Class:       CachedPhotonLibHypothesis
+// File:        CachedPhotonLibHypothesis.cc
+////////////////////////////////////////////////////////////////////////
+
+#include "sbndcode/OpT0Finder/CachedPhotonLibHypothesis.h"
+
+#include "art/Framework/Services/Registry/ServiceHandle.h"
+#include "larsim/PhotonPropagation/PhotonVisibilityService.h"
+#include "larcoreobj/SimpleTypesAndConstants/geo_vectors.h"
+
+#include <algorithm>
+
+namespace flashmatch {
+
+  static CachedPhotonLibHypothesisFactory __global_CachedPhotonLibHypothesisFactory__;
+
+  CachedPhotonLibHypothesis::CachedPhotonLibHypothesis(const std::string name)
+    : BaseFlashHypothesis(name)
+  {}
+
+  void CachedPhotonLibHypothesis::_Configure_(const Config_t &pset)
+  {
+    _global_qe      = pset.get<double>("GlobalQE");
+    _global_qe_refl = pset.get<double>("GlobalQERefl");
+    _cache.SetMaxVoxels(pset.get<size_t>("MaxCachedVoxels", 0));
+    _n_opdets = 0;
+  }
+
+  void CachedPhotonLibHypothesis::SetupChannels(size_t n_opdets) const
+  {
+    _n_opdets = n_opdets;
+    _ch_v.clear();
+    _direct_weight_v.clear();
+    _refl_weight_v.clear();
+
+    for (size_t ch = 0; ch < n_opdets; ch++) {
+      if (std::find(_channel_mask.begin(), _channel_mask.end(), (int)ch) == _channel_mask.end()) continue;
+      bool const uncoated =
+        std::find(_uncoated_pmt_list.begin(), _uncoated_pmt_list.end(), (int)ch) != _uncoated_pmt_list.end();
+      _ch_v.push_back(ch);
+      _direct_weight_v.push_back(uncoated ? 0. : _global_qe);
+      _refl_weight_v.push_back(_global_qe_refl);
+    }
+
+    _cache.SetNChannels(_ch_v.size());
+  }
+
+  void CachedPhotonLibHypothesis::FillRow(int /* voxel */, double x, double y, double z, float* row) const
+  {
+    art::ServiceHandle<phot::PhotonVisibilityService const> pvs;
+    geo::Point_t const xyz{x, y, z};
+
+    auto const direct = pvs->GetAllVisibilities(xyz);
+    auto const reflected = pvs->GetAllVisibilities(xyz, true);
+
+    // Only called for voxels inside the library
+    for (size_t k = 0; k < _ch_v.size(); k++) {
+      row[k] = _direct_weight_v[k] * direct[_ch_v[k]] + _refl_weight_v[k] * reflected[_ch_v[k]];
+    }
+  }
+
+  void CachedPhotonLibHypothesis::FillEstimate(const QCluster_t& trk, Flash_t& flash) const
+  {
+    if (_n_opdets != flash.pe_v.size() || _ch_v.empty()) SetupChannels(flash.pe_v.size());
+
+    for (auto& v : flash.pe_v) v = 0;
+    if (_ch_v.empty() || trk.empty()) return;
+
+    art::ServiceHandle<phot::PhotonVisibilityService const> pvs;
+    auto const& voxel_def = pvs->GetVoxelDef();
+
+    // Split the cluster into voxel keys and charges
+    size_t const n_pts = trk.size();
+    _voxel_v.resize(n_pts);
+    _x_v.resize(n_pts);
+    _y_v.resize(n_pts);
+    _z_v.resize(n_pts);
+    _q_v.resize(n_pts);
+    for (size_t i = 0; i < n_pts; i++) {
+      auto const& pt = trk[i];
+      _voxel_v[i] = voxel_def.GetVoxelID(geo::Point_t{pt.x, pt.y, pt.z});
+      _x_v[i] = pt.x;
+      _y_v[i] = pt.y;
+      _z_v[i] = pt.z;
+      _q_v[i] = pt.q;
+    }
+
+    // Gather the cached rows and sum them
+    _cache.Gather(_voxel_v, _x_v, _y_v, _z_v,
+                  [this](int voxel, double x, double y, double z, float* row) { FillRow(voxel, x, y, z, row); },
+                  _row_v, _scratch_v);
+
+    _pe_v.assign(_ch_v.size(), 0.);
+    AccumulateRows(_row_v, _q_v, _ch_v.size(), _pe_v.data());
+
+    for (size_t k = 0; k < _ch_v.size(); k++) {
+      flash.pe_v[_ch_v[k]] = _pe_v[k];
+    }
+  }
+
+}
@@ -0,0 +1,87 @@
+////////////////////////////////////////////////////////////////////////
+// Class:       CachedPhotonLibHypothesis
+// File:        CachedPhotonLibHypothesis.h
+//
+// Flash hypothesis from the photon library, with the per-channel light
+// yield of each library voxel cached for the whole job. Only the
+// channels in the channel mask are cached. Coated PMTs see direct and
+// reflected light, uncoated PMTs only reflected light.
+//
+// The cache is exact for a non-interpolated photon library, as every
+// point in a voxel has the same visibility.
+////////////////////////////////////////////////////////////////////////
+
+#ifndef SBND_CACHEDPHOTONLIBHYPOTHESIS_H
+#define SBND_CACHEDPHOTONLIBHYPOTHESIS_H
+
+#include "sbncode/OpT0Finder/flashmatch/Base/BaseFlashHypothesis.h"
+#include "sbncode/OpT0Finder/flashmatch/Base/FlashHypothesisFactory.h"
+
+#include "sbndcode/OpT0Finder/VisibilityCache.h"
+
+#include <string>
+#include <vector>
+
+namespace flashmatch {
+
+  class CachedPhotonLibHypothesis : public BaseFlashHypothesis {
+
+  public:
+
+    CachedPhotonLibHypothesis(const std::string name="SBNDCachedPhotonLibHypothesis");
+
+    ~CachedPhotonLibHypothesis() {}
+
+    void FillEstimate(const QCluster_t&, Flash_t&) const;
+
+    /// Number of voxels currently cached
+    size_t NCachedVoxels() const { return _cache.Size(); }
+
+  protected:
+
+    void _Configure_(const Config_t &pset);
+
+  private:
+
+    /// (Re)builds the list of cached channels and their weights from the channel mask
+    void SetupChannels(size_t n_opdets) const;
+
+    /// Fills the cached row of a voxel, given a point inside it
+    void FillRow(int voxel, double x, double y, double z, float* row) const;
+
+    double _global_qe;      ///< QE applied to the direct light
+    double _global_qe_refl; ///< QE applied to the reflected light
+
+    mutable VisibilityCache _cache;
+    mutable size_t _n_opdets = 0;
+    mutable std::vector<int> _ch_v;              ///< cached channels, in row order
+    mutable std::vector<float> _direct_weight_v; ///< weight of the direct light per cached channel
+    mutable std::vector<float> _refl_weight_v;   ///< weight of the reflected light per cached channel
+
+    // Work buffers, reused across calls
+    mutable std::vector<int> _voxel_v;
+    mutable std::vector<double> _x_v, _y_v, _z_v;
+    mutable std::vector<float> _q_v;
+    mutable std::vector<const float*> _row_v;
+    mutable std::vector<float> _scratch_v;
+    mutable std::vector<float> _pe_v;
+
+  };
+
+  /**
+     \class flashmatch::CachedPhotonLibHypothesisFactory
+  */
+  class CachedPhotonLibHypothesisFactory : public FlashHypothesisFactoryBase {
+
+  public:
+    /// ctor
+    CachedPhotonLibHypothesisFactory() { FlashHypothesisFactory::get().add_factory("SBNDCachedPhotonLibHypothesis",this); }
+    /// dtor
+    ~CachedPhotonLibHypothesisFactory() {}
+    /// creation method
+    BaseFlashHypothesis* create(const std::string instance_name) { return new CachedPhotonLibHypothesis(instance_name); }
+  };
+
+}
+
+#endif
@@ -44,6 +44,8 @@
 #include "TFile.h"
 #include "TTree.h"
 
+#include <algorithm>
+#include <map>
 #include <memory>
 
 
@@ -68,15 +70,39 @@ public:
 
 private:
 
-  /// Performs the matching in a specified tpc
-  void DoMatch(art::Event& e,
-               int tpc,
-               std::unique_ptr<std::vector<anab::T0>> & t0_v,
-               std::unique_ptr< art::Assns<recob::Slice, anab::T0>> & slice_t0_assn_v,
-               std::unique_ptr< art::Assns<recob::OpFlash, anab::T0>> & flash_t0_assn_v);
-
-  /// Constructs all the LightClusters (TPC Objects) in a specified TPC
-  bool ConstructLightClusters(art::Event& e, unsigned int tpc);
+  /// Holds the matching inputs and outputs for one TPC, so that
+  /// TPCs can be matched independently of each other
+  struct TPCMatch {
+    unsigned int tpc;
+    bool do_match = false; ///< Whether there are flashes and clusters to match
+    std::unique_ptr<::flashmatch::FlashMatchManager> mgr; ///< The flash matching manager
+    std::vector<flashmatch::FlashMatch_t> result_v; ///< Matching result will be stored here
+    std::vector<::flashmatch::Flash_t> flash_v; ///< Flashes to be matched, reused across events
+    std::vector<flashmatch::QCluster_t> light_cluster_v; ///< TPC objects, reused across events
+    std::vector<art::Ptr<recob::Slice>> clusterid_to_slice; ///< tpc object id -> Slice
+    std::vector<art::Ptr<recob::OpFlash>> flashid_to_opflash; ///< flash id -> OpFlash
+
+    // Deposits for the slice_deposition_tree, flattened over slices
+    std::vector<size_t> dep_slice_offset; ///< First deposit of each slice (size n_slices + 1)
+    std::vector<float> dep_x, dep_y, dep_z, dep_charge, dep_n_photons;
+    std::vector<int> dep_slice;
+  };
+
+  /// Constructs the flashes to be matched in the TPC, returns false if there are none
+  bool ConstructFlashes(art::Event& e, TPCMatch& match);
+
+  /// Constructs all the LightClusters (TPC Objects) for all TPCs in a single pass over the slices
+  bool ConstructLightClusters(art::Event& e);
+
+  /// Runs the flash matching manager in the TPC
+  void DoMatch(TPCMatch& match);
+
+  /// Saves the matches in the TPC to the output tree and data products
+  void StoreMatches(art::Event& e,
+                    TPCMatch& match,
+                    std::vector<anab::T0>& t0_v,
+                    art::Assns<recob::Slice, anab::T0>& slice_t0_assn_v,
+                    art::Assns<recob::OpFlash, anab::T0>& flash_t0_assn_v);
 
   /// Returns the number of photons given charge and PFParticle
   float GetNPhotons(const float charge, const art::Ptr<recob::PFParticle> &pfp);
@@ -87,8 +113,7 @@ private:
   /// Returns a list of uncoated PMTs that are a subset of those in ch_to_use
   std::vector<int> GetUncoatedPTMList(std::vector<int> ch_to_use);
 
-  ::flashmatch::FlashMatchManager _mgr; ///< The flash matching manager
-  std::vector<flashmatch::FlashMatch_t> _result_v; ///< Matching result will be stored here
+  std::vector<TPCMatch> _match_v; ///< Matching state, one per TPC in _tpc_v
 
   std::vector<std::string> _opflash_producer_v; ///< The OpFlash producers (to be set)
   std::vector<unsigned int> _tpc_v; ///< TPC number per OpFlash producer (to be set)
@@ -103,15 +128,12 @@ private:
   std::vector<std::string> _photo_detectors; ///< The photodetector to use (to be set)
   std::vector<int> _opch_to_use; ///< List of opch to use (will be infered from _photo_detectors)
   std::vector<int> _uncoated_pmts; ///< List of uncoated opch to use (will be infered from _opch_to_use)
+  std::vector<unsigned int> _opch_to_opdet; ///< OpDet for each opch (will be infered from geometry)
+  std::vector<bool> _opch_in_use; ///< Whether each opch is in _opch_to_use
 
   opdet::sbndPDMapAlg _pds_map; ///< map for photon detector types
   // std::unique_ptr<opdet::sbndPDMapAlg> _pds_map;
 
-  std::vector<flashmatch::QCluster_t> _light_cluster_v; ///< Vector that contains all the TPC objects
-
-  std::map<int, art::Ptr<recob::Slice>> _clusterid_to_slice; /// Will contain map tpc object id -> Slice
-  std::map<int, art::Ptr<recob::OpFlash>> _flashid_to_opflash; /// Will contain map flash id -> OpFlash
-
   TTree* _tree1;
   int _run, _subrun, _event;
   int _tpc;
@@ -156,11 +178,25 @@ SBNDOpT0Finder::SBNDOpT0Finder(fhicl::ParameterSet const& p)
       << "TPC vector and OpFlash producer vector don't have the same size, check your fcl params.";
   }
 
-  _mgr.Configure(p.get<flashmatch::Config_t>("FlashMatchConfig"));
-
-  _mgr.SetChannelMask(_opch_to_use);
+  // One independent manager per TPC; all of them use the PhotoDetectors
+  // channel mask, which overrides any channel selection in FlashMatchConfig
+  auto const flashmatch_config = p.get<flashmatch::Config_t>("FlashMatchConfig");
+  _match_v.resize(_tpc_v.size());
+  for (size_t i = 0; i < _tpc_v.size(); i++) {
+    auto& match = _match_v[i];
+    match.tpc = _tpc_v[i];
+    match.mgr = std::make_unique<::flashmatch::FlashMatchManager>();
+    match.mgr->Configure(flashmatch_config);
+    match.mgr->SetChannelMask(_opch_to_use);
+    match.mgr->SetUncoatedPMTs(_uncoated_pmts);
+  }
 
-  _mgr.SetUncoatedPMTs(_uncoated_pmts);
+  _opch_to_opdet.resize(geo->NOpDets());
+  _opch_in_use.resize(geo->NOpDets(), false);
+  for (unsigned int op_ch = 0; op_ch < _opch_to_opdet.size(); op_ch++) {
+    _opch_to_opdet[op_ch] = geo->OpDetFromOpChannel(op_ch);
+    _opch_in_use[op_ch] = std::find(_opch_to_use.begin(), _opch_to_use.end(), op_ch) != _opch_to_use.end();
+  }
 
 
   _flash_spec.resize(geo->NOpDets(), 0.);
@@ -203,29 +239,63 @@ void SBNDOpT0Finder::produce(art::Event& e)
   std::unique_ptr< art::Assns<recob::Slice, anab::T0>> slice_t0_assn_v (new art::Assns<recob::Slice, anab::T0>);
   std::unique_ptr< art::Assns<recob::OpFlash, anab::T0>> flash_t0_assn_v (new art::Assns<recob::OpFlash, anab::T0>);
 
-  // _mgr.PrintConfig();
-
   _run    = e.id().run();
   _subrun = e.id().subRun();
   _event  = e.id().event();
 
-  // Loop over the specified TPCs
-  for (auto tpc : _tpc_v) {
-
-    mf::LogInfo("SBNDOpT0Finder") << "Performing matching in TPC " << tpc << std::endl;
+  // Collect the flashes in every TPC
+  bool any_flashes = false;
+  for (auto& match : _match_v) {
 
     // Reset the manager and the result vector
-    _mgr.Reset();
-    _result_v.clear();
-    _tpc = tpc;
+    match.mgr->Reset();
+    match.result_v.clear();
+    match.do_match = ConstructFlashes(e, match);
+    any_flashes |= match.do_match;
 
     // Tell the manager what TPC and cryostat we are going to be doing
     // the matching in. For SBND, the cryostat is always zero.
-    _mgr.SetTPCCryo(tpc, 0);
+    match.mgr->SetTPCCryo(match.tpc, 0);
+  }
+
+  // Get all the light clusters, for all TPCs at once
+  if (any_flashes && !ConstructLightClusters(e)) {
+    mf::LogWarning("SBNDOpT0Finder") << "Cannot construct Light Clusters." << std::endl;
+    for (auto& match : _match_v) match.do_match = false;
+  }
+
+  for (auto& match : _match_v) {
+    if (!match.do_match) continue;
+
+    // Save the deposits, one entry per slice
+    _tpc = match.tpc;
+    for (size_t n_slice = 0; n_slice + 1 < match.dep_slice_offset.size(); n_slice++) {
+      auto const begin = match.dep_slice_offset[n_slice];
+      auto const end = match.dep_slice_offset[n_slice + 1];
+      _dep_slice.assign(match.dep_slice.begin() + begin, match.dep_slice.begin() + end);
+      _dep_x.assign(match.dep_x.begin() + begin, match.dep_x.begin() + end);
+      _dep_y.assign(match.dep_y.begin() + begin, match.dep_y.begin() + end);
+      _dep_z.assign(match.dep_z.begin() + begin, match.dep_z.begin() + end);
+      _dep_charge.assign(match.dep_charge.begin() + begin, match.dep_charge.begin() + end);
+      _dep_n_photons.assign(match.dep_n_photons.begin() + begin, match.dep_n_photons.begin() + end);
+      _tree1->Fill();
+    }
+
+    // Don't waste time if there are no clusters
+    if (match.light_cluster_v.empty()) {
+      mf::LogWarning("SBNDOpT0Finder") << "No slices to work with." << std::endl;
+      match.do_match = false;
+    }
+  }
 
-    // Perform the matching in the specified TPC
-    DoMatch(e, tpc, t0_v, slice_t0_assn_v, flash_t0_assn_v);
+  // Perform the matching in the specified TPCs, each TPC has its own manager;
+  // the TPCs are matched one after the other, since the QLL matcher minimises
+  // through a process-wide singleton and the global gMinuit
+  for (auto& match : _match_v) DoMatch(match);
 
+  // Store the results in the order of the TPCs
+  for (auto& match : _match_v) {
+    StoreMatches(e, match, *t0_v, *slice_t0_assn_v, *flash_t0_assn_v);
   }
 
   // Finally, place the anab::T0 vector and the associations in the Event
@@ -236,53 +306,41 @@ void SBNDOpT0Finder::produce(art::Event& e)
   return;
 }
 
-void SBNDOpT0Finder::DoMatch(art::Event& e,
-                             int tpc,
-                             std::unique_ptr<std::vector<anab::T0>> & t0_v,
-                             std::unique_ptr< art::Assns<recob::Slice, anab::T0>> & slice_t0_assn_v,
-                             std::unique_ptr< art::Assns<recob::OpFlash, anab::T0>> & flash_t0_assn_v) {
+bool SBNDOpT0Finder::ConstructFlashes(art::Event& e, TPCMatch& match) {
 
-  _flashid_to_opflash.clear();
-  _clusterid_to_slice.clear();
+  match.flashid_to_opflash.clear();
+  match.flash_v.clear();
 
-  auto const & flash_h = e.getValidHandle<std::vector<recob::OpFlash>>(_opflash_producer_v[tpc]);
+  auto const& producer = _opflash_producer_v[match.tpc];
+  auto const & flash_h = e.getValidHandle<std::vector<recob::OpFlash>>(producer);
   if(!flash_h.isValid() || flash_h->empty()) {
     mf::LogWarning("SBNDOpT0Finder") << "Don't have good flashes from producer "
-                                     << _opflash_producer_v[tpc] << std::endl;
-    return;
+                                     << producer << std::endl;
+    return false;
   }
 
   // Construct the vector of OpFlashes
   std::vector<art::Ptr<recob::OpFlash>> flash_v;
   art::fill_ptr_vector(flash_v, flash_h);
 
-  ::art::ServiceHandle<geo::Geometry> geo;
-
-  int n_flashes = 0;
-  std::vector<::flashmatch::Flash_t> all_flashes;
-
   for (size_t n = 0; n < flash_v.size(); n++) {
 
     auto const& flash = *flash_v[n];
 
-    mf::LogDebug("SBNDOpT0Finder") << "Flash time from " << _opflash_producer_v[tpc] << ": " << flash.Time() << std::endl;
+    mf::LogDebug("SBNDOpT0Finder") << "Flash time from " << producer << ": " << flash.Time() << std::endl;
 
     if(flash.Time() < _flash_trange_start || _flash_trange_end < flash.Time()) {
       continue;
     }
 
-    _flashid_to_opflash[n_flashes] = flash_v[n];
-
-    n_flashes++;
-
     // Construct a Flash_t
     ::flashmatch::Flash_t f;
     f.x = f.x_err = 0;
-    f.pe_v.resize(geo->NOpDets());
-    f.pe_err_v.resize(geo->NOpDets());
+    f.pe_v.resize(_opch_to_opdet.size());
+    f.pe_err_v.resize(_opch_to_opdet.size());
     for (unsigned int op_ch = 0; op_ch < f.pe_v.size(); op_ch++) {
-      unsigned int opdet = geo->OpDetFromOpChannel(op_ch);
-      if (std::find(_opch_to_use.begin(), _opch_to_use.end(), op_ch) == _opch_to_use.end()) {
+      unsigned int opdet = _opch_to_opdet[op_ch];
+      if (!_opch_in_use[op_ch]) {
         f.pe_v[opdet] = 0;
         f.pe_err_v[opdet] = 0;
       } else {
@@ -295,53 +353,58 @@ void SBNDOpT0Finder::DoMatch(art::Event& e,
     f.y_err = flash.YWidth();
     f.z_err = flash.ZWidth();
     f.time = flash.Time();
-    f.idx = n_flashes-1;
-    all_flashes.resize(n_flashes);
-    all_flashes[n_flashes-1] = f;
+    f.idx = match.flash_v.size();
+
+    match.flashid_to_opflash.push_back(flash_v[n]);
+    match.flash_v.emplace_back(std::move(f));
 
   } // flash loop
 
   // Don't waste time if there are no flashes
-  if (n_flashes == 0) {
+  if (match.flash_v.empty()) {
     mf::LogWarning("SBNDOpT0Finder") << "Zero good flashes in this event." << std::endl;
-    return;
+    return false;
   }
 
-  // Get all the ligh clusters
-  // auto light_cluster_v = GetLighClusters(e);
-  if (!ConstructLightClusters(e, tpc)) {
-    mf::LogWarning("SBNDOpT0Finder") << "Cannot construct Light Clusters." << std::endl;
-    return;
-  }
+  return true;
+}
 
-  // Don't waste time if there are no clusters
-  if (!_light_cluster_v.size()) {
-    mf::LogWarning("SBNDOpT0Finder") << "No slices to work with." << std::endl;
-    return;
-  }
+void SBNDOpT0Finder::DoMatch(TPCMatch& match) {
+
+  if (!match.do_match) return;
 
-  // Emplace flashes to Flash Matching Manager
-  for (auto f : all_flashes) {
-    _mgr.Emplace(std::move(f));
+  mf::LogInfo("SBNDOpT0Finder") << "Performing matching in TPC " << match.tpc << std::endl;
+
+  // Emplace flashes and clusters to Flash Matching Manager
+  for (auto& f : match.flash_v) {
+    match.mgr->Emplace(std::move(f));
   }
 
-  // Emplace clusters to Flash Matching Manager
-  for (auto lc : _light_cluster_v) {
-    _mgr.Emplace(std::move(lc));
+  for (auto& lc : match.light_cluster_v) {
+    match.mgr->Emplace(std::move(lc));
   }
 
   // Run the matching
-  _result_v = _mgr.Match();
+  match.result_v = match.mgr->Match();
+}
+
+void SBNDOpT0Finder::StoreMatches(art::Event& e,
+                                  TPCMatch& match,
+                                  std::vector<anab::T0>& t0_v,
+                                  art::Assns<recob::Slice, anab::T0>& slice_t0_assn_v,
+                                  art::Assns<recob::OpFlash, anab::T0>& flash_t0_assn_v) {
+
+  _tpc = match.tpc;
 
   // Loop over the matching results
-  for(_matchid = 0; _matchid < (int)(_result_v.size()); ++_matchid) {
+  for(_matchid = 0; _matchid < (int)(match.result_v.size()); ++_matchid) {
 
-    auto const& match = _result_v[_matchid];
+    auto const& result = match.result_v[_matchid];
 
-    _tpcid    = match.tpc_id;
-    _flashid  = match.flash_id;
-    _score    = match.score;
-    _qll_xmin = match.tpc_point.x;
+    _tpcid    = result.tpc_id;
+    _flashid  = result.flash_id;
+    _score    = result.score;
+    _qll_xmin = result.tpc_point.x;
 
     mf::LogInfo("SBNDOpT0Finder") << "Matched TPC object " << _tpcid
                                   << " with flash number " << _flashid
@@ -350,19 +413,19 @@ void SBNDOpT0Finder::DoMatch(art::Event& e,
 
     // Get the minimum x position of the TPC Object
     _tpc_xmin = 1.e4;
-    for(auto const& pt : _mgr.QClusterArray()[_tpcid]) {
+    for(auto const& pt : match.mgr->QClusterArray()[_tpcid]) {
       if(pt.x < _tpc_xmin) _tpc_xmin = pt.x;
     }
 
     // Get the matched flash time, the t0
-    auto const& flash = _mgr.FlashArray()[_flashid];
+    auto const& flash = match.mgr->FlashArray()[_flashid];
     _t0 = flash.time;
 
     // Save the reconstructed flash and hypothesis flash PE spectrum
-    if(_hypo_spec.size() != match.hypothesis.size()) {
+    if(_hypo_spec.size() != result.hypothesis.size()) {
       throw cet::exception("SBNDOpT0Finder") << "Hypothesis size mismatch!";
     }
-    for(size_t pmt=0; pmt<_hypo_spec.size(); ++pmt) _hypo_spec[pmt]  = match.hypothesis[pmt];
+    for(size_t pmt=0; pmt<_hypo_spec.size(); ++pmt) _hypo_spec[pmt]  = result.hypothesis[pmt];
     for(size_t pmt=0; pmt<_hypo_spec.size(); ++pmt) _flash_spec[pmt] = flash.pe_v[pmt];
 
     // Also save the total number of photoelectrons
@@ -380,21 +443,34 @@ void SBNDOpT0Finder::DoMatch(art::Event& e,
                        _flashid,   // "ID": placing the flash id instead
                        _score);    // "TriggerConfidence": Matching score
 
-    t0_v->push_back(t0);
-    util::CreateAssn(*this, e, *t0_v, _clusterid_to_slice[_tpcid], *slice_t0_assn_v);
-    util::CreateAssn(*this, e, *t0_v, _flashid_to_opflash[_flashid], *flash_t0_assn_v);
+    t0_v.push_back(t0);
+    util::CreateAssn(*this, e, t0_v, match.clusterid_to_slice.at(_tpcid), slice_t0_assn_v);
+    util::CreateAssn(*this, e, t0_v, match.flashid_to_opflash.at(_flashid), flash_t0_assn_v);
   }
 
 }
 
-bool SBNDOpT0Finder::ConstructLightClusters(art::Event& e, unsigned int tpc) {
-  // One slice is one QCluster_t.
+bool SBNDOpT0Finder::ConstructLightClusters(art::Event& e) {
+  // One slice is one QCluster_t per TPC.
   // Start from a slice, get all the PFParticles, from there get all the spacepoints, from
   // there get all the hits on the collection plane.
   // Use the charge on the collection plane to estimate the light, and the 3D spacepoint
   // position for the 3D location.
-
-  _light_cluster_v.clear();
+  // The slices are traversed once, and each hit is assigned to the TPC it belongs to.
+
+  std::map<unsigned int, TPCMatch*> tpc_to_match;
+  for (auto& match : _match_v) {
+    match.light_cluster_v.clear();
+    match.clusterid_to_slice.clear();
+    match.dep_slice_offset.assign(1, 0);
+    match.dep_slice.clear();
+    match.dep_x.clear();
+    match.dep_y.clear();
+    match.dep_z.clear();
+    match.dep_charge.clear();
+    match.dep_n_photons.clear();
+    if (match.do_match) tpc_to_match[match.tpc] = &match;
+  }
 
   ::art::Handle<std::vector<recob::Slice>> slice_h;
   e.getByLabel(_slice_producer, slice_h);
@@ -426,79 +502,82 @@ bool SBNDOpT0Finder::ConstructLightClusters(art::Event& e, unsigned int tpc) {
   art::FindManyP<recob::SpacePoint> pfp_to_spacepoints (pfp_h, e, _slice_producer);
   art::FindManyP<recob::Hit> spacepoint_to_hits (spacepoint_h, e, _slice_producer);
 
+  std::map<unsigned int, flashmatch::QCluster_t> light_cluster_m;
+
   // Loop over the Slices
   for (size_t n_slice = 0; n_slice < slice_h->size(); n_slice++) {
 
-    flashmatch::QCluster_t light_cluster;
-
-    _dep_slice.clear();
-    _dep_x.clear();
-    _dep_y.clear();
-    _dep_z.clear();
-    _dep_charge.clear();
-    _dep_n_photons.clear();
+    light_cluster_m.clear();
 
     // Get the associated PFParticles
-    std::vector<art::Ptr<recob::PFParticle>> pfp_v = slice_to_pfps.at(n_slice);
+    auto const& pfp_v = slice_to_pfps.at(n_slice);
 
     for (size_t n_pfp = 0; n_pfp < pfp_v.size(); n_pfp++) {
 
-      auto pfp = pfp_v[n_pfp];
+      auto const& pfp = pfp_v[n_pfp];
+      float const charge_to_n_photons = GetNPhotons(1., pfp);
 
       // Get the associated SpacePoints
-      std::vector<art::Ptr<recob::SpacePoint>> spacepoint_v = pfp_to_spacepoints.at(pfp.key());
+      auto const& spacepoint_v = pfp_to_spacepoints.at(pfp.key());
 
       for (size_t n_spacepoint = 0; n_spacepoint < spacepoint_v.size(); n_spacepoint++) {
 
-        auto spacepoint = spacepoint_v[n_spacepoint];
+        auto const& spacepoint = spacepoint_v[n_spacepoint];
 
         // Get the associated hits
-        std::vector<art::Ptr<recob::Hit>> hit_v = spacepoint_to_hits.at(spacepoint.key());
+        auto const& hit_v = spacepoint_to_hits.at(spacepoint.key());
 
         for (size_t n_hit = 0; n_hit < hit_v.size(); n_hit++) {
 
-          auto hit = hit_v[n_hit];
+          auto const& hit = hit_v[n_hit];
 
           // Only select hits from the collection plane
           if (hit->View() != geo::kZ) {
             continue;
           }
 
-          // Only use hits (and so spacepoints) that are in the specified TPC
-          if (hit->WireID().TPC != tpc) {
+          // Only use hits (and so spacepoints) that are in the TPCs being matched
+          auto match_it = tpc_to_match.find(hit->WireID().TPC);
+          if (match_it == tpc_to_match.end()) {
             continue;
           }
+          auto& match = *(match_it->second);
 
           const auto &position(spacepoint->XYZ());
           const auto charge(hit->Integral());
+          const float n_photons = charge * charge_to_n_photons;
 
           // Emplace this point with charge to the light cluster
-          light_cluster.emplace_back(position[0],
-                                     position[1],
-                                     position[2],
-                                     GetNPhotons(charge, pfp));
+          light_cluster_m[match.tpc].emplace_back(position[0],
+                                                  position[1],
+                                                  position[2],
+                                                  n_photons);
 
           // Also save the quantites for the output tree
-          _dep_slice.push_back(_light_cluster_v.size());
-          _dep_x.push_back(position[0]);
-          _dep_y.push_back(position[1]);
-          _dep_z.push_back(position[2]);
-          _dep_charge.push_back(charge);
-          _dep_n_photons.push_back(GetNPhotons(charge, pfp));
+          match.dep_slice.push_back(match.light_cluster_v.size());
+          match.dep_x.push_back(position[0]);
+          match.dep_y.push_back(position[1]);
+          match.dep_z.push_back(position[2]);
+          match.dep_charge.push_back(charge);
+          match.dep_n_photons.push_back(n_photons);
         }
       } // End loop over Spacepoints
     } // End loop over PFParticle
 
-    _tree1->Fill();
+    for (auto& tpc_match : tpc_to_match) {
+      auto& match = *(tpc_match.second);
+      match.dep_slice_offset.push_back(match.dep_x.size());
 
-    // Don't include clusters with zero points
-    if (!light_cluster.size()) {
-      continue;
-    }
+      // Don't include clusters with zero points
+      auto cluster_it = light_cluster_m.find(match.tpc);
+      if (cluster_it == light_cluster_m.end() || cluster_it->second.empty()) {
+        continue;
+      }
 
-    // Save the light cluster, and remember the correspondance from index to slice
-    _clusterid_to_slice[_light_cluster_v.size()] = slice_v.at(n_slice);
-    _light_cluster_v.emplace_back(light_cluster);
+      // Save the light cluster, and remember the correspondance from index to slice
+      match.clusterid_to_slice.push_back(slice_v.at(n_slice));
+      match.light_cluster_v.emplace_back(std::move(cluster_it->second));
+    }
 
   } // End loop over Slices
 
@@ -0,0 +1,85 @@
+////////////////////////////////////////////////////////////////////////
+// Class:       VisibilityCache
+// File:        VisibilityCache.cc
+////////////////////////////////////////////////////////////////////////
+
+#include "sbndcode/OpT0Finder/VisibilityCache.h"
+
+namespace flashmatch {
+
+  void VisibilityCache::SetNChannels(size_t n_channels) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _n_channels = n_channels;
+    _row_m.clear();
+  }
+
+  size_t VisibilityCache::Size() const {
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _row_m.size();
+  }
+
+  void VisibilityCache::Clear() {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _row_m.clear();
+  }
+
+  void VisibilityCache::Gather(const std::vector<int>& voxel_v,
+                               const std::vector<double>& x_v,
+                               const std::vector<double>& y_v,
+                               const std::vector<double>& z_v,
+                               const RowFiller_t& filler,
+                               std::vector<const float*>& row_v,
+                               std::vector<float>& scratch) {
+
+    row_v.assign(voxel_v.size(), nullptr);
+    std::vector<size_t> overflow_v;
+
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    for (size_t i = 0; i < voxel_v.size(); i++) {
+      int const voxel = voxel_v[i];
+      if (voxel < 0) continue;
+
+      auto it = _row_m.find(voxel);
+      if (it != _row_m.end()) {
+        row_v[i] = it->second.data();
+        continue;
+      }
+
+      if (_max_voxels != 0 && _row_m.size() >= _max_voxels) {
+        overflow_v.push_back(i);
+        continue;
+      }
+
+      auto& row = _row_m[voxel];
+      row.assign(_n_channels, 0.);
+      filler(voxel, x_v[i], y_v[i], z_v[i], row.data());
+      row_v[i] = row.data();
+    }
+
+    // Voxels that don't fit in the cache are computed for this call only
+    scratch.assign(overflow_v.size() * _n_channels, 0.);
+    for (size_t k = 0; k < overflow_v.size(); k++) {
+      size_t const i = overflow_v[k];
+      float* row = scratch.data() + k * _n_channels;
+      filler(voxel_v[i], x_v[i], y_v[i], z_v[i], row);
+      row_v[i] = row;
+    }
+  }
+
+  void AccumulateRows(const std::vector<const float*>& row_v,
+                      const std::vector<float>& q_v,
+                      size_t n_channels,
+                      float* __restrict__ pe) {
+
+    for (size_t i = 0; i < row_v.size(); i++) {
+      const float* __restrict__ row = row_v[i];
+      if (!row) continue;
+      float const q = q_v[i];
+      for (size_t ch = 0; ch < n_channels; ch++) {
+        pe[ch] += q * row[ch];
+      }
+    }
+  }
+
+}
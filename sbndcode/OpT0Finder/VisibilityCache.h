@@ -0,0 +1,72 @@
+////////////////////////////////////////////////////////////////////////
+// Class:       VisibilityCache
+// File:        VisibilityCache.h
+//
+// Voxel-keyed cache of per-channel light yield rows, used to turn the
+// flash hypothesis calculation into a dense gather-and-sum over the
+// points of a light cluster.
+////////////////////////////////////////////////////////////////////////
+
+#ifndef SBND_VISIBILITYCACHE_H
+#define SBND_VISIBILITYCACHE_H
+
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace flashmatch {
+
+  class VisibilityCache {
+
+  public:
+
+    /// Fills the row of a voxel, given a point inside the voxel
+    using RowFiller_t = std::function<void(int voxel, double x, double y, double z, float* row)>;
+
+    VisibilityCache() = default;
+
+    /// Sets the number of channels per row, clears the cache
+    void SetNChannels(size_t n_channels);
+
+    /// Maximum number of voxels to keep, 0 for no limit
+    void SetMaxVoxels(size_t max_voxels) { _max_voxels = max_voxels; }
+
+    size_t NChannels() const { return _n_channels; }
+
+    /// Number of cached voxels
+    size_t Size() const;
+
+    void Clear();
+
+    /// Gathers the rows of all points, filling the missing voxels with filler.
+    /// Points outside the voxelisation (voxel < 0) get a null row.
+    /// Rows that do not fit in the cache are filled into scratch.
+    void Gather(const std::vector<int>& voxel_v,
+                const std::vector<double>& x_v,
+                const std::vector<double>& y_v,
+                const std::vector<double>& z_v,
+                const RowFiller_t& filler,
+                std::vector<const float*>& row_v,
+                std::vector<float>& scratch);
+
+  private:
+
+    size_t _n_channels = 0;
+    size_t _max_voxels = 0;
+    mutable std::mutex _mutex;
+    std::unordered_map<int, std::vector<float>> _row_m; ///< voxel -> row, node storage keeps rows stable
+
+  };
+
+  /// Dense hypothesis kernel: pe[ch] += sum_i q[i] * row_v[i][ch].
+  /// Null rows are skipped.
+  void AccumulateRows(const std::vector<const float*>& row_v,
+                      const std::vector<float>& q_v,
+                      size_t n_channels,
+                      float* pe);
+
+}
+
+#endif
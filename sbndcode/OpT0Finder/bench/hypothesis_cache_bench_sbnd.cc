@@ -0,0 +1,134 @@
+////////////////////////////////////////////////////////////////////////
+// File:        hypothesis_cache_bench_sbnd.cc
+//
+// Benchmark of the flash hypothesis kernel used by
+// CachedPhotonLibHypothesis, on synthetic light clusters and a synthetic
+// voxelised visibility map. Compares the per-point, per-channel lookup
+// against the cached gather-and-sum.
+//
+// Usage: hypothesis_cache_bench_sbnd [n_slices] [n_points] [n_flashes] [n_channels]
+// Output: one "key value" pair per line.
+////////////////////////////////////////////////////////////////////////
+
+#include "sbndcode/OpT0Finder/VisibilityCache.h"
+
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <vector>
+
+namespace {
+
+  // Detector half-size and voxel size, roughly the SBND library
+  constexpr double kHalfX = 200., kHalfY = 200., kLengthZ = 500.;
+  constexpr double kVoxel = 5.;
+  constexpr int kNX = 80, kNY = 80, kNZ = 100;
+
+  int VoxelID(double x, double y, double z) {
+    int const ix = (x + kHalfX) / kVoxel;
+    int const iy = (y + kHalfY) / kVoxel;
+    int const iz = z / kVoxel;
+    if (ix < 0 || iy < 0 || iz < 0 || ix >= kNX || iy >= kNY || iz >= kNZ) return -1;
+    return ix + kNX * (iy + kNY * iz);
+  }
+
+  // Stand-in for a photon library lookup of one channel, constant within a voxel
+  float Visibility(double x, double y, double z, size_t ch, size_t n_channels) {
+    x = -kHalfX + kVoxel * (std::floor((x + kHalfX) / kVoxel) + 0.5);
+    y = -kHalfY + kVoxel * (std::floor((y + kHalfY) / kVoxel) + 0.5);
+    z = kVoxel * (std::floor(z / kVoxel) + 0.5);
+    double const cy = -kHalfY + 2. * kHalfY * (ch % 8) / 8.;
+    double const cz = kLengthZ * (double)ch / n_channels;
+    double const d2 = (kHalfX - std::abs(x)) * (kHalfX - std::abs(x)) + (y - cy) * (y - cy) + (z - cz) * (z - cz);
+    return 1.e-3 / (1. + d2);
+  }
+
+  double Seconds(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  }
+
+}
+
+int main(int argc, char** argv) {
+
+  size_t const n_slices   = argc > 1 ? std::atoi(argv[1]) : 50;
+  size_t const n_points   = argc > 2 ? std::atoi(argv[2]) : 1000;
+  size_t const n_flashes  = argc > 3 ? std::atoi(argv[3]) : 20;
+  size_t const n_channels = argc > 4 ? std::atoi(argv[4]) : 120;
+
+  std::mt19937 rng(12345);
+  std::uniform_real_distribution<double> ux(-kHalfX, kHalfX), uy(-kHalfY, kHalfY), uz(0., kLengthZ);
+  std::uniform_real_distribution<float> uq(1.e3, 1.e5);
+
+  // Each slice is a straight segment of points, as a track would be
+  std::vector<std::vector<double>> x_v(n_slices), y_v(n_slices), z_v(n_slices);
+  std::vector<std::vector<float>> q_v(n_slices);
+  std::vector<std::vector<int>> voxel_v(n_slices);
+  for (size_t s = 0; s < n_slices; s++) {
+    double const x0 = ux(rng), y0 = uy(rng), z0 = uz(rng);
+    double const x1 = ux(rng), y1 = uy(rng), z1 = uz(rng);
+    for (size_t i = 0; i < n_points; i++) {
+      double const f = (double)i / n_points;
+      x_v[s].push_back(x0 + f * (x1 - x0));
+      y_v[s].push_back(y0 + f * (y1 - y0));
+      z_v[s].push_back(z0 + f * (z1 - z0));
+      q_v[s].push_back(uq(rng));
+      voxel_v[s].push_back(VoxelID(x_v[s].back(), y_v[s].back(), z_v[s].back()));
+    }
+  }
+
+  // The matching evaluates one hypothesis per slice per flash
+  size_t const n_hypotheses = n_slices * n_flashes;
+  std::vector<float> pe(n_channels);
+  double checksum_direct = 0., checksum_cached = 0.;
+
+  auto start = std::chrono::steady_clock::now();
+  for (size_t f = 0; f < n_flashes; f++) {
+    for (size_t s = 0; s < n_slices; s++) {
+      std::fill(pe.begin(), pe.end(), 0.);
+      for (size_t ch = 0; ch < n_channels; ch++) {
+        for (size_t i = 0; i < n_points; i++) {
+          if (voxel_v[s][i] < 0) continue;
+          pe[ch] += q_v[s][i] * Visibility(x_v[s][i], y_v[s][i], z_v[s][i], ch, n_channels);
+        }
+      }
+      for (auto const v : pe) checksum_direct += v;
+    }
+  }
+  double const t_direct = Seconds(start);
+
+  flashmatch::VisibilityCache cache;
+  cache.SetNChannels(n_channels);
+  auto filler = [n_channels](int, double x, double y, double z, float* row) {
+    for (size_t ch = 0; ch < n_channels; ch++) row[ch] = Visibility(x, y, z, ch, n_channels);
+  };
+  std::vector<const float*> row_v;
+  std::vector<float> scratch;
+
+  start = std::chrono::steady_clock::now();
+  for (size_t f = 0; f < n_flashes; f++) {
+    for (size_t s = 0; s < n_slices; s++) {
+      std::fill(pe.begin(), pe.end(), 0.);
+      cache.Gather(voxel_v[s], x_v[s], y_v[s], z_v[s], filler, row_v, scratch);
+      flashmatch::AccumulateRows(row_v, q_v[s], n_channels, pe.data());
+      for (auto const v : pe) checksum_cached += v;
+    }
+  }
+  double const t_cached = Seconds(start);
+
+  std::cout << "n_slices " << n_slices << "\n"
+            << "n_points " << n_points << "\n"
+            << "n_flashes " << n_flashes << "\n"
+            << "n_channels " << n_channels << "\n"
+            << "n_cached_voxels " << cache.Size() << "\n"
+            << "direct_s " << t_direct << "\n"
+            << "cached_s " << t_cached << "\n"
+            << "direct_hypotheses_per_s " << n_hypotheses / t_direct << "\n"
+            << "cached_hypotheses_per_s " << n_hypotheses / t_cached << "\n"
+            << "speedup " << t_direct / t_cached << "\n"
+            << "relative_difference " << std::abs(checksum_cached - checksum_direct) / checksum_direct << "\n";
+
+  return 0;
+}
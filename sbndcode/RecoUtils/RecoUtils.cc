@@ -1,5 +1,7 @@
 #include "RecoUtils.h"
 
+#include <iostream>
+
 
 int RecoUtils::TrueParticleID(detinfo::DetectorClocksData const& clockData,
                               const art::Ptr<recob::Hit> hit, bool rollup_unsaved_ids) {
@@ -29,85 +31,26 @@ int RecoUtils::TrueParticleID(detinfo::DetectorClocksData const& clockData,
 
 int RecoUtils::TrueParticleIDFromTotalTrueEnergy(detinfo::DetectorClocksData const& clockData, const std::vector<art::Ptr<recob::Hit> >& hits, bool rollup_unsaved_ids) {
   art::ServiceHandle<cheat::BackTrackerService> bt_serv;
-  std::map<int,double> trackIDToEDepMap;
-  for (std::vector<art::Ptr<recob::Hit> >::const_iterator hitIt = hits.begin(); hitIt != hits.end(); ++hitIt) {
-    art::Ptr<recob::Hit> hit = *hitIt;
-    std::vector<sim::TrackIDE> trackIDs = bt_serv->HitToTrackIDEs(clockData, hit);
-    for (unsigned int idIt = 0; idIt < trackIDs.size(); ++idIt) {
-      int id = trackIDs[idIt].trackID;
-      if (rollup_unsaved_ids) id = std::abs(id);
-      trackIDToEDepMap[id] += trackIDs[idIt].energy;
-    }
-  }
-
-  //Loop over the map and find the track which contributes the highest energy to the hit vector
-  double maxenergy = -1;
-  int objectTrack = -99999;
-  for (std::map<int,double>::iterator mapIt = trackIDToEDepMap.begin(); mapIt != trackIDToEDepMap.end(); mapIt++){
-    double energy = mapIt->second;
-    double trackid = mapIt->first;
-    if (energy > maxenergy){
-      maxenergy = energy;
-      objectTrack = trackid;
-    }
-  }
-
-  return objectTrack;
+  return TrueParticleIDFromTotalTrueEnergy(hits,
+    [&](art::Ptr<recob::Hit> const& hit){ return bt_serv->HitToTrackIDEs(clockData, hit); },
+    rollup_unsaved_ids);
 }
 
 
 
 int RecoUtils::TrueParticleIDFromTotalRecoCharge(detinfo::DetectorClocksData const& clockData, const std::vector<art::Ptr<recob::Hit> >& hits, bool rollup_unsaved_ids) {
-  // Make a map of the tracks which are associated with this object and the charge each contributes
-  std::map<int,double> trackMap;
-  for (std::vector<art::Ptr<recob::Hit> >::const_iterator hitIt = hits.begin(); hitIt != hits.end(); ++hitIt) {
-    art::Ptr<recob::Hit> hit = *hitIt;
-    int trackID = TrueParticleID(clockData, hit, rollup_unsaved_ids);
-    trackMap[trackID] += hit->Integral();
-  }
-
-  // Pick the track with the highest charge as the 'true track'
-  double highestCharge = 0;
-  int objectTrack = -99999;
-  for (std::map<int,double>::iterator trackIt = trackMap.begin(); trackIt != trackMap.end(); ++trackIt) {
-    if (trackIt->second > highestCharge) {
-      highestCharge = trackIt->second;
-      objectTrack  = trackIt->first;
-    }
-  }
-  return objectTrack;
+  return TrueParticleIDFromTotalRecoCharge(hits,
+    [&](art::Ptr<recob::Hit> const& hit){ return TrueParticleID(clockData, hit, rollup_unsaved_ids); });
 }
 
 
 
 int RecoUtils::TrueParticleIDFromTotalRecoHits(detinfo::DetectorClocksData const& clockData,const std::vector<art::Ptr<recob::Hit> >& hits, bool rollup_unsaved_ids) {
-  // Make a map of the tracks which are associated with this object and the number of hits they are the primary contributor to
-  std::map<int,int> trackMap;
-  for (std::vector<art::Ptr<recob::Hit> >::const_iterator hitIt = hits.begin(); hitIt != hits.end(); ++hitIt) {
-    art::Ptr<recob::Hit> hit = *hitIt;
-    int trackID = TrueParticleID(clockData, hit, rollup_unsaved_ids);
-    trackMap[trackID]++;
-  }
-
-  // Pick the track which is the primary contributor to the most hits as the 'true track'
-  int objectTrack = -99999;
-  int highestCount = -1;
-  int NHighestCounts = 0;
-  for (std::map<int,int>::iterator trackIt = trackMap.begin(); trackIt != trackMap.end(); ++trackIt) {
-    if (trackIt->second > highestCount) {
-      highestCount = trackIt->second;
-      objectTrack  = trackIt->first;
-      NHighestCounts = 1;
-    }
-    else if (trackIt->second == highestCount){
-      NHighestCounts++;
-    }
-  }
-  if (NHighestCounts > 1){
-    std::cout<<"RecoUtils::TrueParticleIDFromTotalRecoHits - There are " << NHighestCounts << " particles which tie for highest number of contributing hits (" << highestCount<<" hits).  Using RecoUtils::TrueParticleIDFromTotalTrueEnergy instead."<<std::endl;
-    objectTrack = RecoUtils::TrueParticleIDFromTotalTrueEnergy(clockData, hits,rollup_unsaved_ids);
-  }
-  return objectTrack;
+  art::ServiceHandle<cheat::BackTrackerService> bt_serv;
+  return TrueParticleIDFromTotalRecoHits(hits,
+    [&](art::Ptr<recob::Hit> const& hit){ return bt_serv->HitToTrackIDEs(clockData, hit); },
+    [&](art::Ptr<recob::Hit> const& hit){ return TrueParticleID(clockData, hit, rollup_unsaved_ids); },
+    rollup_unsaved_ids);
 }
 
 
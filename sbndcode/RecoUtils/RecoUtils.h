@@ -38,6 +38,10 @@ namespace detinfo { class DetectorClocksData; }
 // c++
 #include <vector>
 #include <map>
+#include <utility>
+#include <algorithm>
+#include <iterator>
+#include <cstdlib>
 
 // ROOT
 #include "TTree.h"
@@ -50,6 +54,102 @@ namespace RecoUtils{
   int TrueParticleIDFromTotalRecoHits(detinfo::DetectorClocksData const& clockData, const std::vector<art::Ptr<recob::Hit> >& hits, bool rollup_unsaved_ids=1);  //Returns the geant4 ID which contributes the most to the vector of hits.  The matching method looks for which true particle maximally contributes to the most reco hits
   bool IsInsideTPC(TVector3 position, double distance_buffer); //Checks if a position is within any of the TPCs in the geometry (user can define some distance buffer from the TPC walls)
   double CalculateTrackLength(const art::Ptr<recob::Track> track); //Calculates the total length of a recob::track by summing up the distances between adjacent traj. points
+
+  // Same matching as the TrueParticleIDFromTotal* functions above with the backtracking of each hit supplied by the caller, so that hits shared between objects can be backtracked once per event.
+  // trackIDEs(hit) returns the true particles contributing to the hit as a range of objects with trackID and energy members, as from BackTrackerService::HitToTrackIDEs().
+  // mainTrackID(hit) returns the true particle contributing the most to the hit, as from TrueParticleID() with the same rollup_unsaved_ids.
+  template <class TrackIDEsFunc>
+  int TrueParticleIDFromTotalTrueEnergy(const std::vector<art::Ptr<recob::Hit> >& hits, TrackIDEsFunc&& trackIDEs, bool rollup_unsaved_ids=1);
+  template <class MainTrackIDFunc>
+  int TrueParticleIDFromTotalRecoCharge(const std::vector<art::Ptr<recob::Hit> >& hits, MainTrackIDFunc&& mainTrackID);
+  template <class TrackIDEsFunc, class MainTrackIDFunc>
+  int TrueParticleIDFromTotalRecoHits(const std::vector<art::Ptr<recob::Hit> >& hits, TrackIDEsFunc&& trackIDEs, MainTrackIDFunc&& mainTrackID, bool rollup_unsaved_ids=1);
+
+  // Sums the values with the same ID, leaving one entry per ID sorted by ID; the values of each ID are added in their original order
+  inline void SumByID(std::vector<std::pair<int, double> >& values);
+  // ID with the largest value from the output of SumByID, the lowest ID on ties; noID if no value is above minValue
+  inline std::pair<int, double> MaxByID(const std::vector<std::pair<int, double> >& values, double minValue, int noID=-99999);
+}
+
+
+inline void RecoUtils::SumByID(std::vector<std::pair<int, double> >& values) {
+  std::stable_sort(values.begin(), values.end(), [](auto const& a, auto const& b){ return a.first < b.first; });
+  auto out = values.begin();
+  for (auto const& value: values) {
+    if ((out != values.begin()) && (std::prev(out)->first == value.first)) std::prev(out)->second += value.second;
+    else *(out++) = value;
+  }
+  values.erase(out, values.end());
+}
+
+
+
+inline std::pair<int, double> RecoUtils::MaxByID(const std::vector<std::pair<int, double> >& values, double minValue, int noID) {
+  std::pair<int, double> max(noID, minValue);
+  for (auto const& value: values) {
+    if (value.second > max.second) max = value;
+  }
+  return max;
+}
+
+
+template <class TrackIDEsFunc>
+int RecoUtils::TrueParticleIDFromTotalTrueEnergy(const std::vector<art::Ptr<recob::Hit> >& hits, TrackIDEsFunc&& trackIDEs, bool rollup_unsaved_ids) {
+  // Collect the energy each true particle deposits in the hits and sum it by particle
+  std::vector<std::pair<int, double> > trackIDToEDep;
+  for (std::vector<art::Ptr<recob::Hit> >::const_iterator hitIt = hits.begin(); hitIt != hits.end(); ++hitIt) {
+    for (auto const& ide: trackIDEs(*hitIt)) {
+      int id = ide.trackID;
+      if (rollup_unsaved_ids) id = std::abs(id);
+      trackIDToEDep.emplace_back(id, ide.energy);
+    }
+  }
+  SumByID(trackIDToEDep);
+
+  //Find the track which contributes the highest energy to the hit vector
+  return MaxByID(trackIDToEDep, -1).first;
+}
+
+
+
+template <class MainTrackIDFunc>
+int RecoUtils::TrueParticleIDFromTotalRecoCharge(const std::vector<art::Ptr<recob::Hit> >& hits, MainTrackIDFunc&& mainTrackID) {
+  // Sum the charge each track associated with this object contributes
+  std::vector<std::pair<int, double> > trackCharges;
+  trackCharges.reserve(hits.size());
+  for (std::vector<art::Ptr<recob::Hit> >::const_iterator hitIt = hits.begin(); hitIt != hits.end(); ++hitIt) {
+    art::Ptr<recob::Hit> const& hit = *hitIt;
+    trackCharges.emplace_back(mainTrackID(hit), hit->Integral());
+  }
+  SumByID(trackCharges);
+
+  // Pick the track with the highest charge as the 'true track'
+  return MaxByID(trackCharges, 0).first;
+}
+
+
+
+template <class TrackIDEsFunc, class MainTrackIDFunc>
+int RecoUtils::TrueParticleIDFromTotalRecoHits(const std::vector<art::Ptr<recob::Hit> >& hits, TrackIDEsFunc&& trackIDEs, MainTrackIDFunc&& mainTrackID, bool rollup_unsaved_ids) {
+  // Count the hits each track associated with this object is the primary contributor to
+  std::vector<std::pair<int, double> > trackCounts;
+  trackCounts.reserve(hits.size());
+  for (std::vector<art::Ptr<recob::Hit> >::const_iterator hitIt = hits.begin(); hitIt != hits.end(); ++hitIt) {
+    trackCounts.emplace_back(mainTrackID(*hitIt), 1.);
+  }
+  SumByID(trackCounts);
+
+  // Pick the track which is the primary contributor to the most hits as the 'true track'
+  std::pair<int, double> const highest = MaxByID(trackCounts, -1);
+  int objectTrack = highest.first;
+  int const highestCount = highest.second;
+  int const NHighestCounts = std::count_if(trackCounts.begin(), trackCounts.end(),
+                                           [&](auto const& trackCount){ return trackCount.second == highest.second; });
+  if (NHighestCounts > 1){
+    mf::LogDebug("RecoUtils") << "RecoUtils::TrueParticleIDFromTotalRecoHits - There are " << NHighestCounts << " particles which tie for highest number of contributing hits (" << highestCount<<" hits).  Using RecoUtils::TrueParticleIDFromTotalTrueEnergy instead.";
+    objectTrack = RecoUtils::TrueParticleIDFromTotalTrueEnergy(hits, trackIDEs, rollup_unsaved_ids);
+  }
+  return objectTrack;
 }
 
 #endif
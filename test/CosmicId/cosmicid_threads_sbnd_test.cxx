@@ -0,0 +1,160 @@
+/**
+ * @file   cosmicid_threads_sbnd_test.cxx
+ * @brief  Unit test for running the cosmic ID cut chains over several threads
+ * @date   October 19th, 2026
+ *
+ * Runs the same cut chains through `CosmicIdAlg::RunCutChains()` with one and
+ * with several threads and checks that the cosmic IDs are identical and in
+ * input order, and that the cut counters add up to the same calls and tagged
+ * totals. The chains mimic `CosmicIdAlg::RunCuts()`: each item runs a fiducial
+ * style cut and then, if not tagged, the stopping dE/dx fits of
+ * `StoppingParticleCosmicIdAlg`.
+ *
+ * Usage: just run the executable.
+ */
+
+// Boost test libraries; defining this symbol tells boost somehow to generate
+// a main() function
+#define BOOST_TEST_MODULE CosmicIdThreadsTestSBND
+#include <boost/test/unit_test.hpp>
+
+// SBND libraries
+#include "sbndcode/CosmicId/Algs/CosmicIdAlg.h"
+#include "sbndcode/CosmicId/Algs/StoppingParticleCosmicIdAlg.h"
+
+// C/C++ standard libraries
+#include <cmath>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+
+//------------------------------------------------------------------------------
+//---  Test helpers
+//---
+namespace {
+
+  using sbnd::CosmicIdAlg;
+
+  /// Track-like item: whether its end is outside the fiducial volume and its dE/dx profile
+  struct Item_t {
+    bool exits = false;
+    std::vector<double> resrg;
+    std::vector<double> dedx;
+  }; // struct Item_t
+
+  /// Half exiting tracks, the rest stopping (Bragg peak) or through-going (flat) profiles
+  std::vector<Item_t> MakeItems(size_t n, unsigned int seed)
+    {
+      std::mt19937 rand(seed);
+      std::uniform_real_distribution<double> uniform(0., 1.);
+      std::normal_distribution<double> smear(0., 0.3);
+      std::vector<Item_t> items(n);
+      for (auto& item: items) {
+        item.exits = uniform(rand) < 0.5;
+        bool const stopping = uniform(rand) < 0.5;
+        for (size_t i = 0; i < 40; ++i) {
+          double const x = 0.5 + 0.4 * i;
+          item.resrg.push_back(x);
+          item.dedx.push_back((stopping? 17. * std::pow(x, -0.42): 2.1) + smear(rand));
+        }
+      }
+      return items;
+    } // MakeItems()
+
+  /// Cut chain of one item in the style of CosmicIdAlg::RunCuts()
+  bool ItemCuts(Item_t const& item, CosmicIdAlg::CutCounters& counters)
+    {
+      if (CosmicIdAlg::RunCut(counters, CosmicIdAlg::kFiducial, [&]{ return item.exits; })) return true;
+      return CosmicIdAlg::RunCut(counters, CosmicIdAlg::kStopping, [&]{
+          double const pol0 = sbnd::StoppingParticleCosmicIdAlg::Pol0ChiSq(item.dedx);
+          double const expo = sbnd::StoppingParticleCosmicIdAlg::ExpoChiSq(item.resrg, item.dedx);
+          return expo > 0. && pol0 / expo > 3.;
+        });
+    } // ItemCuts()
+
+  std::vector<bool> RunItems(std::vector<Item_t> const& items, unsigned nThreads,
+                             CosmicIdAlg::CutCounters& counters)
+    {
+      return CosmicIdAlg::RunCutChains(items.size(), nThreads, counters,
+        [&](size_t i, CosmicIdAlg::CutCounters& itemCounters){ return ItemCuts(items[i], itemCounters); });
+    } // RunItems()
+
+  void CheckThreads(std::vector<Item_t> const& items, unsigned nThreads)
+    {
+      CosmicIdAlg::CutCounters serialCounters;
+      std::vector<bool> const serial = RunItems(items, 1, serialCounters);
+      CosmicIdAlg::CutCounters threadedCounters;
+      std::vector<bool> const threaded = RunItems(items, nThreads, threadedCounters);
+
+      // results in input order, the same as running each chain on its own
+      BOOST_TEST_REQUIRE(serial.size() == items.size());
+      BOOST_TEST_REQUIRE(threaded.size() == items.size());
+      for (size_t i = 0; i < items.size(); ++i) {
+        CosmicIdAlg::CutCounters itemCounters;
+        BOOST_TEST(serial[i] == ItemCuts(items[i], itemCounters), "item " << i);
+        BOOST_TEST(threaded[i] == serial[i], "item " << i << " with " << nThreads << " threads");
+      }
+
+      for (size_t cut = 0; cut < CosmicIdAlg::kNCuts; ++cut) {
+        BOOST_TEST(threadedCounters[cut].calls == serialCounters[cut].calls,
+          CosmicIdAlg::CutName(cut) << " calls with " << nThreads << " threads");
+        BOOST_TEST(threadedCounters[cut].tagged == serialCounters[cut].tagged,
+          CosmicIdAlg::CutName(cut) << " tagged with " << nThreads << " threads");
+        BOOST_TEST(threadedCounters[cut].time >= 0.);
+      }
+    } // CheckThreads()
+
+} // local namespace
+
+
+//------------------------------------------------------------------------------
+//---  The tests
+//---
+BOOST_AUTO_TEST_CASE(IdenticalIdsTest)
+{
+  std::vector<Item_t> const items = MakeItems(200, 1);
+  for (unsigned nThreads: {2u, 3u, 8u}) CheckThreads(items, nThreads);
+} // BOOST_AUTO_TEST_CASE(IdenticalIdsTest)
+
+
+BOOST_AUTO_TEST_CASE(CounterTotalsTest)
+{
+  std::vector<Item_t> const items = MakeItems(200, 2);
+  for (unsigned nThreads: {1u, 4u}) {
+    CosmicIdAlg::CutCounters counters;
+    std::vector<bool> const cosmicIds = RunItems(items, nThreads, counters);
+    unsigned long nTagged = 0;
+    for (bool cosmic: cosmicIds) if (cosmic) ++nTagged;
+
+    // every item runs the fiducial cut and only the untagged ones go on to the stopping cut
+    BOOST_TEST(counters[CosmicIdAlg::kFiducial].calls == items.size());
+    BOOST_TEST(counters[CosmicIdAlg::kStopping].calls
+               == items.size() - counters[CosmicIdAlg::kFiducial].tagged);
+    BOOST_TEST(counters[CosmicIdAlg::kFiducial].tagged + counters[CosmicIdAlg::kStopping].tagged == nTagged);
+    for (size_t cut = 0; cut < CosmicIdAlg::kNCuts; ++cut) {
+      if (cut == CosmicIdAlg::kFiducial || cut == CosmicIdAlg::kStopping) continue;
+      BOOST_TEST(counters[cut].calls == 0UL);
+    }
+  }
+} // BOOST_AUTO_TEST_CASE(CounterTotalsTest)
+
+
+BOOST_AUTO_TEST_CASE(MoreThreadsThanItemsTest)
+{
+  std::vector<Item_t> const items = MakeItems(3, 3);
+  CheckThreads(items, 8);
+  CheckThreads({}, 4);
+} // BOOST_AUTO_TEST_CASE(MoreThreadsThanItemsTest)
+
+
+BOOST_AUTO_TEST_CASE(ExceptionTest)
+{
+  CosmicIdAlg::CutCounters counters;
+  BOOST_CHECK_THROW(
+    CosmicIdAlg::RunCutChains(10, 4, counters, [](size_t i, CosmicIdAlg::CutCounters&) -> bool {
+        if (i == 7) throw std::runtime_error("cut failed");
+        return false;
+      }),
+    std::runtime_error);
+} // BOOST_AUTO_TEST_CASE(ExceptionTest)
@@ -0,0 +1,184 @@
+/**
+ * @file   stopping_fits_sbnd_test.cxx
+ * @brief  Unit test for the dE/dx fits of the stopping particle cosmic tagger
+ * @date   October 19th, 2026
+ *
+ * Compares `StoppingParticleCosmicIdAlg::Pol0ChiSq()` and `ExpoChiSq()` with
+ * the ROOT `TGraph` "pol0" and "expo" fits they replace, on dE/dx versus
+ * residual range profiles like the ones selected by `StoppingChiSq()`.
+ *
+ * Tolerances:
+ * - pol0: ROOT uses the linear fitter, the chi2 must agree to 1e-9 relative;
+ * - expo: Minuit stops once its estimated distance to the minimum is below
+ *   about 1e-5 in chi2 while the native fit converges to 1e-12 relative, so
+ *   the chi2 must agree to 1e-3 absolute plus 1e-5 relative.
+ * Where the ROOT fit fails, the native chi2 must be finite and no larger than
+ * the ROOT one.
+ *
+ * Usage: just run the executable.
+ */
+
+// Boost test libraries; defining this symbol tells boost somehow to generate
+// a main() function
+#define BOOST_TEST_MODULE StoppingFitsTestSBND
+#include <boost/test/unit_test.hpp>
+
+// SBND libraries
+#include "sbndcode/CosmicId/Algs/StoppingParticleCosmicIdAlg.h"
+
+// ROOT libraries
+#include "TGraph.h"
+#include "TF1.h"
+
+// C/C++ standard libraries
+#include <cmath>
+#include <limits>
+#include <random>
+#include <vector>
+
+
+//------------------------------------------------------------------------------
+//---  Test helpers
+//---
+namespace {
+
+  constexpr double kPol0RelTolerance = 1e-9;
+  constexpr double kExpoAbsTolerance = 1e-3;
+  constexpr double kExpoRelTolerance = 1e-5;
+
+  // Same selection limits as the default StoppingParticleCosmicIdAlg configuration
+  constexpr double kDEdxMax = 30.; // [MeV/cm]
+
+  /// dE/dx profile: residual range [cm] and dE/dx [MeV/cm]
+  struct Profile_t {
+    std::vector<double> resrg;
+    std::vector<double> dedx;
+
+    void Add(double x, double y)
+      {
+        if (y >= kDEdxMax) return; // as in StoppingChiSq()
+        resrg.push_back(x);
+        dedx.push_back(y);
+      }
+  }; // struct Profile_t
+
+  /// Chi2 of a ROOT fit of a graph without errors, as the old StoppingChiSq()
+  double RootChiSq(Profile_t const& profile, const char* function)
+    {
+      TGraph graph(profile.dedx.size(), profile.resrg.data(), profile.dedx.data());
+      try { graph.Fit(function, "Q"); }
+      catch (...) { return std::numeric_limits<double>::quiet_NaN(); }
+      TF1* fit = graph.GetFunction(function);
+      if (!fit) return std::numeric_limits<double>::quiet_NaN();
+      return fit->GetChisquare();
+    } // RootChiSq()
+
+  /// Residual ranges from the track end as in the fitted window
+  std::vector<double> ResidualRanges(double start, double step, size_t n)
+    {
+      std::vector<double> resrg;
+      for (size_t i = 0; i < n; ++i) resrg.push_back(start + step * i);
+      return resrg;
+    } // ResidualRanges()
+
+  /// Stopping particle: dE/dx = A R^-b with gaussian smearing
+  Profile_t BraggProfile(double A, double b, double sigma, unsigned int seed)
+    {
+      std::mt19937 rand(seed);
+      std::normal_distribution<double> smear(0., sigma);
+      Profile_t profile;
+      for (double x: ResidualRanges(0.5, 0.4, 50))
+        profile.Add(x, A * std::pow(x, -b) + smear(rand));
+      return profile;
+    } // BraggProfile()
+
+  /// Through-going MIP: flat dE/dx with a gaussian core and a high tail
+  Profile_t MIPProfile(double mean, double sigma, unsigned int seed)
+    {
+      std::mt19937 rand(seed);
+      std::normal_distribution<double> core(mean, sigma);
+      std::exponential_distribution<double> tail(1.);
+      std::uniform_real_distribution<double> uniform(0., 1.);
+      Profile_t profile;
+      for (double x: ResidualRanges(10.3, 0.3, 60)) {
+        double y = core(rand);
+        if (uniform(rand) < 0.1) y += tail(rand);
+        profile.Add(x, y);
+      }
+      return profile;
+    } // MIPProfile()
+
+  void CheckPol0(Profile_t const& profile)
+    {
+      const double native = sbnd::StoppingParticleCosmicIdAlg::Pol0ChiSq(profile.dedx);
+      const double root = RootChiSq(profile, "pol0");
+      BOOST_TEST_REQUIRE(std::isfinite(root));
+      BOOST_TEST(std::abs(native - root) <= kPol0RelTolerance * root,
+        "pol0 chi2 " << native << " (native) vs " << root << " (ROOT)");
+    } // CheckPol0()
+
+  void CheckExpo(Profile_t const& profile)
+    {
+      const double native = sbnd::StoppingParticleCosmicIdAlg::ExpoChiSq(profile.resrg, profile.dedx);
+      const double root = RootChiSq(profile, "expo");
+      BOOST_TEST_REQUIRE(std::isfinite(root));
+      BOOST_TEST(std::abs(native - root) <= kExpoAbsTolerance + kExpoRelTolerance * root,
+        "expo chi2 " << native << " (native) vs " << root << " (ROOT)");
+    } // CheckExpo()
+
+} // local namespace
+
+
+//------------------------------------------------------------------------------
+//---  The tests
+//---
+BOOST_AUTO_TEST_CASE(StoppingMuonTest)
+{
+  for (unsigned int seed = 1; seed <= 10; ++seed) {
+    Profile_t const profile = BraggProfile(17., 0.42, 0.3, seed);
+    CheckPol0(profile);
+    CheckExpo(profile);
+  }
+} // BOOST_AUTO_TEST_CASE(StoppingMuonTest)
+
+
+BOOST_AUTO_TEST_CASE(StoppingProtonTest)
+{
+  for (unsigned int seed = 1; seed <= 10; ++seed) {
+    Profile_t const profile = BraggProfile(40., 0.45, 1.0, seed);
+    CheckPol0(profile);
+    CheckExpo(profile);
+  }
+} // BOOST_AUTO_TEST_CASE(StoppingProtonTest)
+
+
+BOOST_AUTO_TEST_CASE(ThroughGoingMuonTest)
+{
+  for (unsigned int seed = 1; seed <= 10; ++seed) {
+    Profile_t const profile = MIPProfile(2.1, 0.25, seed);
+    CheckPol0(profile);
+    CheckExpo(profile);
+  }
+} // BOOST_AUTO_TEST_CASE(ThroughGoingMuonTest)
+
+
+BOOST_AUTO_TEST_CASE(FailingFitTest)
+{
+  // all the points at the same residual range: the expo slope is undetermined,
+  // and zero and negative dE/dx values have no logarithm for the initial fit
+  Profile_t profile;
+  std::mt19937 rand(7);
+  std::normal_distribution<double> smear(0., 0.5);
+  for (size_t i = 0; i < 20; ++i) profile.Add(5., smear(rand));
+  profile.dedx[0] = 0.;
+
+  CheckPol0(profile);
+
+  const double native = sbnd::StoppingParticleCosmicIdAlg::ExpoChiSq(profile.resrg, profile.dedx);
+  const double root = RootChiSq(profile, "expo");
+  BOOST_TEST(std::isfinite(native));
+  if (std::isfinite(root)) {
+    BOOST_TEST(native <= root + kExpoAbsTolerance + kExpoRelTolerance * root,
+      "expo chi2 " << native << " (native) vs " << root << " (ROOT)");
+  }
+} // BOOST_AUTO_TEST_CASE(FailingFitTest)